@@ -57,6 +57,14 @@ ensure_debug_category (void)
 typedef void (*MixerFunc) (GstAudioChannelMixer * mix, const gpointer src[],
     gpointer dst[], gint samples);
 
+/* an input channel that contributes to an output channel */
+typedef struct
+{
+  gint in;
+  gfloat coeff;
+  gint coeff_int;
+} MixEntry;
+
 struct _GstAudioChannelMixer
 {
   gint in_channels;
@@ -70,6 +78,14 @@ struct _GstAudioChannelMixer
    * this is matrix * (2^10) as integers */
   gint **matrix_int;
 
+  /* for each output channel the inputs with a non-zero coefficient,
+   * entries[out * in_channels + k] with k < n_entries[out] */
+  MixEntry *entries;
+  gint *n_entries;
+  /* when each output is a copy of one input, the input for each output
+   * or -1 for silence */
+  gint *perm;
+
   MixerFunc func;
 };
 
@@ -95,6 +111,10 @@ gst_audio_channel_mixer_free (GstAudioChannelMixer * mix)
   g_free (mix->matrix_int);
   mix->matrix_int = NULL;
 
+  g_free (mix->entries);
+  g_free (mix->n_entries);
+  g_free (mix->perm);
+
   g_slice_free (GstAudioChannelMixer, mix);
 }
 
@@ -673,6 +693,45 @@ gst_audio_channel_mixer_setup_matrix_int (GstAudioChannelMixer * mix)
   }
 }
 
+/* collect the non-zero coefficients for each output channel, returns
+ * %TRUE when the matrix only copies and reorders channels */
+static gboolean
+gst_audio_channel_mixer_setup_entries (GstAudioChannelMixer * mix)
+{
+  gint i, j;
+  gboolean is_permutation = TRUE;
+
+  mix->entries = g_new (MixEntry, mix->in_channels * mix->out_channels);
+  mix->n_entries = g_new0 (gint, mix->out_channels);
+  mix->perm = g_new (gint, mix->out_channels);
+
+  for (j = 0; j < mix->out_channels; j++) {
+    MixEntry *e = &mix->entries[j * mix->in_channels];
+    gint n = 0;
+
+    for (i = 0; i < mix->in_channels; i++) {
+      if (mix->matrix[i][j] == 0.0f && mix->matrix_int[i][j] == 0)
+        continue;
+
+      e[n].in = i;
+      e[n].coeff = mix->matrix[i][j];
+      e[n].coeff_int = mix->matrix_int[i][j];
+      n++;
+    }
+    mix->n_entries[j] = n;
+
+    if (n == 0) {
+      mix->perm[j] = -1;
+    } else if (n == 1 && e[0].coeff == 1.0f &&
+        e[0].coeff_int == (1 << PRECISION_INT)) {
+      mix->perm[j] = e[0].in;
+    } else {
+      is_permutation = FALSE;
+    }
+  }
+  return is_permutation;
+}
+
 static gfloat **
 gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, GstAudioChannelPosition * in_position,
@@ -806,6 +865,245 @@ DEFINE_FLOAT_MIX_FUNC (double, interleaved, planar);
 DEFINE_FLOAT_MIX_FUNC (double, planar, interleaved);
 DEFINE_FLOAT_MIX_FUNC (double, planar, planar);
 
+/* only accumulate the inputs with a non-zero coefficient */
+#define DEFINE_INTEGER_SPARSE_MIX_FUNC(bits, resbits, inlayout, outlayout) \
+static void \
+gst_audio_channel_mixer_sparse_int##bits##_##inlayout##_##outlayout ( \
+    GstAudioChannelMixer * mix, const gint##bits * in_data[], \
+    gint##bits * out_data[], gint samples) \
+{ \
+  gint out, n, k, n_entries; \
+  gint##resbits res; \
+  gint inchannels, outchannels; \
+  const MixEntry *e; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (n = 0; n < samples; n++) { \
+    for (out = 0; out < outchannels; out++) { \
+      e = &mix->entries[out * inchannels]; \
+      n_entries = mix->n_entries[out]; \
+      \
+      res = 0; \
+      for (k = 0; k < n_entries; k++) \
+        res += \
+          _get_in_data_##inlayout##_gint##bits (in_data, n, e[k].in, \
+              inchannels) * (gint##resbits) e[k].coeff_int; \
+      \
+      /* remove factor from int matrix */ \
+      res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT; \
+      *_get_out_data_##outlayout##_gint##bits (out_data, n, out, outchannels) = \
+          CLAMP (res, G_MININT##bits, G_MAXINT##bits); \
+    } \
+  } \
+}
+
+#define DEFINE_FLOAT_SPARSE_MIX_FUNC(type, inlayout, outlayout) \
+static void \
+gst_audio_channel_mixer_sparse_##type##_##inlayout##_##outlayout ( \
+    GstAudioChannelMixer * mix, const g##type * in_data[], \
+    g##type * out_data[], gint samples) \
+{ \
+  gint out, n, k, n_entries; \
+  g##type res; \
+  gint inchannels, outchannels; \
+  const MixEntry *e; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (n = 0; n < samples; n++) { \
+    for (out = 0; out < outchannels; out++) { \
+      e = &mix->entries[out * inchannels]; \
+      n_entries = mix->n_entries[out]; \
+      \
+      res = 0.0; \
+      for (k = 0; k < n_entries; k++) \
+        res += \
+          _get_in_data_##inlayout##_g##type (in_data, n, e[k].in, \
+              inchannels) * e[k].coeff; \
+      \
+      *_get_out_data_##outlayout##_g##type (out_data, n, out, outchannels) = res; \
+    } \
+  } \
+}
+
+/* planar to planar, one output channel at a time so that the inner loops
+ * run over consecutive samples and can be vectorized by the compiler */
+#define DEFINE_FLOAT_PLANAR_MIX_FUNC(type) \
+static void \
+gst_audio_channel_mixer_planar_##type ( \
+    GstAudioChannelMixer * mix, const g##type * in_data[], \
+    g##type * out_data[], gint samples) \
+{ \
+  gint out, n, k, n_entries; \
+  gint inchannels, outchannels; \
+  const MixEntry *e; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (out = 0; out < outchannels; out++) { \
+    g##type *o = out_data[out]; \
+    \
+    e = &mix->entries[out * inchannels]; \
+    n_entries = mix->n_entries[out]; \
+    \
+    if (n_entries == 0) { \
+      memset (o, 0, samples * sizeof (g##type)); \
+      continue; \
+    } \
+    { \
+      const g##type *i0 = in_data[e[0].in]; \
+      const g##type c = e[0].coeff; \
+      \
+      for (n = 0; n < samples; n++) \
+        o[n] = i0[n] * c; \
+    } \
+    for (k = 1; k < n_entries; k++) { \
+      const g##type *ik = in_data[e[k].in]; \
+      const g##type c = e[k].coeff; \
+      \
+      for (n = 0; n < samples; n++) \
+        o[n] += ik[n] * c; \
+    } \
+  } \
+}
+
+/* every output is a copy of one input or silence */
+#define DEFINE_PERMUTE_FUNC(type, inlayout, outlayout) \
+static void \
+gst_audio_channel_mixer_permute_##type##_##inlayout##_##outlayout ( \
+    GstAudioChannelMixer * mix, const type * in_data[], \
+    type * out_data[], gint samples) \
+{ \
+  gint in, out, n; \
+  gint inchannels, outchannels; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (n = 0; n < samples; n++) { \
+    for (out = 0; out < outchannels; out++) { \
+      in = mix->perm[out]; \
+      *_get_out_data_##outlayout##_##type (out_data, n, out, outchannels) = \
+          in < 0 ? 0 : \
+          _get_in_data_##inlayout##_##type (in_data, n, in, inchannels); \
+    } \
+  } \
+}
+
+#define DEFINE_PERMUTE_PLANAR_FUNC(type) \
+static void \
+gst_audio_channel_mixer_permute_##type##_planar_planar ( \
+    GstAudioChannelMixer * mix, const type * in_data[], \
+    type * out_data[], gint samples) \
+{ \
+  gint in, out; \
+  \
+  for (out = 0; out < mix->out_channels; out++) { \
+    in = mix->perm[out]; \
+    if (in < 0) \
+      memset (out_data[out], 0, samples * sizeof (type)); \
+    else if (out_data[out] != in_data[in]) \
+      memcpy (out_data[out], in_data[in], samples * sizeof (type)); \
+  } \
+}
+
+DEFINE_INTEGER_SPARSE_MIX_FUNC (16, 32, interleaved, interleaved);
+DEFINE_INTEGER_SPARSE_MIX_FUNC (16, 32, interleaved, planar);
+DEFINE_INTEGER_SPARSE_MIX_FUNC (16, 32, planar, interleaved);
+DEFINE_INTEGER_SPARSE_MIX_FUNC (16, 32, planar, planar);
+
+DEFINE_INTEGER_SPARSE_MIX_FUNC (32, 64, interleaved, interleaved);
+DEFINE_INTEGER_SPARSE_MIX_FUNC (32, 64, interleaved, planar);
+DEFINE_INTEGER_SPARSE_MIX_FUNC (32, 64, planar, interleaved);
+DEFINE_INTEGER_SPARSE_MIX_FUNC (32, 64, planar, planar);
+
+DEFINE_FLOAT_SPARSE_MIX_FUNC (float, interleaved, interleaved);
+DEFINE_FLOAT_SPARSE_MIX_FUNC (float, interleaved, planar);
+DEFINE_FLOAT_SPARSE_MIX_FUNC (float, planar, interleaved);
+DEFINE_FLOAT_SPARSE_MIX_FUNC (float, planar, planar);
+DEFINE_FLOAT_PLANAR_MIX_FUNC (float);
+
+DEFINE_FLOAT_SPARSE_MIX_FUNC (double, interleaved, interleaved);
+DEFINE_FLOAT_SPARSE_MIX_FUNC (double, interleaved, planar);
+DEFINE_FLOAT_SPARSE_MIX_FUNC (double, planar, interleaved);
+DEFINE_FLOAT_SPARSE_MIX_FUNC (double, planar, planar);
+DEFINE_FLOAT_PLANAR_MIX_FUNC (double);
+
+DEFINE_PERMUTE_FUNC (gint16, interleaved, interleaved);
+DEFINE_PERMUTE_FUNC (gint16, interleaved, planar);
+DEFINE_PERMUTE_FUNC (gint16, planar, interleaved);
+DEFINE_PERMUTE_PLANAR_FUNC (gint16);
+
+DEFINE_PERMUTE_FUNC (gint32, interleaved, interleaved);
+DEFINE_PERMUTE_FUNC (gint32, interleaved, planar);
+DEFINE_PERMUTE_FUNC (gint32, planar, interleaved);
+DEFINE_PERMUTE_PLANAR_FUNC (gint32);
+
+DEFINE_GET_DATA_FUNCS (gint64);
+DEFINE_PERMUTE_FUNC (gint64, interleaved, interleaved);
+DEFINE_PERMUTE_FUNC (gint64, interleaved, planar);
+DEFINE_PERMUTE_FUNC (gint64, planar, interleaved);
+DEFINE_PERMUTE_PLANAR_FUNC (gint64);
+
+/* indexed by format, non-interleaved input and non-interleaved output */
+static const MixerFunc dense_funcs[4][2][2] = {
+  {{(MixerFunc) gst_audio_channel_mixer_mix_int16_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_mix_int16_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_mix_int16_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_mix_int16_planar_planar}},
+  {{(MixerFunc) gst_audio_channel_mixer_mix_int32_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_mix_int32_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_mix_int32_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_mix_int32_planar_planar}},
+  {{(MixerFunc) gst_audio_channel_mixer_mix_float_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_mix_float_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_mix_float_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_mix_float_planar_planar}},
+  {{(MixerFunc) gst_audio_channel_mixer_mix_double_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_mix_double_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_mix_double_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_mix_double_planar_planar}},
+};
+
+static const MixerFunc sparse_funcs[4][2][2] = {
+  {{(MixerFunc) gst_audio_channel_mixer_sparse_int16_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_sparse_int16_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_sparse_int16_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_sparse_int16_planar_planar}},
+  {{(MixerFunc) gst_audio_channel_mixer_sparse_int32_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_sparse_int32_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_sparse_int32_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_sparse_int32_planar_planar}},
+  {{(MixerFunc) gst_audio_channel_mixer_sparse_float_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_sparse_float_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_sparse_float_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_sparse_float_planar_planar}},
+  {{(MixerFunc) gst_audio_channel_mixer_sparse_double_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_sparse_double_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_sparse_double_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_sparse_double_planar_planar}},
+};
+
+/* indexed by sample size: 16, 32 and 64 bits */
+static const MixerFunc permute_funcs[3][2][2] = {
+  {{(MixerFunc) gst_audio_channel_mixer_permute_gint16_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_permute_gint16_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_permute_gint16_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_permute_gint16_planar_planar}},
+  {{(MixerFunc) gst_audio_channel_mixer_permute_gint32_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_permute_gint32_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_permute_gint32_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_permute_gint32_planar_planar}},
+  {{(MixerFunc) gst_audio_channel_mixer_permute_gint64_interleaved_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_permute_gint64_interleaved_planar},
+      {(MixerFunc) gst_audio_channel_mixer_permute_gint64_planar_interleaved,
+          (MixerFunc) gst_audio_channel_mixer_permute_gint64_planar_planar}},
+};
+
 /**
  * gst_audio_channel_mixer_new_with_matrix: (skip):
  * @flags: #GstAudioChannelMixerFlags
@@ -829,6 +1127,8 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, gint out_channels, gfloat ** matrix)
 {
   GstAudioChannelMixer *mix;
+  gboolean planar_in, planar_out, is_permutation;
+  gint i, format_index = 0, size_index = 0, n_entries = 0;
 
   g_return_val_if_fail (format == GST_AUDIO_FORMAT_S16
       || format == GST_AUDIO_FORMAT_S32
@@ -886,87 +1186,51 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
   }
 #endif
 
+  planar_in = (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) != 0;
+  planar_out = (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) != 0;
+
   switch (format) {
     case GST_AUDIO_FORMAT_S16:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_interleaved_interleaved;
-        }
-      }
+      format_index = 0;
+      size_index = 0;
       break;
     case GST_AUDIO_FORMAT_S32:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_interleaved_interleaved;
-        }
-      }
+      format_index = 1;
+      size_index = 1;
       break;
     case GST_AUDIO_FORMAT_F32:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_interleaved_interleaved;
-        }
-      }
+      format_index = 2;
+      size_index = 1;
       break;
     case GST_AUDIO_FORMAT_F64:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_interleaved_interleaved;
-        }
-      }
+      format_index = 3;
+      size_index = 2;
       break;
     default:
       g_assert_not_reached ();
       break;
   }
+
+  is_permutation = gst_audio_channel_mixer_setup_entries (mix);
+  for (i = 0; i < mix->out_channels; i++)
+    n_entries += mix->n_entries[i];
+
+  GST_DEBUG ("using %d of %d coefficients, permutation %d", n_entries,
+      mix->in_channels * mix->out_channels, is_permutation);
+
+  if (is_permutation) {
+    mix->func = permute_funcs[size_index][planar_in][planar_out];
+  } else if (planar_in && planar_out && format_index == 2) {
+    mix->func = (MixerFunc) gst_audio_channel_mixer_planar_float;
+  } else if (planar_in && planar_out && format_index == 3) {
+    mix->func = (MixerFunc) gst_audio_channel_mixer_planar_double;
+  } else if (n_entries == mix->in_channels * mix->out_channels) {
+    /* same as the sparse functions without the indirection */
+    mix->func = dense_funcs[format_index][planar_in][planar_out];
+  } else {
+    mix->func = sparse_funcs[format_index][planar_in][planar_out];
+  }
+
   return mix;
 }
 
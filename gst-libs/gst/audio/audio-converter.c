@@ -146,6 +146,11 @@ struct _GstAudioConverter
   AudioConvertEndianFunc swap_endian;
 
   AudioConvertSamplesFunc convert;
+
+  /* block processing */
+  gsize block_frames;
+  gpointer *in_block;
+  gpointer *out_block;
 };
 
 static GstAudioConverter *
@@ -263,7 +268,6 @@ audio_chain_get_samples (AudioChain * chain, gsize * avail)
   return res;
 }
 
-/*
 static guint
 get_opt_uint (GstAudioConverter * convert, const gchar * opt, guint def)
 {
@@ -272,7 +276,6 @@ get_opt_uint (GstAudioConverter * convert, const gchar * opt, guint def)
     res = def;
   return res;
 }
-*/
 
 static gint
 get_opt_enum (GstAudioConverter * convert, const gchar * opt, GType type,
@@ -294,6 +297,7 @@ get_opt_value (GstAudioConverter * convert, const gchar * opt)
 #define DEFAULT_OPT_DITHER_METHOD GST_AUDIO_DITHER_NONE
 #define DEFAULT_OPT_NOISE_SHAPING_METHOD GST_AUDIO_NOISE_SHAPING_NONE
 #define DEFAULT_OPT_QUANTIZATION 1
+#define DEFAULT_OPT_BLOCK_FRAMES G_MAXUINT
 
 #define GET_OPT_RESAMPLER_METHOD(c) get_opt_enum(c, \
     GST_AUDIO_CONVERTER_OPT_RESAMPLER_METHOD, GST_TYPE_AUDIO_RESAMPLER_METHOD, \
@@ -308,6 +312,29 @@ get_opt_value (GstAudioConverter * convert, const gchar * opt)
     GST_AUDIO_CONVERTER_OPT_QUANTIZATION, DEFAULT_OPT_QUANTIZATION)
 #define GET_OPT_MIX_MATRIX(c) get_opt_value(c, \
     GST_AUDIO_CONVERTER_OPT_MIX_MATRIX)
+#define GET_OPT_BLOCK_FRAMES(c) get_opt_uint(c, \
+    GST_AUDIO_CONVERTER_OPT_BLOCK_FRAMES, DEFAULT_OPT_BLOCK_FRAMES)
+
+/* size of one block of intermediate samples, small enough to stay in the
+ * L1 cache while it goes through all conversion steps */
+#define BLOCK_BYTES 16384
+#define MIN_BLOCK_FRAMES 64
+
+static void
+setup_block_frames (GstAudioConverter * convert)
+{
+  guint block_frames = GET_OPT_BLOCK_FRAMES (convert);
+
+  if (block_frames == DEFAULT_OPT_BLOCK_FRAMES) {
+    gint channels = MAX (convert->in.channels, convert->out.channels);
+
+    /* the widest intermediate format is F64 */
+    block_frames = BLOCK_BYTES / (channels * sizeof (gdouble));
+    block_frames = MAX (GST_ROUND_DOWN_16 (block_frames), MIN_BLOCK_FRAMES);
+  }
+  GST_DEBUG ("block frames %u", block_frames);
+  convert->block_frames = block_frames;
+}
 
 static gboolean
 copy_config (GQuark field_id, const GValue * value, gpointer user_data)
@@ -367,6 +394,7 @@ gst_audio_converter_update_config (GstAudioConverter * convert,
   if (config) {
     gst_structure_foreach (config, copy_config, convert);
     gst_structure_free (config);
+    setup_block_frames (convert);
   }
 
   return TRUE;
@@ -491,6 +519,38 @@ do_unpack (AudioChain * chain, gpointer user_data)
   return TRUE;
 }
 
+/* unpack S16 and convert to F64 in one step, this is the same as unpacking
+ * to S32 and converting that but saves a pass over the samples */
+static gboolean
+do_unpack_s16_to_f64 (AudioChain * chain, gpointer user_data)
+{
+  GstAudioConverter *convert = user_data;
+  gsize num_samples, i, n;
+  gpointer *tmp;
+  gint b;
+
+  num_samples = convert->in_frames;
+  tmp = audio_chain_alloc_samples (chain, num_samples);
+  n = num_samples * chain->inc;
+  GST_LOG ("unpack S16 to F64 %p, %" G_GSIZE_FORMAT, tmp, num_samples);
+
+  for (b = 0; b < chain->blocks; b++) {
+    gdouble *d = tmp[b];
+
+    if (convert->in_data) {
+      const gint16 *s = convert->in_data[b];
+
+      for (i = 0; i < n; i++)
+        d[i] = s[i] * (1.0 / 32768.0);
+    } else {
+      memset (d, 0, n * sizeof (gdouble));
+    }
+  }
+  audio_chain_set_samples (chain, tmp, num_samples);
+
+  return TRUE;
+}
+
 static gboolean
 do_convert_in (AudioChain * chain, gpointer user_data)
 {
@@ -750,10 +810,20 @@ chain_convert_in (GstAudioConverter * convert, AudioChain * prev)
     convert->convert_in = (AudioConvertFunc) audio_orc_s32_to_double;
     convert->current_format = GST_AUDIO_FORMAT_F64;
 
-    prev = audio_chain_new (prev, convert);
-    prev->allow_ip = FALSE;
-    prev->pass_alloc = FALSE;
-    audio_chain_set_make_func (prev, do_convert_in, convert, NULL);
+    if (in->finfo->format == GST_AUDIO_FORMAT_S16 && prev->prev == NULL) {
+      /* replace the unpack step */
+      GST_INFO ("unpack S16 to F64");
+      audio_chain_free (prev);
+      prev = audio_chain_new (NULL, convert);
+      prev->allow_ip = FALSE;
+      prev->pass_alloc = FALSE;
+      audio_chain_set_make_func (prev, do_unpack_s16_to_f64, convert, NULL);
+    } else {
+      prev = audio_chain_new (prev, convert);
+      prev->allow_ip = FALSE;
+      prev->pass_alloc = FALSE;
+      audio_chain_set_make_func (prev, do_convert_in, convert, NULL);
+    }
   }
   return prev;
 }
@@ -1284,6 +1354,75 @@ converter_generic (GstAudioConverter * convert,
   return TRUE;
 }
 
+/* take blocks of frames through the whole chain so that the intermediate
+ * samples stay in the cache */
+static gboolean
+converter_blocked (GstAudioConverter * convert,
+    GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
+    gpointer out[], gsize out_frames)
+{
+  GstAudioInfo *in_info = &convert->in;
+  GstAudioInfo *out_info = &convert->out;
+  gsize block_frames = convert->block_frames;
+  gsize in_done = 0, out_done = 0;
+  gint i, in_blocks, out_blocks, in_bpf, out_bpf;
+
+  if (block_frames == 0 || in_frames <= block_frames)
+    return converter_generic (convert, flags, in, in_frames, out, out_frames);
+
+  if (in_info->layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    in_blocks = in_info->channels;
+    in_bpf = in_info->bpf / in_info->channels;
+  } else {
+    in_blocks = 1;
+    in_bpf = in_info->bpf;
+  }
+  if (out_info->layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    out_blocks = out_info->channels;
+    out_bpf = out_info->bpf / out_info->channels;
+  } else {
+    out_blocks = 1;
+    out_bpf = out_info->bpf;
+  }
+
+  while (in_done < in_frames) {
+    gsize in_left = in_frames - in_done;
+    gsize out_left = out_frames - out_done;
+    gsize in_len, out_len;
+
+    in_len = MIN (block_frames, in_left);
+    out_len = in_len;
+    if (convert->resampler) {
+      /* the resampler might need more input before it produces output */
+      while (TRUE) {
+        out_len =
+            gst_audio_resampler_get_out_frames (convert->resampler, in_len);
+        if (out_len > 0 || in_len == in_left)
+          break;
+        in_len = MIN (in_len + block_frames, in_left);
+      }
+    }
+    if (in_len == in_left)
+      out_len = out_left;
+    else
+      out_len = MIN (out_len, out_left);
+
+    if (in) {
+      for (i = 0; i < in_blocks; i++)
+        convert->in_block[i] = (guint8 *) in[i] + in_done * in_bpf;
+    }
+    for (i = 0; i < out_blocks; i++)
+      convert->out_block[i] = (guint8 *) out[i] + out_done * out_bpf;
+
+    converter_generic (convert, flags, in ? convert->in_block : NULL, in_len,
+        convert->out_block, out_len);
+
+    in_done += in_len;
+    out_done += out_len;
+  }
+  return TRUE;
+}
+
 static gboolean
 converter_resample (GstAudioConverter * convert,
     GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
@@ -1353,6 +1492,8 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
   convert->config = gst_structure_new_empty ("GstAudioConverter");
   if (config)
     gst_audio_converter_update_config (convert, 0, 0, config);
+  else
+    setup_block_frames (convert);
 
   GST_INFO ("unitsizes: %d -> %d", in_info->bpf, out_info->bpf);
 
@@ -1426,6 +1567,12 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
     }
   }
 
+  if (convert->convert == converter_generic) {
+    convert->convert = converter_blocked;
+    convert->in_block = g_new (gpointer, in_info->channels);
+    convert->out_block = g_new (gpointer, out_info->channels);
+  }
+
   setup_allocators (convert);
 
   return convert;
@@ -1476,6 +1623,8 @@ gst_audio_converter_free (GstAudioConverter * convert)
   gst_audio_info_init (&convert->out);
 
   gst_structure_free (convert->config);
+  g_free (convert->in_block);
+  g_free (convert->out_block);
 
   g_slice_free (GstAudioConverter, convert);
 }
@@ -106,6 +106,19 @@ typedef struct _GstAudioConverter GstAudioConverter;
  */
 #define GST_AUDIO_CONVERTER_OPT_MIX_MATRIX   "GstAudioConverter.mix-matrix"
 
+/**
+ * GST_AUDIO_CONVERTER_OPT_BLOCK_FRAMES:
+ *
+ * #G_TYPE_UINT, The number of frames that are taken through all
+ * conversion steps at a time. Small blocks keep the intermediate samples
+ * in the CPU cache. 0 converts all frames in one go.
+ * Default is a number of frames that keeps a block of intermediate
+ * samples below 16KB.
+ *
+ * Since: 1.20
+ */
+#define GST_AUDIO_CONVERTER_OPT_BLOCK_FRAMES   "GstAudioConverter.block-frames"
+
 /**
  * GstAudioConverterFlags:
  * @GST_AUDIO_CONVERTER_FLAG_NONE: no flag
@@ -0,0 +1,728 @@
+/* GStreamer
+ *
+ * audio-loudness.c: EBU R128 loudness and true-peak measurement
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstaudioloudness
+ * @title: GstAudioLoudness
+ * @short_description: EBU R128 loudness and true-peak measurement
+ *
+ * #GstAudioLoudness measures the loudness of interleaved S16, S32 or F32
+ * samples as specified by ITU-R BS.1770-4 and EBU R128. The samples are
+ * K-weighted and the momentary (400ms), short-term (3s) and gated
+ * integrated loudness is calculated from them. The true-peak of every
+ * channel is measured by oversampling the signal 4 times.
+ *
+ * The samples are converted in small blocks so that the measurement can be
+ * done right after producing the samples while they are still in the cache,
+ * without converting the complete stream to another format first.
+ *
+ * Since: 1.20
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <math.h>
+
+#include "audio-loudness.h"
+
+#if defined (HAVE_XMMINTRIN_H) && defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#ifndef GST_DISABLE_GST_DEBUG
+#define GST_CAT_DEFAULT ensure_debug_category()
+static GstDebugCategory *
+ensure_debug_category (void)
+{
+  static gsize cat_gonce = 0;
+
+  if (g_once_init_enter (&cat_gonce)) {
+    gsize cat_done;
+
+    cat_done = (gsize) _gst_debug_category_new ("audio-loudness", 0,
+        "audio-loudness object");
+
+    g_once_init_leave (&cat_gonce, cat_done);
+  }
+
+  return (GstDebugCategory *) cat_gonce;
+}
+#else
+#define ensure_debug_category() /* NOOP */
+#endif /* GST_DISABLE_GST_DEBUG */
+
+/* frames that are converted to float at a time */
+#define BLOCK_FRAMES      256
+
+/* true-peak oversampling filter */
+#define TP_PHASES         4
+#define TP_TAPS           12
+#define TP_HISTORY        (TP_TAPS - 1)
+
+/* loudness is measured in steps of 100ms, the momentary loudness over 4 and
+ * the short-term loudness over 30 of them */
+#define MOMENTARY_STEPS   4
+#define SHORT_TERM_STEPS  30
+
+/* histogram of the gating blocks in 0.1 LU bins from -70 to +10 LUFS */
+#define ABSOLUTE_GATE     -70.0
+#define RELATIVE_GATE     -10.0
+#define HIST_STEP         0.1
+#define HIST_BINS         800
+
+typedef struct
+{
+  gdouble b0, b1, b2;
+  gdouble a1, a2;
+} Biquad;
+
+typedef void (*DeinterleaveFunc) (GstAudioLoudness * loudness,
+    const guint8 * src, gint frames);
+typedef void (*TruePeakFunc) (const gfloat * in, gint frames, gfloat * peak);
+
+struct _GstAudioLoudness
+{
+  gint channels;
+  gint rate;
+  gint bpf;
+  /* frames per step of 100ms */
+  gint step_frames;
+
+  DeinterleaveFunc deinterleave;
+  TruePeakFunc true_peak;
+
+  /* K-weighting filter, the high shelf and the RLB high pass */
+  Biquad shelf;
+  Biquad highpass;
+  /* 4 values of filter state for each channel */
+  gdouble *state;
+  gdouble *weights;
+
+  /* planar samples of each channel, starting with the history that is
+   * needed by the oversampling filter */
+  gfloat *planar;
+  gint stride;
+  gfloat *peaks;
+
+  /* sum of the squares of the K-weighted samples in the current step */
+  gdouble *energy;
+  gint step_pos;
+
+  /* weighted mean square of the last steps */
+  gdouble steps[SHORT_TERM_STEPS];
+  guint64 n_steps;
+
+  guint64 hist_count[HIST_BINS];
+  gdouble hist_energy[HIST_BINS];
+};
+
+/* the polyphase filter for 4x oversampling, indexed by tap and phase so
+ * that all phases of one tap can be calculated at once */
+static gfloat tp_coeffs[TP_TAPS][TP_PHASES];
+
+static void
+init_true_peak_coeffs (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+    const gint n_taps = TP_TAPS * TP_PHASES;
+    gdouble sum[TP_PHASES] = { 0.0, };
+    gint n, k, p;
+
+    /* Blackman windowed sinc with the cutoff at the original Nyquist
+     * frequency */
+    for (n = 0; n < n_taps; n++) {
+      gdouble x = (n - (n_taps - 1) / 2.0) / TP_PHASES;
+      gdouble w = 2.0 * G_PI * n / (n_taps - 1);
+      gdouble h;
+
+      h = sin (G_PI * x) / (G_PI * x);
+      h *= 0.42 - 0.5 * cos (w) + 0.08 * cos (2.0 * w);
+
+      tp_coeffs[n / TP_PHASES][n % TP_PHASES] = h;
+      sum[n % TP_PHASES] += h;
+    }
+    /* unity gain at DC for every phase */
+    for (k = 0; k < TP_TAPS; k++)
+      for (p = 0; p < TP_PHASES; p++)
+        tp_coeffs[k][p] /= sum[p];
+
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
+
+static void
+true_peak_c (const gfloat * in, gint frames, gfloat * peak)
+{
+  gfloat max = *peak;
+  gint n, k, p;
+
+  for (n = 0; n < frames; n++) {
+    const gfloat *s = in + n + TP_HISTORY;
+    gfloat acc[TP_PHASES] = { 0.0, };
+
+    for (k = 0; k < TP_TAPS; k++)
+      for (p = 0; p < TP_PHASES; p++)
+        acc[p] += tp_coeffs[k][p] * s[-k];
+
+    for (p = 0; p < TP_PHASES; p++)
+      max = MAX (max, fabsf (acc[p]));
+  }
+  *peak = max;
+}
+
+#if defined (HAVE_XMMINTRIN_H) && defined(__SSE__)
+/* all 4 phases of a tap fit in one register and the 12 taps stay in
+ * registers for the complete block */
+static void
+true_peak_sse (const gfloat * in, gint frames, gfloat * peak)
+{
+  __m128 c[TP_TAPS];
+  __m128 sign = _mm_set1_ps (-0.0f);
+  __m128 max = _mm_set1_ps (*peak);
+  gfloat res[4];
+  gint n, k;
+
+  for (k = 0; k < TP_TAPS; k++)
+    c[k] = _mm_loadu_ps (tp_coeffs[k]);
+
+  for (n = 0; n < frames; n++) {
+    const gfloat *s = in + n + TP_HISTORY;
+    __m128 acc = _mm_mul_ps (c[0], _mm_set1_ps (s[0]));
+
+    for (k = 1; k < TP_TAPS; k++)
+      acc = _mm_add_ps (acc, _mm_mul_ps (c[k], _mm_set1_ps (s[-k])));
+
+    max = _mm_max_ps (max, _mm_andnot_ps (sign, acc));
+  }
+  _mm_storeu_ps (res, max);
+  *peak = MAX (MAX (res[0], res[1]), MAX (res[2], res[3]));
+}
+#endif
+
+#define MAKE_DEINTERLEAVE_FUNC(type,scale)                              \
+static void                                                             \
+deinterleave_ ##type (GstAudioLoudness * loudness, const guint8 * src,  \
+    gint frames)                                                        \
+{                                                                       \
+  const type *s = (const type *) src;                                   \
+  gint c, i, channels = loudness->channels;                             \
+                                                                        \
+  for (c = 0; c < channels; c++) {                                      \
+    gfloat *d = loudness->planar + c * loudness->stride + TP_HISTORY;   \
+                                                                        \
+    for (i = 0; i < frames; i++)                                        \
+      d[i] = s[i * channels + c] * (scale);                             \
+  }                                                                     \
+}
+
+MAKE_DEINTERLEAVE_FUNC (gint16, 1.0f / 32768.0f);
+MAKE_DEINTERLEAVE_FUNC (gint32, 1.0f / 2147483648.0f);
+MAKE_DEINTERLEAVE_FUNC (gfloat, 1.0f);
+
+/* K-weighting filter coefficients for any sample rate, from the analog
+ * prototypes of the filters in BS.1770 */
+static void
+setup_k_weighting (GstAudioLoudness * loudness)
+{
+  gdouble f0, gain, q, k, vh, vb, a0;
+
+  f0 = 1681.974450955533;
+  gain = 3.999843853973347;
+  q = 0.7071752369554196;
+  k = tan (G_PI * f0 / loudness->rate);
+  vh = pow (10.0, gain / 20.0);
+  vb = pow (vh, 0.4996667741545416);
+  a0 = 1.0 + k / q + k * k;
+
+  loudness->shelf.b0 = (vh + vb * k / q + k * k) / a0;
+  loudness->shelf.b1 = 2.0 * (k * k - vh) / a0;
+  loudness->shelf.b2 = (vh - vb * k / q + k * k) / a0;
+  loudness->shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+  loudness->shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+  f0 = 38.13547087602444;
+  q = 0.5003270373238773;
+  k = tan (G_PI * f0 / loudness->rate);
+  a0 = 1.0 + k / q + k * k;
+
+  loudness->highpass.b0 = 1.0;
+  loudness->highpass.b1 = -2.0;
+  loudness->highpass.b2 = 1.0;
+  loudness->highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+  loudness->highpass.a2 = (1.0 - k / q + k * k) / a0;
+}
+
+/* runs both K-weighting filters in transposed direct form II and returns
+ * the sum of the squares of the result */
+static gdouble
+k_weight (GstAudioLoudness * loudness, gdouble * z, const gfloat * in,
+    gint frames)
+{
+  const Biquad *s = &loudness->shelf;
+  const Biquad *h = &loudness->highpass;
+  gdouble z0 = z[0], z1 = z[1], z2 = z[2], z3 = z[3];
+  gdouble sum = 0.0;
+  gint i;
+
+  for (i = 0; i < frames; i++) {
+    gdouble x = in[i], y;
+
+    y = s->b0 * x + z0;
+    z0 = s->b1 * x - s->a1 * y + z1;
+    z1 = s->b2 * x - s->a2 * y;
+
+    x = y;
+    y = h->b0 * x + z2;
+    z2 = h->b1 * x - h->a1 * y + z3;
+    z3 = h->b2 * x - h->a2 * y;
+
+    sum += y * y;
+  }
+  z[0] = z0;
+  z[1] = z1;
+  z[2] = z2;
+  z[3] = z3;
+
+  return sum;
+}
+
+static gdouble
+energy_to_lufs (gdouble energy)
+{
+  if (energy <= 0.0)
+    return -HUGE_VAL;
+
+  return -0.691 + 10.0 * log10 (energy);
+}
+
+static gdouble
+mean_steps (GstAudioLoudness * loudness, guint n)
+{
+  gdouble sum = 0.0;
+  guint i;
+
+  for (i = 0; i < n; i++)
+    sum += loudness->steps[(loudness->n_steps - 1 - i) % SHORT_TERM_STEPS];
+
+  return sum / n;
+}
+
+static void
+finish_step (GstAudioLoudness * loudness)
+{
+  gdouble z = 0.0, block, lufs;
+  gint c, bin;
+
+  for (c = 0; c < loudness->channels; c++) {
+    z += loudness->weights[c] * loudness->energy[c];
+    loudness->energy[c] = 0.0;
+  }
+  z /= loudness->step_frames;
+
+  loudness->steps[loudness->n_steps % SHORT_TERM_STEPS] = z;
+  loudness->n_steps++;
+  loudness->step_pos = 0;
+
+  if (loudness->n_steps < MOMENTARY_STEPS)
+    return;
+
+  /* gating blocks of 400ms overlap by 75% */
+  block = mean_steps (loudness, MOMENTARY_STEPS);
+  lufs = energy_to_lufs (block);
+  if (lufs < ABSOLUTE_GATE)
+    return;
+
+  bin = (lufs - ABSOLUTE_GATE) / HIST_STEP;
+  bin = CLAMP (bin, 0, HIST_BINS - 1);
+  loudness->hist_count[bin]++;
+  loudness->hist_energy[bin] += block;
+}
+
+static gdouble
+channel_weight (const GstAudioInfo * info, gint channel)
+{
+  if (GST_AUDIO_INFO_IS_UNPOSITIONED (info))
+    return 1.0;
+
+  switch (info->position[channel]) {
+    case GST_AUDIO_CHANNEL_POSITION_LFE1:
+    case GST_AUDIO_CHANNEL_POSITION_LFE2:
+      return 0.0;
+    case GST_AUDIO_CHANNEL_POSITION_REAR_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT:
+    case GST_AUDIO_CHANNEL_POSITION_SIDE_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_SIDE_RIGHT:
+    case GST_AUDIO_CHANNEL_POSITION_SURROUND_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_SURROUND_RIGHT:
+      return 1.41;
+    default:
+      return 1.0;
+  }
+}
+
+/**
+ * gst_audio_loudness_new: (skip):
+ * @info: a #GstAudioInfo
+ *
+ * Create a new loudness meter for samples in the format of @info. Only
+ * interleaved samples in the native endian S16, S32 and F32 formats are
+ * supported.
+ *
+ * Returns: (transfer full) (nullable): a new #GstAudioLoudness or %NULL
+ * when the format is not supported. Free with gst_audio_loudness_free().
+ *
+ * Since: 1.20
+ */
+GstAudioLoudness *
+gst_audio_loudness_new (const GstAudioInfo * info)
+{
+  GstAudioLoudness *loudness;
+  DeinterleaveFunc deinterleave;
+  gint c;
+
+  g_return_val_if_fail (info != NULL, NULL);
+
+  if (GST_AUDIO_INFO_CHANNELS (info) < 1 || GST_AUDIO_INFO_RATE (info) < 10)
+    return NULL;
+  if (GST_AUDIO_INFO_LAYOUT (info) != GST_AUDIO_LAYOUT_INTERLEAVED)
+    return NULL;
+
+  switch (GST_AUDIO_INFO_FORMAT (info)) {
+    case GST_AUDIO_FORMAT_S16:
+      deinterleave = deinterleave_gint16;
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      deinterleave = deinterleave_gint32;
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      deinterleave = deinterleave_gfloat;
+      break;
+    default:
+      GST_DEBUG ("unsupported format %s",
+          GST_AUDIO_INFO_NAME (info) ? GST_AUDIO_INFO_NAME (info) : "none");
+      return NULL;
+  }
+
+  init_true_peak_coeffs ();
+
+  loudness = g_slice_new0 (GstAudioLoudness);
+  loudness->channels = GST_AUDIO_INFO_CHANNELS (info);
+  loudness->rate = GST_AUDIO_INFO_RATE (info);
+  loudness->bpf = GST_AUDIO_INFO_BPF (info);
+  loudness->step_frames = loudness->rate / 10;
+  loudness->deinterleave = deinterleave;
+  loudness->true_peak = true_peak_c;
+#if defined (HAVE_XMMINTRIN_H) && defined(__SSE__)
+  loudness->true_peak = true_peak_sse;
+#endif
+
+  setup_k_weighting (loudness);
+
+  loudness->state = g_new0 (gdouble, 4 * loudness->channels);
+  loudness->weights = g_new (gdouble, loudness->channels);
+  for (c = 0; c < loudness->channels; c++)
+    loudness->weights[c] = channel_weight (info, c);
+
+  /* keep the blocks of each channel 16 byte aligned */
+  loudness->stride = GST_ROUND_UP_4 (TP_HISTORY + BLOCK_FRAMES);
+  loudness->planar = g_new0 (gfloat, loudness->stride * loudness->channels);
+  loudness->peaks = g_new0 (gfloat, loudness->channels);
+  loudness->energy = g_new0 (gdouble, loudness->channels);
+
+  GST_DEBUG ("new loudness meter for %d channels at %d Hz",
+      loudness->channels, loudness->rate);
+
+  return loudness;
+}
+
+/**
+ * gst_audio_loudness_free:
+ * @loudness: a #GstAudioLoudness
+ *
+ * Free a #GstAudioLoudness.
+ *
+ * Since: 1.20
+ */
+void
+gst_audio_loudness_free (GstAudioLoudness * loudness)
+{
+  g_return_if_fail (loudness != NULL);
+
+  g_free (loudness->state);
+  g_free (loudness->weights);
+  g_free (loudness->planar);
+  g_free (loudness->peaks);
+  g_free (loudness->energy);
+  g_slice_free (GstAudioLoudness, loudness);
+}
+
+/**
+ * gst_audio_loudness_reset:
+ * @loudness: a #GstAudioLoudness
+ *
+ * Forget all measurements and the filter history, for example after a
+ * flush.
+ *
+ * Since: 1.20
+ */
+void
+gst_audio_loudness_reset (GstAudioLoudness * loudness)
+{
+  gint channels;
+
+  g_return_if_fail (loudness != NULL);
+
+  channels = loudness->channels;
+
+  memset (loudness->state, 0, sizeof (gdouble) * 4 * channels);
+  memset (loudness->planar, 0, sizeof (gfloat) * loudness->stride * channels);
+  memset (loudness->peaks, 0, sizeof (gfloat) * channels);
+  memset (loudness->energy, 0, sizeof (gdouble) * channels);
+  loudness->step_pos = 0;
+  loudness->n_steps = 0;
+  memset (loudness->hist_count, 0, sizeof (loudness->hist_count));
+  memset (loudness->hist_energy, 0, sizeof (loudness->hist_energy));
+}
+
+/**
+ * gst_audio_loudness_process:
+ * @loudness: a #GstAudioLoudness
+ * @data: (array) (element-type guint8): interleaved samples
+ * @frames: the number of frames in @data
+ *
+ * Measure @frames of samples in @data.
+ *
+ * Since: 1.20
+ */
+void
+gst_audio_loudness_process (GstAudioLoudness * loudness, gconstpointer data,
+    gsize frames)
+{
+  const guint8 *src = data;
+
+  g_return_if_fail (loudness != NULL);
+  g_return_if_fail (frames == 0 || data != NULL);
+
+  while (frames > 0) {
+    gint n, c;
+
+    /* never cross a step so that the energy can be summed per block */
+    n = MIN (frames, BLOCK_FRAMES);
+    n = MIN (n, loudness->step_frames - loudness->step_pos);
+
+    loudness->deinterleave (loudness, src, n);
+
+    for (c = 0; c < loudness->channels; c++) {
+      gfloat *p = loudness->planar + c * loudness->stride;
+
+      loudness->true_peak (p, n, &loudness->peaks[c]);
+      loudness->energy[c] += k_weight (loudness, loudness->state + 4 * c,
+          p + TP_HISTORY, n);
+
+      /* keep the history for the next block */
+      memmove (p, p + n, TP_HISTORY * sizeof (gfloat));
+    }
+
+    loudness->step_pos += n;
+    if (loudness->step_pos == loudness->step_frames)
+      finish_step (loudness);
+
+    src += n * loudness->bpf;
+    frames -= n;
+  }
+}
+
+/**
+ * gst_audio_loudness_get_momentary:
+ * @loudness: a #GstAudioLoudness
+ *
+ * Get the loudness of the last 400ms.
+ *
+ * Returns: the momentary loudness in LUFS or -HUGE_VAL when not enough
+ * samples were processed yet or they were silent.
+ *
+ * Since: 1.20
+ */
+gdouble
+gst_audio_loudness_get_momentary (GstAudioLoudness * loudness)
+{
+  g_return_val_if_fail (loudness != NULL, -HUGE_VAL);
+
+  if (loudness->n_steps < MOMENTARY_STEPS)
+    return -HUGE_VAL;
+
+  return energy_to_lufs (mean_steps (loudness, MOMENTARY_STEPS));
+}
+
+/**
+ * gst_audio_loudness_get_short_term:
+ * @loudness: a #GstAudioLoudness
+ *
+ * Get the loudness of the last 3 seconds.
+ *
+ * Returns: the short-term loudness in LUFS or -HUGE_VAL when not enough
+ * samples were processed yet or they were silent.
+ *
+ * Since: 1.20
+ */
+gdouble
+gst_audio_loudness_get_short_term (GstAudioLoudness * loudness)
+{
+  g_return_val_if_fail (loudness != NULL, -HUGE_VAL);
+
+  if (loudness->n_steps < SHORT_TERM_STEPS)
+    return -HUGE_VAL;
+
+  return energy_to_lufs (mean_steps (loudness, SHORT_TERM_STEPS));
+}
+
+/**
+ * gst_audio_loudness_get_integrated:
+ * @loudness: a #GstAudioLoudness
+ *
+ * Get the gated loudness of everything that was processed since the
+ * creation or the last reset of @loudness. Blocks below -70 LUFS and blocks
+ * more than 10 LU below the loudness of the remaining blocks are ignored.
+ *
+ * Returns: the integrated loudness in LUFS or -HUGE_VAL when no block was
+ * loud enough.
+ *
+ * Since: 1.20
+ */
+gdouble
+gst_audio_loudness_get_integrated (GstAudioLoudness * loudness)
+{
+  gdouble energy = 0.0, gate;
+  guint64 count = 0;
+  gint i, start;
+
+  g_return_val_if_fail (loudness != NULL, -HUGE_VAL);
+
+  for (i = 0; i < HIST_BINS; i++) {
+    energy += loudness->hist_energy[i];
+    count += loudness->hist_count[i];
+  }
+  if (count == 0)
+    return -HUGE_VAL;
+
+  gate = energy_to_lufs (energy / count) + RELATIVE_GATE;
+  start = ceil ((gate - ABSOLUTE_GATE) / HIST_STEP);
+  start = CLAMP (start, 0, HIST_BINS - 1);
+
+  energy = 0.0;
+  count = 0;
+  for (i = start; i < HIST_BINS; i++) {
+    energy += loudness->hist_energy[i];
+    count += loudness->hist_count[i];
+  }
+  if (count == 0)
+    return -HUGE_VAL;
+
+  return energy_to_lufs (energy / count);
+}
+
+/**
+ * gst_audio_loudness_get_true_peak:
+ * @loudness: a #GstAudioLoudness
+ * @channel: the channel or -1 for the maximum of all channels
+ *
+ * Get the highest true-peak that was measured on @channel since the
+ * creation or the last reset of @loudness.
+ *
+ * Returns: the true-peak in dBTP or -HUGE_VAL for silence
+ *
+ * Since: 1.20
+ */
+gdouble
+gst_audio_loudness_get_true_peak (GstAudioLoudness * loudness, gint channel)
+{
+  gfloat peak = 0.0;
+  gint c;
+
+  g_return_val_if_fail (loudness != NULL, -HUGE_VAL);
+  g_return_val_if_fail (channel >= -1 && channel < loudness->channels,
+      -HUGE_VAL);
+
+  if (channel == -1) {
+    for (c = 0; c < loudness->channels; c++)
+      peak = MAX (peak, loudness->peaks[c]);
+  } else {
+    peak = loudness->peaks[channel];
+  }
+
+  if (peak <= 0.0)
+    return -HUGE_VAL;
+
+  return 20.0 * log10 (peak);
+}
+
+/**
+ * gst_audio_loudness_get_structure:
+ * @loudness: a #GstAudioLoudness
+ *
+ * Get all measurements in a "loudness" structure, suitable for posting in
+ * an element message. It contains:
+ *
+ * * "momentary" G_TYPE_DOUBLE: the momentary loudness in LUFS
+ * * "short-term" G_TYPE_DOUBLE: the short-term loudness in LUFS
+ * * "integrated" G_TYPE_DOUBLE: the integrated loudness in LUFS
+ * * "max-true-peak" G_TYPE_DOUBLE: the highest true-peak of all channels in
+ *   dBTP
+ * * "true-peak" GST_TYPE_ARRAY: the true-peak of each channel in dBTP as
+ *   G_TYPE_DOUBLE
+ *
+ * Returns: (transfer full): a new #GstStructure
+ *
+ * Since: 1.20
+ */
+GstStructure *
+gst_audio_loudness_get_structure (GstAudioLoudness * loudness)
+{
+  GstStructure *s;
+  GValue peaks = G_VALUE_INIT;
+  GValue v = G_VALUE_INIT;
+  gint c;
+
+  g_return_val_if_fail (loudness != NULL, NULL);
+
+  s = gst_structure_new ("loudness",
+      "momentary", G_TYPE_DOUBLE, gst_audio_loudness_get_momentary (loudness),
+      "short-term", G_TYPE_DOUBLE,
+      gst_audio_loudness_get_short_term (loudness), "integrated",
+      G_TYPE_DOUBLE, gst_audio_loudness_get_integrated (loudness),
+      "max-true-peak", G_TYPE_DOUBLE,
+      gst_audio_loudness_get_true_peak (loudness, -1), NULL);
+
+  gst_value_array_init (&peaks, loudness->channels);
+  g_value_init (&v, G_TYPE_DOUBLE);
+  for (c = 0; c < loudness->channels; c++) {
+    g_value_set_double (&v, gst_audio_loudness_get_true_peak (loudness, c));
+    gst_value_array_append_value (&peaks, &v);
+  }
+  g_value_unset (&v);
+  gst_structure_take_value (s, "true-peak", &peaks);
+
+  return s;
+}
@@ -0,0 +1,63 @@
+/* GStreamer
+ *
+ * audio-loudness.h: EBU R128 loudness and true-peak measurement
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_AUDIO_LOUDNESS_H__
+#define __GST_AUDIO_LOUDNESS_H__
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstAudioLoudness GstAudioLoudness;
+
+GST_AUDIO_API
+GstAudioLoudness * gst_audio_loudness_new             (const GstAudioInfo * info);
+
+GST_AUDIO_API
+void               gst_audio_loudness_free            (GstAudioLoudness * loudness);
+
+GST_AUDIO_API
+void               gst_audio_loudness_reset           (GstAudioLoudness * loudness);
+
+GST_AUDIO_API
+void               gst_audio_loudness_process         (GstAudioLoudness * loudness,
+                                                       gconstpointer data,
+                                                       gsize frames);
+
+GST_AUDIO_API
+gdouble            gst_audio_loudness_get_momentary   (GstAudioLoudness * loudness);
+
+GST_AUDIO_API
+gdouble            gst_audio_loudness_get_short_term  (GstAudioLoudness * loudness);
+
+GST_AUDIO_API
+gdouble            gst_audio_loudness_get_integrated  (GstAudioLoudness * loudness);
+
+GST_AUDIO_API
+gdouble            gst_audio_loudness_get_true_peak   (GstAudioLoudness * loudness,
+                                                       gint channel);
+
+GST_AUDIO_API
+GstStructure *     gst_audio_loudness_get_structure   (GstAudioLoudness * loudness);
+
+G_END_DECLS
+
+#endif /* __GST_AUDIO_LOUDNESS_H__ */
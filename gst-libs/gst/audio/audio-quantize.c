@@ -39,6 +39,12 @@
 typedef void (*QuantizeFunc) (GstAudioQuantize * quant, const gpointer src,
     gpointer dst, gint count);
 
+/* number of independent random number generators, they are stepped
+ * together so that generating random numbers can be vectorized */
+#define RANDOM_LANES 8
+/* number of random numbers that are generated on the stack at once */
+#define RANDOM_CHUNK 512
+
 struct _GstAudioQuantize
 {
   GstAudioDitherMethod dither;
@@ -52,7 +58,11 @@ struct _GstAudioQuantize
   guint shift;
   guint32 mask, bias;
 
-  /* last random number generated per channel for hifreq TPDF dither */
+  /* random number generator state and the seed it is reset to */
+  guint32 random_seed;
+  guint32 random_state[RANDOM_LANES];
+  /* last random number generated per channel for hifreq TPDF dither,
+   * followed by the same amount of scratch space */
   gpointer last_random;
   /* contains the past quantization errors, error[channels][count] */
   guint error_size;
@@ -67,13 +77,13 @@ struct _GstAudioQuantize
   QuantizeFunc quantize;
 };
 
-#define ADDSS(res,val) \
-        if (val > 0 && res > 0 && G_MAXINT32 - res <= val){             \
-          res = G_MAXINT32;                                             \
-        } else if (val < 0 && res < 0 && G_MININT32 - res >= val){      \
-          res = G_MININT32;                                             \
-        } else                                                          \
-          res += val;
+/* saturating addition, written without branches so that the loops using
+ * it can be vectorized */
+static inline gint32
+add_sat32 (gint32 res, gint32 val)
+{
+  return CLAMP ((gint64) res + val, G_MININT32, G_MAXINT32);
+}
 
 static void
 gst_audio_quantize_quantize_memcpy (GstAudioQuantize * quant,
@@ -92,37 +102,69 @@ gst_audio_quantize_quantize_int_none_none (GstAudioQuantize * quant,
       samples * quant->stride);
 }
 
-/* This is the base function, implementing a linear congruential generator
- * and returning a pseudo random number between 0 and 2^32 - 1.
- */
+/* the finalizer of MurmurHash3, a bijection that mixes all bits of @x */
 static inline guint32
-gst_fast_random_uint32 (void)
+mix32 (guint32 x)
+{
+  x ^= x >> 16;
+  x *= 0x85ebca6b;
+  x ^= x >> 13;
+  x *= 0xc2b2ae35;
+  x ^= x >> 16;
+
+  return x;
+}
+
+/* every lane of every instance starts from a different state so that
+ * instances dithering the same signal don't produce correlated noise, while
+ * resetting an instance repeats its sequence */
+static void
+gst_audio_quantize_seed_random (GstAudioQuantize * quant)
 {
-  static guint32 state = 0xdeadbeef;
-  return (state = state * 1103515245 + 12345);
+  gint l;
+
+  for (l = 0; l < RANDOM_LANES; l++)
+    quant->random_state[l] = mix32 (quant->random_seed * RANDOM_LANES + l);
 }
 
-static inline gint32
-gst_fast_random_int32 (void)
+/* Fills r with len pseudo random numbers between 0 and 2^32 - 1, using
+ * RANDOM_LANES linear congruential generators in parallel. Only the high
+ * bits of the numbers should be used, the low bits of a linear congruential
+ * generator have a short period. */
+static void
+gst_audio_quantize_fill_random (GstAudioQuantize * quant, guint32 * r,
+    gint len)
 {
-  return (gint32) gst_fast_random_uint32 ();
+  guint32 *state = quant->random_state;
+  gint i, l;
+
+  for (i = 0; i + RANDOM_LANES <= len; i += RANDOM_LANES) {
+    for (l = 0; l < RANDOM_LANES; l++) {
+      state[l] = state[l] * 1103515245 + 12345;
+      r[i + l] = state[l];
+    }
+  }
+  for (l = 0; i < len; i++, l++) {
+    state[l] = state[l] * 1103515245 + 12345;
+    r[i] = state[l];
+  }
 }
 
-/* Assuming dither == 2^n,
- * returns one of 2^(n+1) possible random values:
- * -dither <= retval < dither */
-#define RANDOM_INT_DITHER(dither)                                       \
-  (- dither + (gst_fast_random_int32 () & ((dither << 1) - 1)))
+/* Assuming dither == 2^n and r a random number from
+ * gst_audio_quantize_fill_random(), returns one of 2^(n+1) possible
+ * values: -dither <= retval < dither */
+#define RANDOM_INT_DITHER(r,n)                                          \
+  ((gint32) ((r) >> (31 - (n))) - (1 << (n)))
 
 static void
 setup_dither_buf (GstAudioQuantize * quant, gint samples)
 {
   gboolean need_init = FALSE;
   gint stride = quant->stride;
-  gint i, len = samples * stride;
+  gint i, j, n, len = samples * stride;
   guint shift = quant->shift;
-  guint32 bias;
-  gint32 dither, *d;
+  guint32 bias, r[RANDOM_CHUNK];
+  gint32 *d;
 
   if (quant->dither_size < len) {
     quant->dither_size = len;
@@ -142,27 +184,47 @@ setup_dither_buf (GstAudioQuantize * quant, gint samples)
       break;
 
     case GST_AUDIO_DITHER_RPDF:
-      dither = 1 << (shift);
-      for (i = 0; i < len; i++)
-        d[i] = bias + RANDOM_INT_DITHER (dither);
+      for (i = 0; i < len; i += n) {
+        n = MIN (len - i, RANDOM_CHUNK);
+        gst_audio_quantize_fill_random (quant, r, n);
+        for (j = 0; j < n; j++)
+          d[i + j] = bias + RANDOM_INT_DITHER (r[j], shift);
+      }
       break;
 
     case GST_AUDIO_DITHER_TPDF:
-      dither = 1 << (shift - 1);
-      for (i = 0; i < len; i++)
-        d[i] = bias + RANDOM_INT_DITHER (dither) + RANDOM_INT_DITHER (dither);
+      for (i = 0; i < len; i += n) {
+        n = MIN (len - i, RANDOM_CHUNK / 2);
+        gst_audio_quantize_fill_random (quant, r, 2 * n);
+        for (j = 0; j < n; j++)
+          d[i + j] = bias + RANDOM_INT_DITHER (r[j], shift - 1) +
+              RANDOM_INT_DITHER (r[n + j], shift - 1);
+      }
       break;
 
     case GST_AUDIO_DITHER_TPDF_HF:
     {
-      gint32 tmp, *last_random = quant->last_random;
-
-      dither = 1 << (shift - 1);
-      for (i = 0; i < len; i++) {
-        tmp = RANDOM_INT_DITHER (dither);
-        d[i] = bias + tmp - last_random[i % stride];
-        last_random[i % stride] = tmp;
+      gint32 *last_random = quant->last_random;
+      gint32 *next_random = last_random + stride;
+
+      /* first generate the random numbers in place, then subtract the
+       * previous number of the same channel going backwards so that the
+       * previous number is not overwritten yet */
+      for (i = 0; i < len; i += n) {
+        n = MIN (len - i, RANDOM_CHUNK);
+        gst_audio_quantize_fill_random (quant, r, n);
+        for (j = 0; j < n; j++)
+          d[i + j] = RANDOM_INT_DITHER (r[j], shift - 1);
       }
+      if (len == 0)
+        break;
+
+      memcpy (next_random, &d[len - stride], stride * sizeof (gint32));
+      for (i = len - 1; i >= stride; i--)
+        d[i] = bias + d[i] - d[i - stride];
+      for (i = 0; i < stride; i++)
+        d[i] = bias + d[i] - last_random[i];
+      memcpy (last_random, next_random, stride * sizeof (gint32));
       break;
     }
   }
@@ -192,38 +254,46 @@ setup_error_buf (GstAudioQuantize * quant, gint samples, gint extra)
   }
 }
 
+/* The quantization error of each channel only depends on the earlier errors
+ * of the same channel. The error feedback and noise shaping loops go over the
+ * frames and handle all channels of a frame in the inner loop, which has no
+ * dependencies between iterations and can be vectorized. */
 static void
 gst_audio_quantize_quantize_int_dither_feedback (GstAudioQuantize * quant,
     const gpointer src, gpointer dst, gint samples)
 {
   guint32 mask;
-  gint i, len, stride;
+  gint i, c, stride;
   const gint32 *s = src;
-  gint32 *dith, *d = dst, v, o, *e, err;
+  gint32 *dith, *d = dst, v, o, *e, *ne, err;
 
   setup_dither_buf (quant, samples);
   setup_error_buf (quant, samples, 1);
 
   stride = quant->stride;
-  len = samples * stride;
   dith = quant->dither_buf;
   e = quant->error_buf;
   mask = ~quant->mask;
 
-  for (i = 0; i < len; i++) {
-    o = v = s[i];
-    /* add dither */
-    err = dith[i];
-    /* remove error */
-    err -= e[i];
-    ADDSS (v, err);
-    v &= mask;
-    /* store new error */
-    e[i + stride] = e[i] + (v - o);
-    /* store result */
-    d[i] = v;
+  for (i = 0; i < samples; i++) {
+    ne = e + stride;
+    for (c = 0; c < stride; c++) {
+      o = v = s[c];
+      /* add dither and remove error */
+      err = dith[c] - e[c];
+      v = add_sat32 (v, err);
+      v &= mask;
+      /* store new error */
+      ne[c] = e[c] + (v - o);
+      /* store result */
+      d[c] = v;
+    }
+    s += stride;
+    d += stride;
+    dith += stride;
+    e = ne;
   }
-  memmove (e, &e[len], sizeof (gint32) * stride);
+  memmove (quant->error_buf, e, sizeof (gint32) * stride);
 }
 
 #define SHIFT 10
@@ -232,47 +302,72 @@ gst_audio_quantize_quantize_int_dither_feedback (GstAudioQuantize * quant,
 #define SREDUCE 2
 #define SROUND (1<<(SREDUCE-1))
 
-static void
-gst_audio_quantize_quantize_int_dither_noise_shape (GstAudioQuantize * quant,
-    const gpointer src, gpointer dst, gint samples)
+/* nc is a constant in the callers so that the loop over the coefficients
+ * can be unrolled */
+static inline void
+quantize_int_dither_noise_shape (GstAudioQuantize * quant, const gint32 * s,
+    gint32 * d, gint samples, const gint nc)
 {
   guint32 mask;
-  gint i, j, k, len, stride, nc;
-  const gint32 *s = src;
-  gint32 *c, *dith, *d = dst, v, o, *e, err;
-
-  nc = quant->n_coeffs;
-
-  setup_dither_buf (quant, samples);
-  setup_error_buf (quant, samples, nc);
+  gint i, j, c, stride;
+  const gint32 *coeffs;
+  gint32 *dith, v, o, *e, *ne, err;
 
   stride = quant->stride;
-  len = samples * stride;
   dith = quant->dither_buf;
   e = quant->error_buf;
-  c = quant->coeffs;
+  coeffs = quant->coeffs;
   mask = ~quant->mask;
 
-  for (i = 0; i < len; i++) {
-    v = s[i];
-    /* combine and remove error */
-    err = 0;
-    for (j = 0, k = i; j < nc; j++, k += stride)
-      err -= e[k] * c[j];
-    err = (err + SROUND) >> (SREDUCE);
-    ADDSS (v, err);
-    o = v;
-    /* add dither */
-    err = dith[i];
-    ADDSS (v, err);
-    /* quantize */
-    v &= mask;
-    /* store new error with reduced precision */
-    e[k] = (v - o + RROUND) >> REDUCE;
-    /* store result */
-    d[i] = v;
+  for (i = 0; i < samples; i++) {
+    ne = e + nc * stride;
+    for (c = 0; c < stride; c++) {
+      /* combine and remove error */
+      err = 0;
+      for (j = 0; j < nc; j++)
+        err -= e[j * stride + c] * coeffs[j];
+      err = (err + SROUND) >> (SREDUCE);
+      o = v = add_sat32 (s[c], err);
+      /* add dither */
+      v = add_sat32 (v, dith[c]);
+      /* quantize */
+      v &= mask;
+      /* store new error with reduced precision */
+      ne[c] = (v - o + RROUND) >> REDUCE;
+      /* store result */
+      d[c] = v;
+    }
+    s += stride;
+    d += stride;
+    dith += stride;
+    e += stride;
+  }
+  memmove (quant->error_buf, e, sizeof (gint32) * stride * nc);
+}
+
+static void
+gst_audio_quantize_quantize_int_dither_noise_shape (GstAudioQuantize * quant,
+    const gpointer src, gpointer dst, gint samples)
+{
+  gint nc = quant->n_coeffs;
+
+  setup_dither_buf (quant, samples);
+  setup_error_buf (quant, samples, nc);
+
+  switch (nc) {
+    case 2:
+      quantize_int_dither_noise_shape (quant, src, dst, samples, 2);
+      break;
+    case 5:
+      quantize_int_dither_noise_shape (quant, src, dst, samples, 5);
+      break;
+    case 8:
+      quantize_int_dither_noise_shape (quant, src, dst, samples, 8);
+      break;
+    default:
+      quantize_int_dither_noise_shape (quant, src, dst, samples, nc);
+      break;
   }
-  memmove (e, &e[len], sizeof (gint32) * stride * nc);
 }
 
 #define MAKE_QUANTIZE_FUNC_NAME(name)                                   \
@@ -371,7 +466,7 @@ gst_audio_quantize_setup_dither (GstAudioQuantize * quant)
 {
   switch (quant->dither) {
     case GST_AUDIO_DITHER_TPDF_HF:
-      quant->last_random = g_new0 (gint32, quant->stride);
+      quant->last_random = g_new0 (gint32, 2 * quant->stride);
       break;
     case GST_AUDIO_DITHER_RPDF:
     case GST_AUDIO_DITHER_TPDF:
@@ -434,6 +529,7 @@ gst_audio_quantize_new (GstAudioDitherMethod dither,
     GstAudioNoiseShapingMethod ns, GstAudioQuantizeFlags flags,
     GstAudioFormat format, guint channels, guint quantizer)
 {
+  static gint n_instances = 0;
   GstAudioQuantize *quant;
 
   g_return_val_if_fail (format == GST_AUDIO_FORMAT_S32, NULL);
@@ -460,6 +556,8 @@ gst_audio_quantize_new (GstAudioDitherMethod dither,
     quant->bias = 0;
   quant->mask = (1U << quant->shift) - 1;
 
+  quant->random_seed = g_atomic_int_add (&n_instances, 1);
+  gst_audio_quantize_seed_random (quant);
   gst_audio_quantize_setup_dither (quant);
   gst_audio_quantize_setup_noise_shaping (quant);
   gst_audio_quantize_setup_quantize_func (quant);
@@ -499,6 +597,10 @@ gst_audio_quantize_reset (GstAudioQuantize * quant)
   g_free (quant->error_buf);
   quant->error_buf = NULL;
   quant->error_size = 0;
+
+  gst_audio_quantize_seed_random (quant);
+  if (quant->last_random)
+    memset (quant->last_random, 0, quant->stride * sizeof (gint32));
 }
 
 /**
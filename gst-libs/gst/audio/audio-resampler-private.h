@@ -49,6 +49,8 @@ typedef void (*ResampleFunc) (GstAudioResampler * resampler, gpointer in[],
 typedef void (*DeinterleaveFunc) (GstAudioResampler * resampler,
     gpointer * sbuf, gpointer in[], gsize in_frames);
 
+typedef struct _AudioResamplerTask AudioResamplerTask;
+
 struct _GstAudioResampler
 {
   GstAudioResamplerMethod method;
@@ -108,6 +110,12 @@ struct _GstAudioResampler
   gsize samples_len;
   gsize samples_avail;
   gpointer *sbuf;
+
+  /* for resampling groups of channels in parallel */
+  guint max_threads;
+  gboolean taps_cached;
+  AudioResamplerTask *tasks;
+  gint n_tasks;
 };
 
 #endif /* __GST_AUDIO_RESAMPLER_PRIVATE_H__ */
@@ -0,0 +1,778 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && \
+    defined (__AVX2__) && defined (__FMA__)
+
+#include <immintrin.h>
+
+/* ORC does not know about AVX2, check the CPU ourselves */
+gboolean
+audio_resampler_x86_have_avx2 (void)
+{
+#if defined (__GNUC__)
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma");
+#else
+  return FALSE;
+#endif
+}
+
+/* The inner products do whole vectors while they can and a masked load for
+ * the remaining taps so that we never read more samples than the SSE
+ * versions.
+ *
+ * The integer versions accumulate in the same lanes as the SSE2 and SSE4.1
+ * versions once the two 128 bit halves are added together, and then use the
+ * same final reduction, so they produce exactly the same result. The float
+ * versions use FMA and can differ in the last bit. */
+
+static inline __m256i
+tail_mask_epi32 (gint n)
+{
+  return _mm256_cmpgt_epi32 (_mm256_set1_epi32 (n),
+      _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+static inline __m256i
+tail_mask_epi64 (gint n)
+{
+  return _mm256_cmpgt_epi64 (_mm256_set1_epi64x (n),
+      _mm256_setr_epi64x (0, 1, 2, 3));
+}
+
+static inline __m128i
+fold_epi32 (__m256i v)
+{
+  return _mm_add_epi32 (_mm256_castsi256_si128 (v),
+      _mm256_extracti128_si256 (v, 1));
+}
+
+/* even products in lane 0, odd products in lane 1, like SSE4.1 */
+static inline __m128i
+fold_epi64 (__m256i even, __m256i odd)
+{
+  __m128i e, o;
+
+  e = _mm_add_epi64 (_mm256_castsi256_si128 (even),
+      _mm256_extracti128_si256 (even, 1));
+  o = _mm_add_epi64 (_mm256_castsi256_si128 (odd),
+      _mm256_extracti128_si256 (odd, 1));
+
+  return _mm_add_epi64 (_mm_unpacklo_epi64 (e, o), _mm_unpackhi_epi64 (e, o));
+}
+
+static inline gfloat
+hsum_ps (__m256 v)
+{
+  __m128 t;
+
+  t = _mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+  t = _mm_add_ps (t, _mm_movehl_ps (t, t));
+  t = _mm_add_ss (t, _mm_shuffle_ps (t, t, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  return _mm_cvtss_f32 (t);
+}
+
+static inline gdouble
+hsum_pd (__m256d v)
+{
+  __m128d t;
+
+  t = _mm_add_pd (_mm256_castpd256_pd128 (v), _mm256_extractf128_pd (v, 1));
+  t = _mm_add_sd (t, _mm_unpackhi_pd (t, t));
+
+  return _mm_cvtsd_f64 (t);
+}
+
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i s0, s1, m;
+  __m128i sum;
+
+  s0 = s1 = _mm256_setzero_si256 ();
+
+  for (i = 0; i + 32 <= len; i += 32) {
+    s0 = _mm256_add_epi32 (s0,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_loadu_si256 ((__m256i *) (b + i))));
+    s1 = _mm256_add_epi32 (s1,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i + 16)),
+            _mm256_loadu_si256 ((__m256i *) (b + i + 16))));
+  }
+  for (; i < len; i += 16) {
+    m = tail_mask_epi32 ((len - i + 1) / 2);
+    s0 = _mm256_add_epi32 (s0,
+        _mm256_madd_epi16 (_mm256_maskload_epi32 ((const int *) (a + i), m),
+            _mm256_maskload_epi32 ((const int *) (b + i), m)));
+  }
+  sum = fold_epi32 (_mm256_add_epi32 (s0, s1));
+
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (2, 3, 2, 3)));
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  sum = _mm_add_epi32 (sum, _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum = _mm_srai_epi32 (sum, PRECISION_S16);
+  sum = _mm_packs_epi32 (sum, sum);
+  *o = _mm_extract_epi16 (sum, 0);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i s[2], t, m;
+  __m128i sum[2];
+  __m128i f = _mm_set_epi64x (0, *((gint64 *) icoeff));
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  s[0] = s[1] = _mm256_setzero_si256 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (i = 0; i + 16 <= len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    s[0] = _mm256_add_epi32 (s[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    s[1] = _mm256_add_epi32 (s[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+  }
+  if (i < len) {
+    m = tail_mask_epi32 ((len - i + 1) / 2);
+    t = _mm256_maskload_epi32 ((const int *) (a + i), m);
+    s[0] = _mm256_add_epi32 (s[0], _mm256_madd_epi16 (t,
+            _mm256_maskload_epi32 ((const int *) (c[0] + i), m)));
+    s[1] = _mm256_add_epi32 (s[1], _mm256_madd_epi16 (t,
+            _mm256_maskload_epi32 ((const int *) (c[1] + i), m)));
+  }
+  sum[0] = _mm_srai_epi32 (fold_epi32 (s[0]), PRECISION_S16);
+  sum[1] = _mm_srai_epi32 (fold_epi32 (s[1]), PRECISION_S16);
+
+  sum[0] =
+      _mm_madd_epi16 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_madd_epi16 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[0] = _mm_add_epi32 (sum[0], sum[1]);
+
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  sum[0] = _mm_add_epi32 (sum[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_packs_epi32 (sum[0], sum[0]);
+  *o = _mm_extract_epi16 (sum[0], 0);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i s[4], t, m;
+  __m128i sum[4], u[4];
+  __m128i f = _mm_set_epi64x (0, *((long long *) icoeff));
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  s[0] = s[1] = s[2] = s[3] = _mm256_setzero_si256 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (i = 0; i + 16 <= len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    s[0] = _mm256_add_epi32 (s[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    s[1] = _mm256_add_epi32 (s[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+    s[2] = _mm256_add_epi32 (s[2], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[2] + i))));
+    s[3] = _mm256_add_epi32 (s[3], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[3] + i))));
+  }
+  if (i < len) {
+    m = tail_mask_epi32 ((len - i + 1) / 2);
+    t = _mm256_maskload_epi32 ((const int *) (a + i), m);
+    s[0] = _mm256_add_epi32 (s[0], _mm256_madd_epi16 (t,
+            _mm256_maskload_epi32 ((const int *) (c[0] + i), m)));
+    s[1] = _mm256_add_epi32 (s[1], _mm256_madd_epi16 (t,
+            _mm256_maskload_epi32 ((const int *) (c[1] + i), m)));
+    s[2] = _mm256_add_epi32 (s[2], _mm256_madd_epi16 (t,
+            _mm256_maskload_epi32 ((const int *) (c[2] + i), m)));
+    s[3] = _mm256_add_epi32 (s[3], _mm256_madd_epi16 (t,
+            _mm256_maskload_epi32 ((const int *) (c[3] + i), m)));
+  }
+  sum[0] = fold_epi32 (s[0]);
+  sum[1] = fold_epi32 (s[1]);
+  sum[2] = fold_epi32 (s[2]);
+  sum[3] = fold_epi32 (s[3]);
+
+  u[0] = _mm_unpacklo_epi32 (sum[0], sum[1]);
+  u[1] = _mm_unpacklo_epi32 (sum[2], sum[3]);
+  u[2] = _mm_unpackhi_epi32 (sum[0], sum[1]);
+  u[3] = _mm_unpackhi_epi32 (sum[2], sum[3]);
+
+  sum[0] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (u[0], u[1]), _mm_unpackhi_epi64 (u[0],
+          u[1]));
+  sum[2] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (u[2], u[3]), _mm_unpackhi_epi64 (u[2],
+          u[3]));
+  sum[0] = _mm_add_epi32 (sum[0], sum[2]);
+
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_madd_epi16 (sum[0], f);
+
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  sum[0] = _mm_add_epi32 (sum[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_packs_epi32 (sum[0], sum[0]);
+  *o = _mm_extract_epi16 (sum[0], 0);
+}
+
+/* multiply the even and the odd 32 bit elements into 64 bit sums */
+#define MUL_ACC_EPI32(even,odd,ta,tb)                                   \
+G_STMT_START {                                                          \
+  even = _mm256_add_epi64 (even, _mm256_mul_epi32 (ta, tb));            \
+  odd = _mm256_add_epi64 (odd, _mm256_mul_epi32 (                       \
+          _mm256_srli_epi64 (ta, 32), _mm256_srli_epi64 (tb, 32)));     \
+} G_STMT_END
+
+static inline void
+inner_product_gint32_full_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i even, odd, ta, tb, m;
+  __m128i sum;
+  gint64 res;
+
+  even = odd = _mm256_setzero_si256 ();
+
+  for (i = 0; i + 8 <= len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (b + i));
+    MUL_ACC_EPI32 (even, odd, ta, tb);
+  }
+  if (i < len) {
+    m = tail_mask_epi32 (len - i);
+    ta = _mm256_maskload_epi32 ((const int *) (a + i), m);
+    tb = _mm256_maskload_epi32 ((const int *) (b + i), m);
+    MUL_ACC_EPI32 (even, odd, ta, tb);
+  }
+  sum = fold_epi64 (even, odd);
+  sum = _mm_add_epi64 (sum, _mm_unpackhi_epi64 (sum, sum));
+  res = _mm_cvtsi128_si64 (sum);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_linear_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i even[2], odd[2], ta, tb, m;
+  __m128i sum[2];
+  __m128i f = _mm_loadu_si128 ((__m128i *) icoeff);
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  even[0] = even[1] = odd[0] = odd[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i + 8 <= len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    MUL_ACC_EPI32 (even[0], odd[0], ta, tb);
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+    MUL_ACC_EPI32 (even[1], odd[1], ta, tb);
+  }
+  if (i < len) {
+    m = tail_mask_epi32 (len - i);
+    ta = _mm256_maskload_epi32 ((const int *) (a + i), m);
+    tb = _mm256_maskload_epi32 ((const int *) (c[0] + i), m);
+    MUL_ACC_EPI32 (even[0], odd[0], ta, tb);
+    tb = _mm256_maskload_epi32 ((const int *) (c[1] + i), m);
+    MUL_ACC_EPI32 (even[1], odd[1], ta, tb);
+  }
+  sum[0] = _mm_srli_epi64 (fold_epi64 (even[0], odd[0]), PRECISION_S32);
+  sum[1] = _mm_srli_epi64 (fold_epi64 (even[1], odd[1]), PRECISION_S32);
+  sum[0] =
+      _mm_mul_epi32 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_mul_epi32 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[0] = _mm_add_epi64 (sum[0], sum[1]);
+  sum[0] = _mm_add_epi64 (sum[0], _mm_unpackhi_epi64 (sum[0], sum[0]));
+  res = _mm_cvtsi128_si64 (sum[0]);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i even[4], odd[4], ta, tb, m;
+  __m128i sum[4];
+  __m128i f = _mm_loadu_si128 ((__m128i *) icoeff);
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  even[0] = odd[0] = _mm256_setzero_si256 ();
+  even[1] = odd[1] = _mm256_setzero_si256 ();
+  even[2] = odd[2] = _mm256_setzero_si256 ();
+  even[3] = odd[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i + 8 <= len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    MUL_ACC_EPI32 (even[0], odd[0], ta, tb);
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+    MUL_ACC_EPI32 (even[1], odd[1], ta, tb);
+    tb = _mm256_loadu_si256 ((__m256i *) (c[2] + i));
+    MUL_ACC_EPI32 (even[2], odd[2], ta, tb);
+    tb = _mm256_loadu_si256 ((__m256i *) (c[3] + i));
+    MUL_ACC_EPI32 (even[3], odd[3], ta, tb);
+  }
+  if (i < len) {
+    m = tail_mask_epi32 (len - i);
+    ta = _mm256_maskload_epi32 ((const int *) (a + i), m);
+    tb = _mm256_maskload_epi32 ((const int *) (c[0] + i), m);
+    MUL_ACC_EPI32 (even[0], odd[0], ta, tb);
+    tb = _mm256_maskload_epi32 ((const int *) (c[1] + i), m);
+    MUL_ACC_EPI32 (even[1], odd[1], ta, tb);
+    tb = _mm256_maskload_epi32 ((const int *) (c[2] + i), m);
+    MUL_ACC_EPI32 (even[2], odd[2], ta, tb);
+    tb = _mm256_maskload_epi32 ((const int *) (c[3] + i), m);
+    MUL_ACC_EPI32 (even[3], odd[3], ta, tb);
+  }
+  sum[0] = _mm_srli_epi64 (fold_epi64 (even[0], odd[0]), PRECISION_S32);
+  sum[1] = _mm_srli_epi64 (fold_epi64 (even[1], odd[1]), PRECISION_S32);
+  sum[2] = _mm_srli_epi64 (fold_epi64 (even[2], odd[2]), PRECISION_S32);
+  sum[3] = _mm_srli_epi64 (fold_epi64 (even[3], odd[3]), PRECISION_S32);
+  sum[0] =
+      _mm_mul_epi32 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_mul_epi32 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[2] =
+      _mm_mul_epi32 (sum[2], _mm_shuffle_epi32 (f, _MM_SHUFFLE (2, 2, 2, 2)));
+  sum[3] =
+      _mm_mul_epi32 (sum[3], _mm_shuffle_epi32 (f, _MM_SHUFFLE (3, 3, 3, 3)));
+  sum[0] = _mm_add_epi64 (sum[0], sum[1]);
+  sum[2] = _mm_add_epi64 (sum[2], sum[3]);
+  sum[0] = _mm_add_epi64 (sum[0], sum[2]);
+  sum[0] = _mm_add_epi64 (sum[0], _mm_unpackhi_epi64 (sum[0], sum[0]));
+  res = _mm_cvtsi128_si64 (sum[0]);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 s0, s1;
+  __m256i m;
+
+  s0 = s1 = _mm256_setzero_ps ();
+
+  for (i = 0; i + 16 <= len; i += 16) {
+    s0 = _mm256_fmadd_ps (_mm256_loadu_ps (a + i), _mm256_loadu_ps (b + i),
+        s0);
+    s1 = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 8),
+        _mm256_loadu_ps (b + i + 8), s1);
+  }
+  for (; i < len; i += 8) {
+    m = tail_mask_epi32 (len - i);
+    s0 = _mm256_fmadd_ps (_mm256_maskload_ps (a + i, m),
+        _mm256_maskload_ps (b + i, m), s0);
+  }
+  *o = hsum_ps (_mm256_add_ps (s0, s1));
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[2], t;
+  __m256i m;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (i = 0; i + 8 <= len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+  }
+  if (i < len) {
+    m = tail_mask_epi32 (len - i);
+    t = _mm256_maskload_ps (a + i, m);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_maskload_ps (c[0] + i, m), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_maskload_ps (c[1] + i, m), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_broadcast_ss (icoeff), sum[1]);
+  *o = hsum_ps (sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[4], t;
+  __m256i m;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (i = 0; i + 8 <= len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[3] + i), sum[3]);
+  }
+  if (i < len) {
+    m = tail_mask_epi32 (len - i);
+    t = _mm256_maskload_ps (a + i, m);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_maskload_ps (c[0] + i, m), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_maskload_ps (c[1] + i, m), sum[1]);
+    sum[2] = _mm256_fmadd_ps (t, _mm256_maskload_ps (c[2] + i, m), sum[2]);
+    sum[3] = _mm256_fmadd_ps (t, _mm256_maskload_ps (c[3] + i, m), sum[3]);
+  }
+  t = _mm256_mul_ps (sum[0], _mm256_broadcast_ss (icoeff + 0));
+  t = _mm256_fmadd_ps (sum[1], _mm256_broadcast_ss (icoeff + 1), t);
+  t = _mm256_fmadd_ps (sum[2], _mm256_broadcast_ss (icoeff + 2), t);
+  t = _mm256_fmadd_ps (sum[3], _mm256_broadcast_ss (icoeff + 3), t);
+  *o = hsum_ps (t);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d s0, s1;
+  __m256i m;
+
+  s0 = s1 = _mm256_setzero_pd ();
+
+  for (i = 0; i + 8 <= len; i += 8) {
+    s0 = _mm256_fmadd_pd (_mm256_loadu_pd (a + i), _mm256_loadu_pd (b + i),
+        s0);
+    s1 = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 4),
+        _mm256_loadu_pd (b + i + 4), s1);
+  }
+  for (; i < len; i += 4) {
+    m = tail_mask_epi64 (len - i);
+    s0 = _mm256_fmadd_pd (_mm256_maskload_pd (a + i, m),
+        _mm256_maskload_pd (b + i, m), s0);
+  }
+  *o = hsum_pd (_mm256_add_pd (s0, s1));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[2], t;
+  __m256i m;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i + 4 <= len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+  }
+  if (i < len) {
+    m = tail_mask_epi64 (len - i);
+    t = _mm256_maskload_pd (a + i, m);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_maskload_pd (c[0] + i, m), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_maskload_pd (c[1] + i, m), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_pd (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_broadcast_sd (icoeff), sum[1]);
+  *o = hsum_pd (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[4], t;
+  __m256i m;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (i = 0; i + 4 <= len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[3] + i), sum[3]);
+  }
+  if (i < len) {
+    m = tail_mask_epi64 (len - i);
+    t = _mm256_maskload_pd (a + i, m);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_maskload_pd (c[0] + i, m), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_maskload_pd (c[1] + i, m), sum[1]);
+    sum[2] = _mm256_fmadd_pd (t, _mm256_maskload_pd (c[2] + i, m), sum[2]);
+    sum[3] = _mm256_fmadd_pd (t, _mm256_maskload_pd (c[3] + i, m), sum[3]);
+  }
+  t = _mm256_mul_pd (sum[0], _mm256_broadcast_sd (icoeff + 0));
+  t = _mm256_fmadd_pd (sum[1], _mm256_broadcast_sd (icoeff + 1), t);
+  t = _mm256_fmadd_pd (sum[2], _mm256_broadcast_sd (icoeff + 2), t);
+  t = _mm256_fmadd_pd (sum[3], _mm256_broadcast_sd (icoeff + 3), t);
+  *o = hsum_pd (t);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+/* The interpolation functions are only used with the filter tables, which
+ * have a multiple of 8 taps and are padded, like in the SSE versions. */
+void
+interpolate_gint16_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, t1, t2;
+  __m256i f = _mm256_set1_epi32 (*((gint32 *) ic));
+  __m256i round = _mm256_set1_epi32 (1 << (PRECISION_S16 - 1));
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (i = 0; i < len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+
+    t1 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f);
+    t2 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f);
+
+    t1 = _mm256_srai_epi32 (_mm256_add_epi32 (t1, round), PRECISION_S16);
+    t2 = _mm256_srai_epi32 (_mm256_add_epi32 (t2, round), PRECISION_S16);
+
+    /* the unpack and pack both work per 128 bit lane so the order is kept */
+    _mm256_storeu_si256 ((__m256i *) (o + i), _mm256_packs_epi32 (t1, t2));
+  }
+}
+
+void
+interpolate_gint16_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m256i ta, tb, tl1, tl2, th1, th2;
+  __m256i f[2];
+  __m256i round = _mm256_set1_epi32 (1 << (PRECISION_S16 - 1));
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride),
+    (gint16 *) ((gint8 *) a + 2 * astride),
+    (gint16 *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_set1_epi32 (*((gint32 *) (ic + 0)));
+  f[1] = _mm256_set1_epi32 (*((gint32 *) (ic + 2)));
+
+  for (i = 0; i < len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (c[0] + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[1] + i));
+
+    tl1 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f[0]);
+    th1 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f[0]);
+
+    ta = _mm256_loadu_si256 ((__m256i *) (c[2] + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (c[3] + i));
+
+    tl2 = _mm256_madd_epi16 (_mm256_unpacklo_epi16 (ta, tb), f[1]);
+    th2 = _mm256_madd_epi16 (_mm256_unpackhi_epi16 (ta, tb), f[1]);
+
+    tl1 = _mm256_add_epi32 (_mm256_add_epi32 (tl1, tl2), round);
+    th1 = _mm256_add_epi32 (_mm256_add_epi32 (th1, th2), round);
+
+    tl1 = _mm256_srai_epi32 (tl1, PRECISION_S16);
+    th1 = _mm256_srai_epi32 (th1, PRECISION_S16);
+
+    _mm256_storeu_si256 ((__m256i *) (o + i), _mm256_packs_epi32 (tl1, th1));
+  }
+}
+
+void
+interpolate_gfloat_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[2];
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+
+  for (i = 0; i < len; i += 8) {
+    _mm256_storeu_ps (o + i, _mm256_fmadd_ps (_mm256_loadu_ps (c[1] + i), f[1],
+            _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+  f[2] = _mm256_broadcast_ss (ic + 2);
+  f[3] = _mm256_broadcast_ss (ic + 3);
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0]);
+    t = _mm256_fmadd_ps (_mm256_loadu_ps (c[1] + i), f[1], t);
+    t = _mm256_fmadd_ps (_mm256_loadu_ps (c[2] + i), f[2], t);
+    t = _mm256_fmadd_ps (_mm256_loadu_ps (c[3] + i), f[3], t);
+    _mm256_storeu_ps (o + i, t);
+  }
+}
+
+void
+interpolate_gdouble_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[2];
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+
+  for (i = 0; i < len; i += 4) {
+    _mm256_storeu_pd (o + i, _mm256_fmadd_pd (_mm256_loadu_pd (c[1] + i), f[1],
+            _mm256_mul_pd (_mm256_loadu_pd (c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+  f[2] = _mm256_broadcast_sd (ic + 2);
+  f[3] = _mm256_broadcast_sd (ic + 3);
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_mul_pd (_mm256_loadu_pd (c[0] + i), f[0]);
+    t = _mm256_fmadd_pd (_mm256_loadu_pd (c[1] + i), f[1], t);
+    t = _mm256_fmadd_pd (_mm256_loadu_pd (c[2] + i), f[2], t);
+    t = _mm256_fmadd_pd (_mm256_loadu_pd (c[3] + i), f[3], t);
+    _mm256_storeu_pd (o + i, t);
+  }
+}
+
+#endif
@@ -0,0 +1,696 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx512.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && \
+    defined (__AVX512F__) && defined (__AVX512BW__) && defined (__FMA__)
+
+#include <immintrin.h>
+
+/* ORC does not know about AVX-512, check the CPU ourselves */
+gboolean
+audio_resampler_x86_have_avx512 (void)
+{
+#if defined (__GNUC__)
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("avx512f") &&
+      __builtin_cpu_supports ("avx512bw") && __builtin_cpu_supports ("fma");
+#else
+  return FALSE;
+#endif
+}
+
+/* Same structure as the AVX2 versions: whole vectors, then one masked
+ * load for the remaining taps. The integer sums are folded down to the
+ * SSE2/SSE4.1 lanes and reduced the same way so that the result is exact. */
+
+#define TAIL_MASK(n) (((n) >= 32) ? 0xffffffffu : ((1u << (n)) - 1))
+
+static inline __m128i
+fold_epi32 (__m512i v)
+{
+  __m256i t;
+
+  t = _mm256_add_epi32 (_mm512_castsi512_si256 (v),
+      _mm512_extracti64x4_epi64 (v, 1));
+
+  return _mm_add_epi32 (_mm256_castsi256_si128 (t),
+      _mm256_extracti128_si256 (t, 1));
+}
+
+static inline __m128i
+fold_epi64 (__m512i even, __m512i odd)
+{
+  __m256i te, to;
+  __m128i e, o;
+
+  te = _mm256_add_epi64 (_mm512_castsi512_si256 (even),
+      _mm512_extracti64x4_epi64 (even, 1));
+  to = _mm256_add_epi64 (_mm512_castsi512_si256 (odd),
+      _mm512_extracti64x4_epi64 (odd, 1));
+  e = _mm_add_epi64 (_mm256_castsi256_si128 (te),
+      _mm256_extracti128_si256 (te, 1));
+  o = _mm_add_epi64 (_mm256_castsi256_si128 (to),
+      _mm256_extracti128_si256 (to, 1));
+
+  return _mm_add_epi64 (_mm_unpacklo_epi64 (e, o), _mm_unpackhi_epi64 (e, o));
+}
+
+static inline void
+inner_product_gint16_full_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m512i s;
+  __mmask32 m;
+  __m128i sum;
+
+  s = _mm512_setzero_si512 ();
+
+  for (i = 0; i + 32 <= len; i += 32) {
+    s = _mm512_add_epi32 (s,
+        _mm512_madd_epi16 (_mm512_loadu_si512 (a + i),
+            _mm512_loadu_si512 (b + i)));
+  }
+  if (i < len) {
+    m = TAIL_MASK (len - i);
+    s = _mm512_add_epi32 (s,
+        _mm512_madd_epi16 (_mm512_maskz_loadu_epi16 (m, a + i),
+            _mm512_maskz_loadu_epi16 (m, b + i)));
+  }
+  sum = fold_epi32 (s);
+
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (2, 3, 2, 3)));
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  sum = _mm_add_epi32 (sum, _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum = _mm_srai_epi32 (sum, PRECISION_S16);
+  sum = _mm_packs_epi32 (sum, sum);
+  *o = _mm_extract_epi16 (sum, 0);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m512i s[2], t;
+  __mmask32 m;
+  __m128i sum[2];
+  __m128i f = _mm_set_epi64x (0, *((gint64 *) icoeff));
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  s[0] = s[1] = _mm512_setzero_si512 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (i = 0; i < len; i += 32) {
+    m = TAIL_MASK (len - i);
+    t = _mm512_maskz_loadu_epi16 (m, a + i);
+    s[0] = _mm512_add_epi32 (s[0], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[0] + i)));
+    s[1] = _mm512_add_epi32 (s[1], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[1] + i)));
+  }
+  sum[0] = _mm_srai_epi32 (fold_epi32 (s[0]), PRECISION_S16);
+  sum[1] = _mm_srai_epi32 (fold_epi32 (s[1]), PRECISION_S16);
+
+  sum[0] =
+      _mm_madd_epi16 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_madd_epi16 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[0] = _mm_add_epi32 (sum[0], sum[1]);
+
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  sum[0] = _mm_add_epi32 (sum[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_packs_epi32 (sum[0], sum[0]);
+  *o = _mm_extract_epi16 (sum[0], 0);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m512i s[4], t;
+  __mmask32 m;
+  __m128i sum[4], u[4];
+  __m128i f = _mm_set_epi64x (0, *((long long *) icoeff));
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  s[0] = s[1] = s[2] = s[3] = _mm512_setzero_si512 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (i = 0; i < len; i += 32) {
+    m = TAIL_MASK (len - i);
+    t = _mm512_maskz_loadu_epi16 (m, a + i);
+    s[0] = _mm512_add_epi32 (s[0], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[0] + i)));
+    s[1] = _mm512_add_epi32 (s[1], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[1] + i)));
+    s[2] = _mm512_add_epi32 (s[2], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[2] + i)));
+    s[3] = _mm512_add_epi32 (s[3], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[3] + i)));
+  }
+  sum[0] = fold_epi32 (s[0]);
+  sum[1] = fold_epi32 (s[1]);
+  sum[2] = fold_epi32 (s[2]);
+  sum[3] = fold_epi32 (s[3]);
+
+  u[0] = _mm_unpacklo_epi32 (sum[0], sum[1]);
+  u[1] = _mm_unpacklo_epi32 (sum[2], sum[3]);
+  u[2] = _mm_unpackhi_epi32 (sum[0], sum[1]);
+  u[3] = _mm_unpackhi_epi32 (sum[2], sum[3]);
+
+  sum[0] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (u[0], u[1]), _mm_unpackhi_epi64 (u[0],
+          u[1]));
+  sum[2] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (u[2], u[3]), _mm_unpackhi_epi64 (u[2],
+          u[3]));
+  sum[0] = _mm_add_epi32 (sum[0], sum[2]);
+
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_madd_epi16 (sum[0], f);
+
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  sum[0] = _mm_add_epi32 (sum[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_packs_epi32 (sum[0], sum[0]);
+  *o = _mm_extract_epi16 (sum[0], 0);
+}
+
+#define MUL_ACC_EPI32(even,odd,ta,tb)                                   \
+G_STMT_START {                                                          \
+  even = _mm512_add_epi64 (even, _mm512_mul_epi32 (ta, tb));            \
+  odd = _mm512_add_epi64 (odd, _mm512_mul_epi32 (                       \
+          _mm512_srli_epi64 (ta, 32), _mm512_srli_epi64 (tb, 32)));     \
+} G_STMT_END
+
+static inline void
+inner_product_gint32_full_1_avx512 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  __m512i even, odd, ta, tb;
+  __mmask16 m;
+  __m128i sum;
+  gint64 res;
+
+  even = odd = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 16) {
+    m = TAIL_MASK (len - i);
+    ta = _mm512_maskz_loadu_epi32 (m, a + i);
+    tb = _mm512_maskz_loadu_epi32 (m, b + i);
+    MUL_ACC_EPI32 (even, odd, ta, tb);
+  }
+  sum = fold_epi64 (even, odd);
+  sum = _mm_add_epi64 (sum, _mm_unpackhi_epi64 (sum, sum));
+  res = _mm_cvtsi128_si64 (sum);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_linear_1_avx512 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m512i even[2], odd[2], ta, tb;
+  __mmask16 m;
+  __m128i sum[2];
+  __m128i f = _mm_loadu_si128 ((__m128i *) icoeff);
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  even[0] = even[1] = odd[0] = odd[1] = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 16) {
+    m = TAIL_MASK (len - i);
+    ta = _mm512_maskz_loadu_epi32 (m, a + i);
+    tb = _mm512_maskz_loadu_epi32 (m, c[0] + i);
+    MUL_ACC_EPI32 (even[0], odd[0], ta, tb);
+    tb = _mm512_maskz_loadu_epi32 (m, c[1] + i);
+    MUL_ACC_EPI32 (even[1], odd[1], ta, tb);
+  }
+  sum[0] = _mm_srli_epi64 (fold_epi64 (even[0], odd[0]), PRECISION_S32);
+  sum[1] = _mm_srli_epi64 (fold_epi64 (even[1], odd[1]), PRECISION_S32);
+  sum[0] =
+      _mm_mul_epi32 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_mul_epi32 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[0] = _mm_add_epi64 (sum[0], sum[1]);
+  sum[0] = _mm_add_epi64 (sum[0], _mm_unpackhi_epi64 (sum[0], sum[0]));
+  res = _mm_cvtsi128_si64 (sum[0]);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx512 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m512i even[4], odd[4], ta, tb;
+  __mmask16 m;
+  __m128i sum[4];
+  __m128i f = _mm_loadu_si128 ((__m128i *) icoeff);
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  even[0] = odd[0] = _mm512_setzero_si512 ();
+  even[1] = odd[1] = _mm512_setzero_si512 ();
+  even[2] = odd[2] = _mm512_setzero_si512 ();
+  even[3] = odd[3] = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 16) {
+    m = TAIL_MASK (len - i);
+    ta = _mm512_maskz_loadu_epi32 (m, a + i);
+    tb = _mm512_maskz_loadu_epi32 (m, c[0] + i);
+    MUL_ACC_EPI32 (even[0], odd[0], ta, tb);
+    tb = _mm512_maskz_loadu_epi32 (m, c[1] + i);
+    MUL_ACC_EPI32 (even[1], odd[1], ta, tb);
+    tb = _mm512_maskz_loadu_epi32 (m, c[2] + i);
+    MUL_ACC_EPI32 (even[2], odd[2], ta, tb);
+    tb = _mm512_maskz_loadu_epi32 (m, c[3] + i);
+    MUL_ACC_EPI32 (even[3], odd[3], ta, tb);
+  }
+  sum[0] = _mm_srli_epi64 (fold_epi64 (even[0], odd[0]), PRECISION_S32);
+  sum[1] = _mm_srli_epi64 (fold_epi64 (even[1], odd[1]), PRECISION_S32);
+  sum[2] = _mm_srli_epi64 (fold_epi64 (even[2], odd[2]), PRECISION_S32);
+  sum[3] = _mm_srli_epi64 (fold_epi64 (even[3], odd[3]), PRECISION_S32);
+  sum[0] =
+      _mm_mul_epi32 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_mul_epi32 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[2] =
+      _mm_mul_epi32 (sum[2], _mm_shuffle_epi32 (f, _MM_SHUFFLE (2, 2, 2, 2)));
+  sum[3] =
+      _mm_mul_epi32 (sum[3], _mm_shuffle_epi32 (f, _MM_SHUFFLE (3, 3, 3, 3)));
+  sum[0] = _mm_add_epi64 (sum[0], sum[1]);
+  sum[2] = _mm_add_epi64 (sum[2], sum[3]);
+  sum[0] = _mm_add_epi64 (sum[0], sum[2]);
+  sum[0] = _mm_add_epi64 (sum[0], _mm_unpackhi_epi64 (sum[0], sum[0]));
+  res = _mm_cvtsi128_si64 (sum[0]);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m512 s0, s1;
+  __mmask16 m;
+
+  s0 = s1 = _mm512_setzero_ps ();
+
+  for (i = 0; i + 32 <= len; i += 32) {
+    s0 = _mm512_fmadd_ps (_mm512_loadu_ps (a + i), _mm512_loadu_ps (b + i),
+        s0);
+    s1 = _mm512_fmadd_ps (_mm512_loadu_ps (a + i + 16),
+        _mm512_loadu_ps (b + i + 16), s1);
+  }
+  for (; i < len; i += 16) {
+    m = TAIL_MASK (len - i);
+    s0 = _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, a + i),
+        _mm512_maskz_loadu_ps (m, b + i), s0);
+  }
+  *o = _mm512_reduce_add_ps (_mm512_add_ps (s0, s1));
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m512 sum[2], t;
+  __mmask16 m;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    m = TAIL_MASK (len - i);
+    t = _mm512_maskz_loadu_ps (m, a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_ps (_mm512_sub_ps (sum[0], sum[1]),
+      _mm512_set1_ps (icoeff[0]), sum[1]);
+  *o = _mm512_reduce_add_ps (sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m512 sum[4], t;
+  __mmask16 m;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    m = TAIL_MASK (len - i);
+    t = _mm512_maskz_loadu_ps (m, a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[0] + i),
+        sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[1] + i),
+        sum[1]);
+    sum[2] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[2] + i),
+        sum[2]);
+    sum[3] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[3] + i),
+        sum[3]);
+  }
+  t = _mm512_mul_ps (sum[0], _mm512_set1_ps (icoeff[0]));
+  t = _mm512_fmadd_ps (sum[1], _mm512_set1_ps (icoeff[1]), t);
+  t = _mm512_fmadd_ps (sum[2], _mm512_set1_ps (icoeff[2]), t);
+  t = _mm512_fmadd_ps (sum[3], _mm512_set1_ps (icoeff[3]), t);
+  *o = _mm512_reduce_add_ps (t);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m512d s0, s1;
+  __mmask8 m;
+
+  s0 = s1 = _mm512_setzero_pd ();
+
+  for (i = 0; i + 16 <= len; i += 16) {
+    s0 = _mm512_fmadd_pd (_mm512_loadu_pd (a + i), _mm512_loadu_pd (b + i),
+        s0);
+    s1 = _mm512_fmadd_pd (_mm512_loadu_pd (a + i + 8),
+        _mm512_loadu_pd (b + i + 8), s1);
+  }
+  for (; i < len; i += 8) {
+    m = TAIL_MASK (len - i);
+    s0 = _mm512_fmadd_pd (_mm512_maskz_loadu_pd (m, a + i),
+        _mm512_maskz_loadu_pd (m, b + i), s0);
+  }
+  *o = _mm512_reduce_add_pd (_mm512_add_pd (s0, s1));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m512d sum[2], t;
+  __mmask8 m;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    m = TAIL_MASK (len - i);
+    t = _mm512_maskz_loadu_pd (m, a + i);
+    sum[0] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_pd (_mm512_sub_pd (sum[0], sum[1]),
+      _mm512_set1_pd (icoeff[0]), sum[1]);
+  *o = _mm512_reduce_add_pd (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m512d sum[4], t;
+  __mmask8 m;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    m = TAIL_MASK (len - i);
+    t = _mm512_maskz_loadu_pd (m, a + i);
+    sum[0] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[0] + i),
+        sum[0]);
+    sum[1] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[1] + i),
+        sum[1]);
+    sum[2] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[2] + i),
+        sum[2]);
+    sum[3] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[3] + i),
+        sum[3]);
+  }
+  t = _mm512_mul_pd (sum[0], _mm512_set1_pd (icoeff[0]));
+  t = _mm512_fmadd_pd (sum[1], _mm512_set1_pd (icoeff[1]), t);
+  t = _mm512_fmadd_pd (sum[2], _mm512_set1_pd (icoeff[2]), t);
+  t = _mm512_fmadd_pd (sum[3], _mm512_set1_pd (icoeff[3]), t);
+  *o = _mm512_reduce_add_pd (t);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx512);
+
+/* The filter tables have a multiple of 8 taps and 16 taps of padding, so
+ * the float and double versions can always do whole vectors. */
+void
+interpolate_gint16_linear_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m512i ta, tb, t1, t2;
+  __m512i f = _mm512_set1_epi32 (*((gint32 *) ic));
+  __m512i round = _mm512_set1_epi32 (1 << (PRECISION_S16 - 1));
+  __mmask32 m;
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride)
+  };
+
+  for (i = 0; i < len; i += 32) {
+    m = TAIL_MASK (len - i);
+    ta = _mm512_maskz_loadu_epi16 (m, c[0] + i);
+    tb = _mm512_maskz_loadu_epi16 (m, c[1] + i);
+
+    t1 = _mm512_madd_epi16 (_mm512_unpacklo_epi16 (ta, tb), f);
+    t2 = _mm512_madd_epi16 (_mm512_unpackhi_epi16 (ta, tb), f);
+
+    t1 = _mm512_srai_epi32 (_mm512_add_epi32 (t1, round), PRECISION_S16);
+    t2 = _mm512_srai_epi32 (_mm512_add_epi32 (t2, round), PRECISION_S16);
+
+    _mm512_mask_storeu_epi16 (o + i, m, _mm512_packs_epi32 (t1, t2));
+  }
+}
+
+void
+interpolate_gint16_cubic_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gint16 *o = op, *a = ap, *ic = icp;
+  __m512i ta, tb, tl1, tl2, th1, th2;
+  __m512i f[2];
+  __m512i round = _mm512_set1_epi32 (1 << (PRECISION_S16 - 1));
+  __mmask32 m;
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) a + 0 * astride),
+    (gint16 *) ((gint8 *) a + 1 * astride),
+    (gint16 *) ((gint8 *) a + 2 * astride),
+    (gint16 *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm512_set1_epi32 (*((gint32 *) (ic + 0)));
+  f[1] = _mm512_set1_epi32 (*((gint32 *) (ic + 2)));
+
+  for (i = 0; i < len; i += 32) {
+    m = TAIL_MASK (len - i);
+    ta = _mm512_maskz_loadu_epi16 (m, c[0] + i);
+    tb = _mm512_maskz_loadu_epi16 (m, c[1] + i);
+
+    tl1 = _mm512_madd_epi16 (_mm512_unpacklo_epi16 (ta, tb), f[0]);
+    th1 = _mm512_madd_epi16 (_mm512_unpackhi_epi16 (ta, tb), f[0]);
+
+    ta = _mm512_maskz_loadu_epi16 (m, c[2] + i);
+    tb = _mm512_maskz_loadu_epi16 (m, c[3] + i);
+
+    tl2 = _mm512_madd_epi16 (_mm512_unpacklo_epi16 (ta, tb), f[1]);
+    th2 = _mm512_madd_epi16 (_mm512_unpackhi_epi16 (ta, tb), f[1]);
+
+    tl1 = _mm512_add_epi32 (_mm512_add_epi32 (tl1, tl2), round);
+    th1 = _mm512_add_epi32 (_mm512_add_epi32 (th1, th2), round);
+
+    tl1 = _mm512_srai_epi32 (tl1, PRECISION_S16);
+    th1 = _mm512_srai_epi32 (th1, PRECISION_S16);
+
+    _mm512_mask_storeu_epi16 (o + i, m, _mm512_packs_epi32 (tl1, th1));
+  }
+}
+
+void
+interpolate_gfloat_linear_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m512 f[2];
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm512_set1_ps (ic[0]);
+  f[1] = _mm512_set1_ps (ic[1]);
+
+  for (i = 0; i < len; i += 16) {
+    _mm512_storeu_ps (o + i, _mm512_fmadd_ps (_mm512_loadu_ps (c[1] + i), f[1],
+            _mm512_mul_ps (_mm512_loadu_ps (c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m512 f[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm512_set1_ps (ic[0]);
+  f[1] = _mm512_set1_ps (ic[1]);
+  f[2] = _mm512_set1_ps (ic[2]);
+  f[3] = _mm512_set1_ps (ic[3]);
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm512_mul_ps (_mm512_loadu_ps (c[0] + i), f[0]);
+    t = _mm512_fmadd_ps (_mm512_loadu_ps (c[1] + i), f[1], t);
+    t = _mm512_fmadd_ps (_mm512_loadu_ps (c[2] + i), f[2], t);
+    t = _mm512_fmadd_ps (_mm512_loadu_ps (c[3] + i), f[3], t);
+    _mm512_storeu_ps (o + i, t);
+  }
+}
+
+void
+interpolate_gdouble_linear_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m512d f[2];
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm512_set1_pd (ic[0]);
+  f[1] = _mm512_set1_pd (ic[1]);
+
+  for (i = 0; i < len; i += 8) {
+    _mm512_storeu_pd (o + i, _mm512_fmadd_pd (_mm512_loadu_pd (c[1] + i), f[1],
+            _mm512_mul_pd (_mm512_loadu_pd (c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m512d f[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm512_set1_pd (ic[0]);
+  f[1] = _mm512_set1_pd (ic[1]);
+  f[2] = _mm512_set1_pd (ic[2]);
+  f[3] = _mm512_set1_pd (ic[3]);
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm512_mul_pd (_mm512_loadu_pd (c[0] + i), f[0]);
+    t = _mm512_fmadd_pd (_mm512_loadu_pd (c[1] + i), f[1], t);
+    t = _mm512_fmadd_pd (_mm512_loadu_pd (c[2] + i), f[2], t);
+    t = _mm512_fmadd_pd (_mm512_loadu_pd (c[3] + i), f[3], t);
+    _mm512_storeu_pd (o + i, t);
+  }
+}
+
+#endif
@@ -32,6 +32,7 @@
 #include "audio-resampler.h"
 #include "audio-resampler-private.h"
 #include "audio-resampler-macros.h"
+#include "gst/shared-task-pool-private.h"
 
 #define MEM_ALIGN(m,a) ((gint8 *)((guintptr)((gint8 *)(m) + ((a)-1)) & ~((a)-1)))
 #define ALIGN 16
@@ -105,6 +106,7 @@ static const BlackmanQualityMap blackman_qualities[] = {
 #define DEFAULT_OPT_FILTER_INTERPOLATION GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC
 #define DEFAULT_OPT_FILTER_OVERSAMPLE 8
 #define DEFAULT_OPT_MAX_PHASE_ERROR 0.1
+#define DEFAULT_OPT_MAX_THREADS 1
 
 static gdouble
 get_opt_double (GstStructure * options, const gchar * name, gdouble def)
@@ -124,6 +126,15 @@ get_opt_int (GstStructure * options, const gchar * name, gint def)
   return res;
 }
 
+static guint
+get_opt_uint (GstStructure * options, const gchar * name, guint def)
+{
+  guint res;
+  if (!options || !gst_structure_get_uint (options, name, &res))
+    res = def;
+  return res;
+}
+
 static gint
 get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
 {
@@ -160,6 +171,8 @@ get_opt_enum (GstStructure * options, const gchar * name, GType type, gint def)
     GST_AUDIO_RESAMPLER_OPT_FILTER_OVERSAMPLE, DEFAULT_OPT_FILTER_OVERSAMPLE)
 #define GET_OPT_MAX_PHASE_ERROR(options) get_opt_double(options, \
     GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR, DEFAULT_OPT_MAX_PHASE_ERROR)
+#define GET_OPT_MAX_THREADS(options) get_opt_uint(options, \
+    GST_AUDIO_RESAMPLER_OPT_MAX_THREADS, DEFAULT_OPT_MAX_THREADS)
 
 #include "dbesi0.c"
 #define bessel dbesi0
@@ -873,6 +886,9 @@ audio_resampler_init (void)
           }
         }
       }
+#ifdef CHECK_X86
+      audio_resampler_check_x86_avx ();
+#endif
     }
 #endif
     g_once_init_leave (&init_gonce, 1);
@@ -1010,6 +1026,7 @@ alloc_cache_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
   resampler->cached_taps =
       MEM_ALIGN ((gint8 *) resampler->cached_taps_mem + phases_size, ALIGN);
   resampler->cached_phases = resampler->cached_taps_mem;
+  resampler->taps_cached = FALSE;
 }
 
 static void
@@ -1570,6 +1587,10 @@ gst_audio_resampler_update (GstAudioResampler * resampler,
       gst_structure_free (resampler->options);
     resampler->options = gst_structure_copy (options);
 
+    resampler->max_threads = GET_OPT_MAX_THREADS (options);
+    if (resampler->max_threads == 0)
+      resampler->max_threads = g_get_num_processors ();
+
     old_n_taps = resampler->n_taps;
 
     resampler_calculate_taps (resampler);
@@ -1633,6 +1654,7 @@ gst_audio_resampler_free (GstAudioResampler * resampler)
   g_free (resampler->tmp_taps);
   g_free (resampler->samples);
   g_free (resampler->sbuf);
+  g_free (resampler->tasks);
   if (resampler->options)
     gst_structure_free (resampler->options);
   g_slice_free (GstAudioResampler, resampler);
@@ -1722,6 +1744,127 @@ gst_audio_resampler_get_max_latency (GstAudioResampler * resampler)
   return resampler->n_taps / 2;
 }
 
+struct _AudioResamplerTask
+{
+  /* copy of the resampler for a group of channels */
+  GstAudioResampler resampler;
+  gpointer *in;
+  gpointer *out;
+  gpointer out_interleaved;
+  gsize in_len;
+  gsize out_len;
+  gsize consumed;
+  gpointer handle;
+};
+
+/* the full filter table is filled lazily, do that for all phases before
+ * the threads start so that they only read from it */
+static void
+fill_taps_cache (GstAudioResampler * resampler)
+{
+  gint phase;
+  gdouble icoeff[4];
+
+  for (phase = 0; phase < resampler->out_rate; phase++) {
+    gint samp_index = 0, samp_phase = phase;
+
+    switch (resampler->format_index) {
+      case 0:
+        get_taps_gint16_full (resampler, &samp_index, &samp_phase,
+            (gint16 *) icoeff);
+        break;
+      case 1:
+        get_taps_gint32_full (resampler, &samp_index, &samp_phase,
+            (gint32 *) icoeff);
+        break;
+      case 2:
+        get_taps_gfloat_full (resampler, &samp_index, &samp_phase,
+            (gfloat *) icoeff);
+        break;
+      case 3:
+        get_taps_gdouble_full (resampler, &samp_index, &samp_phase, icoeff);
+        break;
+    }
+  }
+  resampler->taps_cached = TRUE;
+}
+
+static void
+resample_task (AudioResamplerTask * task)
+{
+  task->resampler.resample (&task->resampler, task->in, task->in_len,
+      task->out, task->out_len, &task->consumed);
+}
+
+/* The channels are resampled independently with the same phase, so groups
+ * of channels can be handled in parallel by a copy of the resampler. Each
+ * copy advances the phase in the same way, we take it from the first one. */
+static void
+resample_channels (GstAudioResampler * resampler, gpointer in[],
+    gsize in_len, gpointer out[], gsize out_len, gsize * consumed)
+{
+  GstTaskPool *pool;
+  gint i, n_tasks, blocks = resampler->blocks;
+
+  n_tasks = MIN (resampler->max_threads, blocks);
+  if (n_tasks <= 1) {
+    resampler->resample (resampler, in, in_len, out, out_len, consumed);
+    return;
+  }
+
+  if (resampler->method != GST_AUDIO_RESAMPLER_METHOD_NEAREST &&
+      resampler->in_rate != resampler->out_rate &&
+      resampler->filter_mode == GST_AUDIO_RESAMPLER_FILTER_MODE_FULL &&
+      !resampler->taps_cached)
+    fill_taps_cache (resampler);
+
+  if (resampler->n_tasks < n_tasks) {
+    resampler->tasks =
+        g_renew (AudioResamplerTask, resampler->tasks, n_tasks);
+    resampler->n_tasks = n_tasks;
+  }
+
+  for (i = 0; i < n_tasks; i++) {
+    AudioResamplerTask *task = &resampler->tasks[i];
+    gint first = blocks * i / n_tasks;
+
+    task->resampler = *resampler;
+    task->resampler.blocks = blocks * (i + 1) / n_tasks - first;
+    task->in = in + first;
+    if (resampler->ostride == 1) {
+      task->out = out + first;
+    } else {
+      task->out_interleaved = (gint8 *) out[0] + first * resampler->bps;
+      task->out = &task->out_interleaved;
+    }
+    task->in_len = in_len;
+    task->out_len = out_len;
+  }
+
+  pool = _gst_plugins_base_get_shared_task_pool ();
+  for (i = 1; i < n_tasks; i++) {
+    AudioResamplerTask *task = &resampler->tasks[i];
+
+    task->handle = gst_task_pool_push (pool,
+        (GstTaskPoolFunction) resample_task, task, NULL);
+    /* run it here when the pool can't take it */
+    if (task->handle == NULL)
+      resample_task (task);
+  }
+  resample_task (&resampler->tasks[0]);
+
+  for (i = 1; i < n_tasks; i++) {
+    AudioResamplerTask *task = &resampler->tasks[i];
+
+    if (task->handle)
+      gst_task_pool_join (pool, task->handle);
+  }
+
+  *consumed = resampler->tasks[0].consumed;
+  resampler->samp_index = resampler->tasks[0].resampler.samp_index;
+  resampler->samp_phase = resampler->tasks[0].resampler.samp_phase;
+}
+
 /**
  * gst_audio_resampler_resample:
  * @resampler: a #GstAudioResampler
@@ -1781,7 +1924,7 @@ gst_audio_resampler_resample (GstAudioResampler * resampler,
   }
 
   /* resample all channels */
-  resampler->resample (resampler, sbuf, samples_avail, out, out_frames,
+  resample_channels (resampler, sbuf, samples_avail, out, out_frames,
       &consumed);
 
   GST_LOG ("in %" G_GSIZE_FORMAT ", avail %" G_GSIZE_FORMAT ", consumed %"
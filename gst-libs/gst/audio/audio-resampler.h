@@ -164,6 +164,18 @@ typedef enum {
  */
 #define GST_AUDIO_RESAMPLER_OPT_MAX_PHASE_ERROR "GstAudioResampler.max-phase-error"
 
+/**
+ * GST_AUDIO_RESAMPLER_OPT_MAX_THREADS:
+ *
+ * G_TYPE_UINT: The maximum number of threads to use for resampling. The
+ * channels are split into groups that are resampled in parallel, the result
+ * is the same as with one thread. 0 uses one thread per CPU core.
+ * 1 is the default.
+ *
+ * Since: 1.20
+ */
+#define GST_AUDIO_RESAMPLER_OPT_MAX_THREADS "GstAudioResampler.max-threads"
+
 /**
  * GstAudioResamplerMethod:
  * @GST_AUDIO_RESAMPLER_METHOD_NEAREST: Duplicates the samples when
@@ -33,6 +33,7 @@
 #include <gst/audio/audio-quantize.h>
 #include <gst/audio/audio-converter.h>
 #include <gst/audio/audio-resampler.h>
+#include <gst/audio/audio-loudness.h>
 #include <gst/audio/gstaudiostreamalign.h>
 #include <gst/audio/gstaudioaggregator.h>
 
@@ -42,6 +42,12 @@
  * #GstAudioConverter implementation, or a subclass of #GstAudioAggregatorPad
  * implementing #GstAudioAggregatorPadClass.convert_buffer.
  *
+ * #GstAudioAggregatorConvertPad converts an input buffer only once its
+ * samples are mixed, so samples that are dropped for being late are not
+ * converted when the sample rate is unchanged. Sink pads with the same
+ * formats and converter configuration share one #GstAudioConverter as long
+ * as it does not resample.
+ *
  * To allow for the output caps to change, the mechanism is the same as
  * above, with the GType of the source pad.
  *
@@ -124,9 +130,71 @@ struct _GstAudioAggregatorPadPrivate
   guint64 dropped;              /* Number of sampels dropped since the element came out of READY */
 
   gboolean qos_messages;        /* Property to decide to send QoS messages or not */
+
+  gboolean unconverted;         /* buffer is still in the input format and is
+                                   converted when it is mixed, position and
+                                   size are in output samples already */
 };
 
 
+/* A converter for one input and output format and configuration */
+typedef struct
+{
+  gint refcount;
+  GstAudioInfo in_info;
+  GstAudioInfo out_info;
+  GstStructure *config;
+  /* NULL for passthrough */
+  GstAudioConverter *converter;
+} SharedConverter;
+
+struct _GstAudioAggregatorPrivate
+{
+  GMutex mutex;
+
+  /* All three properties are unprotected, can't be modified while streaming */
+  /* Size in frames that is output per buffer */
+  GstClockTime alignment_threshold;
+  GstClockTime discont_wait;
+
+  gint output_buffer_duration_n;
+  gint output_buffer_duration_d;
+
+  guint samples_per_buffer;
+  guint error_per_buffer;
+  guint accumulated_error;
+  guint current_blocksize;
+
+  /* Protected by srcpad stream clock */
+  /* Output buffer starting at offset containing blocksize frames (calculated
+   * from output_buffer_duration) */
+  GstBuffer *current_buffer;
+
+  /* counters to keep track of timestamps */
+  /* Readable with object lock, writable with both aag lock and object lock */
+
+  /* Sample offset starting from 0 at aggregator.segment.start */
+  gint64 offset;
+
+  /* info structure passed to selected-samples signal, must only be accessed
+   * from the aggregate thread */
+  GstStructure *selected_samples_info;
+
+  /* Only access from src thread */
+  /* Messages to post after releasing locks */
+  GQueue messages;
+
+  /* Loudness measurement of the output, protected by the aagg lock */
+  GstClockTime loudness_interval;
+  GstAudioLoudness *loudness;
+  guint64 loudness_frames;
+
+  /* Conversion of the sink pads, protected by the object lock */
+  GstBufferPool *convert_pool;
+  gsize convert_pool_size;
+  GList *shared_converters;
+};
+
 /*****************************************
  * GstAudioAggregatorPad implementation  *
  *****************************************/
@@ -257,7 +325,7 @@ enum
 struct _GstAudioAggregatorConvertPadPrivate
 {
   /* All members are protected by the pad object lock */
-  GstAudioConverter *converter;
+  SharedConverter *converter;
   GstStructure *converter_config;
   gboolean converter_config_changed;
 };
@@ -266,17 +334,100 @@ struct _GstAudioAggregatorConvertPadPrivate
 G_DEFINE_TYPE_WITH_PRIVATE (GstAudioAggregatorConvertPad,
     gst_audio_aggregator_convert_pad, GST_TYPE_AUDIO_AGGREGATOR_PAD);
 
+static SharedConverter *
+shared_converter_ref (SharedConverter * conv)
+{
+  g_atomic_int_inc (&conv->refcount);
+
+  return conv;
+}
+
+static void
+shared_converter_unref (SharedConverter * conv)
+{
+  if (!g_atomic_int_dec_and_test (&conv->refcount))
+    return;
+
+  if (conv->converter)
+    gst_audio_converter_free (conv->converter);
+  if (conv->config)
+    gst_structure_free (conv->config);
+  g_slice_free (SharedConverter, conv);
+}
+
+/* Converters without a resampler, dither and noise shaping don't keep any
+ * state between buffers and can be used for the buffers of several pads.
+ * The quantizer keeps the dither and noise shaping error of the previous
+ * samples, so sharing it would make the output of a pad depend on the
+ * samples of the others */
+static gboolean
+shared_converter_is_shareable (GstAudioInfo * in_info, GstAudioInfo * out_info,
+    GstStructure * config)
+{
+  GstAudioDitherMethod dither = GST_AUDIO_DITHER_NONE;
+  GstAudioNoiseShapingMethod ns = GST_AUDIO_NOISE_SHAPING_NONE;
+
+  if (GST_AUDIO_INFO_RATE (in_info) != GST_AUDIO_INFO_RATE (out_info))
+    return FALSE;
+
+  if (config) {
+    gst_structure_get_enum (config, GST_AUDIO_CONVERTER_OPT_DITHER_METHOD,
+        GST_TYPE_AUDIO_DITHER_METHOD, (gint *) & dither);
+    gst_structure_get_enum (config,
+        GST_AUDIO_CONVERTER_OPT_NOISE_SHAPING_METHOD,
+        GST_TYPE_AUDIO_NOISE_SHAPING_METHOD, (gint *) & ns);
+  }
+
+  return dither == GST_AUDIO_DITHER_NONE && ns == GST_AUDIO_NOISE_SHAPING_NONE;
+}
+
+/* Called with the aggregator object lock */
+static SharedConverter *
+gst_audio_aggregator_find_shared_converter (GstAudioAggregator * aagg,
+    GstAudioInfo * in_info, GstAudioInfo * out_info, GstStructure * config)
+{
+  SharedConverter *res = NULL;
+  GList *l, *next;
+
+  for (l = aagg->priv->shared_converters; l; l = next) {
+    SharedConverter *conv = l->data;
+
+    next = l->next;
+
+    /* not used by any pad anymore */
+    if (g_atomic_int_get (&conv->refcount) == 1) {
+      aagg->priv->shared_converters =
+          g_list_delete_link (aagg->priv->shared_converters, l);
+      shared_converter_unref (conv);
+      continue;
+    }
+
+    if (!res && gst_audio_info_is_equal (&conv->in_info, in_info)
+        && gst_audio_info_is_equal (&conv->out_info, out_info)
+        && (conv->config == config || (conv->config && config
+                && gst_structure_is_equal (conv->config, config))))
+      res = shared_converter_ref (conv);
+  }
+
+  return res;
+}
+
 static void
 gst_audio_aggregator_convert_pad_update_converter (GstAudioAggregatorConvertPad
     * aaggcpad, GstAudioInfo * in_info, GstAudioInfo * out_info)
 {
   GstStructure *config = aaggcpad->priv->converter_config;
+  GstObject *parent = GST_OBJECT_PARENT (aaggcpad);
+  GstAudioAggregator *aagg = NULL;
+  SharedConverter *conv = aaggcpad->priv->converter;
   GstAudioConverter *converter;
 
-  if (!aaggcpad->priv->converter_config_changed)
+  if (!aaggcpad->priv->converter_config_changed && conv
+      && gst_audio_info_is_equal (&conv->in_info, in_info)
+      && gst_audio_info_is_equal (&conv->out_info, out_info))
     return;
 
-  g_clear_pointer (&aaggcpad->priv->converter, gst_audio_converter_free);
+  g_clear_pointer (&aaggcpad->priv->converter, shared_converter_unref);
   aaggcpad->priv->converter_config_changed = FALSE;
 
   if (in_info->finfo->format == GST_AUDIO_FORMAT_UNKNOWN) {
@@ -285,6 +436,19 @@ gst_audio_aggregator_convert_pad_update_converter (GstAudioAggregatorConvertPad
     return;
   }
 
+  if (parent && GST_IS_AUDIO_AGGREGATOR (parent))
+    aagg = GST_AUDIO_AGGREGATOR (parent);
+
+  if (aagg) {
+    aaggcpad->priv->converter =
+        gst_audio_aggregator_find_shared_converter (aagg, in_info, out_info,
+        config);
+    if (aaggcpad->priv->converter) {
+      GST_DEBUG_OBJECT (aaggcpad, "using shared converter");
+      return;
+    }
+  }
+
   converter =
       gst_audio_converter_new (GST_AUDIO_CONVERTER_FLAG_NONE, in_info, out_info,
       config ? gst_structure_copy (config) : NULL);
@@ -296,10 +460,25 @@ gst_audio_aggregator_convert_pad_update_converter (GstAudioAggregatorConvertPad
     return;
   }
 
+  conv = g_slice_new0 (SharedConverter);
+  conv->refcount = 1;
+  conv->in_info = *in_info;
+  conv->out_info = *out_info;
+  conv->config = config ? gst_structure_copy (config) : NULL;
+
   if (!gst_audio_converter_is_passthrough (converter))
-    aaggcpad->priv->converter = converter;
+    conv->converter = converter;
   else
     gst_audio_converter_free (converter);
+
+  if (aagg && conv->converter
+      && shared_converter_is_shareable (in_info, out_info, config)) {
+    aagg->priv->shared_converters =
+        g_list_prepend (aagg->priv->shared_converters,
+        shared_converter_ref (conv));
+  }
+
+  aaggcpad->priv->converter = conv;
 }
 
 static void
@@ -310,28 +489,87 @@ gst_audio_aggregator_pad_update_conversion_info (GstAudioAggregatorPad *
       TRUE;
 }
 
+/* Called with the aggregator object lock, when the pad has a parent.
+ * Converted buffers all have the output format, so they come from one pool
+ * on the aggregator that grows to the largest buffer */
 static GstBuffer *
-gst_audio_aggregator_convert_pad_convert_buffer (GstAudioAggregatorPad *
-    aaggpad, GstAudioInfo * in_info, GstAudioInfo * out_info,
-    GstBuffer * input_buffer)
+gst_audio_aggregator_alloc_converted_buffer (GstAudioAggregator * aagg,
+    gsize size)
+{
+  GstBuffer *res = NULL;
+
+  if (!aagg)
+    return gst_buffer_new_allocate (NULL, size, NULL);
+
+  if (!aagg->priv->convert_pool || aagg->priv->convert_pool_size < size) {
+    GstBufferPool *pool = gst_buffer_pool_new ();
+    GstStructure *config;
+    guint pool_size = GST_ROUND_UP_N (size, 4096);
+
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, NULL, pool_size, 0, 0);
+    if (!gst_buffer_pool_set_config (pool, config)
+        || !gst_buffer_pool_set_active (pool, TRUE)) {
+      GST_WARNING_OBJECT (aagg, "failed to configure conversion pool");
+      gst_object_unref (pool);
+      return gst_buffer_new_allocate (NULL, size, NULL);
+    }
+
+    /* outstanding buffers of the old pool are freed when they return */
+    if (aagg->priv->convert_pool) {
+      gst_buffer_pool_set_active (aagg->priv->convert_pool, FALSE);
+      gst_object_unref (aagg->priv->convert_pool);
+    }
+    aagg->priv->convert_pool = pool;
+    aagg->priv->convert_pool_size = pool_size;
+  }
+
+  if (gst_buffer_pool_acquire_buffer (aagg->priv->convert_pool, &res,
+          NULL) != GST_FLOW_OK)
+    return gst_buffer_new_allocate (NULL, size, NULL);
+
+  gst_buffer_resize (res, 0, size);
+
+  return res;
+}
+
+/* Converts input_buffer, leaving out the first *skip output samples if that
+ * can be done without converting them. *skip is set to 0 when all samples
+ * were converted. */
+static GstBuffer *
+gst_audio_aggregator_convert_pad_convert (GstAudioAggregatorConvertPad *
+    aaggcpad, GstAudioInfo * in_info, GstAudioInfo * out_info,
+    GstBuffer * input_buffer, guint * skip)
 {
+  GstObject *parent = GST_OBJECT_PARENT (aaggcpad);
+  GstAudioAggregator *aagg = NULL;
+  GstAudioConverter *converter = NULL;
   GstBuffer *res;
-  GstAudioAggregatorConvertPad *aaggcpad =
-      GST_AUDIO_AGGREGATOR_CONVERT_PAD (aaggpad);
 
   gst_audio_aggregator_convert_pad_update_converter (aaggcpad, in_info,
       out_info);
 
-  if (aaggcpad->priv->converter) {
-    gint insize = gst_buffer_get_size (input_buffer);
-    gsize insamples = insize / in_info->bpf;
-    gsize outsamples =
-        gst_audio_converter_get_out_frames (aaggcpad->priv->converter,
+  if (aaggcpad->priv->converter)
+    converter = aaggcpad->priv->converter->converter;
+
+  if (parent && GST_IS_AUDIO_AGGREGATOR (parent))
+    aagg = GST_AUDIO_AGGREGATOR (parent);
+
+  /* without a resampler, output samples are input samples */
+  if (!converter || GST_AUDIO_INFO_RATE (in_info) !=
+      GST_AUDIO_INFO_RATE (out_info))
+    *skip = 0;
+
+  if (converter) {
+    gsize insize = gst_buffer_get_size (input_buffer);
+    gsize insamples = insize / in_info->bpf - *skip;
+    gsize outsamples = gst_audio_converter_get_out_frames (converter,
         insamples);
-    gint outsize = outsamples * out_info->bpf;
+    gsize outsize = outsamples * out_info->bpf;
     GstMapInfo inmap, outmap;
+    gpointer in;
 
-    res = gst_buffer_new_allocate (NULL, outsize, NULL);
+    res = gst_audio_aggregator_alloc_converted_buffer (aagg, outsize);
 
     /* We create a perfectly similar buffer, except obviously for
      * its converted contents */
@@ -339,12 +577,22 @@ gst_audio_aggregator_convert_pad_convert_buffer (GstAudioAggregatorPad *
         GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS |
         GST_BUFFER_COPY_META, 0, -1);
 
+    if (*skip > 0) {
+      GstClockTime skipped = gst_util_uint64_scale_int (*skip, GST_SECOND,
+          GST_AUDIO_INFO_RATE (in_info));
+
+      if (GST_BUFFER_PTS_IS_VALID (res))
+        GST_BUFFER_PTS (res) += skipped;
+      if (GST_BUFFER_DURATION_IS_VALID (res))
+        GST_BUFFER_DURATION (res) -= MIN (skipped, GST_BUFFER_DURATION (res));
+    }
+
     gst_buffer_map (input_buffer, &inmap, GST_MAP_READ);
     gst_buffer_map (res, &outmap, GST_MAP_WRITE);
 
-    gst_audio_converter_samples (aaggcpad->priv->converter,
-        GST_AUDIO_CONVERTER_FLAG_NONE,
-        (gpointer *) & inmap.data, insamples,
+    in = inmap.data + *skip * in_info->bpf;
+    gst_audio_converter_samples (converter,
+        GST_AUDIO_CONVERTER_FLAG_NONE, &in, insamples,
         (gpointer *) & outmap.data, outsamples);
 
     gst_buffer_unmap (input_buffer, &inmap);
@@ -356,13 +604,50 @@ gst_audio_aggregator_convert_pad_convert_buffer (GstAudioAggregatorPad *
   return res;
 }
 
+static GstBuffer *
+gst_audio_aggregator_convert_pad_convert_buffer (GstAudioAggregatorPad *
+    aaggpad, GstAudioInfo * in_info, GstAudioInfo * out_info,
+    GstBuffer * input_buffer)
+{
+  guint skip = 0;
+
+  return
+      gst_audio_aggregator_convert_pad_convert (GST_AUDIO_AGGREGATOR_CONVERT_PAD
+      (aaggpad), in_info, out_info, input_buffer, &skip);
+}
+
+/* Number of output samples the next input buffer of in_frames samples will
+ * be converted to */
+static guint
+gst_audio_aggregator_convert_pad_get_out_frames (GstAudioAggregatorConvertPad
+    * aaggcpad, GstAudioInfo * in_info, GstAudioInfo * out_info,
+    guint in_frames)
+{
+  gst_audio_aggregator_convert_pad_update_converter (aaggcpad, in_info,
+      out_info);
+
+  if (aaggcpad->priv->converter && aaggcpad->priv->converter->converter)
+    return gst_audio_converter_get_out_frames (aaggcpad->priv->converter->
+        converter, in_frames);
+
+  return in_frames;
+}
+
+/* Pads that don't override the conversion of #GstAudioAggregatorConvertPad
+ * convert their buffers only when they are mixed */
+static gboolean
+gst_audio_aggregator_pad_converts_lazily (GstAudioAggregatorPad * pad)
+{
+  return GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer ==
+      gst_audio_aggregator_convert_pad_convert_buffer;
+}
+
 static void
 gst_audio_aggregator_convert_pad_finalize (GObject * object)
 {
   GstAudioAggregatorConvertPad *pad = (GstAudioAggregatorConvertPad *) object;
 
-  if (pad->priv->converter)
-    gst_audio_converter_free (pad->priv->converter);
+  g_clear_pointer (&pad->priv->converter, shared_converter_unref);
 
   if (pad->priv->converter_config)
     gst_structure_free (pad->priv->converter_config);
@@ -448,43 +733,6 @@ gst_audio_aggregator_convert_pad_init (GstAudioAggregatorConvertPad * pad)
  * GstAudioAggregator implementation  *
  **************************************/
 
-struct _GstAudioAggregatorPrivate
-{
-  GMutex mutex;
-
-  /* All three properties are unprotected, can't be modified while streaming */
-  /* Size in frames that is output per buffer */
-  GstClockTime alignment_threshold;
-  GstClockTime discont_wait;
-
-  gint output_buffer_duration_n;
-  gint output_buffer_duration_d;
-
-  guint samples_per_buffer;
-  guint error_per_buffer;
-  guint accumulated_error;
-  guint current_blocksize;
-
-  /* Protected by srcpad stream clock */
-  /* Output buffer starting at offset containing blocksize frames (calculated
-   * from output_buffer_duration) */
-  GstBuffer *current_buffer;
-
-  /* counters to keep track of timestamps */
-  /* Readable with object lock, writable with both aag lock and object lock */
-
-  /* Sample offset starting from 0 at aggregator.segment.start */
-  gint64 offset;
-
-  /* info structure passed to selected-samples signal, must only be accessed
-   * from the aggregate thread */
-  GstStructure *selected_samples_info;
-
-  /* Only access from src thread */
-  /* Messages to post after releasing locks */
-  GQueue messages;
-};
-
 #define GST_AUDIO_AGGREGATOR_LOCK(self)   g_mutex_lock (&(self)->priv->mutex);
 #define GST_AUDIO_AGGREGATOR_UNLOCK(self) g_mutex_unlock (&(self)->priv->mutex);
 
@@ -513,6 +761,8 @@ static GstBuffer *gst_audio_aggregator_do_clip (GstAggregator * agg,
     GstAggregatorPad * bpad, GstBuffer * buffer);
 static GstFlowReturn gst_audio_aggregator_aggregate (GstAggregator * agg,
     gboolean timeout);
+static GstFlowReturn gst_audio_aggregator_finish_buffer (GstAggregator * agg,
+    GstBuffer * buffer);
 static gboolean sync_pad_values (GstElement * aagg, GstPad * pad, gpointer ud);
 static gboolean gst_audio_aggregator_negotiated_src_caps (GstAggregator * agg,
     GstCaps * caps);
@@ -529,6 +779,7 @@ static GstSample *gst_audio_aggregator_peek_next_sample (GstAggregator * agg,
 #define DEFAULT_DISCONT_WAIT (1 * GST_SECOND)
 #define DEFAULT_OUTPUT_BUFFER_DURATION_N (1)
 #define DEFAULT_OUTPUT_BUFFER_DURATION_D (100)
+#define DEFAULT_LOUDNESS_INTERVAL (0)
 
 enum
 {
@@ -537,6 +788,7 @@ enum
   PROP_ALIGNMENT_THRESHOLD,
   PROP_DISCONT_WAIT,
   PROP_OUTPUT_BUFFER_DURATION_FRACTION,
+  PROP_LOUDNESS_INTERVAL,
 };
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstAudioAggregator, gst_audio_aggregator,
@@ -649,6 +901,8 @@ gst_audio_aggregator_class_init (GstAudioAggregatorClass * klass)
   gstaggregator_class->flush = gst_audio_aggregator_flush;
   gstaggregator_class->aggregate =
       GST_DEBUG_FUNCPTR (gst_audio_aggregator_aggregate);
+  gstaggregator_class->finish_buffer =
+      GST_DEBUG_FUNCPTR (gst_audio_aggregator_finish_buffer);
   gstaggregator_class->clip = GST_DEBUG_FUNCPTR (gst_audio_aggregator_do_clip);
   gstaggregator_class->get_next_time = gst_aggregator_simple_get_next_time;
   gstaggregator_class->update_src_caps =
@@ -698,6 +952,26 @@ gst_audio_aggregator_class_init (GstAudioAggregatorClass * klass)
           "creating a discontinuity", 0,
           G_MAXUINT64 - 1, DEFAULT_DISCONT_WAIT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioAggregator:loudness-interval:
+   *
+   * Measure the EBU R128 loudness and true-peak of the output with
+   * #GstAudioLoudness and post a "loudness" element message with the result
+   * every loudness-interval nanoseconds. The output is measured right after
+   * it was produced, while it is still in the cache. The message contains
+   * the fields of gst_audio_loudness_get_structure() and the "timestamp",
+   * "stream-time" and "running-time" of the end of the last measured
+   * buffer. Only S16, S32 and F32 output is measured. 0 disables the
+   * measurement.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_LOUDNESS_INTERVAL,
+      g_param_spec_uint64 ("loudness-interval", "Loudness Interval",
+          "Interval of the loudness messages in nanoseconds (0 = disabled)",
+          0, G_MAXUINT64, DEFAULT_LOUDNESS_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -709,6 +983,7 @@ gst_audio_aggregator_init (GstAudioAggregator * aagg)
 
   aagg->priv->alignment_threshold = DEFAULT_ALIGNMENT_THRESHOLD;
   aagg->priv->discont_wait = DEFAULT_DISCONT_WAIT;
+  aagg->priv->loudness_interval = DEFAULT_LOUDNESS_INTERVAL;
 
   gst_audio_aggregator_translate_output_buffer_duration (aagg,
       DEFAULT_OUTPUT_BUFFER_DURATION);
@@ -731,6 +1006,16 @@ gst_audio_aggregator_dispose (GObject * object)
 
   gst_clear_structure (&aagg->priv->selected_samples_info);
 
+  g_clear_pointer (&aagg->priv->loudness, gst_audio_loudness_free);
+
+  if (aagg->priv->convert_pool) {
+    gst_buffer_pool_set_active (aagg->priv->convert_pool, FALSE);
+    gst_clear_object (&aagg->priv->convert_pool);
+  }
+  g_list_free_full (aagg->priv->shared_converters,
+      (GDestroyNotify) shared_converter_unref);
+  aagg->priv->shared_converters = NULL;
+
   g_mutex_clear (&aagg->priv->mutex);
 
   G_OBJECT_CLASS (gst_audio_aggregator_parent_class)->dispose (object);
@@ -763,6 +1048,11 @@ gst_audio_aggregator_set_property (GObject * object, guint prop_id,
       g_object_notify (object, "output-buffer-duration");
       gst_audio_aggregator_recalculate_latency (aagg);
       break;
+    case PROP_LOUDNESS_INTERVAL:
+      GST_AUDIO_AGGREGATOR_LOCK (aagg);
+      aagg->priv->loudness_interval = g_value_get_uint64 (value);
+      GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -791,6 +1081,11 @@ gst_audio_aggregator_get_property (GObject * object, guint prop_id,
       gst_value_set_fraction (value, aagg->priv->output_buffer_duration_n,
           aagg->priv->output_buffer_duration_d);
       break;
+    case PROP_LOUDNESS_INTERVAL:
+      GST_AUDIO_AGGREGATOR_LOCK (aagg);
+      g_value_set_uint64 (value, aagg->priv->loudness_interval);
+      GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1144,6 +1439,18 @@ gst_audio_aggregator_update_converters (GstAudioAggregator * aagg,
     if (klass->update_conversion_info)
       klass->update_conversion_info (aaggpad);
 
+    /* A buffer that was not converted yet only needs its sample counts
+     * scaled to the new rate, it is converted to the new format directly */
+    if (aaggpad->priv->buffer && aaggpad->priv->unconverted) {
+      aaggpad->priv->position =
+          gst_util_uint64_scale_int (aaggpad->priv->position,
+          GST_AUDIO_INFO_RATE (new_info), GST_AUDIO_INFO_RATE (old_info));
+      aaggpad->priv->size =
+          gst_util_uint64_scale_int (aaggpad->priv->size,
+          GST_AUDIO_INFO_RATE (new_info), GST_AUDIO_INFO_RATE (old_info));
+      continue;
+    }
+
     /* If we currently were mixing a buffer, we need to convert it to the new
      * format */
     if (aaggpad->priv->buffer) {
@@ -1189,6 +1496,9 @@ gst_audio_aggregator_negotiated_src_caps (GstAggregator * agg, GstCaps * caps)
 
     gst_audio_aggregator_update_converters (aagg, &info, &old_info);
 
+    /* the loudness meter is recreated for the new format */
+    g_clear_pointer (&aagg->priv->loudness, gst_audio_loudness_free);
+
     if (srcpad_klass->update_conversion_info)
       srcpad_klass->update_conversion_info (GST_AUDIO_AGGREGATOR_PAD (agg->
               srcpad));
@@ -1583,6 +1893,12 @@ gst_audio_aggregator_reset (GstAudioAggregator * aagg)
   gst_caps_replace (&aagg->current_caps, NULL);
   gst_buffer_replace (&aagg->priv->current_buffer, NULL);
   aagg->priv->accumulated_error = 0;
+  g_clear_pointer (&aagg->priv->loudness, gst_audio_loudness_free);
+  aagg->priv->loudness_frames = 0;
+  if (aagg->priv->convert_pool) {
+    gst_buffer_pool_set_active (aagg->priv->convert_pool, FALSE);
+    gst_clear_object (&aagg->priv->convert_pool);
+  }
   GST_OBJECT_UNLOCK (aagg);
   GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
 }
@@ -1618,6 +1934,9 @@ gst_audio_aggregator_flush (GstAggregator * agg)
   aagg->priv->offset = -1;
   aagg->priv->accumulated_error = 0;
   gst_buffer_replace (&aagg->priv->current_buffer, NULL);
+  if (aagg->priv->loudness)
+    gst_audio_loudness_reset (aagg->priv->loudness);
+  aagg->priv->loudness_frames = 0;
   GST_OBJECT_UNLOCK (aagg);
   GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
 
@@ -1743,7 +2062,14 @@ gst_audio_aggregator_fill_buffer (GstAudioAggregator * aagg,
   }
 
   pad->priv->position = 0;
-  pad->priv->size = gst_buffer_get_size (pad->priv->buffer) / bpf;
+  if (pad->priv->unconverted)
+    pad->priv->size =
+        gst_audio_aggregator_convert_pad_get_out_frames
+        (GST_AUDIO_AGGREGATOR_CONVERT_PAD (pad), &pad->info, &srcpad->info,
+        gst_buffer_get_size (pad->priv->buffer) / GST_AUDIO_INFO_BPF
+        (&pad->info));
+  else
+    pad->priv->size = gst_buffer_get_size (pad->priv->buffer) / bpf;
 
   if (pad->priv->size == 0) {
     if (!GST_BUFFER_DURATION_IS_VALID (pad->priv->buffer) ||
@@ -2082,6 +2408,47 @@ sync_pad_values (GstElement * aagg, GstPad * pad, gpointer user_data)
   return TRUE;
 }
 
+/* Called with the object lock for both the element and pad held
+ *
+ * Converts the pad's current buffer if that was deferred until its samples
+ * are needed. Samples before the current position were dropped and are not
+ * converted when that doesn't change the result.
+ */
+static void
+gst_audio_aggregator_pad_convert_pending (GstAudioAggregator * aagg,
+    GstAudioAggregatorPad * pad)
+{
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR (aagg)->srcpad);
+  GstBuffer *converted;
+  guint skip;
+
+  if (!pad->priv->buffer || !pad->priv->unconverted)
+    return;
+
+  pad->priv->unconverted = FALSE;
+
+  if (GST_BUFFER_FLAG_IS_SET (pad->priv->buffer, GST_BUFFER_FLAG_GAP))
+    return;
+
+  skip = pad->priv->position;
+  converted =
+      gst_audio_aggregator_convert_pad_convert (GST_AUDIO_AGGREGATOR_CONVERT_PAD
+      (pad), &pad->info, &srcpad->info, pad->priv->buffer, &skip);
+  gst_buffer_replace (&pad->priv->buffer, converted);
+  gst_buffer_unref (converted);
+
+  if (skip > 0) {
+    pad->priv->position -= skip;
+    pad->priv->size -= skip;
+  }
+
+  pad->priv->size = MIN (pad->priv->size,
+      gst_buffer_get_size (pad->priv->buffer) /
+      GST_AUDIO_INFO_BPF (&srcpad->info));
+  pad->priv->position = MIN (pad->priv->position, pad->priv->size);
+}
+
 static GstSample *
 gst_audio_aggregator_peek_next_sample (GstAggregator * agg,
     GstAggregatorPad * aggpad)
@@ -2089,26 +2456,122 @@ gst_audio_aggregator_peek_next_sample (GstAggregator * agg,
   GstAudioAggregator *aagg = GST_AUDIO_AGGREGATOR (agg);
   GstAudioAggregatorPad *pad = GST_AUDIO_AGGREGATOR_PAD (aggpad);
   GstSample *sample = NULL;
+  GstCaps *caps = gst_pad_get_current_caps (GST_PAD (aggpad));
 
+  GST_OBJECT_LOCK (agg);
+  GST_OBJECT_LOCK (pad);
   if (pad->priv->buffer && pad->priv->output_offset >= aagg->priv->offset
       && pad->priv->output_offset <
       aagg->priv->offset + aagg->priv->samples_per_buffer) {
-    GstCaps *caps = gst_pad_get_current_caps (GST_PAD (aggpad));
-    GstStructure *info =
-        gst_structure_new ("GstAudioAggregatorPadNextSampleInfo",
+    GstStructure *info;
+
+    gst_audio_aggregator_pad_convert_pending (aagg, pad);
+
+    info = gst_structure_new ("GstAudioAggregatorPadNextSampleInfo",
         "output-offset", G_TYPE_UINT64, pad->priv->output_offset,
         "position", G_TYPE_UINT, pad->priv->position,
         "size", G_TYPE_UINT, pad->priv->size,
         NULL);
 
     sample = gst_sample_new (pad->priv->buffer, caps, &aggpad->segment, info);
-    gst_caps_unref (caps);
     gst_structure_free (info);
   }
+  GST_OBJECT_UNLOCK (pad);
+  GST_OBJECT_UNLOCK (agg);
+
+  if (caps)
+    gst_caps_unref (caps);
 
   return sample;
 }
 
+/* Measures the loudness of an output buffer and returns a message when the
+ * loudness-interval has passed. Called with the aagg lock */
+static GstMessage *
+gst_audio_aggregator_measure_loudness (GstAudioAggregator * aagg,
+    GstBuffer * buffer)
+{
+  GstAggregator *agg = GST_AGGREGATOR (aagg);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GstSegment *segment = &GST_AGGREGATOR_PAD (agg->srcpad)->segment;
+  GstClockTime timestamp, running_time, stream_time;
+  GstStructure *s;
+  GstMapInfo map;
+  guint64 interval_frames;
+  gint rate, bpf;
+
+  if (!GST_AUDIO_INFO_IS_VALID (&srcpad->info))
+    return NULL;
+
+  rate = GST_AUDIO_INFO_RATE (&srcpad->info);
+  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
+
+  if (!aagg->priv->loudness) {
+    aagg->priv->loudness = gst_audio_loudness_new (&srcpad->info);
+    aagg->priv->loudness_frames = 0;
+    if (!aagg->priv->loudness) {
+      GST_LOG_OBJECT (aagg, "can't measure loudness of %s",
+          GST_AUDIO_INFO_NAME (&srcpad->info));
+      return NULL;
+    }
+  }
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+    return NULL;
+  gst_audio_loudness_process (aagg->priv->loudness, map.data, map.size / bpf);
+  aagg->priv->loudness_frames += map.size / bpf;
+  gst_buffer_unmap (buffer, &map);
+
+  interval_frames = gst_util_uint64_scale (aagg->priv->loudness_interval,
+      rate, GST_SECOND);
+  if (aagg->priv->loudness_frames < MAX (interval_frames, 1))
+    return NULL;
+  aagg->priv->loudness_frames = 0;
+
+  timestamp = GST_BUFFER_PTS (buffer);
+  if (GST_CLOCK_TIME_IS_VALID (timestamp)
+      && GST_BUFFER_DURATION_IS_VALID (buffer))
+    timestamp += GST_BUFFER_DURATION (buffer);
+
+  GST_OBJECT_LOCK (aagg);
+  running_time = gst_segment_to_running_time (segment, GST_FORMAT_TIME,
+      timestamp);
+  stream_time = gst_segment_to_stream_time (segment, GST_FORMAT_TIME,
+      timestamp);
+  GST_OBJECT_UNLOCK (aagg);
+
+  s = gst_audio_loudness_get_structure (aagg->priv->loudness);
+  gst_structure_set (s, "timestamp", G_TYPE_UINT64, timestamp,
+      "stream-time", G_TYPE_UINT64, stream_time,
+      "running-time", G_TYPE_UINT64, running_time, NULL);
+
+  return gst_message_new_element (GST_OBJECT (aagg), s);
+}
+
+static GstFlowReturn
+gst_audio_aggregator_finish_buffer (GstAggregator * agg, GstBuffer * buffer)
+{
+  GstAudioAggregator *aagg = GST_AUDIO_AGGREGATOR (agg);
+  GstMessage *msg = NULL;
+  GstFlowReturn ret;
+
+  /* subclasses that finish mixing in finish_buffer chain up after that, so
+   * the complete output is measured here */
+  GST_AUDIO_AGGREGATOR_LOCK (aagg);
+  if (aagg->priv->loudness_interval > 0)
+    msg = gst_audio_aggregator_measure_loudness (aagg, buffer);
+  GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
+
+  ret =
+      GST_AGGREGATOR_CLASS (gst_audio_aggregator_parent_class)->finish_buffer
+      (agg, buffer);
+
+  if (msg)
+    gst_element_post_message (GST_ELEMENT (aagg), msg);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 {
@@ -2299,7 +2762,11 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
     /* New buffer? */
     if (!pad->priv->buffer) {
-      if (GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer)
+      pad->priv->unconverted = FALSE;
+      if (gst_audio_aggregator_pad_converts_lazily (pad)) {
+        pad->priv->buffer = gst_buffer_ref (input_buffer);
+        pad->priv->unconverted = TRUE;
+      } else if (GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer)
         pad->priv->buffer =
             gst_audio_aggregator_convert_buffer
             (aagg, GST_PAD (pad), &pad->info, &srcpad->info, input_buffer);
@@ -2388,6 +2855,7 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
       gboolean drop_buf;
 
       GST_LOG_OBJECT (aggpad, "Mixing buffer for current offset");
+      gst_audio_aggregator_pad_convert_pending (aagg, pad);
       drop_buf = !gst_audio_aggregator_mix_buffer (aagg, pad, pad->priv->buffer,
           outbuf, blocksize);
       if (pad->priv->output_offset >= next_offset) {
@@ -38,6 +38,7 @@
 
 #include <gst/audio/audio.h>
 #include "gstaudiobasesink.h"
+#include "gstaudioutilsprivate.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_audio_base_sink_debug);
 #define GST_CAT_DEFAULT gst_audio_base_sink_debug
@@ -75,6 +76,18 @@ struct _GstAudioBaseSinkPrivate
   GstAudioBaseSinkCustomSlavingCallback custom_slaving_callback;
   gpointer custom_slaving_cb_data;
   GDestroyNotify custom_slaving_cb_notify;
+
+  /* wait for segments without the ringbuffer object lock */
+  gboolean lock_free;
+
+  /* write parts of segments as soon as they are committed */
+  gboolean low_latency;
+  /* latency on top of the device delay in parts of a segment, grows with
+   * every underrun. With LOCK */
+  guint low_latency_slack;
+  guint low_latency_underruns;
+  /* the device delay we reported latency for. With LOCK */
+  GstClockTime low_latency_device_delay;
 };
 
 /* BaseAudioSink signals and args */
@@ -105,6 +118,9 @@ enum
  * fix itself, or is a permanent offset */
 #define DEFAULT_DISCONT_WAIT        (1 * GST_SECOND)
 
+#define DEFAULT_LOCK_FREE           FALSE
+#define DEFAULT_LOW_LATENCY         FALSE
+
 enum
 {
   PROP_0,
@@ -117,6 +133,9 @@ enum
   PROP_ALIGNMENT_THRESHOLD,
   PROP_DRIFT_TOLERANCE,
   PROP_DISCONT_WAIT,
+  PROP_LOCK_FREE,
+  PROP_RINGBUFFER_STATS,
+  PROP_LOW_LATENCY,
 
   PROP_LAST
 };
@@ -247,6 +266,53 @@ gst_audio_base_sink_class_init (GstAudioBaseSinkClass * klass)
           G_MAXUINT64 - 1, DEFAULT_DISCONT_WAIT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioBaseSink:lock-free:
+   *
+   * Wait for free segments of the ringbuffer without taking its object lock,
+   * see gst_audio_ring_buffer_set_lock_free().
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_LOCK_FREE,
+      g_param_spec_boolean ("lock-free", "Lock Free",
+          "Synchronize with the audio device thread without taking the "
+          "ringbuffer lock", DEFAULT_LOCK_FREE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSink:ringbuffer-stats:
+   *
+   * Timing statistics of the audio device thread, see
+   * gst_audio_ring_buffer_get_stats().
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_RINGBUFFER_STATS,
+      g_param_spec_boxed ("ringbuffer-stats", "Ringbuffer Statistics",
+          "Wakeup times and jitter of the audio device thread",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSink:low-latency:
+   *
+   * Write the data to the device as soon as it is rendered instead of one
+   * segment at a time, and report the measured device delay plus some
+   * headroom as latency instead of the size of the ringbuffer. The headroom
+   * starts at a quarter of a segment and grows every time the device runs
+   * out of data, up to the complete ringbuffer.
+   *
+   * Only subclasses of #GstAudioSink that implement the delay vmethod
+   * measure their delay. Changes take effect with the next caps.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_LOW_LATENCY,
+      g_param_spec_boolean ("low-latency", "Low Latency",
+          "Write partial segments to the device and report the measured "
+          "latency", DEFAULT_LOW_LATENCY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_base_sink_change_state);
   gstelement_class->provide_clock =
@@ -290,6 +356,10 @@ gst_audio_base_sink_init (GstAudioBaseSink * audiobasesink)
   audiobasesink->priv->custom_slaving_callback = NULL;
   audiobasesink->priv->custom_slaving_cb_data = NULL;
   audiobasesink->priv->custom_slaving_cb_notify = NULL;
+  audiobasesink->priv->lock_free = DEFAULT_LOCK_FREE;
+  audiobasesink->priv->low_latency = DEFAULT_LOW_LATENCY;
+  audiobasesink->priv->low_latency_slack = 1;
+  audiobasesink->priv->low_latency_device_delay = GST_CLOCK_TIME_NONE;
 
   audiobasesink->provided_clock = gst_audio_clock_new ("GstAudioSinkClock",
       (GstAudioClockGetTimeFunc) gst_audio_base_sink_get_time, audiobasesink,
@@ -452,6 +522,26 @@ gst_audio_base_sink_query (GstElement * element, GstQuery * query)
           base_latency =
               gst_util_uint64_scale_int (spec->seglatency * spec->segsize,
               GST_SECOND, spec->info.rate * spec->info.bpf);
+
+          /* in low-latency mode we report what we measured once we have
+           * measured something */
+          if (__gst_audio_ring_buffer_get_low_latency (basesink->ringbuffer)
+              && GST_CLOCK_TIME_IS_VALID (basesink->priv->
+                  low_latency_device_delay)) {
+            GstClockTime headroom;
+
+            headroom = gst_util_uint64_scale_int (spec->segsize *
+                basesink->priv->low_latency_slack, GST_SECOND,
+                spec->info.rate * spec->info.bpf *
+                __GST_AUDIO_LOW_LATENCY_SUBSEGMENTS);
+            base_latency = MIN (base_latency,
+                basesink->priv->low_latency_device_delay + headroom);
+
+            GST_DEBUG_OBJECT (basesink, "measured device delay %"
+                GST_TIME_FORMAT ", headroom %" GST_TIME_FORMAT,
+                GST_TIME_ARGS (basesink->priv->low_latency_device_delay),
+                GST_TIME_ARGS (headroom));
+          }
           GST_OBJECT_UNLOCK (basesink);
 
           /* we cannot go lower than the buffer size and the min peer latency */
@@ -856,6 +946,19 @@ gst_audio_base_sink_set_property (GObject * object, guint prop_id,
     case PROP_DISCONT_WAIT:
       gst_audio_base_sink_set_discont_wait (sink, g_value_get_uint64 (value));
       break;
+    case PROP_LOCK_FREE:
+      GST_OBJECT_LOCK (sink);
+      sink->priv->lock_free = g_value_get_boolean (value);
+      if (sink->ringbuffer)
+        gst_audio_ring_buffer_set_lock_free (sink->ringbuffer,
+            sink->priv->lock_free);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (sink);
+      sink->priv->low_latency = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -896,6 +999,25 @@ gst_audio_base_sink_get_property (GObject * object, guint prop_id,
     case PROP_DISCONT_WAIT:
       g_value_set_uint64 (value, gst_audio_base_sink_get_discont_wait (sink));
       break;
+    case PROP_LOCK_FREE:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_boolean (value, sink->priv->lock_free);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_RINGBUFFER_STATS:
+      GST_OBJECT_LOCK (sink);
+      if (sink->ringbuffer)
+        g_value_take_boxed (value,
+            gst_audio_ring_buffer_get_stats (sink->ringbuffer));
+      else
+        g_value_set_boxed (value, NULL);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_boolean (value, sink->priv->low_latency);
+      GST_OBJECT_UNLOCK (sink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -948,6 +1070,14 @@ gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
 
   gst_audio_ring_buffer_debug_spec_buff (spec);
 
+  GST_OBJECT_LOCK (sink);
+  __gst_audio_ring_buffer_set_low_latency (sink->ringbuffer,
+      sink->priv->low_latency);
+  sink->priv->low_latency_slack = 1;
+  sink->priv->low_latency_underruns = 0;
+  sink->priv->low_latency_device_delay = GST_CLOCK_TIME_NONE;
+  GST_OBJECT_UNLOCK (sink);
+
   GST_DEBUG_OBJECT (sink, "acquire ringbuffer");
   if (!gst_audio_ring_buffer_acquire (sink->ringbuffer, spec))
     goto acquire_error;
@@ -1796,6 +1926,50 @@ gst_audio_base_sink_get_alignment (GstAudioBaseSink * sink,
   return align;
 }
 
+/* Adapt the latency we report in low-latency mode to the measured device
+ * delay and add more headroom after the device ran out of data */
+static void
+gst_audio_base_sink_update_low_latency (GstAudioBaseSink * sink)
+{
+  GstAudioRingBuffer *ringbuf = sink->ringbuffer;
+  GstClockTime device_delay, subsegment;
+  guint underruns, max_slack;
+  gboolean changed = FALSE;
+
+  underruns = __gst_audio_ring_buffer_get_underruns (ringbuf);
+  device_delay = __gst_audio_ring_buffer_get_device_delay (ringbuf);
+  max_slack = ringbuf->spec.segtotal * __GST_AUDIO_LOW_LATENCY_SUBSEGMENTS;
+  subsegment = gst_util_uint64_scale_int (ringbuf->spec.segsize, GST_SECOND,
+      ringbuf->spec.info.rate * ringbuf->spec.info.bpf *
+      __GST_AUDIO_LOW_LATENCY_SUBSEGMENTS);
+
+  GST_OBJECT_LOCK (sink);
+  if (underruns != sink->priv->low_latency_underruns) {
+    sink->priv->low_latency_underruns = underruns;
+    if (sink->priv->low_latency_slack < max_slack) {
+      sink->priv->low_latency_slack++;
+      GST_INFO_OBJECT (sink, "%u underruns, increasing headroom to %u",
+          underruns, sink->priv->low_latency_slack);
+      changed = TRUE;
+    }
+  }
+
+  /* only report bigger delays when they matter */
+  if (GST_CLOCK_TIME_IS_VALID (device_delay) &&
+      (!GST_CLOCK_TIME_IS_VALID (sink->priv->low_latency_device_delay) ||
+          device_delay > sink->priv->low_latency_device_delay + subsegment)) {
+    GST_INFO_OBJECT (sink, "measured device delay %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (device_delay));
+    sink->priv->low_latency_device_delay = device_delay;
+    changed = TRUE;
+  }
+  GST_OBJECT_UNLOCK (sink);
+
+  if (changed)
+    gst_element_post_message (GST_ELEMENT_CAST (sink),
+        gst_message_new_latency (GST_OBJECT_CAST (sink)));
+}
+
 static GstFlowReturn
 gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
 {
@@ -1830,6 +2004,9 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
   if (G_UNLIKELY (!gst_audio_ring_buffer_is_acquired (ringbuf)))
     goto wrong_state;
 
+  if (G_UNLIKELY (__gst_audio_ring_buffer_get_low_latency (ringbuf)))
+    gst_audio_base_sink_update_low_latency (sink);
+
   /* Wait for upstream latency before starting the ringbuffer, we do this so
    * that we can align the first sample of the ringbuffer to the base_time +
    * latency. */
@@ -2410,6 +2587,7 @@ gst_audio_base_sink_change_state (GstElement * element,
 
       GST_OBJECT_LOCK (sink);
       sink->ringbuffer = rb;
+      gst_audio_ring_buffer_set_lock_free (rb, sink->priv->lock_free);
       GST_OBJECT_UNLOCK (sink);
 
       if (!gst_audio_ring_buffer_open_device (sink->ringbuffer)) {
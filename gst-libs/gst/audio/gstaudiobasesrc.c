@@ -49,6 +49,9 @@ struct _GstAudioBaseSrcPrivate
 {
   /* the clock slaving algorithm in use */
   GstAudioBaseSrcSlaveMethod slave_method;
+
+  /* wait for segments without the ringbuffer object lock */
+  gboolean lock_free;
 };
 
 /* BaseAudioSrc signals and args */
@@ -65,6 +68,7 @@ enum
 #define DEFAULT_ACTUAL_LATENCY_TIME    -1
 #define DEFAULT_PROVIDE_CLOCK   TRUE
 #define DEFAULT_SLAVE_METHOD    GST_AUDIO_BASE_SRC_SLAVE_SKEW
+#define DEFAULT_LOCK_FREE       FALSE
 
 enum
 {
@@ -75,6 +79,8 @@ enum
   PROP_ACTUAL_LATENCY_TIME,
   PROP_PROVIDE_CLOCK,
   PROP_SLAVE_METHOD,
+  PROP_LOCK_FREE,
+  PROP_RINGBUFFER_STATS,
   PROP_LAST
 };
 
@@ -189,6 +195,33 @@ gst_audio_base_src_class_init (GstAudioBaseSrcClass * klass)
           GST_TYPE_AUDIO_BASE_SRC_SLAVE_METHOD, DEFAULT_SLAVE_METHOD,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioBaseSrc:lock-free:
+   *
+   * Wait for filled segments of the ringbuffer without taking its object lock,
+   * see gst_audio_ring_buffer_set_lock_free().
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_LOCK_FREE,
+      g_param_spec_boolean ("lock-free", "Lock Free",
+          "Synchronize with the audio device thread without taking the "
+          "ringbuffer lock", DEFAULT_LOCK_FREE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioBaseSrc:ringbuffer-stats:
+   *
+   * Timing statistics of the audio device thread, see
+   * gst_audio_ring_buffer_get_stats().
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_RINGBUFFER_STATS,
+      g_param_spec_boxed ("ringbuffer-stats", "Ringbuffer Statistics",
+          "Wakeup times and jitter of the audio device thread",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_base_src_change_state);
   gstelement_class->provide_clock =
@@ -222,6 +255,7 @@ gst_audio_base_src_init (GstAudioBaseSrc * audiobasesrc)
   else
     GST_OBJECT_FLAG_UNSET (audiobasesrc, GST_ELEMENT_FLAG_PROVIDE_CLOCK);
   audiobasesrc->priv->slave_method = DEFAULT_SLAVE_METHOD;
+  audiobasesrc->priv->lock_free = DEFAULT_LOCK_FREE;
   /* reset blocksize we use latency time to calculate a more useful
    * value based on negotiated format. */
   GST_BASE_SRC (audiobasesrc)->blocksize = 0;
@@ -440,6 +474,14 @@ gst_audio_base_src_set_property (GObject * object, guint prop_id,
     case PROP_SLAVE_METHOD:
       gst_audio_base_src_set_slave_method (src, g_value_get_enum (value));
       break;
+    case PROP_LOCK_FREE:
+      GST_OBJECT_LOCK (src);
+      src->priv->lock_free = g_value_get_boolean (value);
+      if (src->ringbuffer)
+        gst_audio_ring_buffer_set_lock_free (src->ringbuffer,
+            src->priv->lock_free);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -483,6 +525,20 @@ gst_audio_base_src_get_property (GObject * object, guint prop_id,
     case PROP_SLAVE_METHOD:
       g_value_set_enum (value, gst_audio_base_src_get_slave_method (src));
       break;
+    case PROP_LOCK_FREE:
+      GST_OBJECT_LOCK (src);
+      g_value_set_boolean (value, src->priv->lock_free);
+      GST_OBJECT_UNLOCK (src);
+      break;
+    case PROP_RINGBUFFER_STATS:
+      GST_OBJECT_LOCK (src);
+      if (src->ringbuffer)
+        g_value_take_boxed (value,
+            gst_audio_ring_buffer_get_stats (src->ringbuffer));
+      else
+        g_value_set_boxed (value, NULL);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1123,6 +1179,7 @@ gst_audio_base_src_change_state (GstElement * element,
 
       GST_OBJECT_LOCK (src);
       src->ringbuffer = rb;
+      gst_audio_ring_buffer_set_lock_free (rb, src->priv->lock_free);
       GST_OBJECT_UNLOCK (src);
 
       if (!gst_audio_ring_buffer_open_device (src->ringbuffer)) {
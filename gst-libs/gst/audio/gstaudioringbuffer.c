@@ -38,13 +38,50 @@
 #endif
 
 #include <string.h>
+#include <math.h>
 
 #include <gst/audio/audio.h>
 #include "gstaudioringbuffer.h"
+#include "gstaudioutilsprivate.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_audio_ring_buffer_debug);
 #define GST_CAT_DEFAULT gst_audio_ring_buffer_debug
 
+/* number of period wakeup times that are kept for the stats */
+#define STATS_HISTORY 64
+
+struct _GstAudioRingBufferPrivate
+{
+  /* ATOMIC, readers and writers wait without the object lock */
+  gint lock_free;
+  /* ATOMIC, number of threads waiting on wait_cond */
+  gint waiters;
+  GMutex wait_lock;
+  GCond wait_cond;
+
+  /* period statistics, the thread that advances the ringbuffer never
+   * blocks on stats_lock but skips the update instead */
+  GMutex stats_lock;
+  GstClockTime last_wakeup;
+  gint last_segdone;
+  guint64 periods;
+  guint64 skipped;
+  GstClockTime min_interval;
+  GstClockTime max_interval;
+  GstClockTime total_interval;
+  GstClockTime max_jitter;
+  gdouble jitter_sq_sum;
+  GstClockTime wakeups[STATS_HISTORY];
+
+  /* low-latency mode, ATOMIC */
+  gint low_latency;
+  /* end of the committed samples, counted from segment 0 of segdone */
+  gint committed;
+  gint underruns;
+  /* largest device delay after a write, with stats_lock */
+  GstClockTime device_delay;
+};
+
 static void gst_audio_ring_buffer_dispose (GObject * object);
 static void gst_audio_ring_buffer_finalize (GObject * object);
 
@@ -54,9 +91,28 @@ static guint default_commit (GstAudioRingBuffer * buf, guint64 * sample,
     guint8 * data, gint in_samples, gint out_samples, gint * accum);
 
 /* ringbuffer abstract base class */
-G_DEFINE_ABSTRACT_TYPE (GstAudioRingBuffer, gst_audio_ring_buffer,
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstAudioRingBuffer, gst_audio_ring_buffer,
     GST_TYPE_OBJECT);
 
+static void
+reset_stats (GstAudioRingBuffer * buf)
+{
+  GstAudioRingBufferPrivate *priv = buf->priv;
+
+  priv->last_wakeup = GST_CLOCK_TIME_NONE;
+  priv->last_segdone = 0;
+  priv->periods = 0;
+  priv->skipped = 0;
+  priv->min_interval = GST_CLOCK_TIME_NONE;
+  priv->max_interval = 0;
+  priv->total_interval = 0;
+  priv->max_jitter = 0;
+  priv->jitter_sq_sum = 0.0;
+  memset (priv->wakeups, 0, sizeof (priv->wakeups));
+  priv->device_delay = GST_CLOCK_TIME_NONE;
+  g_atomic_int_set (&priv->underruns, 0);
+}
+
 static void
 gst_audio_ring_buffer_class_init (GstAudioRingBufferClass * klass)
 {
@@ -88,6 +144,12 @@ gst_audio_ring_buffer_init (GstAudioRingBuffer * ringbuffer)
   ringbuffer->flushing = TRUE;
   ringbuffer->segbase = 0;
   ringbuffer->segdone = 0;
+
+  ringbuffer->priv = gst_audio_ring_buffer_get_instance_private (ringbuffer);
+  g_mutex_init (&ringbuffer->priv->wait_lock);
+  g_cond_init (&ringbuffer->priv->wait_cond);
+  g_mutex_init (&ringbuffer->priv->stats_lock);
+  reset_stats (ringbuffer);
 }
 
 static void
@@ -107,6 +169,9 @@ gst_audio_ring_buffer_finalize (GObject * object)
   GstAudioRingBuffer *ringbuffer = GST_AUDIO_RING_BUFFER (object);
 
   g_cond_clear (&ringbuffer->cond);
+  g_mutex_clear (&ringbuffer->priv->wait_lock);
+  g_cond_clear (&ringbuffer->priv->wait_cond);
+  g_mutex_clear (&ringbuffer->priv->stats_lock);
   g_free (ringbuffer->empty_seg);
 
   if (ringbuffer->cb_data_notify != NULL)
@@ -116,6 +181,19 @@ gst_audio_ring_buffer_finalize (GObject * object)
       (ringbuffer));
 }
 
+/* wake up the readers and writers that wait without the object lock */
+static void
+wake_waiters (GstAudioRingBuffer * buf)
+{
+  GstAudioRingBufferPrivate *priv = buf->priv;
+
+  if (g_atomic_int_get (&priv->waiters) > 0) {
+    g_mutex_lock (&priv->wait_lock);
+    g_cond_broadcast (&priv->wait_cond);
+    g_mutex_unlock (&priv->wait_lock);
+  }
+}
+
 #ifndef GST_DISABLE_GST_DEBUG
 static const gchar *format_type_names[] = {
   "raw",
@@ -651,6 +729,11 @@ gst_audio_ring_buffer_acquire (GstAudioRingBuffer * buf,
 
   buf->samples_per_seg = segsize / bpf;
 
+  g_mutex_lock (&buf->priv->stats_lock);
+  reset_stats (buf);
+  g_mutex_unlock (&buf->priv->stats_lock);
+  g_atomic_int_set (&buf->priv->committed, 0);
+
   /* create an empty segment */
   g_free (buf->empty_seg);
   buf->empty_seg = g_malloc (segsize);
@@ -746,6 +829,7 @@ gst_audio_ring_buffer_release (GstAudioRingBuffer * buf)
   /* signal any waiters */
   GST_DEBUG_OBJECT (buf, "signal waiter");
   GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  wake_waiters (buf);
 
   if (G_UNLIKELY (!res))
     goto release_failed;
@@ -914,6 +998,7 @@ gst_audio_ring_buffer_set_flushing (GstAudioRingBuffer * buf, gboolean flushing)
 
   if (flushing) {
     gst_audio_ring_buffer_pause_unlocked (buf);
+    wake_waiters (buf);
   } else {
     gst_audio_ring_buffer_clear_all (buf);
   }
@@ -995,6 +1080,11 @@ gst_audio_ring_buffer_start (GstAudioRingBuffer * buf)
     GST_DEBUG_OBJECT (buf, "resuming");
   }
 
+  /* the time we were not running does not count as a period */
+  g_mutex_lock (&buf->priv->stats_lock);
+  buf->priv->last_wakeup = GST_CLOCK_TIME_NONE;
+  g_mutex_unlock (&buf->priv->stats_lock);
+
   rclass = GST_AUDIO_RING_BUFFER_GET_CLASS (buf);
   if (resume) {
     if (G_LIKELY (rclass->resume))
@@ -1054,6 +1144,7 @@ gst_audio_ring_buffer_pause_unlocked (GstAudioRingBuffer * buf)
   /* signal any waiters */
   GST_DEBUG_OBJECT (buf, "signal waiter");
   GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  wake_waiters (buf);
 
   rclass = GST_AUDIO_RING_BUFFER_GET_CLASS (buf);
   if (G_LIKELY (rclass->pause))
@@ -1163,6 +1254,7 @@ gst_audio_ring_buffer_stop (GstAudioRingBuffer * buf)
   /* signal any waiters */
   GST_DEBUG_OBJECT (buf, "signal waiter");
   GST_AUDIO_RING_BUFFER_SIGNAL (buf);
+  wake_waiters (buf);
 
   rclass = GST_AUDIO_RING_BUFFER_GET_CLASS (buf);
   if (G_LIKELY (rclass->stop))
@@ -1285,6 +1377,10 @@ gst_audio_ring_buffer_set_sample (GstAudioRingBuffer * buf, guint64 sample)
    * offset when calculating the processed samples. */
   buf->segbase = buf->segdone - sample / buf->samples_per_seg;
 
+  /* nothing was committed at the new position yet */
+  g_atomic_int_set (&buf->priv->committed,
+      (guint) g_atomic_int_get (&buf->segdone) * buf->samples_per_seg);
+
   gst_audio_ring_buffer_clear_all (buf);
 
   GST_DEBUG_OBJECT (buf, "set sample to %" G_GUINT64_FORMAT ", segbase %d",
@@ -1334,9 +1430,46 @@ gst_audio_ring_buffer_clear_all (GstAudioRingBuffer * buf)
     rclass->clear_all (buf);
 }
 
+/* wait until segdone is different from @segdone, without taking the object
+ * lock. The thread that advances the ringbuffer only takes wait_lock when
+ * there are waiters. */
+static gboolean
+wait_segment_lock_free (GstAudioRingBuffer * buf, gint segdone)
+{
+  GstAudioRingBufferPrivate *priv = buf->priv;
+  gboolean res;
+
+  g_mutex_lock (&priv->wait_lock);
+  /* announce ourselves before checking the counter, advance does it the
+   * other way around so one of us sees the other */
+  g_atomic_int_inc (&priv->waiters);
+  while (TRUE) {
+    if (G_UNLIKELY (g_atomic_int_get (&buf->flushing))) {
+      GST_DEBUG_OBJECT (buf, "flushing");
+      res = FALSE;
+      break;
+    }
+    if (G_UNLIKELY (g_atomic_int_get (&buf->state) !=
+            GST_AUDIO_RING_BUFFER_STATE_STARTED)) {
+      GST_DEBUG_OBJECT (buf, "stopped processing");
+      res = FALSE;
+      break;
+    }
+    if (g_atomic_int_get (&buf->segdone) != segdone) {
+      res = TRUE;
+      break;
+    }
+    GST_LOG_OBJECT (buf, "waiting..");
+    g_cond_wait (&priv->wait_cond, &priv->wait_lock);
+  }
+  g_atomic_int_add (&priv->waiters, -1);
+  g_mutex_unlock (&priv->wait_lock);
+
+  return res;
+}
 
 static gboolean
-wait_segment (GstAudioRingBuffer * buf)
+wait_segment (GstAudioRingBuffer * buf, gint segdone)
 {
   gint segments;
   gboolean wait = TRUE;
@@ -1358,6 +1491,9 @@ wait_segment (GstAudioRingBuffer * buf)
       wait = FALSE;
   }
 
+  if (g_atomic_int_get (&buf->priv->lock_free))
+    return wait_segment_lock_free (buf, segdone);
+
   /* take lock first, then update our waiting flag */
   GST_OBJECT_LOCK (buf);
   if (G_UNLIKELY (buf->flushing))
@@ -1597,7 +1733,7 @@ default_commit (GstAudioRingBuffer * buf, guint64 * sample,
       }
 
       /* else we need to wait for the segment to become writable. */
-      if (!wait_segment (buf))
+      if (!wait_segment (buf, segdone + buf->segbase))
         goto not_started;
     }
 
@@ -1654,6 +1790,14 @@ default_commit (GstAudioRingBuffer * buf, guint64 * sample,
       }
     }
 
+    /* in low-latency mode the device thread writes out what we committed
+     * without waiting for the end of the segment */
+    if (G_UNLIKELY (g_atomic_int_get (&buf->priv->low_latency))) {
+      g_atomic_int_set (&buf->priv->committed,
+          (guint) (writeseg + buf->segbase) * sps + (sampleoff + avail) / bpf);
+      wake_waiters (buf);
+    }
+
     /* for the next iteration we write to the next segment at the beginning. */
     writeseg++;
     sampleoff = 0;
@@ -1813,7 +1957,7 @@ gst_audio_ring_buffer_read (GstAudioRingBuffer * buf, guint64 sample,
         break;
 
       /* else we need to wait for the segment to become readable. */
-      if (!wait_segment (buf))
+      if (!wait_segment (buf, segdone + buf->segbase))
         goto not_started;
     }
 
@@ -1918,6 +2062,48 @@ gst_audio_ring_buffer_prepare_read (GstAudioRingBuffer * buf, gint * segment,
   return TRUE;
 }
 
+/* record the wakeup time of the thread that advances the ringbuffer */
+static void
+update_stats (GstAudioRingBuffer * buf)
+{
+  GstAudioRingBufferPrivate *priv = buf->priv;
+  GstClockTime now, interval, expected, jitter;
+  gint segdone;
+
+  if (G_UNLIKELY (buf->spec.info.rate == 0))
+    return;
+
+  now = gst_util_get_timestamp ();
+  segdone = g_atomic_int_get (&buf->segdone);
+
+  /* never block the device thread, skip this period instead */
+  if (!g_mutex_trylock (&priv->stats_lock))
+    return;
+
+  if (GST_CLOCK_TIME_IS_VALID (priv->last_wakeup)) {
+    interval = now - priv->last_wakeup;
+    expected = gst_util_uint64_scale_int ((guint64) (segdone -
+            priv->last_segdone) * buf->samples_per_seg, GST_SECOND,
+        buf->spec.info.rate);
+    jitter = interval > expected ? interval - expected : expected - interval;
+
+    if (segdone - priv->last_segdone > 1)
+      priv->skipped += segdone - priv->last_segdone - 1;
+
+    priv->wakeups[priv->periods % STATS_HISTORY] = now;
+    priv->periods++;
+    priv->min_interval = MIN (priv->min_interval, interval);
+    priv->max_interval = MAX (priv->max_interval, interval);
+    priv->total_interval += interval;
+    priv->max_jitter = MAX (priv->max_jitter, jitter);
+    priv->jitter_sq_sum += (gdouble) jitter * jitter;
+  }
+  priv->last_wakeup = now;
+  priv->last_segdone = segdone;
+
+  g_mutex_unlock (&priv->stats_lock);
+}
+
 /**
  * gst_audio_ring_buffer_advance:
  * @buf: the #GstAudioRingBuffer to advance
@@ -1936,6 +2122,8 @@ gst_audio_ring_buffer_advance (GstAudioRingBuffer * buf, guint advance)
   /* update counter */
   g_atomic_int_add (&buf->segdone, advance);
 
+  update_stats (buf);
+
   /* the lock is already taken when the waiting flag is set,
    * we grab the lock as well to make sure the waiter is actually
    * waiting for the signal */
@@ -1945,6 +2133,9 @@ gst_audio_ring_buffer_advance (GstAudioRingBuffer * buf, guint advance)
     GST_AUDIO_RING_BUFFER_SIGNAL (buf);
     GST_OBJECT_UNLOCK (buf);
   }
+
+  /* waiters in lock-free mode */
+  wake_waiters (buf);
 }
 
 /**
@@ -2109,3 +2300,249 @@ not_acquired:
     goto done;
   }
 }
+
+/**
+ * gst_audio_ring_buffer_set_lock_free:
+ * @buf: the #GstAudioRingBuffer
+ * @lock_free: the new value
+ *
+ * Make gst_audio_ring_buffer_commit() and gst_audio_ring_buffer_read()
+ * wait for free or filled segments without taking the object lock of @buf.
+ * The thread that calls gst_audio_ring_buffer_advance() then only
+ * synchronizes with the single reader or writer instead of with everybody
+ * that uses the object lock, which avoids priority inversion with small
+ * segments. The object lock is still used for state changes.
+ *
+ * This can be changed at any time.
+ *
+ * MT safe.
+ *
+ * Since: 1.20
+ */
+void
+gst_audio_ring_buffer_set_lock_free (GstAudioRingBuffer * buf,
+    gboolean lock_free)
+{
+  g_return_if_fail (GST_IS_AUDIO_RING_BUFFER (buf));
+
+  GST_DEBUG_OBJECT (buf, "lock free %d", lock_free);
+
+  g_atomic_int_set (&buf->priv->lock_free, lock_free);
+}
+
+/**
+ * gst_audio_ring_buffer_get_lock_free:
+ * @buf: the #GstAudioRingBuffer
+ *
+ * Check if @buf waits for segments without taking the object lock.
+ *
+ * Returns: %TRUE if lock-free waiting is enabled.
+ *
+ * MT safe.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_audio_ring_buffer_get_lock_free (GstAudioRingBuffer * buf)
+{
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), FALSE);
+
+  return g_atomic_int_get (&buf->priv->lock_free);
+}
+
+/**
+ * gst_audio_ring_buffer_get_stats:
+ * @buf: the #GstAudioRingBuffer
+ *
+ * Get statistics about the times at which segments were processed by the
+ * device, as measured with gst_util_get_timestamp() in
+ * gst_audio_ring_buffer_advance(). The statistics are reset when @buf is
+ * acquired.
+ *
+ * The returned structure is named "GstAudioRingBufferStats" and contains:
+ *
+ * * "periods" G_TYPE_UINT64: number of measured wakeups
+ * * "skipped-periods" G_TYPE_UINT64: number of segments that were advanced
+ *   without a wakeup of their own
+ * * "period" G_TYPE_UINT64: the duration of a segment in nanoseconds
+ * * "min-interval", "max-interval", "mean-interval" G_TYPE_UINT64: the time
+ *   between wakeups in nanoseconds
+ * * "max-jitter", "rms-jitter" G_TYPE_UINT64: the difference between the
+ *   time between wakeups and the duration of the processed segments in
+ *   nanoseconds
+ * * "wakeups" GST_TYPE_ARRAY: the times of the most recent wakeups in
+ *   nanoseconds, oldest first
+ * * "underruns" G_TYPE_UINT: number of times the device had to be given
+ *   data before it was committed, only counted in low-latency mode
+ * * "device-delay" G_TYPE_UINT64: the largest delay of the device after a
+ *   write in nanoseconds, only measured in low-latency mode,
+ *   GST_CLOCK_TIME_NONE otherwise
+ *
+ * Returns: (transfer full): a #GstStructure with the statistics.
+ *
+ * MT safe.
+ *
+ * Since: 1.20
+ */
+GstStructure *
+gst_audio_ring_buffer_get_stats (GstAudioRingBuffer * buf)
+{
+  GstAudioRingBufferPrivate *priv;
+  GstStructure *s;
+  GValue wakeups = G_VALUE_INIT;
+  GValue v = G_VALUE_INIT;
+  GstClockTime period = 0, mean = 0, rms = 0;
+  guint64 i, first;
+
+  g_return_val_if_fail (GST_IS_AUDIO_RING_BUFFER (buf), NULL);
+
+  priv = buf->priv;
+
+  gst_value_array_init (&wakeups, STATS_HISTORY);
+  g_value_init (&v, G_TYPE_UINT64);
+
+  g_mutex_lock (&priv->stats_lock);
+  if (buf->spec.info.rate > 0)
+    period = gst_util_uint64_scale_int (buf->samples_per_seg, GST_SECOND,
+        buf->spec.info.rate);
+  if (priv->periods > 0) {
+    mean = priv->total_interval / priv->periods;
+    rms = sqrt (priv->jitter_sq_sum / priv->periods);
+  }
+
+  first = priv->periods > STATS_HISTORY ? priv->periods - STATS_HISTORY : 0;
+  for (i = first; i < priv->periods; i++) {
+    g_value_set_uint64 (&v, priv->wakeups[i % STATS_HISTORY]);
+    gst_value_array_append_value (&wakeups, &v);
+  }
+
+  s = gst_structure_new ("GstAudioRingBufferStats",
+      "periods", G_TYPE_UINT64, priv->periods,
+      "skipped-periods", G_TYPE_UINT64, priv->skipped,
+      "period", G_TYPE_UINT64, period,
+      "min-interval", G_TYPE_UINT64,
+      priv->periods > 0 ? priv->min_interval : (GstClockTime) 0,
+      "max-interval", G_TYPE_UINT64, priv->max_interval,
+      "mean-interval", G_TYPE_UINT64, mean,
+      "max-jitter", G_TYPE_UINT64, priv->max_jitter,
+      "rms-jitter", G_TYPE_UINT64, rms,
+      "underruns", G_TYPE_UINT, g_atomic_int_get (&priv->underruns),
+      "device-delay", G_TYPE_UINT64, priv->device_delay, NULL);
+  g_mutex_unlock (&priv->stats_lock);
+
+  gst_structure_take_value (s, "wakeups", &wakeups);
+  g_value_unset (&v);
+
+  return s;
+}
+
+/* low-latency mode, used by GstAudioBaseSink and GstAudioSink */
+
+void
+__gst_audio_ring_buffer_set_low_latency (GstAudioRingBuffer * buf,
+    gboolean low_latency)
+{
+  GST_DEBUG_OBJECT (buf, "low latency %d", low_latency);
+
+  g_atomic_int_set (&buf->priv->low_latency, low_latency);
+}
+
+gboolean
+__gst_audio_ring_buffer_get_low_latency (GstAudioRingBuffer * buf)
+{
+  return g_atomic_int_get (&buf->priv->low_latency);
+}
+
+/* the number of bytes of @segment, counted like segdone, that were
+ * committed */
+static gint
+get_committed (GstAudioRingBuffer * buf, gint segment)
+{
+  gint committed;
+
+  committed = (gint) ((guint) g_atomic_int_get (&buf->priv->committed) -
+      (guint) segment * buf->samples_per_seg);
+  committed = CLAMP (committed, 0, buf->samples_per_seg);
+
+  return committed * buf->spec.info.bpf;
+}
+
+/* Wait until more than @have bytes of @segment were committed or until
+ * @end_time, in g_get_monotonic_time() units. Returns the number of
+ * committed bytes, which is @have on timeout, or -1 when the ringbuffer
+ * is not running anymore. */
+gint
+__gst_audio_ring_buffer_wait_committed (GstAudioRingBuffer * buf,
+    gint segment, gint have, gint64 end_time)
+{
+  GstAudioRingBufferPrivate *priv = buf->priv;
+  gint committed;
+
+  g_mutex_lock (&priv->wait_lock);
+  g_atomic_int_inc (&priv->waiters);
+  while (TRUE) {
+    if (G_UNLIKELY (g_atomic_int_get (&buf->flushing) ||
+            g_atomic_int_get (&buf->state) !=
+            GST_AUDIO_RING_BUFFER_STATE_STARTED)) {
+      committed = -1;
+      break;
+    }
+    committed = get_committed (buf, segment);
+    if (committed > have)
+      break;
+    if (!g_cond_wait_until (&priv->wait_cond, &priv->wait_lock, end_time)) {
+      committed = MAX (get_committed (buf, segment), have);
+      break;
+    }
+  }
+  g_atomic_int_add (&priv->waiters, -1);
+  g_mutex_unlock (&priv->wait_lock);
+
+  return committed;
+}
+
+/* called by the device thread after a write in low-latency mode, @delay is
+ * the number of frames queued in the device */
+void
+__gst_audio_ring_buffer_report_write (GstAudioRingBuffer * buf, guint delay,
+    gboolean underrun)
+{
+  GstAudioRingBufferPrivate *priv = buf->priv;
+  GstClockTime delay_time;
+
+  if (underrun)
+    g_atomic_int_inc (&priv->underruns);
+
+  if (G_UNLIKELY (buf->spec.info.rate == 0))
+    return;
+
+  delay_time = gst_util_uint64_scale_int (delay, GST_SECOND,
+      buf->spec.info.rate);
+
+  if (!g_mutex_trylock (&priv->stats_lock))
+    return;
+  if (!GST_CLOCK_TIME_IS_VALID (priv->device_delay)
+      || delay_time > priv->device_delay)
+    priv->device_delay = delay_time;
+  g_mutex_unlock (&priv->stats_lock);
+}
+
+guint
+__gst_audio_ring_buffer_get_underruns (GstAudioRingBuffer * buf)
+{
+  return g_atomic_int_get (&buf->priv->underruns);
+}
+
+/* the largest measured device delay or GST_CLOCK_TIME_NONE when nothing
+ * was measured yet */
+GstClockTime
+__gst_audio_ring_buffer_get_device_delay (GstAudioRingBuffer * buf)
+{
+  GstClockTime res;
+
+  g_mutex_lock (&buf->priv->stats_lock);
+  res = buf->priv->device_delay;
+  g_mutex_unlock (&buf->priv->stats_lock);
+
+  return res;
+}
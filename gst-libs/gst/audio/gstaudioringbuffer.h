@@ -40,6 +40,7 @@ G_BEGIN_DECLS
 typedef struct _GstAudioRingBuffer GstAudioRingBuffer;
 typedef struct _GstAudioRingBufferClass GstAudioRingBufferClass;
 typedef struct _GstAudioRingBufferSpec GstAudioRingBufferSpec;
+typedef struct _GstAudioRingBufferPrivate GstAudioRingBufferPrivate;
 
 /**
  * GstAudioRingBufferCallback:
@@ -216,7 +217,9 @@ struct _GstAudioRingBuffer {
   GDestroyNotify              cb_data_notify;
 
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING - 1];
+  GstAudioRingBufferPrivate  *priv;
+
+  gpointer _gst_reserved[GST_PADDING - 2];
 };
 
 /**
@@ -407,6 +410,19 @@ void            gst_audio_ring_buffer_advance         (GstAudioRingBuffer *buf,
 GST_AUDIO_API
 void            gst_audio_ring_buffer_may_start       (GstAudioRingBuffer *buf, gboolean allowed);
 
+/* lock-free waiting */
+
+GST_AUDIO_API
+void            gst_audio_ring_buffer_set_lock_free   (GstAudioRingBuffer *buf, gboolean lock_free);
+
+GST_AUDIO_API
+gboolean        gst_audio_ring_buffer_get_lock_free   (GstAudioRingBuffer *buf);
+
+/* statistics */
+
+GST_AUDIO_API
+GstStructure *  gst_audio_ring_buffer_get_stats       (GstAudioRingBuffer *buf);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstAudioRingBuffer, gst_object_unref)
 
 G_END_DECLS
@@ -191,6 +191,98 @@ gst_audio_sink_ring_buffer_class_init (GstAudioSinkRingBufferClass * klass)
 
 typedef gint (*WriteFunc) (GstAudioSink * sink, gpointer data, guint length);
 
+/* write @len bytes of @readptr to the device, returns FALSE when not all data
+ * could be written */
+static gboolean
+audioringbuffer_write (GstAudioSink * sink, GstAudioRingBuffer * buf,
+    WriteFunc writefunc, guint8 * readptr, gint len, gint readseg)
+{
+  gint left, written;
+
+  left = len;
+  do {
+    written = writefunc (sink, readptr, left);
+    GST_LOG_OBJECT (sink, "transferred %d bytes of %d from segment %d",
+        written, left, readseg);
+    if (written < 0 || written > left) {
+      /* might not be critical, it e.g. happens when aborting playback */
+      GST_WARNING_OBJECT (sink,
+          "error writing data in %s (reason: %s), skipping segment (left: %d, written: %d)",
+          GST_DEBUG_FUNCPTR_NAME (writefunc),
+          (errno > 1 ? g_strerror (errno) : "unknown"), left, written);
+      return FALSE;
+    } else if (written == 0 && G_UNLIKELY (g_atomic_int_get (&buf->state) !=
+            GST_AUDIO_RING_BUFFER_STATE_STARTED)) {
+      return FALSE;
+    }
+    left -= written;
+    readptr += written;
+  } while (left > 0);
+
+  return TRUE;
+}
+
+/* In low-latency mode the committed part of the segment is written as soon
+ * as it is available instead of waiting for the complete segment. When
+ * nothing new was committed by the time the device is about to run out of
+ * data, a part of the segment is written anyway, which is counted as an
+ * underrun. */
+static void
+audioringbuffer_write_low_latency (GstAudioSink * sink,
+    GstAudioRingBuffer * buf, WriteFunc writefunc, guint8 * readptr, gint len,
+    gint readseg)
+{
+  GstAudioSinkClass *csink = GST_AUDIO_SINK_GET_CLASS (sink);
+  gint segdone, bpf, chunk, done, committed;
+  GstClockTime chunk_time;
+
+  segdone = g_atomic_int_get (&buf->segdone);
+  bpf = buf->spec.info.bpf;
+  chunk = MAX (len / __GST_AUDIO_LOW_LATENCY_SUBSEGMENTS / bpf, 1) * bpf;
+  chunk_time = gst_util_uint64_scale_int (chunk / bpf, GST_SECOND,
+      buf->spec.info.rate);
+
+  done = 0;
+  while (done < len) {
+    GstClockTime wait_time;
+    gboolean underrun = FALSE;
+    guint delay = 0;
+
+    /* wait until the device only has one part of a segment left */
+    if (csink->delay) {
+      GstClockTime delay_time;
+
+      delay = csink->delay (sink);
+      delay_time = gst_util_uint64_scale_int (delay, GST_SECOND,
+          buf->spec.info.rate);
+      wait_time = delay_time > chunk_time ? delay_time - chunk_time : 0;
+    } else {
+      wait_time = chunk_time;
+    }
+
+    committed = __gst_audio_ring_buffer_wait_committed (buf, segdone, done,
+        g_get_monotonic_time () + wait_time / GST_USECOND);
+    if (committed < 0)
+      return;
+
+    if (committed <= done) {
+      committed = MIN (done + chunk, len);
+      underrun = TRUE;
+      GST_LOG_OBJECT (sink, "underrun, writing %d bytes of segment %d",
+          committed - done, readseg);
+    }
+
+    if (!audioringbuffer_write (sink, buf, writefunc, readptr + done,
+            committed - done, readseg))
+      return;
+    done = committed;
+
+    if (csink->delay)
+      delay = csink->delay (sink);
+    __gst_audio_ring_buffer_report_write (buf, delay, underrun);
+  }
+}
+
 /* this internal thread does nothing else but write samples to the audio device.
  * It will write each segment in the ringbuffer and will update the play
  * pointer.
@@ -234,33 +326,17 @@ audioringbuffer_thread_func (GstAudioRingBuffer * buf)
   gst_element_post_message (GST_ELEMENT_CAST (sink), message);
 
   while (TRUE) {
-    gint left, len;
+    gint len;
     guint8 *readptr;
     gint readseg;
 
     /* buffer must be started */
     if (gst_audio_ring_buffer_prepare_read (buf, &readseg, &readptr, &len)) {
-      gint written;
-
-      left = len;
-      do {
-        written = writefunc (sink, readptr, left);
-        GST_LOG_OBJECT (sink, "transferred %d bytes of %d from segment %d",
-            written, left, readseg);
-        if (written < 0 || written > left) {
-          /* might not be critical, it e.g. happens when aborting playback */
-          GST_WARNING_OBJECT (sink,
-              "error writing data in %s (reason: %s), skipping segment (left: %d, written: %d)",
-              GST_DEBUG_FUNCPTR_NAME (writefunc),
-              (errno > 1 ? g_strerror (errno) : "unknown"), left, written);
-          break;
-        } else if (written == 0 && G_UNLIKELY (g_atomic_int_get (&buf->state) !=
-                GST_AUDIO_RING_BUFFER_STATE_STARTED)) {
-          break;
-        }
-        left -= written;
-        readptr += written;
-      } while (left > 0);
+      if (__gst_audio_ring_buffer_get_low_latency (buf))
+        audioringbuffer_write_low_latency (sink, buf, writefunc, readptr, len,
+            readseg);
+      else
+        audioringbuffer_write (sink, buf, writefunc, readptr, len, readseg);
 
       /* clear written samples */
       gst_audio_ring_buffer_clear (buf, readseg);
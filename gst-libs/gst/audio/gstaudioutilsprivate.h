@@ -48,6 +48,35 @@ gboolean __gst_audio_set_thread_priority   (gpointer * handle);
 G_GNUC_INTERNAL
 gboolean __gst_audio_restore_thread_priority (gpointer handle);
 
+/* Ringbuffer low-latency mode */
+
+/* number of parts a segment is written in when no data is committed */
+#define __GST_AUDIO_LOW_LATENCY_SUBSEGMENTS 4
+
+G_GNUC_INTERNAL
+void     __gst_audio_ring_buffer_set_low_latency (GstAudioRingBuffer * buf,
+                                                  gboolean low_latency);
+
+G_GNUC_INTERNAL
+gboolean __gst_audio_ring_buffer_get_low_latency (GstAudioRingBuffer * buf);
+
+G_GNUC_INTERNAL
+gint     __gst_audio_ring_buffer_wait_committed  (GstAudioRingBuffer * buf,
+                                                  gint segment, gint have,
+                                                  gint64 end_time);
+
+G_GNUC_INTERNAL
+void     __gst_audio_ring_buffer_report_write    (GstAudioRingBuffer * buf,
+                                                  guint delay,
+                                                  gboolean underrun);
+
+G_GNUC_INTERNAL
+guint    __gst_audio_ring_buffer_get_underruns   (GstAudioRingBuffer * buf);
+
+G_GNUC_INTERNAL
+GstClockTime
+         __gst_audio_ring_buffer_get_device_delay (GstAudioRingBuffer * buf);
+
 G_END_DECLS
 
 #endif
@@ -74,6 +74,9 @@ gst_discoverer_stream_info_finalize (GObject * object)
 
   if (info->misc)
     gst_structure_free (info->misc);
+
+  if (info->field_sources)
+    gst_structure_free (info->field_sources);
 }
 
 static void
@@ -140,6 +143,9 @@ gst_discoverer_info_copy_int (GstDiscovererStreamInfo * info,
   if (info->misc)
     ret->misc = gst_structure_copy (info->misc);
 
+  if (info->field_sources)
+    ret->field_sources = gst_structure_copy (info->field_sources);
+
   if (stream_map)
     g_hash_table_insert (stream_map, info, ret);
 
@@ -355,6 +361,7 @@ static void
 gst_discoverer_info_init (GstDiscovererInfo * info)
 {
   info->missing_elements_details = g_ptr_array_new_with_free_func (g_free);
+  info->discovery_time = GST_CLOCK_TIME_NONE;
 }
 
 static void
@@ -416,6 +423,7 @@ gst_discoverer_info_copy (GstDiscovererInfo * ptr)
   ret->result = ptr->result;
   ret->seekable = ptr->seekable;
   ret->live = ptr->live;
+  ret->discovery_time = ptr->discovery_time;
   if (ptr->misc)
     ret->misc = gst_structure_copy (ptr->misc);
 
@@ -712,6 +720,36 @@ gst_discoverer_stream_info_get_misc (GstDiscovererStreamInfo * info)
 }
 #endif
 
+/**
+ * gst_discoverer_stream_info_get_field_sources:
+ * @info: a #GstDiscovererStreamInfo
+ *
+ * Tells where the fields of an audio or video stream discovered in
+ * #GstDiscoverer:header-only mode come from. The returned structure maps
+ * field names (such as "sample-rate", "channels", "width", "framerate",
+ * "depth", "bitrate", "profile" or "level") to one of these strings:
+ *
+ * * "caps" if the field was read from the caps of the parsed stream,
+ * * "codec-data" if it was derived from the codec data with the
+ *   codec-utils helpers,
+ * * "tags" if it was read from the stream tags,
+ * * "unknown" if it could not be determined without decoding the stream.
+ *
+ * The field sources are not serialized by gst_discoverer_info_to_variant().
+ *
+ * Returns: (transfer none) (nullable): the sources of the fields of @info,
+ * or %NULL if @info was not discovered in header-only mode.
+ *
+ * Since: 1.20
+ */
+const GstStructure *
+gst_discoverer_stream_info_get_field_sources (GstDiscovererStreamInfo * info)
+{
+  g_return_val_if_fail (GST_IS_DISCOVERER_STREAM_INFO (info), NULL);
+
+  return info->field_sources;
+}
+
 /* GstDiscovererContainerInfo */
 
 /**
@@ -1043,6 +1081,21 @@ DISCOVERER_INFO_ACCESSOR_CODE (seekable, gboolean, FALSE);
 
 DISCOVERER_INFO_ACCESSOR_CODE (live, gboolean, FALSE);
 
+/**
+ * gst_discoverer_info_get_discovery_time:
+ * @info: a #GstDiscovererInfo
+ *
+ * Returns: the time it took to discover the URI, from the moment the
+ * #GstDiscoverer started processing it until the result was available.
+ * Time spent waiting in the queue of pending URIs is not included. For
+ * results loaded from the cache, this is the time it took to load them.
+ *
+ * Since: 1.20
+ */
+
+DISCOVERER_INFO_ACCESSOR_CODE (discovery_time, GstClockTime,
+    GST_CLOCK_TIME_NONE);
+
 #ifndef GST_REMOVE_DEPRECATED
 /**
  * gst_discoverer_info_get_misc:
@@ -38,6 +38,24 @@
  * By default this will use the GLib default main context unless you have
  * set a custom context using g_main_context_push_thread_default().
  *
+ * In non-blocking mode, several URIs can be discovered in parallel by setting
+ * the #GstDiscoverer:max-concurrent property. Each of the parallel discovery
+ * pipelines is kept around and reused for the following URIs, and the
+ * results are emitted through the #GstDiscoverer::discovered signal in the
+ * order in which they complete. gst_discoverer_discover_uris_async() can be
+ * used to queue a whole batch of URIs at once, and
+ * gst_discoverer_info_get_discovery_time() tells how long the discovery of
+ * each of them took.
+ *
+ * When #GstDiscoverer:use-cache is enabled, the results for local files are
+ * stored on disk and reused as long as the file was not modified, which
+ * avoids running a pipeline for files that were already discovered before.
+ * The #GstDiscoverer:cache-max-size property bounds the size of that cache.
+ *
+ * If only the stream layout and the information available from the stream
+ * headers are needed, #GstDiscoverer:header-only makes the discovery stop at
+ * the parsers, without instantiating any decoder.
+ *
  * All the information is returned in a #GstDiscovererInfo structure.
  */
 
@@ -59,6 +77,9 @@
 GST_DEBUG_CATEGORY_STATIC (discoverer_debug);
 #define GST_CAT_DEFAULT discoverer_debug
 #define CACHE_DIRNAME "discoverer"
+/* size, mtime and inode of the file followed by the serialized info */
+#define CACHE_ENTRY_TYPE "(txtv)"
+#define CACHE_ENTRY_FORMAT "(txt@v)"
 
 static GQuark _CAPS_QUARK;
 static GQuark _TAGS_QUARK;
@@ -82,6 +103,22 @@ typedef struct
   gulong probe_id;
 } PrivateStream;
 
+/* Mirrors GstAutoplugSelectResult from the playback plugin */
+typedef enum
+{
+  DISCOVERER_AUTOPLUG_SELECT_TRY,
+  DISCOVERER_AUTOPLUG_SELECT_EXPOSE,
+  DISCOVERER_AUTOPLUG_SELECT_SKIP
+} DiscovererAutoplugSelectResult;
+
+/* Identifies the version of a file a cache entry was created for */
+typedef struct
+{
+  guint64 size;
+  gint64 mtime;
+  guint64 inode;
+} CacheKey;
+
 struct _GstDiscovererPrivate
 {
   gboolean async;
@@ -106,6 +143,8 @@ struct _GstDiscovererPrivate
   GstDiscovererInfo *current_info;
   GError *current_error;
   GstStructure *current_topology;
+  /* when the processing of current_info started */
+  GstClockTime current_start;
 
   /* List of private streams */
   GList *streams;
@@ -140,9 +179,29 @@ struct _GstDiscovererPrivate
   gulong no_more_pads_id;
   gulong source_chg_id;
   gulong element_added_id;
+  gulong autoplug_select_id;
   gulong bus_cb_id;
 
   gboolean use_cache;
+  /* stop at the parsers instead of decoding the streams */
+  gboolean header_only;
+  /* maximum size of the cache in bytes, 0 for unlimited */
+  guint64 cache_max_size;
+  /* size of the cache at the last scan plus what we wrote since,
+   * -1 if the cache was not scanned yet */
+  gint64 cache_size;
+  guint64 cache_hits;
+  guint64 cache_misses;
+  /* key of the cache entry for current_info */
+  CacheKey current_cache_key;
+
+  /* Maximum number of URIs discovered in parallel in async mode */
+  guint max_concurrent;
+  /* Child discoverers the pending URIs are handed to when max_concurrent
+   * is bigger than 1. Each of them keeps its pipeline around between URIs */
+  GList *workers;
+  GList *idle_workers;
+  guint active_workers;
 };
 
 #define DISCO_LOCK(dc) g_mutex_lock (&dc->priv->lock);
@@ -177,12 +236,20 @@ enum
 
 #define DEFAULT_PROP_TIMEOUT 15 * GST_SECOND
 #define DEFAULT_PROP_USE_CACHE FALSE
+#define DEFAULT_PROP_CACHE_MAX_SIZE 0
+#define DEFAULT_PROP_HEADER_ONLY FALSE
+#define DEFAULT_PROP_MAX_CONCURRENT 1
 
 enum
 {
   PROP_0,
   PROP_TIMEOUT,
-  PROP_USE_CACHE
+  PROP_USE_CACHE,
+  PROP_CACHE_MAX_SIZE,
+  PROP_CACHE_HITS,
+  PROP_CACHE_MISSES,
+  PROP_HEADER_ONLY,
+  PROP_MAX_CONCURRENT
 };
 
 static guint gst_discoverer_signals[LAST_SIGNAL] = { 0 };
@@ -211,6 +278,9 @@ static void gst_discoverer_get_property (GObject * object, guint prop_id,
 static gboolean _setup_locked (GstDiscoverer * dc);
 static void handle_current_async (GstDiscoverer * dc);
 static gboolean emit_discovererd_and_next (GstDiscoverer * dc);
+static void _write_cachefile (GstDiscoverer * dc);
+static void dispatch_to_workers (GstDiscoverer * dc);
+static void discoverer_stop_workers (GstDiscoverer * dc);
 static GVariant *gst_discoverer_info_to_variant_recurse (GstDiscovererStreamInfo
     * sinfo, GstDiscovererSerializeFlags flags);
 static GstDiscovererStreamInfo *_parse_discovery (GVariant * variant,
@@ -254,6 +324,10 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
    *
    * The cache files are saved in `$XDG_CACHE_DIR/gstreamer-1.0/discoverer/`.
    *
+   * Only local files are cached. An entry is only used if the size,
+   * modification time and inode of the file did not change since it was
+   * written, it is replaced otherwise.
+   *
    * Since: 1.16
    */
   g_object_class_install_property (gobject_class, PROP_USE_CACHE,
@@ -261,6 +335,94 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
           DEFAULT_PROP_USE_CACHE,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDiscoverer:cache-max-size:
+   *
+   * The maximum size (in bytes) of the discoverer cache, or 0 for no limit.
+   *
+   * When writing a new entry makes the cache grow bigger than this, the
+   * least recently used entries are removed until it shrinks back to three
+   * quarters of it.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_MAX_SIZE,
+      g_param_spec_uint64 ("cache-max-size", "cache max size",
+          "Maximum size of the cache in bytes (0 = unlimited)",
+          0, G_MAXUINT64, DEFAULT_PROP_CACHE_MAX_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:cache-hits:
+   *
+   * The number of local files whose information was loaded from the cache
+   * when #GstDiscoverer:use-cache is enabled.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_HITS,
+      g_param_spec_uint64 ("cache-hits", "cache hits",
+          "Number of URIs whose information was loaded from the cache",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:cache-misses:
+   *
+   * The number of local files which had to be discovered because they had
+   * no valid entry in the cache when #GstDiscoverer:use-cache is enabled.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_MISSES,
+      g_param_spec_uint64 ("cache-misses", "cache misses",
+          "Number of URIs which had no valid entry in the cache",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:header-only:
+   *
+   * Whether to only discover what can be known from the stream headers.
+   *
+   * In this mode, the streams are demuxed and parsed but no decoder is
+   * instantiated and no buffer is decoded, which makes discovery a lot
+   * faster. The audio and video stream information is filled from the
+   * parsed caps, completed with what the codec-utils helpers can derive from
+   * the codec data. Fields that can only be known by decoding, such as the
+   * depth of compressed streams, are left unset, and
+   * gst_discoverer_stream_info_get_field_sources() tells which fields were
+   * found and where.
+   *
+   * Results of header-only discoveries are not stored in the cache, but
+   * complete results from the cache are used when available.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_HEADER_ONLY,
+      g_param_spec_boolean ("header-only", "header only",
+          "Only discover the information available from the stream headers",
+          DEFAULT_PROP_HEADER_ONLY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:max-concurrent:
+   *
+   * The maximum number of URIs that are discovered in parallel in
+   * asynchronous mode.
+   *
+   * When bigger than 1, the pending URIs are distributed over up to that
+   * many discovery pipelines, which are created as needed and reused for
+   * the following URIs once done. Results are emitted in the order in which
+   * they complete, which might differ from the order in which the URIs were
+   * added. This has no effect on the synchronous API.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_CONCURRENT,
+      g_param_spec_uint ("max-concurrent", "max concurrent",
+          "Maximum number of URIs discovered in parallel in async mode",
+          1, G_MAXUINT, DEFAULT_PROP_MAX_CONCURRENT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* signals */
   /**
    * GstDiscoverer::finished:
@@ -337,6 +499,21 @@ uridecodebin_element_added_cb (GstElement * uridecodebin,
   }
 }
 
+static DiscovererAutoplugSelectResult
+uridecodebin_autoplug_select_cb (GstElement * uridecodebin, GstPad * pad,
+    GstCaps * caps, GstElementFactory * factory, GstDiscoverer * dc)
+{
+  /* In header-only mode, expose the stream instead of decoding it */
+  if (dc->priv->header_only && gst_element_factory_list_is_type (factory,
+          GST_ELEMENT_FACTORY_TYPE_DECODER)) {
+    GST_DEBUG_OBJECT (dc, "Not plugging decoder %s for %" GST_PTR_FORMAT,
+        GST_OBJECT_NAME (factory), caps);
+    return DISCOVERER_AUTOPLUG_SELECT_EXPOSE;
+  }
+
+  return DISCOVERER_AUTOPLUG_SELECT_TRY;
+}
+
 static void
 gst_discoverer_init (GstDiscoverer * dc)
 {
@@ -347,6 +524,10 @@ gst_discoverer_init (GstDiscoverer * dc)
 
   dc->priv->timeout = DEFAULT_PROP_TIMEOUT;
   dc->priv->use_cache = DEFAULT_PROP_USE_CACHE;
+  dc->priv->cache_max_size = DEFAULT_PROP_CACHE_MAX_SIZE;
+  dc->priv->header_only = DEFAULT_PROP_HEADER_ONLY;
+  dc->priv->cache_size = -1;
+  dc->priv->max_concurrent = DEFAULT_PROP_MAX_CONCURRENT;
   dc->priv->async = FALSE;
 
   g_mutex_init (&dc->priv->lock);
@@ -397,6 +578,9 @@ gst_discoverer_init (GstDiscoverer * dc)
   dc->priv->element_added_id =
       g_signal_connect_object (dc->priv->uridecodebin, "element-added",
       G_CALLBACK (uridecodebin_element_added_cb), dc, 0);
+  dc->priv->autoplug_select_id =
+      g_signal_connect_object (dc->priv->uridecodebin, "autoplug-select",
+      G_CALLBACK (uridecodebin_autoplug_select_cb), dc, 0);
   tmp = gst_element_factory_make ("decodebin", NULL);
   dc->priv->decodebin_type = G_OBJECT_TYPE (tmp);
   gst_object_unref (tmp);
@@ -442,6 +626,7 @@ gst_discoverer_dispose (GObject * obj)
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->no_more_pads_id);
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->source_chg_id);
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->element_added_id);
+    DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->autoplug_select_id);
     DISCONNECT_SIGNAL (dc->priv->bus, dc->priv->bus_cb_id);
 
     /* pipeline was set to NULL in _reset */
@@ -456,6 +641,11 @@ gst_discoverer_dispose (GObject * obj)
 
   gst_discoverer_stop (dc);
 
+  g_list_free (dc->priv->idle_workers);
+  dc->priv->idle_workers = NULL;
+  g_list_free_full (dc->priv->workers, g_object_unref);
+  dc->priv->workers = NULL;
+
   if (dc->priv->seeking_query) {
     gst_query_unref (dc->priv->seeking_query);
     dc->priv->seeking_query = NULL;
@@ -474,6 +664,23 @@ gst_discoverer_finalize (GObject * obj)
   G_OBJECT_CLASS (gst_discoverer_parent_class)->finalize (obj);
 }
 
+/* Applies a property change to the worker discoverers as well */
+static void
+discoverer_forward_property (GstDiscoverer * dc, GParamSpec * pspec,
+    const GValue * value)
+{
+  GList *workers, *tmp;
+
+  DISCO_LOCK (dc);
+  workers = g_list_copy_deep (dc->priv->workers, (GCopyFunc) g_object_ref,
+      NULL);
+  DISCO_UNLOCK (dc);
+
+  for (tmp = workers; tmp; tmp = tmp->next)
+    g_object_set_property (G_OBJECT (tmp->data), pspec->name, value);
+  g_list_free_full (workers, g_object_unref);
+}
+
 static void
 gst_discoverer_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -483,11 +690,33 @@ gst_discoverer_set_property (GObject * object, guint prop_id,
   switch (prop_id) {
     case PROP_TIMEOUT:
       gst_discoverer_set_timeout (dc, g_value_get_uint64 (value));
+      discoverer_forward_property (dc, pspec, value);
       break;
     case PROP_USE_CACHE:
       DISCO_LOCK (dc);
       dc->priv->use_cache = g_value_get_boolean (value);
       DISCO_UNLOCK (dc);
+      discoverer_forward_property (dc, pspec, value);
+      break;
+    case PROP_CACHE_MAX_SIZE:
+      DISCO_LOCK (dc);
+      dc->priv->cache_max_size = g_value_get_uint64 (value);
+      DISCO_UNLOCK (dc);
+      discoverer_forward_property (dc, pspec, value);
+      break;
+    case PROP_HEADER_ONLY:
+      DISCO_LOCK (dc);
+      dc->priv->header_only = g_value_get_boolean (value);
+      DISCO_UNLOCK (dc);
+      discoverer_forward_property (dc, pspec, value);
+      break;
+    case PROP_MAX_CONCURRENT:
+      DISCO_LOCK (dc);
+      dc->priv->max_concurrent = g_value_get_uint (value);
+      DISCO_UNLOCK (dc);
+      /* Raising the limit can free up room for pending URIs */
+      if (dc->priv->async && dc->priv->max_concurrent > 1)
+        dispatch_to_workers (dc);
       break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -512,6 +741,44 @@ gst_discoverer_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, dc->priv->use_cache);
       DISCO_UNLOCK (dc);
       break;
+    case PROP_CACHE_MAX_SIZE:
+      DISCO_LOCK (dc);
+      g_value_set_uint64 (value, dc->priv->cache_max_size);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_HEADER_ONLY:
+      DISCO_LOCK (dc);
+      g_value_set_boolean (value, dc->priv->header_only);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_CACHE_HITS:
+    case PROP_CACHE_MISSES:
+    {
+      GList *workers, *tmp;
+      guint64 count;
+
+      DISCO_LOCK (dc);
+      count = prop_id == PROP_CACHE_HITS ?
+          dc->priv->cache_hits : dc->priv->cache_misses;
+      workers = g_list_copy_deep (dc->priv->workers, (GCopyFunc) g_object_ref,
+          NULL);
+      DISCO_UNLOCK (dc);
+
+      /* Account for the URIs that were handed over to workers */
+      for (tmp = workers; tmp; tmp = tmp->next) {
+        g_object_get_property (G_OBJECT (tmp->data), pspec->name, value);
+        count += g_value_get_uint64 (value);
+      }
+      g_list_free_full (workers, g_object_unref);
+
+      g_value_set_uint64 (value, count);
+      break;
+    }
+    case PROP_MAX_CONCURRENT:
+      DISCO_LOCK (dc);
+      g_value_set_uint (value, dc->priv->max_concurrent);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1138,6 +1405,133 @@ collect_information (GstDiscoverer * dc, const GstStructure * st,
 
 }
 
+static const gchar *
+caps_field_source (const GstStructure * caps_st, const gchar * fieldname)
+{
+  return gst_structure_has_field (caps_st, fieldname) ? "caps" : "unknown";
+}
+
+/* Header-only mode: derives what the parsed caps of an audio or video stream
+ * lack from its codec data, and records where each field came from */
+static void
+complete_from_headers (GstDiscovererStreamInfo * info)
+{
+  GstStructure *caps_st, *sources;
+  const GValue *value;
+  GstBuffer *codec_data = NULL;
+  GstMapInfo map = GST_MAP_INFO_INIT;
+  const gchar *profile_src, *level_src;
+  guint bitrate;
+  gint mpegversion;
+
+  if (!GST_IS_DISCOVERER_AUDIO_INFO (info)
+      && !GST_IS_DISCOVERER_VIDEO_INFO (info))
+    return;
+
+  if (!info->caps || gst_caps_is_empty (info->caps)
+      || gst_caps_is_any (info->caps))
+    return;
+
+  info->caps = gst_caps_make_writable (info->caps);
+  caps_st = gst_caps_get_structure (info->caps, 0);
+
+  value = gst_structure_get_value (caps_st, "codec_data");
+  if (value && GST_VALUE_HOLDS_BUFFER (value)) {
+    codec_data = gst_buffer_ref (gst_value_get_buffer (value));
+    gst_buffer_map (codec_data, &map, GST_MAP_READ);
+  }
+
+  sources = gst_structure_new_empty ("field-sources");
+  profile_src = caps_field_source (caps_st, "profile");
+  level_src = caps_field_source (caps_st, "level");
+
+  if (GST_IS_DISCOVERER_AUDIO_INFO (info)) {
+    GstDiscovererAudioInfo *ainfo = (GstDiscovererAudioInfo *) info;
+    const gchar *rate_src = caps_field_source (caps_st, "rate");
+    const gchar *channels_src = caps_field_source (caps_st, "channels");
+
+    /* AAC, the AudioSpecificConfig is the codec data */
+    if (map.size >= 2 && gst_structure_has_name (caps_st, "audio/mpeg")
+        && gst_structure_get_int (caps_st, "mpegversion", &mpegversion)
+        && mpegversion != 1) {
+      if (ainfo->sample_rate == 0) {
+        ainfo->sample_rate =
+            gst_codec_utils_aac_get_sample_rate (map.data, map.size);
+        if (ainfo->sample_rate)
+          rate_src = "codec-data";
+      }
+      if (ainfo->channels == 0) {
+        ainfo->channels = gst_codec_utils_aac_get_channels (map.data, map.size);
+        if (ainfo->channels) {
+          ainfo->channel_mask =
+              gst_audio_channel_get_fallback_mask (ainfo->channels);
+          channels_src = "codec-data";
+        }
+      }
+      if (!gst_structure_has_field (caps_st, "profile")
+          && gst_codec_utils_aac_caps_set_level_and_profile (info->caps,
+              map.data, map.size))
+        profile_src = level_src = "codec-data";
+    }
+
+    bitrate = ainfo->bitrate;
+    gst_structure_set (sources, "sample-rate", G_TYPE_STRING, rate_src,
+        "channels", G_TYPE_STRING, channels_src, "depth", G_TYPE_STRING,
+        ainfo->depth ? "caps" : "unknown", NULL);
+  } else {
+    GstDiscovererVideoInfo *vinfo = (GstDiscovererVideoInfo *) info;
+
+    if (gst_structure_has_field (caps_st, "profile")) {
+      /* already set by the parser */
+    } else if (map.size >= 4 && gst_structure_has_name (caps_st,
+            "video/x-h264")) {
+      /* avcC, the profile, compatibility and level bytes follow the version */
+      if (gst_codec_utils_h264_caps_set_level_and_profile (info->caps,
+              map.data + 1, map.size - 1))
+        profile_src = level_src = "codec-data";
+    } else if (map.size >= 13 && gst_structure_has_name (caps_st,
+            "video/x-h265")) {
+      /* hvcC, the profile_tier_level follows the version */
+      if (gst_codec_utils_h265_caps_set_level_tier_and_profile (info->caps,
+              map.data + 1, map.size - 1))
+        profile_src = level_src = "codec-data";
+    } else if (map.size > 4 && gst_structure_has_name (caps_st, "video/mpeg")
+        && gst_structure_get_int (caps_st, "mpegversion", &mpegversion)
+        && mpegversion == 4 && GST_READ_UINT32_BE (map.data) == 0x000001b0) {
+      /* visual object sequence start code */
+      if (gst_codec_utils_mpeg4video_caps_set_level_and_profile (info->caps,
+              map.data + 4, map.size - 4))
+        profile_src = level_src = "codec-data";
+    }
+
+    bitrate = vinfo->bitrate;
+    gst_structure_set (sources,
+        "width", G_TYPE_STRING, caps_field_source (caps_st, "width"),
+        "height", G_TYPE_STRING, caps_field_source (caps_st, "height"),
+        "framerate", G_TYPE_STRING, caps_field_source (caps_st, "framerate"),
+        "pixel-aspect-ratio", G_TYPE_STRING,
+        caps_field_source (caps_st, "pixel-aspect-ratio"),
+        "interlaced", G_TYPE_STRING,
+        caps_field_source (caps_st, "interlace-mode"),
+        "depth", G_TYPE_STRING, vinfo->depth ? "caps" : "unknown", NULL);
+  }
+
+  gst_structure_set (sources, "bitrate", G_TYPE_STRING,
+      bitrate ? "tags" : "unknown", "profile", G_TYPE_STRING, profile_src,
+      "level", G_TYPE_STRING, level_src, NULL);
+
+  if (codec_data) {
+    gst_buffer_unmap (codec_data, &map);
+    gst_buffer_unref (codec_data);
+  }
+
+  GST_DEBUG ("field sources %" GST_PTR_FORMAT, sources);
+
+  if (info->field_sources)
+    gst_structure_free (info->field_sources);
+  info->field_sources = sources;
+}
+
 static GstStructure *
 find_stream_for_node (GstDiscoverer * dc, const GstStructure * topology)
 {
@@ -1381,7 +1775,18 @@ parse_stream_topology (GstDiscoverer * dc, const GstStructure * topology,
 static void
 setup_next_uri_locked (GstDiscoverer * dc)
 {
-  if (dc->priv->pending_uris != NULL) {
+  if (dc->priv->max_concurrent > 1) {
+    /* max-concurrent was raised while we were processing a URI, let the
+     * workers take care of the remaining ones */
+    gboolean done = (dc->priv->pending_uris == NULL
+        && dc->priv->active_workers == 0);
+
+    DISCO_UNLOCK (dc);
+    if (done)
+      g_signal_emit (dc, gst_discoverer_signals[SIGNAL_FINISHED], 0);
+    else
+      dispatch_to_workers (dc);
+  } else if (dc->priv->pending_uris != NULL) {
     gboolean ready = _setup_locked (dc);
     DISCO_UNLOCK (dc);
 
@@ -1401,11 +1806,21 @@ setup_next_uri_locked (GstDiscoverer * dc)
 }
 
 
+static void
+discoverer_set_discovery_time (GstDiscoverer * dc)
+{
+  dc->priv->current_info->discovery_time =
+      gst_util_get_timestamp () - dc->priv->current_start;
+}
+
 static void
 emit_discovererd (GstDiscoverer * dc)
 {
-  GST_DEBUG_OBJECT (dc, "Emitting 'discoverered' %s",
-      dc->priv->current_info->uri);
+  discoverer_set_discovery_time (dc);
+
+  GST_DEBUG_OBJECT (dc, "Emitting 'discoverered' %s (took %" GST_TIME_FORMAT
+      ")", dc->priv->current_info->uri,
+      GST_TIME_ARGS (dc->priv->current_info->discovery_time));
   g_signal_emit (dc, gst_discoverer_signals[SIGNAL_DISCOVERED], 0,
       dc->priv->current_info, dc->priv->current_error);
   /* Clients get a copy of current_info since it is a boxed type */
@@ -1511,6 +1926,10 @@ discoverer_collect (GstDiscoverer * dc)
       dc->priv->current_info->stream_info = parse_stream_topology (dc,
           dc->priv->current_topology, NULL);
 
+    if (dc->priv->header_only)
+      g_list_foreach (dc->priv->current_info->stream_list,
+          (GFunc) complete_from_headers, NULL);
+
     /*
      * Images need some special handling. They do not have a duration, have
      * caps named image/<foo> (th exception being MJPEG video which is also
@@ -1535,15 +1954,10 @@ discoverer_collect (GstDiscoverer * dc)
     }
   }
 
-  if (dc->priv->use_cache && dc->priv->current_info->cachefile &&
-      dc->priv->current_info->result == GST_DISCOVERER_OK) {
-    GVariant *variant = gst_discoverer_info_to_variant (dc->priv->current_info,
-        GST_DISCOVERER_SERIALIZE_ALL);
-
-    g_file_set_contents (dc->priv->current_info->cachefile,
-        g_variant_get_data (variant), g_variant_get_size (variant), NULL);
-    g_variant_unref (variant);
-  }
+  if (dc->priv->use_cache && !dc->priv->header_only
+      && dc->priv->current_info->cachefile
+      && dc->priv->current_info->result == GST_DISCOVERER_OK)
+    _write_cachefile (dc);
 
   if (dc->priv->async)
     emit_discovererd (dc);
@@ -1801,11 +2215,21 @@ handle_current_sync (GstDiscoverer * dc)
 }
 
 static gchar *
-_serialized_info_get_path (GstDiscoverer * dc, gchar * uri)
+_get_cache_dir (void)
+{
+  return g_build_filename (g_get_user_cache_dir (),
+      "gstreamer-" GST_API_VERSION, CACHE_DIRNAME, NULL);
+}
+
+/* Entries are named after the location of the file only, so that the entry
+ * of an outdated version of a file gets replaced by the new one. The key
+ * identifying the version of the file is stored in the entry itself */
+static gchar *
+_serialized_info_get_path (GstDiscoverer * dc, gchar * uri, CacheKey * key)
 {
   GChecksum *cs = NULL;
   GStatBuf file_status;
-  gchar *location = NULL, *res = NULL, *cache_dir = NULL, *tmp = NULL,
+  gchar *location = NULL, *res = NULL, *cache_dir = NULL, *root_dir = NULL,
       *protocol = gst_uri_get_protocol (uri), hash_dirname[3] = "00";
   const gchar *checksum;
 
@@ -1823,17 +2247,18 @@ _serialized_info_get_path (GstDiscoverer * dc, gchar * uri)
     goto done;
   }
 
-  tmp = g_strdup_printf ("%s-%" G_GSIZE_FORMAT "-%" G_GINT64_FORMAT,
-      location, (gsize) file_status.st_size, (gint64) file_status.st_mtime);
+  key->size = file_status.st_size;
+  key->mtime = file_status.st_mtime;
+  key->inode = file_status.st_ino;
+
   cs = g_checksum_new (G_CHECKSUM_SHA1);
-  g_checksum_update (cs, (const guchar *) tmp, strlen (tmp));
+  g_checksum_update (cs, (const guchar *) location, strlen (location));
   checksum = g_checksum_get_string (cs);
 
   hash_dirname[0] = checksum[0];
   hash_dirname[1] = checksum[1];
-  cache_dir =
-      g_build_filename (g_get_user_cache_dir (), "gstreamer-" GST_API_VERSION,
-      CACHE_DIRNAME, hash_dirname, NULL);
+  root_dir = _get_cache_dir ();
+  cache_dir = g_build_filename (root_dir, hash_dirname, NULL);
   g_mkdir_with_parents (cache_dir, 0777);
 
   res = g_build_filename (cache_dir, &checksum[2], NULL);
@@ -1841,40 +2266,280 @@ _serialized_info_get_path (GstDiscoverer * dc, gchar * uri)
 done:
   g_checksum_free (cs);
   g_free (cache_dir);
+  g_free (root_dir);
   g_free (location);
-  g_free (tmp);
   g_free (protocol);
 
   return res;
 }
 
+/* The parsing code trusts the layout of the variant it is given, so check
+ * all of it, as written by gst_discoverer_info_to_variant(), before parsing
+ * a cache entry */
+static gboolean
+_is_valid_stream_variant (GVariant * variant)
+{
+  GVariant *common, *specific, *child;
+  GVariantIter iter;
+  gboolean ret = FALSE;
+  guchar type;
+
+  if (!g_variant_is_of_type (variant, G_VARIANT_TYPE ("(yvav)"))
+      && !g_variant_is_of_type (variant, G_VARIANT_TYPE ("(yvv)")))
+    return FALSE;
+
+  g_variant_get_child (variant, 0, "y", &type);
+  g_variant_get_child (variant, 1, "v", &common);
+  specific = g_variant_get_child_value (variant, 2);
+
+  if (g_variant_is_of_type (common, G_VARIANT_TYPE ("(msmsmsmsv)"))) {
+    g_variant_get_child (common, 4, "v", &child);
+    ret = g_variant_is_of_type (child, G_VARIANT_TYPE_UNIT)
+        || _is_valid_stream_variant (child);
+    g_variant_unref (child);
+  } else {
+    /* written before the next stream was serialized */
+    ret = g_variant_is_of_type (common, G_VARIANT_TYPE ("(msmsmsms)"));
+  }
+  if (!ret)
+    goto done;
+
+  if (type == 'c') {
+    if (!g_variant_is_of_type (specific, G_VARIANT_TYPE ("av"))) {
+      ret = FALSE;
+      goto done;
+    }
+    g_variant_iter_init (&iter, specific);
+    while (ret && g_variant_iter_next (&iter, "v", &child)) {
+      ret = _is_valid_stream_variant (child);
+      g_variant_unref (child);
+    }
+    goto done;
+  }
+
+  if (!g_variant_is_of_type (specific, G_VARIANT_TYPE_VARIANT)) {
+    ret = FALSE;
+    goto done;
+  }
+  g_variant_get (specific, "v", &child);
+
+  switch (type) {
+    case 'a':
+      ret = g_variant_is_of_type (child, G_VARIANT_TYPE ("(uuuuumst)"));
+      break;
+    case 'v':
+      ret = g_variant_is_of_type (child, G_VARIANT_TYPE ("(uuuuuuubuub)"));
+      break;
+    case 's':
+      ret = g_variant_is_of_type (child, G_VARIANT_TYPE ("ms"));
+      break;
+    case 'n':
+      /* the next stream is parsed from the common info */
+      ret = TRUE;
+      break;
+    default:
+      ret = FALSE;
+      break;
+  }
+  g_variant_unref (child);
+
+done:
+  g_variant_unref (specific);
+  g_variant_unref (common);
+
+  return ret;
+}
+
+static gboolean
+_is_valid_info_variant (GVariant * variant)
+{
+  GVariant *info_variant, *stream_variant;
+  gboolean ret;
+
+  if (!g_variant_is_of_type (variant, G_VARIANT_TYPE ("(vv)")))
+    return FALSE;
+
+  g_variant_get (variant, "(vv)", &info_variant, &stream_variant);
+  ret = g_variant_is_of_type (info_variant, G_VARIANT_TYPE ("(mstbmsb)"))
+      && _is_valid_stream_variant (stream_variant);
+  g_variant_unref (info_variant);
+  g_variant_unref (stream_variant);
+
+  return ret;
+}
+
 static GstDiscovererInfo *
-_get_info_from_cachefile (GstDiscoverer * dc, gchar * cachefile)
+_get_info_from_cachefile (GstDiscoverer * dc, gchar * cachefile,
+    const CacheKey * key)
 {
-  gchar *data;
-  gsize length;
+  GstDiscovererInfo *info = NULL;
+  GMappedFile *mapped;
+  GBytes *bytes;
+  GVariant *entry, *variant, *contents;
+  CacheKey entry_key;
 
-  if (g_file_get_contents (cachefile, &data, &length, NULL)) {
-    GstDiscovererInfo *info = NULL;
-    GVariant *variant =
-        g_variant_new_from_data (G_VARIANT_TYPE ("v"), data, length,
-        TRUE, NULL, NULL);
+  mapped = g_mapped_file_new (cachefile, FALSE, NULL);
+  if (!mapped)
+    return NULL;
 
+  /* The entry might have been written by another version, or be corrupted,
+   * so don't trust it. Entries are replaced atomically, so it can't change
+   * under our feet while mapped. */
+  bytes = g_mapped_file_get_bytes (mapped);
+  g_mapped_file_unref (mapped);
+  entry = g_variant_new_from_bytes (G_VARIANT_TYPE (CACHE_ENTRY_TYPE), bytes,
+      FALSE);
+  g_variant_ref_sink (entry);
+  g_bytes_unref (bytes);
+
+  g_variant_get (entry, CACHE_ENTRY_FORMAT, &entry_key.size, &entry_key.mtime,
+      &entry_key.inode, &variant);
+  contents = g_variant_get_variant (variant);
+
+  if (entry_key.size != key->size || entry_key.mtime != key->mtime
+      || entry_key.inode != key->inode) {
+    GST_DEBUG_OBJECT (dc, "Cache entry %s is outdated", cachefile);
+  } else if (!_is_valid_info_variant (contents)) {
+    GST_WARNING_OBJECT (dc, "Invalid cache entry %s", cachefile);
+  } else {
     info = gst_discoverer_info_from_variant (variant);
-    g_variant_unref (variant);
+  }
 
-    if (info) {
-      info->cachefile = cachefile;
-      info->from_cache = (gpointer) 0x01;
+  g_variant_unref (contents);
+  g_variant_unref (variant);
+  g_variant_unref (entry);
+
+  if (info) {
+    info->cachefile = cachefile;
+    info->from_cache = (gpointer) 0x01;
+
+    /* Keep track of when entries were last used to know which ones to
+     * evict first */
+    if (dc->priv->cache_max_size)
+      g_utime (cachefile, NULL);
+  } else {
+    g_unlink (cachefile);
+  }
+
+  GST_INFO_OBJECT (dc, "Got info from cache: %p", info);
+
+  return info;
+}
+
+typedef struct
+{
+  gchar *path;
+  guint64 size;
+  gint64 mtime;
+} CacheFile;
+
+static gint
+_cache_file_compare (const CacheFile * a, const CacheFile * b)
+{
+  if (a->mtime < b->mtime)
+    return -1;
+  return a->mtime > b->mtime;
+}
+
+/* Scans the cache, and if it is bigger than cache-max-size, removes the
+ * least recently used entries until it is down to 3/4 of that */
+static void
+_prune_cache (GstDiscoverer * dc)
+{
+  GArray *files = g_array_new (FALSE, FALSE, sizeof (CacheFile));
+  gchar *cache_dir = _get_cache_dir ();
+  const gchar *hash_dirname;
+  guint64 total = 0;
+  GDir *dir;
+  guint i;
+
+  dir = g_dir_open (cache_dir, 0, NULL);
+  while (dir && (hash_dirname = g_dir_read_name (dir))) {
+    gchar *subdir_path = g_build_filename (cache_dir, hash_dirname, NULL);
+    GDir *subdir = g_dir_open (subdir_path, 0, NULL);
+    const gchar *name;
+
+    while (subdir && (name = g_dir_read_name (subdir))) {
+      GStatBuf file_status;
+      CacheFile file;
+
+      file.path = g_build_filename (subdir_path, name, NULL);
+      if (g_stat (file.path, &file_status) < 0) {
+        g_free (file.path);
+        continue;
+      }
+
+      file.size = file_status.st_size;
+      file.mtime = file_status.st_mtime;
+      total += file.size;
+      g_array_append_val (files, file);
     }
 
-    GST_INFO_OBJECT (dc, "Got info from cache: %p", info);
-    g_free (data);
+    if (subdir)
+      g_dir_close (subdir);
+    g_free (subdir_path);
+  }
+  if (dir)
+    g_dir_close (dir);
+
+  if (total > dc->priv->cache_max_size) {
+    guint64 target = dc->priv->cache_max_size / 4 * 3;
 
-    return info;
+    g_array_sort (files, (GCompareFunc) _cache_file_compare);
+    for (i = 0; i < files->len && total > target; i++) {
+      CacheFile *file = &g_array_index (files, CacheFile, i);
+
+      if (g_unlink (file->path) == 0)
+        total -= file->size;
+    }
+
+    GST_DEBUG_OBJECT (dc, "Pruned cache down to %" G_GUINT64_FORMAT " bytes",
+        total);
+  }
+
+  for (i = 0; i < files->len; i++)
+    g_free (g_array_index (files, CacheFile, i).path);
+  g_array_free (files, TRUE);
+  g_free (cache_dir);
+
+  dc->priv->cache_size = total;
+}
+
+static void
+_write_cachefile (GstDiscoverer * dc)
+{
+  const CacheKey *key = &dc->priv->current_cache_key;
+  GVariant *variant, *entry;
+  gsize size;
+
+  variant = gst_discoverer_info_to_variant (dc->priv->current_info,
+      GST_DISCOVERER_SERIALIZE_ALL);
+  g_variant_ref_sink (variant);
+  entry = g_variant_new (CACHE_ENTRY_FORMAT, key->size, key->mtime,
+      key->inode, variant);
+  g_variant_ref_sink (entry);
+  g_variant_unref (variant);
+
+  size = g_variant_get_size (entry);
+  if (!g_file_set_contents (dc->priv->current_info->cachefile,
+          g_variant_get_data (entry), size, NULL)) {
+    GST_WARNING_OBJECT (dc, "Could not write cache entry %s",
+        dc->priv->current_info->cachefile);
+    goto done;
+  }
+
+  if (dc->priv->cache_max_size) {
+    /* Only scan the whole cache the first time and when our estimate
+     * goes over the limit */
+    if (dc->priv->cache_size >= 0)
+      dc->priv->cache_size += size;
+    if (dc->priv->cache_size < 0
+        || (guint64) dc->priv->cache_size > dc->priv->cache_max_size)
+      _prune_cache (dc);
   }
 
-  return NULL;
+done:
+  g_variant_unref (entry);
 }
 
 static gboolean
@@ -1887,10 +2552,19 @@ _setup_locked (GstDiscoverer * dc)
   dc->priv->pending_uris =
       g_list_delete_link (dc->priv->pending_uris, dc->priv->pending_uris);
 
+  dc->priv->current_start = gst_util_get_timestamp ();
+
   if (dc->priv->use_cache) {
-    cachefile = _serialized_info_get_path (dc, uri);
-    if (cachefile)
-      dc->priv->current_info = _get_info_from_cachefile (dc, cachefile);
+    cachefile =
+        _serialized_info_get_path (dc, uri, &dc->priv->current_cache_key);
+    if (cachefile) {
+      dc->priv->current_info = _get_info_from_cachefile (dc, cachefile,
+          &dc->priv->current_cache_key);
+      if (dc->priv->current_info)
+        dc->priv->cache_hits++;
+      else
+        dc->priv->cache_misses++;
+    }
 
     if (dc->priv->current_info) {
       /* Make sure the URI is exactly what the user passed in */
@@ -2024,6 +2698,178 @@ async_timeout_cb (GstDiscoverer * dc)
   return FALSE;
 }
 
+/* Attaches the bus watch to @ctx so that URIs are discovered
+ * asynchronously from there. Returns FALSE if we were already started */
+static gboolean
+discoverer_start_in_context (GstDiscoverer * dc, GMainContext * ctx)
+{
+  GSource *source;
+
+  if (dc->priv->async)
+    return FALSE;
+
+  dc->priv->async = TRUE;
+  dc->priv->running = TRUE;
+
+  source = gst_bus_create_watch (dc->priv->bus);
+  g_source_set_callback (source, (GSourceFunc) gst_bus_async_signal_func,
+      NULL, NULL);
+  g_source_attach (source, ctx);
+  dc->priv->bus_source = source;
+  dc->priv->ctx = g_main_context_ref (ctx);
+
+  return TRUE;
+}
+
+static void
+worker_discovered_cb (GstDiscoverer * worker, GstDiscovererInfo * info,
+    GError * err, GstDiscoverer * dc)
+{
+  g_signal_emit (dc, gst_discoverer_signals[SIGNAL_DISCOVERED], 0, info, err);
+}
+
+static void
+worker_source_setup_cb (GstDiscoverer * worker, GstElement * source,
+    GstDiscoverer * dc)
+{
+  g_signal_emit (dc, gst_discoverer_signals[SIGNAL_SOURCE_SETUP], 0, source);
+}
+
+/* Workers are handed a single URI at a time, so they emit 'finished' right
+ * after having emitted its result */
+static void
+worker_finished_cb (GstDiscoverer * worker, GstDiscoverer * dc)
+{
+  gboolean done;
+
+  DISCO_LOCK (dc);
+  if (!dc->priv->running) {
+    DISCO_UNLOCK (dc);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (dc, "Worker %p is idle again", worker);
+  dc->priv->idle_workers = g_list_prepend (dc->priv->idle_workers, worker);
+  dc->priv->active_workers--;
+  done = (dc->priv->pending_uris == NULL && dc->priv->active_workers == 0
+      && dc->priv->current_info == NULL);
+  DISCO_UNLOCK (dc);
+
+  if (done)
+    g_signal_emit (dc, gst_discoverer_signals[SIGNAL_FINISHED], 0);
+  else
+    dispatch_to_workers (dc);
+}
+
+static GstDiscoverer *
+discoverer_new_worker_locked (GstDiscoverer * dc)
+{
+  GstDiscoverer *worker;
+
+  worker = g_object_new (GST_TYPE_DISCOVERER, "timeout", dc->priv->timeout,
+      "use-cache", dc->priv->use_cache, "cache-max-size",
+      dc->priv->cache_max_size, "header-only", dc->priv->header_only, NULL);
+
+  g_signal_connect_object (worker, "discovered",
+      G_CALLBACK (worker_discovered_cb), dc, 0);
+  g_signal_connect_object (worker, "source-setup",
+      G_CALLBACK (worker_source_setup_cb), dc, 0);
+  g_signal_connect_object (worker, "finished",
+      G_CALLBACK (worker_finished_cb), dc, 0);
+
+  dc->priv->workers = g_list_prepend (dc->priv->workers, worker);
+
+  GST_DEBUG_OBJECT (dc, "Created worker %p", worker);
+
+  return worker;
+}
+
+/* Hands the pending URIs over to idle workers, creating new ones as long as
+ * max-concurrent allows it */
+static void
+dispatch_to_workers (GstDiscoverer * dc)
+{
+  while (TRUE) {
+    GstDiscoverer *worker;
+    GMainContext *ctx;
+    gchar *uri;
+
+    DISCO_LOCK (dc);
+    if (!dc->priv->running || dc->priv->pending_uris == NULL
+        || dc->priv->active_workers >= dc->priv->max_concurrent) {
+      DISCO_UNLOCK (dc);
+      break;
+    }
+
+    if (dc->priv->idle_workers) {
+      worker = dc->priv->idle_workers->data;
+      dc->priv->idle_workers =
+          g_list_delete_link (dc->priv->idle_workers, dc->priv->idle_workers);
+    } else {
+      worker = discoverer_new_worker_locked (dc);
+    }
+
+    uri = dc->priv->pending_uris->data;
+    dc->priv->pending_uris =
+        g_list_delete_link (dc->priv->pending_uris, dc->priv->pending_uris);
+    dc->priv->active_workers++;
+
+    g_object_ref (worker);
+    ctx = g_main_context_ref (dc->priv->ctx);
+    DISCO_UNLOCK (dc);
+
+    GST_DEBUG_OBJECT (dc, "Handing %s over to worker %p", uri, worker);
+
+    discoverer_start_in_context (worker, ctx);
+    gst_discoverer_discover_uri_async (worker, uri);
+
+    g_main_context_unref (ctx);
+    g_object_unref (worker);
+    g_free (uri);
+  }
+}
+
+/* Stops the workers. Busy ones can't be reused after having been
+ * interrupted, so they are dropped once their cache statistics were
+ * accounted for */
+static void
+discoverer_stop_workers (GstDiscoverer * dc)
+{
+  GList *workers, *busy = NULL, *tmp, *next;
+
+  DISCO_LOCK (dc);
+  for (tmp = dc->priv->workers; tmp; tmp = next) {
+    next = tmp->next;
+    if (!g_list_find (dc->priv->idle_workers, tmp->data)) {
+      dc->priv->workers = g_list_remove_link (dc->priv->workers, tmp);
+      busy = g_list_concat (tmp, busy);
+    }
+  }
+  workers = g_list_copy_deep (dc->priv->workers, (GCopyFunc) g_object_ref,
+      NULL);
+  dc->priv->active_workers = 0;
+  DISCO_UNLOCK (dc);
+
+  for (tmp = workers; tmp; tmp = tmp->next)
+    gst_discoverer_stop (tmp->data);
+  g_list_free_full (workers, g_object_unref);
+
+  for (tmp = busy; tmp; tmp = tmp->next) {
+    guint64 hits, misses;
+
+    GST_DEBUG_OBJECT (dc, "Dropping interrupted worker %p", tmp->data);
+    gst_discoverer_stop (tmp->data);
+
+    g_object_get (tmp->data, "cache-hits", &hits, "cache-misses", &misses,
+        NULL);
+    DISCO_LOCK (dc);
+    dc->priv->cache_hits += hits;
+    dc->priv->cache_misses += misses;
+    DISCO_UNLOCK (dc);
+  }
+  g_list_free_full (busy, g_object_unref);
+}
+
 /* If there is a pending URI, it will pop it from the list of pending
  * URIs and start the discovery on it.
  *
@@ -2046,6 +2892,17 @@ start_discovering (GstDiscoverer * dc)
     goto beach;
   }
 
+  if (dc->priv->async && dc->priv->max_concurrent > 1) {
+    gboolean starting = (dc->priv->active_workers == 0
+        && dc->priv->current_info == NULL);
+
+    DISCO_UNLOCK (dc);
+    if (starting)
+      g_signal_emit (dc, gst_discoverer_signals[SIGNAL_STARTING], 0);
+    dispatch_to_workers (dc);
+    goto beach;
+  }
+
   if (dc->priv->current_info != NULL) {
     GST_WARNING ("Already processing a file");
     res = GST_DISCOVERER_BUSY;
@@ -2441,33 +3298,22 @@ out:
 void
 gst_discoverer_start (GstDiscoverer * discoverer)
 {
-  GSource *source;
   GMainContext *ctx = NULL;
 
   g_return_if_fail (GST_IS_DISCOVERER (discoverer));
 
   GST_DEBUG_OBJECT (discoverer, "Starting...");
 
-  if (discoverer->priv->async) {
-    GST_DEBUG_OBJECT (discoverer, "We were already started");
-    return;
-  }
-
-  discoverer->priv->async = TRUE;
-  discoverer->priv->running = TRUE;
-
   ctx = g_main_context_get_thread_default ();
 
   /* Connect to bus signals */
   if (ctx == NULL)
     ctx = g_main_context_default ();
 
-  source = gst_bus_create_watch (discoverer->priv->bus);
-  g_source_set_callback (source, (GSourceFunc) gst_bus_async_signal_func,
-      NULL, NULL);
-  g_source_attach (source, ctx);
-  discoverer->priv->bus_source = source;
-  discoverer->priv->ctx = g_main_context_ref (ctx);
+  if (!discoverer_start_in_context (discoverer, ctx)) {
+    GST_DEBUG_OBJECT (discoverer, "We were already started");
+    return;
+  }
 
   start_discovering (discoverer);
   GST_DEBUG_OBJECT (discoverer, "Started");
@@ -2507,6 +3353,8 @@ gst_discoverer_stop (GstDiscoverer * discoverer)
   discoverer->priv->running = FALSE;
   DISCO_UNLOCK (discoverer);
 
+  discoverer_stop_workers (discoverer);
+
   /* Remove timeout handler */
   if (discoverer->priv->timeout_source) {
     g_source_destroy (discoverer->priv->timeout_source);
@@ -2568,6 +3416,57 @@ gst_discoverer_discover_uri_async (GstDiscoverer * discoverer,
   return TRUE;
 }
 
+/**
+ * gst_discoverer_discover_uris_async:
+ * @discoverer: A #GstDiscoverer
+ * @uris: (array zero-terminated=1): a %NULL-terminated array of URIs to add
+ *
+ * Appends all the given @uris to the list of URIs to discover, in order.
+ * This behaves like calling gst_discoverer_discover_uri_async() for each of
+ * them, but only takes the internal lock once and lets the discovery of the
+ * whole batch be scheduled at once, which is useful in combination with
+ * #GstDiscoverer:max-concurrent.
+ *
+ * The #GstDiscoverer::discovered signal is emitted for each URI as soon as
+ * its discovery is done, and #GstDiscoverer::finished once all of them have
+ * been processed.
+ *
+ * Returns: %TRUE if the @uris were successfully appended to the list of
+ * pending uris, else %FALSE
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_discoverer_discover_uris_async (GstDiscoverer * discoverer,
+    const gchar * const *uris)
+{
+  GList *batch = NULL;
+  gboolean can_run;
+  guint i;
+
+  g_return_val_if_fail (GST_IS_DISCOVERER (discoverer), FALSE);
+  g_return_val_if_fail (uris != NULL, FALSE);
+
+  for (i = 0; uris[i]; i++) {
+    GST_DEBUG_OBJECT (discoverer, "uri : %s", uris[i]);
+    batch = g_list_prepend (batch, g_strdup (uris[i]));
+  }
+
+  if (batch == NULL)
+    return TRUE;
+
+  DISCO_LOCK (discoverer);
+  can_run = (discoverer->priv->pending_uris == NULL);
+  discoverer->priv->pending_uris =
+      g_list_concat (discoverer->priv->pending_uris, g_list_reverse (batch));
+  DISCO_UNLOCK (discoverer);
+
+  if (can_run)
+    start_discovering (discoverer);
+
+  return TRUE;
+}
+
 
 /* Synchronous mode */
 /**
@@ -2613,6 +3512,9 @@ gst_discoverer_discover_uri (GstDiscoverer * discoverer, const gchar * uri,
   res = start_discovering (discoverer);
   discoverer_collect (discoverer);
 
+  if (discoverer->priv->current_info)
+    discoverer_set_discovery_time (discoverer);
+
   /* Get results */
   if (err) {
     if (discoverer->priv->current_error)
@@ -84,6 +84,9 @@ const GstStructure*      gst_discoverer_stream_info_get_misc(GstDiscovererStream
 GST_PBUTILS_API
 const gchar *            gst_discoverer_stream_info_get_stream_type_nick(GstDiscovererStreamInfo* info);
 
+GST_PBUTILS_API
+const GstStructure*      gst_discoverer_stream_info_get_field_sources(GstDiscovererStreamInfo* info);
+
 /**
  * GstDiscovererContainerInfo:
  *
@@ -303,6 +306,9 @@ gboolean                  gst_discoverer_info_get_seekable(const GstDiscovererIn
 GST_PBUTILS_API
 gboolean                  gst_discoverer_info_get_live(const GstDiscovererInfo* info);
 
+GST_PBUTILS_API
+GstClockTime              gst_discoverer_info_get_discovery_time(const GstDiscovererInfo* info);
+
 GST_PBUTILS_DEPRECATED_FOR(gst_discoverer_info_get_missing_elements_installer_details)
 const GstStructure*       gst_discoverer_info_get_misc(const GstDiscovererInfo* info);
 
@@ -402,6 +408,10 @@ GST_PBUTILS_API
 gboolean       gst_discoverer_discover_uri_async (GstDiscoverer *discoverer,
 						  const gchar *uri);
 
+GST_PBUTILS_API
+gboolean       gst_discoverer_discover_uris_async (GstDiscoverer *discoverer,
+						   const gchar * const *uris);
+
 /* Synchronous API */
 
 GST_PBUTILS_API
@@ -31,6 +31,9 @@ struct _GstDiscovererStreamInfo {
   GstToc                *toc;
   gchar                 *stream_id;
   GstStructure          *misc;
+
+  /* where the fields were taken from, in header-only mode */
+  GstStructure          *field_sources;
 };
 
 struct _GstDiscovererContainerInfo {
@@ -96,6 +99,9 @@ struct _GstDiscovererInfo {
   gboolean seekable;
   GPtrArray *missing_elements_details;
 
+  /* time spent discovering the URI, queueing excluded */
+  GstClockTime discovery_time;
+
   gchar *cachefile;
   gpointer from_cache;
 };
@@ -0,0 +1,76 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_SHARED_TASK_POOL_PRIVATE_H__
+#define __GST_SHARED_TASK_POOL_PRIVATE_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+#define GST_PLUGINS_BASE_SHARED_TASK_POOL_KEY "gst-plugins-base-shared-task-pool"
+
+static inline void
+_gst_plugins_base_shared_task_pool_free (GstTaskPool * pool)
+{
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+/* The task pool shared by all the libraries of gst-plugins-base that
+ * run work in parallel, one thread per CPU core.
+ *
+ * The libraries don't depend on each other, so the pool is attached to the
+ * default registry. That makes it a single pool for the whole process, and
+ * it is cleaned up with the registry in gst_deinit(). */
+static inline GstTaskPool *
+_gst_plugins_base_get_shared_task_pool (void)
+{
+  static gsize pool_gonce = 0;
+
+  if (g_once_init_enter (&pool_gonce)) {
+    GObject *registry = G_OBJECT (gst_registry_get ());
+    GstTaskPool *pool;
+
+    while (!(pool = g_object_get_data (registry,
+                GST_PLUGINS_BASE_SHARED_TASK_POOL_KEY))) {
+      pool = gst_shared_task_pool_new ();
+      gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool),
+          g_get_num_processors ());
+      gst_task_pool_prepare (pool, NULL);
+      gst_object_ref_sink (pool);
+      GST_OBJECT_FLAG_SET (pool, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+
+      /* another library might have made one meanwhile, then use that one */
+      if (g_object_replace_data (registry,
+              GST_PLUGINS_BASE_SHARED_TASK_POOL_KEY, NULL, pool,
+              (GDestroyNotify) _gst_plugins_base_shared_task_pool_free, NULL))
+        break;
+
+      _gst_plugins_base_shared_task_pool_free (pool);
+    }
+
+    g_once_init_leave (&pool_gonce, (gsize) pool);
+  }
+
+  return (GstTaskPool *) pool_gonce;
+}
+
+G_END_DECLS
+
+#endif /* __GST_SHARED_TASK_POOL_PRIVATE_H__ */
@@ -2900,6 +2900,9 @@ gst_video_aggregator_sink_query (GstAggregator * agg, GstAggregatorPad * bpad,
  * Subclasses can add their own operation to perform using the returned
  * #GstTaskPool during #GstVideoAggregatorClass::aggregate_frames().
  *
+ * This is the process-wide pool returned by
+ * gst_video_task_runner_get_shared_pool().
+ *
  * Returns: (transfer full): the #GstTaskPool that can be used by subclasses
  *     for performing concurrent operations
  *
@@ -2922,8 +2925,6 @@ gst_video_aggregator_finalize (GObject * o)
   g_mutex_clear (&vagg->priv->lock);
   g_ptr_array_unref (vagg->priv->supported_formats);
 
-  if (vagg->priv->task_pool)
-    gst_task_pool_cleanup (vagg->priv->task_pool);
   gst_clear_object (&vagg->priv->task_pool);
 
   G_OBJECT_CLASS (gst_video_aggregator_parent_class)->finalize (o);
@@ -3064,8 +3065,7 @@ gst_video_aggregator_init (GstVideoAggregator * vagg,
 
   gst_caps_unref (src_template);
 
-  vagg->priv->task_pool = gst_shared_task_pool_new ();
-  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (vagg->
-          priv->task_pool), g_get_num_processors ());
-  gst_task_pool_prepare (vagg->priv->task_pool, NULL);
+  /* share the threads with all other converters in the process */
+  vagg->priv->task_pool =
+      gst_object_ref (gst_video_task_runner_get_shared_pool ());
 }
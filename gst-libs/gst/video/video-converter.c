@@ -57,7 +57,7 @@
  * (a)  unpack
  * (b)  chroma upsample
  * (c)  (convert Y'CbCr to R'G'B')
- * (d)  gamma decode
+ * (d)  gamma decode, tone mapping
  * (e)  downscale
  * (f)  colorspace convert through XYZ
  * (g)  upscale
@@ -116,177 +116,11 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-typedef struct _GstParallelizedWorkItem GstParallelizedWorkItem;
-
-struct _GstParallelizedWorkItem
-{
-  GstParallelizedTaskRunner *self;
-  GstParallelizedTaskFunc func;
-  gpointer user_data;
-};
-
-struct _GstParallelizedTaskRunner
-{
-  GstTaskPool *pool;
-  gboolean own_pool;
-  guint n_threads;
-
-  GstQueueArray *tasks;
-  GstQueueArray *work_items;
-
-  GMutex lock;
-
-  gboolean async_tasks;
-};
-
-static void
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskRunner *runner = data;
-  GstParallelizedWorkItem *work_item;
-
-  g_mutex_lock (&runner->lock);
-  work_item = gst_queue_array_pop_head (runner->work_items);
-  g_mutex_unlock (&runner->lock);
-
-  g_assert (work_item != NULL);
-  g_assert (work_item->func != NULL);
-
-
-  work_item->func (work_item->user_data);
-  if (runner->async_tasks)
-    g_free (work_item);
-}
-
-static void
-gst_parallelized_task_runner_join (GstParallelizedTaskRunner * self)
-{
-  gboolean joined = FALSE;
-
-  while (!joined) {
-    g_mutex_lock (&self->lock);
-    if (!(joined = gst_queue_array_is_empty (self->tasks))) {
-      gpointer task = gst_queue_array_pop_head (self->tasks);
-      g_mutex_unlock (&self->lock);
-      gst_task_pool_join (self->pool, task);
-    } else {
-      g_mutex_unlock (&self->lock);
-    }
-  }
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-
-  gst_queue_array_free (self->work_items);
-  gst_queue_array_free (self->tasks);
-  if (self->own_pool)
-    gst_task_pool_cleanup (self->pool);
-  gst_object_unref (self->pool);
-  g_mutex_clear (&self->lock);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
-    gboolean async_tasks)
-{
-  GstParallelizedTaskRunner *self;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-
-  if (pool) {
-    self->pool = g_object_ref (pool);
-    self->own_pool = FALSE;
-
-    /* No reason to split up the work between more threads than the
-     * pool can spawn */
-    if (GST_IS_SHARED_TASK_POOL (pool))
-      n_threads =
-          MIN (n_threads,
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
-  } else {
-    self->pool = gst_shared_task_pool_new ();
-    self->own_pool = TRUE;
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
-        n_threads);
-    gst_task_pool_prepare (self->pool, NULL);
-  }
-
-  self->tasks = gst_queue_array_new (n_threads);
-  self->work_items = gst_queue_array_new (n_threads);
-
-  self->n_threads = n_threads;
-
-  g_mutex_init (&self->lock);
-
-  /* Set when scheduling a job */
-  self->async_tasks = async_tasks;
-
-  return self;
-}
-
-static void
-gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  if (n_threads > 1 || self->async_tasks) {
-    guint i = 0;
-    g_mutex_lock (&self->lock);
-    if (!self->async_tasks) {
-      /* if not async, perform one of the functions in the current thread */
-      i = 1;
-    }
-    for (; i < n_threads; i++) {
-      gpointer task;
-      GstParallelizedWorkItem *work_item;
-
-      if (!self->async_tasks)
-        work_item = g_newa (GstParallelizedWorkItem, 1);
-      else
-        work_item = g_new0 (GstParallelizedWorkItem, 1);
-
-      work_item->self = self;
-      work_item->func = func;
-      work_item->user_data = task_data[i];
-      gst_queue_array_push_tail (self->work_items, work_item);
-
-      task =
-          gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
-          self, NULL);
-
-      /* The return value of push() is unfortunately nullable, and we can't deal with that */
-      g_assert (task != NULL);
-      gst_queue_array_push_tail (self->tasks, task);
-    }
-    g_mutex_unlock (&self->lock);
-  }
-
-  if (!self->async_tasks) {
-    func (task_data[0]);
-
-    gst_parallelized_task_runner_finish (self);
-  }
-}
-
 typedef struct _GstLineCache GstLineCache;
 
+/* never split a frame in stripes of less lines than this */
+#define MIN_LINES_PER_TASK 64
+
 #define SCALE    (8)
 #define SCALE_F  ((float) (1 << SCALE))
 
@@ -317,6 +151,22 @@ struct _GammaData
   void (*gamma_func) (GammaData * data, gpointer dest, gpointer src);
 };
 
+typedef struct _ToneMapData ToneMapData;
+
+struct _ToneMapData
+{
+  GstVideoToneMapMethod method;
+  /* peak luminance in cd/m^2 */
+  gdouble src_peak;
+  gdouble dst_peak;
+  /* BT.2390 EETF, in PQ code values relative to the source peak */
+  gdouble pq_src_peak;
+  gdouble max_lum;
+  gdouble knee;
+  /* Hable curve value of the source peak */
+  gdouble hable_white;
+};
+
 typedef enum
 {
   ALPHA_MODE_NONE = 0,
@@ -338,6 +188,23 @@ typedef struct
 typedef void (*FastConvertFunc) (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest, gint plane);
 
+/* horizontally scaled input lines of a fused fastpath, indexed by input line
+ * modulo the number of vertical taps */
+typedef struct
+{
+  guint8 *data;
+  gsize stride;
+  guint n_lines;
+  gint *in_line;
+} FusedLineRing;
+
+/* an overlay rectangle to blend, in output frame coordinates */
+typedef struct
+{
+  GstVideoFrame frame;
+  gint x, y;
+} ConvertOverlay;
+
 struct _GstVideoConverter
 {
   gint flags;
@@ -366,7 +233,14 @@ struct _GstVideoConverter
 
   GstStructure *config;
 
-  GstParallelizedTaskRunner *conversion_runner;
+  GstVideoTaskRunner *conversion_runner;
+  /* number of workers, for per-thread state */
+  guint n_threads;
+  /* number of stripes a frame is split in */
+  gint n_tasks;
+  /* completion callback of the frame in flight */
+  GstVideoConverterDoneFunc done_func;
+  gpointer done_data;
 
   guint16 **tmpline;
 
@@ -401,6 +275,7 @@ struct _GstVideoConverter
   MatrixData to_RGB_matrix;
   /* gamma decode */
   GammaData gamma_dec;
+  ToneMapData tone_map;
 
   /* scaling */
   GstLineCache **hscale_lines;
@@ -412,6 +287,10 @@ struct _GstVideoConverter
   GstVideoScaler **v_scaler_i;
   gint v_scale_width;
   gint v_scale_format;
+  gint v_scale_pstride;
+  /* column tiles for vertical scaling, 0 tile width scales full lines */
+  guint v_tile_width;
+  guint v_tile_lines;
 
   /* color space conversion */
   GstLineCache **convert_lines;
@@ -479,6 +358,20 @@ struct _GstVideoConverter
   /* for parallel async running */
   gpointer tasks[4];
   gpointer tasks_p[4];
+
+  /* fused fastpaths, line rings per plane and worker */
+  FusedLineRing *fring[2];
+  guint8 **fout_lines;
+  gsize fout_stride;
+
+  /* name of the selected fastpath, NULL for the generic path */
+  gchar *fastpath_name;
+
+  /* overlays of the current frame */
+  gboolean blend_overlays;
+  gboolean fused_blend;
+  ConvertOverlay *overlays;
+  guint n_overlays;
 };
 
 typedef gpointer (*GstLineCacheAllocLineFunc) (GstLineCache * cache, gint idx,
@@ -542,6 +435,14 @@ gst_line_cache_free (GstLineCache * cache)
   g_slice_free (GstLineCache, cache);
 }
 
+/* clear @cache and all the caches it reads from */
+static void
+gst_line_cache_clear_chain (GstLineCache * cache)
+{
+  for (; cache; cache = cache->prev)
+    gst_line_cache_clear (cache);
+}
+
 static void
 gst_line_cache_set_need_line_func (GstLineCache * cache,
     GstLineCacheNeedLineFunc need_line, gint idx, gpointer user_data,
@@ -633,6 +534,9 @@ gst_line_cache_alloc_line (GstLineCache * cache, gint idx)
 static void video_converter_generic (GstVideoConverter * convert,
     const GstVideoFrame * src, GstVideoFrame * dest);
 static gboolean video_converter_lookup_fastpath (GstVideoConverter * convert);
+static void video_converter_task_done (GstVideoTaskRunner * runner,
+    gpointer user_data);
+static void video_converter_clear_overlays (GstVideoConverter * convert);
 static void video_converter_compute_matrix (GstVideoConverter * convert);
 static void video_converter_compute_resample (GstVideoConverter * convert,
     gint idx);
@@ -793,6 +697,11 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
 #define DEFAULT_OPT_DITHER_METHOD GST_VIDEO_DITHER_BAYER
 #define DEFAULT_OPT_DITHER_QUANTIZATION 1
 #define DEFAULT_OPT_ASYNC_TASKS FALSE
+#define DEFAULT_OPT_BLEND_OVERLAYS FALSE
+#define DEFAULT_OPT_SCALE_TILE_WIDTH 0
+#define DEFAULT_OPT_TONE_MAP_METHOD GST_VIDEO_TONE_MAP_METHOD_NONE
+#define DEFAULT_OPT_TONE_MAP_SOURCE_PEAK 0.0
+#define DEFAULT_OPT_TONE_MAP_TARGET_PEAK 100.0
 
 #define GET_OPT_FILL_BORDER(c) get_opt_bool(c, \
     GST_VIDEO_CONVERTER_OPT_FILL_BORDER, DEFAULT_OPT_FILL_BORDER)
@@ -825,6 +734,19 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
     GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, DEFAULT_OPT_DITHER_QUANTIZATION)
 #define GET_OPT_ASYNC_TASKS(c) get_opt_bool(c, \
     GST_VIDEO_CONVERTER_OPT_ASYNC_TASKS, DEFAULT_OPT_ASYNC_TASKS)
+#define GET_OPT_BLEND_OVERLAYS(c) get_opt_bool(c, \
+    GST_VIDEO_CONVERTER_OPT_BLEND_OVERLAYS, DEFAULT_OPT_BLEND_OVERLAYS)
+#define GET_OPT_SCALE_TILE_WIDTH(c) get_opt_uint(c, \
+    GST_VIDEO_CONVERTER_OPT_SCALE_TILE_WIDTH, DEFAULT_OPT_SCALE_TILE_WIDTH)
+#define GET_OPT_TONE_MAP_METHOD(c) get_opt_enum(c, \
+    GST_VIDEO_CONVERTER_OPT_TONE_MAP_METHOD, GST_TYPE_VIDEO_TONE_MAP_METHOD, \
+    DEFAULT_OPT_TONE_MAP_METHOD)
+#define GET_OPT_TONE_MAP_SOURCE_PEAK(c) get_opt_double(c, \
+    GST_VIDEO_CONVERTER_OPT_TONE_MAP_SOURCE_PEAK, \
+    DEFAULT_OPT_TONE_MAP_SOURCE_PEAK)
+#define GET_OPT_TONE_MAP_TARGET_PEAK(c) get_opt_double(c, \
+    GST_VIDEO_CONVERTER_OPT_TONE_MAP_TARGET_PEAK, \
+    DEFAULT_OPT_TONE_MAP_TARGET_PEAK)
 
 #define CHECK_ALPHA_COPY(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_COPY)
 #define CHECK_ALPHA_SET(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_SET)
@@ -837,6 +759,10 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
 
 #define CHECK_GAMMA_NONE(c) (GET_OPT_GAMMA_MODE(c) == GST_VIDEO_GAMMA_MODE_NONE)
 #define CHECK_GAMMA_REMAP(c) (GET_OPT_GAMMA_MODE(c) == GST_VIDEO_GAMMA_MODE_REMAP)
+/* tone mapping is done in the gamma stages */
+#define CHECK_TONE_MAP(c) \
+    ((c)->tone_map.method != GST_VIDEO_TONE_MAP_METHOD_NONE)
+#define CHECK_GAMMA_STAGES(c) (CHECK_GAMMA_REMAP(c) || CHECK_TONE_MAP(c))
 
 #define CHECK_PRIMARIES_NONE(c) (GET_OPT_PRIMARIES_MODE(c) == GST_VIDEO_PRIMARIES_MODE_NONE)
 #define CHECK_PRIMARIES_MERGE(c) (GET_OPT_PRIMARIES_MODE(c) == GST_VIDEO_PRIMARIES_MODE_MERGE_ONLY)
@@ -1496,6 +1422,139 @@ gamma_convert_u16_u16 (GammaData * data, gpointer dest, gpointer src)
   }
 }
 
+/* SMPTE ST 2084 constants */
+#define PQ_M1 (2610.0 / 16384.0)
+#define PQ_M2 (2523.0 / 4096.0 * 128.0)
+#define PQ_C1 (3424.0 / 4096.0)
+#define PQ_C2 (2413.0 / 4096.0 * 32.0)
+#define PQ_C3 (2392.0 / 4096.0 * 32.0)
+
+/* PQ code value to cd/m^2 */
+static gdouble
+pq_to_nits (gdouble val)
+{
+  gdouble nm = pow (CLAMP (val, 0.0, 1.0), 1.0 / PQ_M2);
+
+  return 10000.0 * pow (MAX (nm - PQ_C1, 0.0) / (PQ_C2 - PQ_C3 * nm),
+      1.0 / PQ_M1);
+}
+
+/* cd/m^2 to PQ code value */
+static gdouble
+nits_to_pq (gdouble nits)
+{
+  gdouble ln = pow (CLAMP (nits / 10000.0, 0.0, 1.0), PQ_M1);
+
+  return pow ((PQ_C1 + PQ_C2 * ln) / (1.0 + PQ_C3 * ln), PQ_M2);
+}
+
+static gdouble
+hable_curve (gdouble x)
+{
+  const gdouble A = 0.15, B = 0.50, C = 0.10, D = 0.20, E = 0.02, F = 0.30;
+
+  return (x * (A * x + C * B) + D * E) / (x * (A * x + B) + D * F) - E / F;
+}
+
+static void
+setup_tone_map (GstVideoConverter * convert)
+{
+  ToneMapData *tm = &convert->tone_map;
+  GstVideoTransferFunction in_func, out_func;
+
+  tm->method = GET_OPT_TONE_MAP_METHOD (convert);
+  if (tm->method == GST_VIDEO_TONE_MAP_METHOD_NONE)
+    return;
+
+  in_func = convert->in_info.colorimetry.transfer;
+  out_func = convert->out_info.colorimetry.transfer;
+
+  /* only from HDR to SDR */
+  if ((in_func != GST_VIDEO_TRANSFER_SMPTE2084
+          && in_func != GST_VIDEO_TRANSFER_ARIB_STD_B67)
+      || out_func == GST_VIDEO_TRANSFER_SMPTE2084
+      || out_func == GST_VIDEO_TRANSFER_ARIB_STD_B67
+      || out_func == GST_VIDEO_TRANSFER_UNKNOWN) {
+    GST_DEBUG ("no tone mapping for transfer %d -> %d", in_func, out_func);
+    tm->method = GST_VIDEO_TONE_MAP_METHOD_NONE;
+    return;
+  }
+
+  tm->src_peak = GET_OPT_TONE_MAP_SOURCE_PEAK (convert);
+  if (tm->src_peak <= 0.0)
+    tm->src_peak = 1000.0;
+  tm->dst_peak = GET_OPT_TONE_MAP_TARGET_PEAK (convert);
+  if (tm->dst_peak <= 0.0)
+    tm->dst_peak = DEFAULT_OPT_TONE_MAP_TARGET_PEAK;
+
+  /* BT.2390 EETF with a black level of 0, the knee starts where the
+   * target peak can not be reached linearly anymore */
+  tm->pq_src_peak = nits_to_pq (tm->src_peak);
+  tm->max_lum = nits_to_pq (tm->dst_peak) / tm->pq_src_peak;
+  tm->knee = 1.5 * tm->max_lum - 0.5;
+
+  tm->hable_white = hable_curve (tm->src_peak / tm->dst_peak);
+
+  GST_DEBUG ("tone mapping %d from %f to %f cd/m^2", tm->method,
+      tm->src_peak, tm->dst_peak);
+}
+
+/* maps the input code value @val to linear light where 1.0 is the target
+ * peak */
+static gdouble
+tone_map_decode (GstVideoConverter * convert, gdouble val)
+{
+  ToneMapData *tm = &convert->tone_map;
+  gdouble nits, res;
+
+  if (convert->in_info.colorimetry.transfer == GST_VIDEO_TRANSFER_SMPTE2084) {
+    nits = pq_to_nits (val);
+  } else {
+    /* HLG, scene light to display light with the system gamma of a display
+     * with the source peak luminance, applied per component */
+    nits = tm->src_peak * pow (gst_video_transfer_function_decode
+        (GST_VIDEO_TRANSFER_ARIB_STD_B67, val), 1.2);
+  }
+
+  switch (tm->method) {
+    case GST_VIDEO_TONE_MAP_METHOD_BT2390:
+    {
+      gdouble e1, e2;
+
+      e1 = MIN (nits_to_pq (nits) / tm->pq_src_peak, 1.0);
+      if (tm->knee < 1.0 && e1 > tm->knee) {
+        gdouble t = (e1 - tm->knee) / (1.0 - tm->knee);
+        gdouble t2 = t * t, t3 = t2 * t;
+
+        e2 = (2 * t3 - 3 * t2 + 1) * tm->knee +
+            (t3 - 2 * t2 + t) * (1.0 - tm->knee) +
+            (-2 * t3 + 3 * t2) * tm->max_lum;
+      } else {
+        e2 = e1;
+      }
+      res = pq_to_nits (e2 * tm->pq_src_peak) / tm->dst_peak;
+      break;
+    }
+    case GST_VIDEO_TONE_MAP_METHOD_HABLE:
+      res = hable_curve (nits / tm->dst_peak) / tm->hable_white;
+      break;
+    default:
+      res = nits / tm->dst_peak;
+      break;
+  }
+  return CLAMP (res, 0.0, 1.0);
+}
+
+static gdouble
+gamma_decode (GstVideoConverter * convert, gdouble val)
+{
+  if (CHECK_TONE_MAP (convert))
+    return tone_map_decode (convert, val);
+
+  return gst_video_transfer_function_decode (convert->in_info.
+      colorimetry.transfer, val);
+}
+
 static void
 setup_gamma_decode (GstVideoConverter * convert)
 {
@@ -1514,17 +1573,14 @@ setup_gamma_decode (GstVideoConverter * convert)
     t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 256);
 
     for (i = 0; i < 256; i++)
-      t[i] =
-          rint (gst_video_transfer_function_decode (func, i / 255.0) * 65535.0);
+      t[i] = rint (gamma_decode (convert, i / 255.0) * 65535.0);
   } else {
     GST_DEBUG ("gamma decode 16->16: %d", func);
     convert->gamma_dec.gamma_func = gamma_convert_u16_u16;
     t = convert->gamma_dec.gamma_table = g_malloc (sizeof (guint16) * 65536);
 
     for (i = 0; i < 65536; i++)
-      t[i] =
-          rint (gst_video_transfer_function_decode (func,
-              i / 65535.0) * 65535.0);
+      t[i] = rint (gamma_decode (convert, i / 65535.0) * 65535.0);
   }
   convert->current_bits = 16;
   convert->current_pstride = 8;
@@ -1572,7 +1628,7 @@ chain_convert_to_RGB (GstVideoConverter * convert, GstLineCache * prev,
 {
   gboolean do_gamma;
 
-  do_gamma = CHECK_GAMMA_REMAP (convert);
+  do_gamma = CHECK_GAMMA_STAGES (convert);
 
   if (do_gamma) {
     gint scale;
@@ -1641,6 +1697,27 @@ chain_hscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
   return prev;
 }
 
+/* number of output lines scaled together in tile mode */
+#define VSCALE_TILE_LINES 8
+
+/* the maximum number of input lines needed for a block of @n_lines output
+ * lines */
+static guint
+vscale_tile_span (GstVideoScaler * scale, guint out_size, guint n_lines)
+{
+  guint i, span = 0;
+
+  for (i = 0; i < out_size; i += n_lines) {
+    guint first, last, n_taps;
+
+    gst_video_scaler_get_coeff (scale, i, &first, NULL);
+    gst_video_scaler_get_coeff (scale, MIN (i + n_lines, out_size) - 1, &last,
+        &n_taps);
+    span = MAX (span, last + n_taps - first);
+  }
+  return span;
+}
+
 static GstLineCache *
 chain_vscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
 {
@@ -1666,18 +1743,34 @@ chain_vscale (GstVideoConverter * convert, GstLineCache * prev, gint idx)
       convert->out_height, convert->config);
   convert->v_scale_width = convert->current_width;
   convert->v_scale_format = convert->current_format;
+  convert->v_scale_pstride = convert->current_pstride;
   convert->current_height = convert->out_height;
 
   gst_video_scaler_get_coeff (convert->v_scaler_p[idx], 0, NULL, &taps);
 
-  GST_DEBUG ("chain vscale %d->%d, taps %d, method %d, backlog %d",
-      convert->in_height, convert->out_height, taps, method, backlog);
+  /* tiles are only used for progressive scaling with more than one tap */
+  convert->v_tile_width = 0;
+  convert->v_tile_lines = 0;
+  if (taps > 1 && taps_i == 0
+      && GET_OPT_SCALE_TILE_WIDTH (convert) < convert->v_scale_width) {
+    convert->v_tile_width = GET_OPT_SCALE_TILE_WIDTH (convert);
+    if (convert->v_tile_width)
+      convert->v_tile_lines = VSCALE_TILE_LINES;
+  }
+
+  GST_DEBUG ("chain vscale %d->%d, taps %d, method %d, backlog %d, tile %u",
+      convert->in_height, convert->out_height, taps, method, backlog,
+      convert->v_tile_width);
 
   prev->backlog = backlog;
   prev = convert->vscale_lines[idx] = gst_line_cache_new (prev);
   prev->pass_alloc = (taps == 1);
   prev->write_input = FALSE;
   prev->n_lines = MAX (taps_i, taps);
+  if (convert->v_tile_width)
+    prev->n_lines = MAX (prev->n_lines,
+        vscale_tile_span (convert->v_scaler_p[idx], convert->out_height,
+            convert->v_tile_lines));
   prev->stride = convert->current_pstride * convert->current_width;
   gst_line_cache_set_need_line_func (prev, do_vscale_lines, idx, convert, NULL);
 
@@ -1802,7 +1895,7 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev, gint idx)
     color_matrix_debug (&convert->convert_matrix);
   }
 
-  do_gamma = CHECK_GAMMA_REMAP (convert);
+  do_gamma = CHECK_GAMMA_STAGES (convert);
   if (!do_gamma) {
 
     convert->in_bits = convert->unpack_bits;
@@ -1961,7 +2054,7 @@ chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev,
 {
   gboolean do_gamma;
 
-  do_gamma = CHECK_GAMMA_REMAP (convert);
+  do_gamma = CHECK_GAMMA_STAGES (convert);
 
   if (do_gamma) {
     gint scale;
@@ -2108,7 +2201,7 @@ setup_allocators (GstVideoConverter * convert)
   width = MAX (convert->in_maxwidth, convert->out_maxwidth);
   width += convert->out_x;
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  for (i = 0; i < convert->n_threads; i++) {
     /* start with using dest lines if we can directly write into it */
     if (convert->identity_pack) {
       alloc_line = get_dest_line;
@@ -2117,8 +2210,8 @@ setup_allocators (GstVideoConverter * convert)
       notify = NULL;
     } else {
       user_data =
-          converter_alloc_new (sizeof (guint16) * width * 4, 4 + BACKLOG,
-          convert, NULL);
+          converter_alloc_new (sizeof (guint16) * width * 4,
+          4 + BACKLOG + convert->v_tile_lines, convert, NULL);
       setup_border_alloc (convert, user_data);
       notify = (GDestroyNotify) converter_alloc_free;
       alloc_line = get_border_temp_line;
@@ -2150,9 +2243,11 @@ setup_allocators (GstVideoConverter * convert)
 
       if (!cache->pass_alloc) {
         /* can't pass allocator, make new temp line allocator */
+        /* tiled vertical scaling makes a block of lines at once */
         user_data =
             converter_alloc_new (sizeof (guint16) * width * 4,
-            cache->n_lines + cache->backlog, convert, NULL);
+            cache->n_lines + cache->backlog + convert->v_tile_lines, convert,
+            NULL);
         notify = (GDestroyNotify) converter_alloc_free;
         alloc_line = get_temp_line;
         alloc_writable = FALSE;
@@ -2301,7 +2396,7 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
   GstLineCache *prev;
   const GstVideoFormatInfo *fin, *fout, *finfo;
   gdouble alpha_value;
-  gint n_threads, i;
+  gint n_threads, max_height, i;
   gboolean async_tasks;
 
   g_return_val_if_fail (in_info != NULL, NULL);
@@ -2326,6 +2421,8 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
   if (config)
     gst_video_converter_set_config (convert, config);
 
+  setup_tone_map (convert);
+
   convert->in_maxwidth = GST_VIDEO_INFO_WIDTH (in_info);
   convert->in_maxheight = GST_VIDEO_INFO_FIELD_HEIGHT (in_info);
   convert->out_maxwidth = GST_VIDEO_INFO_WIDTH (out_info);
@@ -2433,8 +2530,21 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
     n_threads = 1;
 
   async_tasks = GET_OPT_ASYNC_TASKS (convert);
+  convert->blend_overlays = GET_OPT_BLEND_OVERLAYS (convert);
   convert->conversion_runner =
-      gst_parallelized_task_runner_new (n_threads, pool, async_tasks);
+      gst_video_task_runner_new (n_threads, pool, async_tasks);
+  /* the runner might use less threads than asked for */
+  n_threads = gst_video_task_runner_get_n_workers (convert->conversion_runner);
+  convert->n_threads = n_threads;
+  if (async_tasks)
+    gst_video_task_runner_set_done_func (convert->conversion_runner,
+        video_converter_task_done, convert);
+  /* split up in finer stripes than threads so that idle threads can pick up
+   * the remaining work of busy ones */
+  max_height = MAX (convert->out_height, convert->in_height);
+  convert->n_tasks =
+      gst_video_task_runner_get_n_stripes (convert->conversion_runner,
+      max_height, MIN_LINES_PER_TASK);
 
   if (video_converter_lookup_fastpath (convert))
     goto done;
@@ -2566,7 +2676,7 @@ gst_video_converter_free (GstVideoConverter * convert)
 
   g_return_if_fail (convert != NULL);
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  for (i = 0; i < convert->n_threads; i++) {
     if (convert->upsample_p && convert->upsample_p[i])
       gst_video_chroma_resample_free (convert->upsample_p[i]);
     if (convert->upsample_i && convert->upsample_i[i])
@@ -2628,7 +2738,7 @@ gst_video_converter_free (GstVideoConverter * convert)
   g_free (convert->gamma_enc.gamma_table);
 
   if (convert->tmpline) {
-    for (i = 0; i < convert->conversion_runner->n_threads; i++)
+    for (i = 0; i < convert->n_threads; i++)
       g_free (convert->tmpline[i]);
     g_free (convert->tmpline);
   }
@@ -2639,7 +2749,7 @@ gst_video_converter_free (GstVideoConverter * convert)
     gst_structure_free (convert->config);
 
   for (i = 0; i < 4; i++) {
-    for (j = 0; j < convert->conversion_runner->n_threads; j++) {
+    for (j = 0; j < convert->n_threads; j++) {
       if (convert->fv_scaler[i].scaler)
         gst_video_scaler_free (convert->fv_scaler[i].scaler[j]);
       if (convert->fh_scaler[i].scaler)
@@ -2649,8 +2759,26 @@ gst_video_converter_free (GstVideoConverter * convert)
     g_free (convert->fh_scaler[i].scaler);
   }
 
+  for (i = 0; i < 2; i++) {
+    if (convert->fring[i]) {
+      for (j = 0; j < convert->n_threads; j++) {
+        g_free (convert->fring[i][j].data);
+        g_free (convert->fring[i][j].in_line);
+      }
+      g_free (convert->fring[i]);
+    }
+  }
+  if (convert->fout_lines) {
+    for (i = 0; i < convert->n_threads; i++)
+      g_free (convert->fout_lines[i]);
+    g_free (convert->fout_lines);
+  }
+  g_free (convert->fastpath_name);
+
   if (convert->conversion_runner)
-    gst_parallelized_task_runner_free (convert->conversion_runner);
+    gst_video_task_runner_free (convert->conversion_runner);
+
+  video_converter_clear_overlays (convert);
 
   clear_matrix_data (&convert->to_RGB_matrix);
   clear_matrix_data (&convert->convert_matrix);
@@ -2722,28 +2850,160 @@ gst_video_converter_get_config (GstVideoConverter * convert)
   return convert->config;
 }
 
-/**
- * gst_video_converter_frame:
- * @convert: a #GstVideoConverter
- * @dest: a #GstVideoFrame
- * @src: a #GstVideoFrame
- *
- * Convert the pixels of @src into @dest using @convert.
- *
- * If #GST_VIDEO_CONVERTER_OPT_ASYNC_TASKS is %TRUE then this function will
- * return immediately and needs to be followed by a call to
- * gst_video_converter_frame_finish().
- *
- * Since: 1.6
- */
-void
-gst_video_converter_frame (GstVideoConverter * convert,
-    const GstVideoFrame * src, GstVideoFrame * dest)
+/* makes @sub point to @height lines of the single plane @frame, starting at
+ * line @y */
+static void
+video_frame_sub_lines (GstVideoFrame * sub, const GstVideoFrame * frame,
+    gint y, gint height)
 {
-  g_return_if_fail (convert != NULL);
-  g_return_if_fail (src != NULL);
-  g_return_if_fail (dest != NULL);
+  *sub = *frame;
+  GST_VIDEO_INFO_HEIGHT (&sub->info) = height;
+  sub->data[0] = (guint8 *) frame->data[0] +
+      y * GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
+}
+
+/* blend the parts of @overlays that fall in lines @y0 to @y1 of the packed
+ * @dest */
+static void
+video_converter_blend_lines (const ConvertOverlay * overlays,
+    guint n_overlays, GstVideoFrame * dest, gint y0, gint y1)
+{
+  guint i;
+
+  for (i = 0; i < n_overlays; i++) {
+    const ConvertOverlay *overlay = &overlays[i];
+    GstVideoFrame d, s;
+    gint start, end;
+
+    start = MAX (y0, overlay->y);
+    end = MIN (y1, overlay->y + GST_VIDEO_FRAME_HEIGHT (&overlay->frame));
+    if (start >= end)
+      continue;
+
+    video_frame_sub_lines (&d, dest, start, end - start);
+    video_frame_sub_lines (&s, &overlay->frame, start - overlay->y,
+        end - start);
+
+    if (!gst_video_blend (&d, &s, overlay->x, 0, 1.0))
+      GST_WARNING ("could not blend overlay rectangle");
+  }
+}
+
+static void
+video_converter_clear_overlays (GstVideoConverter * convert)
+{
+  guint i;
+
+  for (i = 0; i < convert->n_overlays; i++)
+    gst_video_frame_unmap (&convert->overlays[i].frame);
+  g_free (convert->overlays);
+  convert->overlays = NULL;
+  convert->n_overlays = 0;
+}
+
+/* map the overlay rectangles attached to the buffer of @src, scaled and
+ * positioned like the video in the output frame */
+static void
+video_converter_prepare_overlays (GstVideoConverter * convert,
+    const GstVideoFrame * src)
+{
+  GstVideoOverlayCompositionMeta *meta;
+  gboolean scaled;
+  guint i, n;
+
+  video_converter_clear_overlays (convert);
+
+  if (!convert->blend_overlays || src->buffer == NULL)
+    return;
+
+  meta = gst_buffer_get_video_overlay_composition_meta (src->buffer);
+  if (meta == NULL)
+    return;
+
+  scaled = convert->in_width != convert->out_width
+      || convert->in_height != convert->out_height;
+
+  n = gst_video_overlay_composition_n_rectangles (meta->overlay);
+  convert->overlays = g_new0 (ConvertOverlay, n);
+
+  for (i = 0; i < n; i++) {
+    ConvertOverlay *overlay = &convert->overlays[convert->n_overlays];
+    GstVideoOverlayRectangle *rect;
+    GstVideoMeta *vmeta;
+    GstVideoInfo info;
+    GstBuffer *pixels;
+    gint x, y;
+    guint w, h;
+
+    rect = gst_video_overlay_composition_get_rectangle (meta->overlay, i);
+    gst_video_overlay_rectangle_get_render_rectangle (rect, &x, &y, &w, &h);
+
+    x = ((gint64) x - convert->in_x) * convert->out_width / convert->in_width;
+    y = ((gint64) y - convert->in_y) * convert->out_height /
+        convert->in_height;
+
+    if (scaled) {
+      w = gst_util_uint64_scale_int (w, convert->out_width, convert->in_width);
+      h = gst_util_uint64_scale_int (h, convert->out_height,
+          convert->in_height);
+      if (w == 0 || h == 0)
+        continue;
+
+      /* render a scaled copy, the pixels stay alive with the mapping */
+      rect = gst_video_overlay_rectangle_copy (rect);
+      gst_video_overlay_rectangle_set_render_rectangle (rect, x, y, w, h);
+    }
+
+    pixels = gst_video_overlay_rectangle_get_pixels_argb (rect,
+        GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+    vmeta = gst_buffer_get_video_meta (pixels);
+
+    if (vmeta && gst_video_info_set_format (&info, vmeta->format,
+            vmeta->width, vmeta->height)
+        && gst_video_frame_map (&overlay->frame, &info, pixels,
+            GST_MAP_READ)) {
+      overlay->x = x + convert->out_x;
+      overlay->y = y + convert->out_y;
+      convert->n_overlays++;
+    } else {
+      GST_WARNING ("could not map overlay rectangle %u", i);
+    }
+
+    if (scaled)
+      gst_video_overlay_rectangle_unref (rect);
+  }
+
+  GST_LOG ("blending %u overlay rectangles", convert->n_overlays);
+}
+
+/* blend the overlays onto the complete @dest, for the paths that did not do
+ * it while converting */
+static void
+video_converter_blend_overlays (GstVideoConverter * convert,
+    GstVideoFrame * dest)
+{
+  guint i;
+
+  if (convert->n_overlays == 0 || convert->fused_blend)
+    return;
+
+  /* the conversion needs to be complete */
+  if (gst_video_task_runner_is_async (convert->conversion_runner))
+    gst_video_task_runner_finish (convert->conversion_runner);
+
+  for (i = 0; i < convert->n_overlays; i++) {
+    const ConvertOverlay *overlay = &convert->overlays[i];
 
+    if (!gst_video_blend (dest, (GstVideoFrame *) & overlay->frame,
+            overlay->x, overlay->y, 1.0))
+      GST_WARNING ("could not blend overlay rectangle");
+  }
+}
+
+static gboolean
+video_converter_check_frames (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
   /* Check the frames we've been passed match the layout
    * we were configured for or we might go out of bounds */
   if (G_UNLIKELY (GST_VIDEO_INFO_FORMAT (&convert->in_info) !=
@@ -2753,7 +3013,7 @@ gst_video_converter_frame (GstVideoConverter * convert,
           || GST_VIDEO_INFO_FIELD_HEIGHT (&convert->in_info) >
           GST_VIDEO_FRAME_HEIGHT (src))) {
     g_critical ("Input video frame does not match configuration");
-    return;
+    return FALSE;
   }
   if (G_UNLIKELY (GST_VIDEO_INFO_FORMAT (&convert->out_info) !=
           GST_VIDEO_FRAME_FORMAT (dest)
@@ -2762,14 +3022,109 @@ gst_video_converter_frame (GstVideoConverter * convert,
           || GST_VIDEO_INFO_FIELD_HEIGHT (&convert->out_info) >
           GST_VIDEO_FRAME_HEIGHT (dest))) {
     g_critical ("Output video frame does not match configuration");
-    return;
+    return FALSE;
   }
 
   if (G_UNLIKELY (convert->in_width == 0 || convert->in_height == 0 ||
           convert->out_width == 0 || convert->out_height == 0))
+    return FALSE;
+
+  return TRUE;
+}
+
+/**
+ * gst_video_converter_frame:
+ * @convert: a #GstVideoConverter
+ * @dest: a #GstVideoFrame
+ * @src: a #GstVideoFrame
+ *
+ * Convert the pixels of @src into @dest using @convert.
+ *
+ * If #GST_VIDEO_CONVERTER_OPT_ASYNC_TASKS is %TRUE then this function will
+ * return immediately and needs to be followed by a call to
+ * gst_video_converter_frame_finish(). Use gst_video_converter_frame_async()
+ * to be notified when the conversion completed.
+ *
+ * Since: 1.6
+ */
+void
+gst_video_converter_frame (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  g_return_if_fail (convert != NULL);
+  g_return_if_fail (src != NULL);
+  g_return_if_fail (dest != NULL);
+
+  if (!video_converter_check_frames (convert, src, dest))
     return;
 
+  convert->done_func = NULL;
+  video_converter_prepare_overlays (convert, src);
   convert->convert (convert, src, dest);
+  video_converter_blend_overlays (convert, dest);
+
+  if (!gst_video_task_runner_is_async (convert->conversion_runner))
+    video_converter_clear_overlays (convert);
+}
+
+static void
+video_converter_task_done (GstVideoTaskRunner * runner, gpointer user_data)
+{
+  GstVideoConverter *convert = user_data;
+
+  if (convert->done_func)
+    convert->done_func (convert, convert->done_data);
+}
+
+/**
+ * gst_video_converter_frame_async:
+ * @convert: a #GstVideoConverter
+ * @src: a #GstVideoFrame
+ * @dest: a #GstVideoFrame
+ * @done: (scope async) (allow-none): function to call when the conversion
+ *   completed, or %NULL
+ * @user_data: user data passed to @done
+ *
+ * Start converting the pixels of @src into @dest using @convert and return
+ * without waiting for the conversion to complete. @convert must have been
+ * created with #GST_VIDEO_CONVERTER_OPT_ASYNC_TASKS set to %TRUE.
+ *
+ * @done is called once all pixels of @dest were written, possibly from a
+ * thread of the task pool or before this function returns. It must not call
+ * any other function on @convert. @src and @dest must stay mapped until then
+ * and gst_video_converter_frame_finish() must be called before @convert is
+ * used for the next frame. gst_video_converter_frame_finish() can also be
+ * used as a fence instead of @done.
+ *
+ * One converter only has one frame in flight at a time. To overlap the
+ * conversion of consecutive frames, use several converters with the same
+ * configuration and the same #GstTaskPool.
+ *
+ * Since: 1.20
+ */
+void
+gst_video_converter_frame_async (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest,
+    GstVideoConverterDoneFunc done, gpointer user_data)
+{
+  g_return_if_fail (convert != NULL);
+  g_return_if_fail (src != NULL);
+  g_return_if_fail (dest != NULL);
+  g_return_if_fail (gst_video_task_runner_is_async
+      (convert->conversion_runner));
+
+  convert->done_func = done;
+  convert->done_data = user_data;
+
+  /* tasks complete while convert() still schedules more, make sure done is
+   * only called at the very end */
+  gst_video_task_runner_hold (convert->conversion_runner);
+  if (video_converter_check_frames (convert, src, dest)) {
+    video_converter_prepare_overlays (convert, src);
+    convert->convert (convert, src, dest);
+    video_converter_blend_overlays (convert, dest);
+  }
+  gst_video_task_runner_release (convert->conversion_runner);
 }
 
 /**
@@ -2786,9 +3141,62 @@ gst_video_converter_frame_finish (GstVideoConverter * convert)
 {
   g_return_if_fail (convert);
   g_return_if_fail (convert->conversion_runner);
-  g_return_if_fail (convert->conversion_runner->async_tasks);
+  g_return_if_fail (gst_video_task_runner_is_async
+      (convert->conversion_runner));
+
+  gst_video_task_runner_finish (convert->conversion_runner);
+  video_converter_clear_overlays (convert);
+}
+
+/**
+ * gst_video_converter_get_fastpath_name:
+ * @convert: a #GstVideoConverter
+ *
+ * Get the name of the optimized conversion function @convert uses, for
+ * example "NV12-I420-fused-scale". Fused fastpaths convert, scale and blend in
+ * one pass over the frame, other fastpaths are named after their input and
+ * output format. This can be used to detect when a conversion falls back to
+ * the slower generic line-based conversion.
+ *
+ * Returns: (nullable): the name of the fastpath or %NULL if @convert uses
+ *   the generic conversion
+ *
+ * Since: 1.20
+ */
+const gchar *
+gst_video_converter_get_fastpath_name (GstVideoConverter * convert)
+{
+  g_return_val_if_fail (convert != NULL, NULL);
 
-  gst_parallelized_task_runner_finish (convert->conversion_runner);
+  return convert->fastpath_name;
+}
+
+/**
+ * gst_video_converter_get_stats:
+ * @convert: a #GstVideoConverter
+ *
+ * Get statistics about the conversions done with @convert so far, such as
+ * the time spent converting by all threads. See
+ * gst_video_task_runner_get_stats() for the fields of the returned
+ * structure. Additionally the "fastpath" (#G_TYPE_STRING) field contains
+ * the name returned by gst_video_converter_get_fastpath_name().
+ *
+ * Returns: (transfer full): a #GstStructure with the statistics
+ *
+ * Since: 1.20
+ */
+GstStructure *
+gst_video_converter_get_stats (GstVideoConverter * convert)
+{
+  GstStructure *stats;
+
+  g_return_val_if_fail (convert != NULL, NULL);
+
+  stats = gst_video_task_runner_get_stats (convert->conversion_runner);
+  gst_structure_set (stats, "fastpath", G_TYPE_STRING, convert->fastpath_name,
+      NULL);
+
+  return stats;
 }
 
 static void
@@ -3024,6 +3432,55 @@ do_hscale_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
   return TRUE;
 }
 
+/* scale the lines up to the end of the tile block of @in_line, one column
+ * tile at a time so that the input lines of the tile stay in the cache */
+static void
+do_vscale_tiles (GstLineCache * cache, gint idx, gint out_line, gint in_line,
+    GstVideoConverter * convert)
+{
+  GstVideoScaler *scaler = convert->v_scaler[idx];
+  gpointer *lines, *destlines, *srcs;
+  guint first, sline, n_taps, x, width, tile_width;
+  gint i, n_out, pstride;
+
+  n_out = MIN ((in_line / convert->v_tile_lines + 1) * convert->v_tile_lines,
+      convert->out_height) - in_line;
+
+  gst_video_scaler_get_coeff (scaler, in_line, &first, NULL);
+  gst_video_scaler_get_coeff (scaler, in_line + n_out - 1, &sline, &n_taps);
+  lines = gst_line_cache_get_lines (cache->prev, idx, out_line, first,
+      sline + n_taps - first);
+
+  destlines = g_newa (gpointer, n_out);
+  for (i = 0; i < n_out; i++)
+    destlines[i] = gst_line_cache_alloc_line (cache, out_line + i);
+
+  GST_DEBUG ("vresample tiles %d-%d %d-%d", in_line, in_line + n_out - 1,
+      first, sline + n_taps - 1);
+
+  srcs = g_newa (gpointer, n_taps);
+  pstride = convert->v_scale_pstride;
+  width = convert->v_scale_width;
+
+  for (x = 0; x < width; x += tile_width) {
+    tile_width = MIN (convert->v_tile_width, width - x);
+
+    for (i = 0; i < n_out; i++) {
+      guint j;
+
+      gst_video_scaler_get_coeff (scaler, in_line + i, &sline, NULL);
+      for (j = 0; j < n_taps; j++)
+        srcs[j] = (guint8 *) lines[sline - first + j] + x * pstride;
+
+      gst_video_scaler_vertical (scaler, convert->v_scale_format, srcs,
+          (guint8 *) destlines[i] + x * pstride, in_line + i, tile_width);
+    }
+  }
+
+  for (i = 0; i < n_out; i++)
+    gst_line_cache_add_line (cache, in_line + i, destlines[i]);
+}
+
 static gboolean
 do_vscale_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
     gpointer user_data)
@@ -3035,6 +3492,12 @@ do_vscale_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
 
   cline = CLAMP (in_line, 0, convert->out_height - 1);
 
+  if (convert->v_tile_width && cline == in_line
+      && convert->v_scaler == convert->v_scaler_p) {
+    do_vscale_tiles (cache, idx, out_line, in_line, convert);
+    return TRUE;
+  }
+
   gst_video_scaler_get_coeff (convert->v_scaler[idx], cline, &sline, &n_lines);
   lines = gst_line_cache_get_lines (cache->prev, idx, out_line, sline, n_lines);
 
@@ -3201,8 +3664,7 @@ do_dither_lines (GstLineCache * cache, gint idx, gint out_line, gint in_line,
 
 typedef struct
 {
-  GstLineCache *pack_lines;
-  gint idx;
+  GstLineCache **pack_lines;
   gint h_0, h_1;
   gint pack_lines_count;
   gint out_y;
@@ -3212,17 +3674,22 @@ typedef struct
 } ConvertTask;
 
 static void
-convert_generic_task (ConvertTask * task)
+convert_generic_task (ConvertTask * task, guint worker)
 {
   gint i;
 
+  /* workers pull any stripe, the lines cached by this worker belong to
+   * another stripe, possibly of the previous frame, and the unpack cache
+   * can point into a source frame that is not mapped anymore */
+  gst_line_cache_clear_chain (task->pack_lines[worker]);
+
   for (i = task->h_0; i < task->h_1; i += task->pack_lines_count) {
     gpointer *lines;
 
-    /* load the lines needed to pack */
+    /* load the lines needed to pack, using the line caches of this worker */
     lines =
-        gst_line_cache_get_lines (task->pack_lines, task->idx, i + task->out_y,
-        i, task->pack_lines_count);
+        gst_line_cache_get_lines (task->pack_lines[worker], worker,
+        i + task->out_y, i, task->pack_lines_count);
 
     if (!task->identity_pack) {
       /* take away the border */
@@ -3234,6 +3701,24 @@ convert_generic_task (ConvertTask * task)
   }
 }
 
+/* Split @height lines in at most convert->n_tasks stripes of a multiple of
+ * @align lines. Planes can be a lot smaller than the frame height the number
+ * of stripes was chosen for (subsampled chroma of a downscaled output), so
+ * only return as many stripes as needed for none of them to be empty */
+static gint
+get_n_stripes (GstVideoConverter * convert, gint height, gint align,
+    gint * lines_per_task)
+{
+  gint n_tasks = convert->n_tasks;
+  gint lines;
+
+  lines = (height + n_tasks - 1) / n_tasks;
+  lines = MAX (1, (lines + align - 1) / align * align);
+  *lines_per_task = lines;
+
+  return CLAMP ((height + lines - 1) / lines, 1, n_tasks);
+}
+
 static void
 video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
@@ -3245,8 +3730,8 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
   gint lb_width;
   ConvertTask *tasks;
   ConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
   out_height = convert->out_height;
   out_maxwidth = convert->out_maxwidth;
@@ -3295,33 +3780,33 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
       PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
   }
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (ConvertTask, convert->tasks[0], n_threads);
+      g_renew (ConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (ConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (ConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread =
-      GST_ROUND_UP_N ((out_height + n_threads - 1) / n_threads, pack_lines);
+  /* tile blocks of the vertical scaler must not cross tasks */
+  n_tasks = get_n_stripes (convert, out_height,
+      MAX (pack_lines, convert->v_tile_lines), &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dest = dest;
-    tasks[i].pack_lines = convert->pack_lines[i];
-    tasks[i].idx = i;
+    tasks[i].pack_lines = convert->pack_lines;
     tasks[i].pack_lines_count = pack_lines;
     tasks[i].out_y = out_y;
     tasks[i].identity_pack = convert->identity_pack;
     tasks[i].lb_width = lb_width;
     tasks[i].out_maxwidth = out_maxwidth;
 
-    tasks[i].h_0 = i * lines_per_thread;
-    tasks[i].h_1 = MIN ((i + 1) * lines_per_thread, out_height);
+    tasks[i].h_0 = i * lines_per_task;
+    tasks[i].h_1 = MIN ((i + 1) * lines_per_task, out_height);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_generic_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_generic_task, (gpointer *) tasks_p, n_tasks);
 
   if (convert->borderline) {
     for (i = out_y + out_height; i < out_maxheight; i++)
@@ -3360,7 +3845,10 @@ typedef struct
   MatrixData *data;
   gint in_x, in_y;
   gint out_x, out_y;
-  gpointer tmpline;
+  guint16 **tmplines;
+  /* overlays to blend onto the converted lines */
+  const ConvertOverlay *overlays;
+  guint n_overlays;
 } FConvertTask;
 
 static void
@@ -3394,8 +3882,8 @@ convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   gint h2;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
   /* I420 has half as many chroma lines, as such we have to
    * always merge two into one. For non-interlaced these are
@@ -3406,30 +3894,30 @@ convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = GST_ROUND_UP_2 ((h2 + n_threads - 1) / n_threads);
+  n_tasks = get_n_stripes (convert, h2, 2, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
     tasks[i].interlaced = interlaced;
     tasks[i].width = width;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (h2, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_YUY2_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_I420_YUY2_task, (gpointer *) tasks_p, n_tasks);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3471,8 +3959,8 @@ convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   gint h2;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
   /* I420 has half as many chroma lines, as such we have to
    * always merge two into one. For non-interlaced these are
@@ -3483,30 +3971,30 @@ convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = GST_ROUND_UP_2 ((h2 + n_threads - 1) / n_threads);
+  n_tasks = get_n_stripes (convert, h2, 2, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
     tasks[i].interlaced = interlaced;
     tasks[i].width = width;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (h2, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_UYVY_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_I420_UYVY_task, (gpointer *) tasks_p, n_tasks);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3549,8 +4037,8 @@ convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   gint h2;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
   /* I420 has half as many chroma lines, as such we have to
    * always merge two into one. For non-interlaced these are
@@ -3562,15 +4050,15 @@ convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     h2 = GST_ROUND_DOWN_2 (height);
 
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = GST_ROUND_UP_2 ((h2 + n_threads - 1) / n_threads);
+  n_tasks = get_n_stripes (convert, h2, 2, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
@@ -3578,15 +4066,15 @@ convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks[i].width = width;
     tasks[i].alpha = alpha;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (h2, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_AYUV_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_I420_AYUV_task, (gpointer *) tasks_p, n_tasks);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3630,8 +4118,8 @@ convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   gint h2;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
   /* I420 has half as many chroma lines, as such we have to
    * always merge two into one. For non-interlaced these are
@@ -3642,30 +4130,30 @@ convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = GST_ROUND_UP_2 ((h2 + n_threads - 1) / n_threads);
+  n_tasks = get_n_stripes (convert, h2, 2, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
     tasks[i].interlaced = interlaced;
     tasks[i].width = width;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (h2, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_I420_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_YUY2_I420_task, (gpointer *) tasks_p, n_tasks);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3760,28 +4248,151 @@ convert_v210_I420_task (FConvertTask * task)
         d_v[j / 2 + 1] = (v2_1 + v2_2) / 2;
       }
 
-      if (j < task->width - 3) {
-        d_y1[j + 3] = y3_1;
-        d_y2[j + 3] = y3_2;
-      }
+      if (j < task->width - 3) {
+        d_y1[j + 3] = y3_1;
+        d_y2[j + 3] = y3_2;
+      }
+
+      if (j < task->width - 4) {
+        d_y1[j + 4] = y4_1;
+        d_y2[j + 4] = y4_2;
+        d_u[j / 2 + 2] = (u4_1 + u4_2) / 2;
+        d_v[j / 2 + 2] = (v4_1 + v4_2) / 2;
+      }
+
+      if (j < task->width - 5) {
+        d_y1[j + 5] = y5_1;
+        d_y2[j + 5] = y5_2;
+      }
+    }
+  }
+}
+
+static void
+convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  int i;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  gboolean interlaced = GST_VIDEO_FRAME_IS_INTERLACED (src)
+      && (GST_VIDEO_INFO_INTERLACE_MODE (&src->info) !=
+      GST_VIDEO_INTERLACE_MODE_ALTERNATE);
+  gint h2;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_tasks;
+  gint lines_per_task;
+
+  /* I420 has half as many chroma lines, as such we have to
+   * always merge two into one. For non-interlaced these are
+   * the two next to each other, for interlaced one is skipped
+   * in between. */
+  if (interlaced)
+    h2 = GST_ROUND_DOWN_4 (height);
+  else
+    h2 = GST_ROUND_DOWN_2 (height);
+
+  n_tasks = convert->n_tasks;
+  tasks = convert->tasks[0] =
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
+
+  n_tasks = get_n_stripes (convert, h2, 2, &lines_per_task);
+
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].interlaced = interlaced;
+    tasks[i].width = width;
+
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
+    tasks[i].height_1 = MIN (h2, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_v210_I420_task, (gpointer *) tasks_p, n_tasks);
+
+  /* now handle last lines. For interlaced these are up to 3 */
+  if (h2 != height) {
+    for (i = h2; i < height; i++) {
+      UNPACK_FRAME (src, convert->tmpline[0], i, convert->in_x, width);
+      PACK_FRAME (dest, convert->tmpline[0], i, width);
+    }
+  }
+}
+
+static inline void
+unpack_v210_group (const guint8 * s, guint16 y[6], guint16 u[3], guint16 v[3])
+{
+  guint32 a0, a1, a2, a3;
+
+  a0 = GST_READ_UINT32_LE (s + 0);
+  a1 = GST_READ_UINT32_LE (s + 4);
+  a2 = GST_READ_UINT32_LE (s + 8);
+  a3 = GST_READ_UINT32_LE (s + 12);
+
+  u[0] = (a0 >> 0) & 0x3ff;
+  y[0] = (a0 >> 10) & 0x3ff;
+  v[0] = (a0 >> 20) & 0x3ff;
+  y[1] = (a1 >> 0) & 0x3ff;
+
+  u[1] = (a1 >> 10) & 0x3ff;
+  y[2] = (a1 >> 20) & 0x3ff;
+  v[1] = (a2 >> 0) & 0x3ff;
+  y[3] = (a2 >> 10) & 0x3ff;
+
+  u[2] = (a2 >> 20) & 0x3ff;
+  y[4] = (a3 >> 0) & 0x3ff;
+  v[2] = (a3 >> 10) & 0x3ff;
+  y[5] = (a3 >> 20) & 0x3ff;
+}
+
+static void
+convert_v210_P010_10LE_task (FConvertTask * task)
+{
+  gint i, j, k;
+  gint l1, l2;
+  guint16 *d_y1, *d_y2, *d_uv;
+  const guint8 *s1, *s2;
+  guint16 y_1[6], u_1[3], v_1[3];
+  guint16 y_2[6], u_2[3], v_2[3];
+
+  for (i = task->height_0; i < task->height_1; i += 2) {
+    GET_LINE_OFFSETS (task->interlaced, i, l1, l2);
+
+    d_y1 = FRAME_GET_Y_LINE (task->dest, l1);
+    d_y2 = FRAME_GET_Y_LINE (task->dest, l2);
+    d_uv = FRAME_GET_PLANE_LINE (task->dest, 1, i >> 1);
+
+    s1 = FRAME_GET_LINE (task->src, l1);
+    s2 = FRAME_GET_LINE (task->src, l2);
 
-      if (j < task->width - 4) {
-        d_y1[j + 4] = y4_1;
-        d_y2[j + 4] = y4_2;
-        d_u[j / 2 + 2] = (u4_1 + u4_2) / 2;
-        d_v[j / 2 + 2] = (v4_1 + v4_2) / 2;
-      }
+    /* the samples stay 10 bits, only the chroma lines are merged */
+    for (j = 0; j < task->width; j += 6) {
+      unpack_v210_group (s1 + (j / 6) * 16, y_1, u_1, v_1);
+      unpack_v210_group (s2 + (j / 6) * 16, y_2, u_2, v_2);
 
-      if (j < task->width - 5) {
-        d_y1[j + 5] = y5_1;
-        d_y2[j + 5] = y5_2;
+      for (k = 0; k < 6 && j + k < task->width; k++) {
+        GST_WRITE_UINT16_LE (d_y1 + j + k, y_1[k] << 6);
+        GST_WRITE_UINT16_LE (d_y2 + j + k, y_2[k] << 6);
+      }
+      for (k = 0; k < 3 && j + 2 * k < task->width; k++) {
+        GST_WRITE_UINT16_LE (d_uv + j + 2 * k, ((u_1[k] + u_2[k]) / 2) << 6);
+        GST_WRITE_UINT16_LE (d_uv + j + 2 * k + 1,
+            ((v_1[k] + v_2[k]) / 2) << 6);
       }
     }
   }
 }
 
 static void
-convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
+convert_v210_P010_10LE (GstVideoConverter * convert, const GstVideoFrame * src,
     GstVideoFrame * dest)
 {
   int i;
@@ -3793,10 +4404,10 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   gint h2;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
-  /* I420 has half as many chroma lines, as such we have to
+  /* P010 has half as many chroma lines, as such we have to
    * always merge two into one. For non-interlaced these are
    * the two next to each other, for interlaced one is skipped
    * in between. */
@@ -3805,30 +4416,31 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = GST_ROUND_UP_2 ((h2 + n_threads - 1) / n_threads);
+  n_tasks = get_n_stripes (convert, h2, 2, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
     tasks[i].interlaced = interlaced;
     tasks[i].width = width;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (h2, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_I420_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_v210_P010_10LE_task, (gpointer *) tasks_p,
+      n_tasks);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3839,6 +4451,76 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   }
 }
 
+static void
+convert_P010_10LE_I420_10LE_task (FConvertTask * task)
+{
+  gint i, j;
+  gint uv_width = (task->width + 1) / 2;
+  const guint16 *s_y, *s_uv;
+  guint16 *d_y, *d_u, *d_v;
+
+  /* P010 keeps the 10 bits in the high bits of each sample, I420_10LE in
+   * the low bits. The chroma lines map one to one, also when interlaced. */
+  for (i = task->height_0; i < task->height_1; i++) {
+    s_y = FRAME_GET_Y_LINE (task->src, i);
+    d_y = FRAME_GET_Y_LINE (task->dest, i);
+
+    for (j = 0; j < task->width; j++)
+      GST_WRITE_UINT16_LE (d_y + j, GST_READ_UINT16_LE (s_y + j) >> 6);
+  }
+
+  for (i = task->height_0 / 2; i < (task->height_1 + 1) / 2; i++) {
+    s_uv = FRAME_GET_PLANE_LINE (task->src, 1, i);
+    d_u = FRAME_GET_U_LINE (task->dest, i);
+    d_v = FRAME_GET_V_LINE (task->dest, i);
+
+    for (j = 0; j < uv_width; j++) {
+      GST_WRITE_UINT16_LE (d_u + j, GST_READ_UINT16_LE (s_uv + 2 * j) >> 6);
+      GST_WRITE_UINT16_LE (d_v + j,
+          GST_READ_UINT16_LE (s_uv + 2 * j + 1) >> 6);
+    }
+  }
+}
+
+static void
+convert_P010_10LE_I420_10LE (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  int i;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_tasks;
+  gint lines_per_task;
+
+  n_tasks = convert->n_tasks;
+  tasks = convert->tasks[0] =
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
+
+  /* even, so that each task also does whole chroma lines */
+  n_tasks = get_n_stripes (convert, height, 2, &lines_per_task);
+
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].width = width;
+
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
+    tasks[i].height_1 = MIN (height, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_P010_10LE_I420_10LE_task,
+      (gpointer *) tasks_p, n_tasks);
+}
+
 typedef struct
 {
   const guint8 *s, *s2, *su, *sv;
@@ -3867,8 +4549,8 @@ convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 alpha = MIN (convert->alpha_value, 255);
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -3876,31 +4558,31 @@ convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
     tasks[i].alpha = alpha;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_AYUV_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_YUY2_AYUV_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -3922,8 +4604,8 @@ convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *dy, *du, *dv;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -3936,34 +4618,34 @@ convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_Y_STRIDE (dest);
     tasks[i].dustride = FRAME_GET_U_STRIDE (dest);
     tasks[i].dvstride = FRAME_GET_V_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = dy + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].du = du + i * lines_per_thread * tasks[i].dustride;
-    tasks[i].dv = dv + i * lines_per_thread * tasks[i].dvstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = dy + i * lines_per_task * tasks[i].dstride;
+    tasks[i].du = du + i * lines_per_task * tasks[i].dustride;
+    tasks[i].dv = dv + i * lines_per_task * tasks[i].dvstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_Y42B_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_YUY2_Y42B_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -3987,8 +4669,8 @@ convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *dy, *du, *dv;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4001,34 +4683,34 @@ convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_Y_STRIDE (dest);
     tasks[i].dustride = FRAME_GET_U_STRIDE (dest);
     tasks[i].dvstride = FRAME_GET_V_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = dy + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].du = du + i * lines_per_thread * tasks[i].dustride;
-    tasks[i].dv = dv + i * lines_per_thread * tasks[i].dvstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = dy + i * lines_per_task * tasks[i].dstride;
+    tasks[i].du = du + i * lines_per_task * tasks[i].dustride;
+    tasks[i].dv = dv + i * lines_per_task * tasks[i].dvstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_Y444_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_YUY2_Y444_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4111,8 +4793,8 @@ convert_v210_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *dy, *du, *dv;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4125,34 +4807,34 @@ convert_v210_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_Y_STRIDE (dest);
     tasks[i].dustride = FRAME_GET_U_STRIDE (dest);
     tasks[i].dvstride = FRAME_GET_V_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = dy + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].du = du + i * lines_per_thread * tasks[i].dustride;
-    tasks[i].dv = dv + i * lines_per_thread * tasks[i].dvstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = dy + i * lines_per_task * tasks[i].dstride;
+    tasks[i].du = du + i * lines_per_task * tasks[i].dustride;
+    tasks[i].dv = dv + i * lines_per_task * tasks[i].dvstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_Y42B_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_v210_Y42B_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4188,8 +4870,8 @@ convert_UYVY_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   gint h2;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
   /* I420 has half as many chroma lines, as such we have to
    * always merge two into one. For non-interlaced these are
@@ -4200,30 +4882,30 @@ convert_UYVY_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = GST_ROUND_UP_2 ((h2 + n_threads - 1) / n_threads);
+  n_tasks = get_n_stripes (convert, h2, 2, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
     tasks[i].interlaced = interlaced;
     tasks[i].width = width;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (h2, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_I420_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_UYVY_I420_task, (gpointer *) tasks_p, n_tasks);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -4251,8 +4933,8 @@ convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 alpha = MIN (convert->alpha_value, 255);
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4260,31 +4942,31 @@ convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
     tasks[i].alpha = alpha;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_AYUV_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_UYVY_AYUV_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4305,8 +4987,8 @@ convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4314,30 +4996,30 @@ convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_YUY2_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_UYVY_YUY2_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4418,8 +5100,8 @@ convert_v210_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4427,30 +5109,30 @@ convert_v210_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_UYVY_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_v210_UYVY_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4531,8 +5213,8 @@ convert_v210_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4540,30 +5222,30 @@ convert_v210_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_YUY2_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_v210_YUY2_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4585,8 +5267,8 @@ convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *dy, *du, *dv;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4599,34 +5281,34 @@ convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_Y_STRIDE (dest);
     tasks[i].dustride = FRAME_GET_U_STRIDE (dest);
     tasks[i].dvstride = FRAME_GET_V_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = dy + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].du = du + i * lines_per_thread * tasks[i].dustride;
-    tasks[i].dv = dv + i * lines_per_thread * tasks[i].dvstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = dy + i * lines_per_task * tasks[i].dstride;
+    tasks[i].du = du + i * lines_per_task * tasks[i].dustride;
+    tasks[i].dv = dv + i * lines_per_task * tasks[i].dvstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_Y42B_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_UYVY_Y42B_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4650,8 +5332,8 @@ convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *dy, *du, *dv;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4664,34 +5346,34 @@ convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_Y_STRIDE (dest);
     tasks[i].dustride = FRAME_GET_U_STRIDE (dest);
     tasks[i].dvstride = FRAME_GET_V_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = dy + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].du = du + i * lines_per_thread * tasks[i].dustride;
-    tasks[i].dv = dv + i * lines_per_thread * tasks[i].dvstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = dy + i * lines_per_task * tasks[i].dstride;
+    tasks[i].du = du + i * lines_per_task * tasks[i].dustride;
+    tasks[i].dv = dv + i * lines_per_task * tasks[i].dvstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_Y444_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_UYVY_Y444_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4713,37 +5395,38 @@ convert_UYVY_GRAY8 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
   d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_GRAY8_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_UYVY_GRAY8_task, (gpointer *) tasks_p,
+      n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4769,8 +5452,8 @@ convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s1, *s2, *dy1, *dy2, *du, *dv;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s1 = FRAME_GET_LINE (src, convert->in_y + 0);
@@ -4789,36 +5472,36 @@ convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
 
   /* only for even width/height */
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = GST_ROUND_UP_2 ((height + n_threads - 1) / n_threads);
+  n_tasks = get_n_stripes (convert, height, 2, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_Y_STRIDE (dest);
     tasks[i].dustride = FRAME_GET_U_STRIDE (dest);
     tasks[i].dvstride = FRAME_GET_V_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = dy1 + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].d2 = dy2 + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].du = du + i * lines_per_thread * tasks[i].dustride / 2;
-    tasks[i].dv = dv + i * lines_per_thread * tasks[i].dvstride / 2;
-    tasks[i].s = s1 + i * lines_per_thread * tasks[i].sstride;
-    tasks[i].s2 = s2 + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = dy1 + i * lines_per_task * tasks[i].dstride;
+    tasks[i].d2 = dy2 + i * lines_per_task * tasks[i].dstride;
+    tasks[i].du = du + i * lines_per_task * tasks[i].dustride / 2;
+    tasks[i].dv = dv + i * lines_per_task * tasks[i].dvstride / 2;
+    tasks[i].s = s1 + i * lines_per_task * tasks[i].sstride;
+    tasks[i].s2 = s2 + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_I420_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_AYUV_I420_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4839,8 +5522,8 @@ convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4849,30 +5532,30 @@ convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_YUY2_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_AYUV_YUY2_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4893,8 +5576,8 @@ convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4903,30 +5586,30 @@ convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_UYVY_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_AYUV_UYVY_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -4948,8 +5631,8 @@ convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *dy, *du, *dv;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -4963,34 +5646,34 @@ convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv += convert->out_x >> 1;
 
   /* only works for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_Y_STRIDE (dest);
     tasks[i].dustride = FRAME_GET_U_STRIDE (dest);
     tasks[i].dvstride = FRAME_GET_V_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = dy + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].du = du + i * lines_per_thread * tasks[i].dustride;
-    tasks[i].dv = dv + i * lines_per_thread * tasks[i].dvstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = dy + i * lines_per_task * tasks[i].dstride;
+    tasks[i].du = du + i * lines_per_task * tasks[i].dustride;
+    tasks[i].dv = dv + i * lines_per_task * tasks[i].dvstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_Y42B_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_AYUV_Y42B_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5012,8 +5695,8 @@ convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *dy, *du, *dv;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -5026,34 +5709,34 @@ convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_Y_STRIDE (dest);
     tasks[i].dustride = FRAME_GET_U_STRIDE (dest);
     tasks[i].dvstride = FRAME_GET_V_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = dy + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].du = du + i * lines_per_thread * tasks[i].dustride;
-    tasks[i].dv = dv + i * lines_per_thread * tasks[i].dvstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = dy + i * lines_per_task * tasks[i].dstride;
+    tasks[i].du = du + i * lines_per_task * tasks[i].dustride;
+    tasks[i].dv = dv + i * lines_per_task * tasks[i].dvstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_Y444_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_AYUV_Y444_task, (gpointer *) tasks_p, n_tasks);
   convert_fill_border (convert, dest);
 }
 
@@ -5075,8 +5758,8 @@ convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *sy, *su, *sv, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   sy = FRAME_GET_Y_LINE (src, convert->in_y);
@@ -5089,34 +5772,34 @@ convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_Y_STRIDE (src);
     tasks[i].sustride = FRAME_GET_U_STRIDE (src);
     tasks[i].svstride = FRAME_GET_V_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = sy + i * lines_per_thread * tasks[i].sstride;
-    tasks[i].su = su + i * lines_per_thread * tasks[i].sustride;
-    tasks[i].sv = sv + i * lines_per_thread * tasks[i].svstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = sy + i * lines_per_task * tasks[i].sstride;
+    tasks[i].su = su + i * lines_per_task * tasks[i].sustride;
+    tasks[i].sv = sv + i * lines_per_task * tasks[i].svstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_YUY2_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_Y42B_YUY2_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5139,8 +5822,8 @@ convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *sy, *su, *sv, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   sy = FRAME_GET_Y_LINE (src, convert->in_y);
@@ -5153,34 +5836,34 @@ convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_Y_STRIDE (src);
     tasks[i].sustride = FRAME_GET_U_STRIDE (src);
     tasks[i].svstride = FRAME_GET_V_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = sy + i * lines_per_thread * tasks[i].sstride;
-    tasks[i].su = su + i * lines_per_thread * tasks[i].sustride;
-    tasks[i].sv = sv + i * lines_per_thread * tasks[i].svstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = sy + i * lines_per_task * tasks[i].sstride;
+    tasks[i].su = su + i * lines_per_task * tasks[i].sustride;
+    tasks[i].sv = sv + i * lines_per_task * tasks[i].svstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_UYVY_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_Y42B_UYVY_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5205,8 +5888,8 @@ convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 alpha = MIN (convert->alpha_value, 255);
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   sy = FRAME_GET_Y_LINE (src, convert->in_y);
@@ -5220,35 +5903,35 @@ convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d += convert->out_x * 4;
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_Y_STRIDE (src);
     tasks[i].sustride = FRAME_GET_U_STRIDE (src);
     tasks[i].svstride = FRAME_GET_V_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = sy + i * lines_per_thread * tasks[i].sstride;
-    tasks[i].su = su + i * lines_per_thread * tasks[i].sustride;
-    tasks[i].sv = sv + i * lines_per_thread * tasks[i].svstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = sy + i * lines_per_task * tasks[i].sstride;
+    tasks[i].su = su + i * lines_per_task * tasks[i].sustride;
+    tasks[i].sv = sv + i * lines_per_task * tasks[i].svstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
     tasks[i].alpha = alpha;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_AYUV_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_Y42B_AYUV_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5271,8 +5954,8 @@ convert_Y444_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *sy, *su, *sv, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   sy = FRAME_GET_Y_LINE (src, convert->in_y);
@@ -5285,34 +5968,34 @@ convert_Y444_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_Y_STRIDE (src);
     tasks[i].sustride = FRAME_GET_U_STRIDE (src);
     tasks[i].svstride = FRAME_GET_V_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = sy + i * lines_per_thread * tasks[i].sstride;
-    tasks[i].su = su + i * lines_per_thread * tasks[i].sustride;
-    tasks[i].sv = sv + i * lines_per_thread * tasks[i].svstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = sy + i * lines_per_task * tasks[i].sstride;
+    tasks[i].su = su + i * lines_per_task * tasks[i].sustride;
+    tasks[i].sv = sv + i * lines_per_task * tasks[i].svstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y444_YUY2_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_Y444_YUY2_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5335,8 +6018,8 @@ convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *sy, *su, *sv, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   sy = FRAME_GET_Y_LINE (src, convert->in_y);
@@ -5349,34 +6032,34 @@ convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_Y_STRIDE (src);
     tasks[i].sustride = FRAME_GET_U_STRIDE (src);
     tasks[i].svstride = FRAME_GET_V_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = sy + i * lines_per_thread * tasks[i].sstride;
-    tasks[i].su = su + i * lines_per_thread * tasks[i].sustride;
-    tasks[i].sv = sv + i * lines_per_thread * tasks[i].svstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = sy + i * lines_per_task * tasks[i].sstride;
+    tasks[i].su = su + i * lines_per_task * tasks[i].sustride;
+    tasks[i].sv = sv + i * lines_per_task * tasks[i].svstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y444_UYVY_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_Y444_UYVY_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5401,8 +6084,8 @@ convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 alpha = MIN (convert->alpha_value, 255);
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   sy = FRAME_GET_Y_LINE (src, convert->in_y);
@@ -5415,35 +6098,35 @@ convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += convert->out_x * 4;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_Y_STRIDE (src);
     tasks[i].sustride = FRAME_GET_U_STRIDE (src);
     tasks[i].svstride = FRAME_GET_V_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = sy + i * lines_per_thread * tasks[i].sstride;
-    tasks[i].su = su + i * lines_per_thread * tasks[i].sustride;
-    tasks[i].sv = sv + i * lines_per_thread * tasks[i].svstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = sy + i * lines_per_task * tasks[i].sstride;
+    tasks[i].su = su + i * lines_per_task * tasks[i].sustride;
+    tasks[i].sv = sv + i * lines_per_task * tasks[i].svstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
     tasks[i].alpha = alpha;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y444_AYUV_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_Y444_AYUV_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5468,8 +6151,8 @@ convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -5477,31 +6160,31 @@ convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
     tasks[i].data = data;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_ARGB_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_AYUV_ARGB_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5525,8 +6208,8 @@ convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -5534,31 +6217,31 @@ convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
     tasks[i].data = data;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_BGRA_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_AYUV_BGRA_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5582,8 +6265,8 @@ convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -5591,31 +6274,31 @@ convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
     tasks[i].data = data;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_ABGR_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_AYUV_ABGR_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5639,8 +6322,8 @@ convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
   guint8 *s, *d;
   FConvertPlaneTask *tasks;
   FConvertPlaneTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_LINE (src, convert->in_y);
@@ -5648,31 +6331,31 @@ convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
+      g_renew (FConvertPlaneTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertPlaneTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_STRIDE (dest);
     tasks[i].sstride = FRAME_GET_STRIDE (src);
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = width;
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, height);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
     tasks[i].data = data;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_RGBA_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_AYUV_RGBA_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -5710,8 +6393,18 @@ convert_I420_BGRA_task (FConvertTask * task)
 }
 
 static void
-convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
-    GstVideoFrame * dest)
+convert_I420_BGRA_blend_task (FConvertTask * task)
+{
+  convert_I420_BGRA_task (task);
+
+  /* blend while the lines are still in the cache */
+  video_converter_blend_lines (task->overlays, task->n_overlays, task->dest,
+      task->out_y + task->height_0, task->out_y + task->height_1);
+}
+
+static void
+convert_I420_BGRA_full (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest, gboolean blend)
 {
   int i;
   gint width = convert->in_width;
@@ -5719,18 +6412,19 @@ convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   MatrixData *data = &convert->convert_matrix;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  GstVideoTaskFunc func;
+  gint n_tasks;
+  gint lines_per_task;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
@@ -5740,20 +6434,41 @@ convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks[i].in_y = convert->in_y;
     tasks[i].out_x = convert->out_x;
     tasks[i].out_y = convert->out_y;
+    tasks[i].overlays = convert->overlays;
+    tasks[i].n_overlays = convert->n_overlays;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (height, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_BGRA_task, (gpointer) tasks_p);
+  if (blend)
+    func = (GstVideoTaskFunc) convert_I420_BGRA_blend_task;
+  else
+    func = (GstVideoTaskFunc) convert_I420_BGRA_task;
+
+  gst_video_task_runner_run (convert->conversion_runner, func,
+      (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
 
+static void
+convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_I420_BGRA_full (convert, src, dest, FALSE);
+}
+
+static void
+convert_I420_BGRA_fused_blend (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_I420_BGRA_full (convert, src, dest, TRUE);
+}
+
 static void
 convert_I420_ARGB_task (FConvertTask * task)
 {
@@ -5795,18 +6510,18 @@ convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   MatrixData *data = &convert->convert_matrix;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
@@ -5817,23 +6532,24 @@ convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks[i].out_x = convert->out_x;
     tasks[i].out_y = convert->out_y;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (height, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_ARGB_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_I420_ARGB_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_I420_pack_ARGB_task (FConvertTask * task)
+convert_I420_pack_ARGB_task (FConvertTask * task, guint worker)
 {
   gint i;
+  gpointer tmpline = tmplines[worker];
   gpointer d[GST_VIDEO_MAX_PLANES];
 
   d[0] = FRAME_GET_LINE (task->dest, 0);
@@ -5852,12 +6568,12 @@ convert_I420_pack_ARGB_task (FConvertTask * task)
     sv += (task->in_x >> 1);
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    video_orc_convert_I420_ARGB (task->tmpline, sy, su, sv,
+    video_orc_convert_I420_ARGB (tmpline, sy, su, sv,
         task->data->im[0][0], task->data->im[0][2],
         task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
         task->width);
 #else
-    video_orc_convert_I420_BGRA (task->tmpline, sy, su, sv,
+    video_orc_convert_I420_BGRA (tmpline, sy, su, sv,
         task->data->im[0][0], task->data->im[0][2],
         task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
         task->width);
@@ -5866,7 +6582,7 @@ convert_I420_pack_ARGB_task (FConvertTask * task)
         (GST_VIDEO_FRAME_IS_INTERLACED (task->dest) ?
             GST_VIDEO_PACK_FLAG_INTERLACED :
             GST_VIDEO_PACK_FLAG_NONE),
-        task->tmpline, 0, d, task->dest->info.stride,
+        tmpline, 0, d, task->dest->info.stride,
         task->dest->info.chroma_site, i + task->out_y, task->width);
   }
 }
@@ -5881,18 +6597,18 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   MatrixData *data = &convert->convert_matrix;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
@@ -5902,26 +6618,27 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks[i].in_y = convert->in_y;
     tasks[i].out_x = convert->out_x;
     tasks[i].out_y = convert->out_y;
-    tasks[i].tmpline = convert->tmpline[i];
+    tasks[i].tmplines = convert->tmpline;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (height, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_pack_ARGB_task,
-      (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_I420_pack_ARGB_task, (gpointer *) tasks_p,
+      n_tasks);
 
   convert_fill_border (convert, dest);
 }
 
 static void
-convert_A420_pack_ARGB_task (FConvertTask * task)
+convert_A420_pack_ARGB_task (FConvertTask * task, guint worker)
 {
   gint i;
+  gpointer tmpline = tmplines[worker];
   gpointer d[GST_VIDEO_MAX_PLANES];
 
   d[0] = FRAME_GET_LINE (task->dest, 0);
@@ -5942,12 +6659,12 @@ convert_A420_pack_ARGB_task (FConvertTask * task)
     sa += task->in_x;
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    video_orc_convert_A420_ARGB (task->tmpline, sy, su, sv, sa,
+    video_orc_convert_A420_ARGB (tmpline, sy, su, sv, sa,
         task->data->im[0][0], task->data->im[0][2],
         task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
         task->width);
 #else
-    video_orc_convert_A420_BGRA (task->tmpline, sy, su, sv, sa,
+    video_orc_convert_A420_BGRA (tmpline, sy, su, sv, sa,
         task->data->im[0][0], task->data->im[0][2],
         task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
         task->width);
@@ -5957,7 +6674,7 @@ convert_A420_pack_ARGB_task (FConvertTask * task)
         (GST_VIDEO_FRAME_IS_INTERLACED (task->dest) ?
             GST_VIDEO_PACK_FLAG_INTERLACED :
             GST_VIDEO_PACK_FLAG_NONE),
-        task->tmpline, 0, d, task->dest->info.stride,
+        tmpline, 0, d, task->dest->info.stride,
         task->dest->info.chroma_site, i + task->out_y, task->width);
   }
 }
@@ -5972,18 +6689,18 @@ convert_A420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   MatrixData *data = &convert->convert_matrix;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
@@ -5993,18 +6710,18 @@ convert_A420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks[i].in_y = convert->in_y;
     tasks[i].out_x = convert->out_x;
     tasks[i].out_y = convert->out_y;
-    tasks[i].tmpline = convert->tmpline[i];
+    tasks[i].tmplines = convert->tmpline;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (height, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_A420_pack_ARGB_task,
-      (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_A420_pack_ARGB_task, (gpointer *) tasks_p,
+      n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -6052,18 +6769,18 @@ convert_A420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   MatrixData *data = &convert->convert_matrix;
   FConvertTask *tasks;
   FConvertTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[0] =
-      g_renew (FConvertTask, convert->tasks[0], n_threads);
+      g_renew (FConvertTask, convert->tasks[0], n_tasks);
   tasks_p = convert->tasks_p[0] =
-      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+      g_renew (FConvertTask *, convert->tasks_p[0], n_tasks);
 
-  lines_per_thread = (height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].src = src;
     tasks[i].dest = dest;
 
@@ -6074,15 +6791,15 @@ convert_A420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks[i].out_x = convert->out_x;
     tasks[i].out_y = convert->out_y;
 
-    tasks[i].height_0 = i * lines_per_thread;
-    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_0 = i * lines_per_task;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_task;
     tasks[i].height_1 = MIN (height, tasks[i].height_1);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_A420_BGRA_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_A420_BGRA_task, (gpointer *) tasks_p, n_tasks);
 
   convert_fill_border (convert, dest);
 }
@@ -6258,35 +6975,37 @@ convert_plane_fill (GstVideoConverter * convert,
   guint8 *d;
   FSimpleScaleTask *tasks;
   FSimpleScaleTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[plane] =
-      g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
+      g_renew (FSimpleScaleTask, convert->tasks[plane], n_tasks);
   tasks_p = convert->tasks_p[plane] =
-      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_threads);
-  lines_per_thread = (convert->fout_height[plane] + n_threads - 1) / n_threads;
+      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_tasks);
+  n_tasks = get_n_stripes (convert, convert->fout_height[plane], 1,
+      &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
-    tasks[i].d = d + i * lines_per_thread * convert->fout_width[plane];
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].dstride = FRAME_GET_PLANE_STRIDE (dest, plane);
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
 
     tasks[i].fill = convert->ffill[plane];
     tasks[i].width = convert->fout_width[plane];
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, convert->fout_height[plane]);
-    tasks[i].height -= i * lines_per_thread;
-    tasks[i].dstride = FRAME_GET_PLANE_STRIDE (dest, plane);
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_fill_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_plane_fill_task, (gpointer *) tasks_p,
+      n_tasks);
 }
 
 static void
@@ -6304,8 +7023,8 @@ convert_plane_h_double (GstVideoConverter * convert,
   gint splane = convert->fsplane[plane];
   FSimpleScaleTask *tasks;
   FSimpleScaleTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
@@ -6313,31 +7032,32 @@ convert_plane_h_double (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[plane] =
-      g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
+      g_renew (FSimpleScaleTask, convert->tasks[plane], n_tasks);
   tasks_p = convert->tasks_p[plane] =
-      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_threads);
-  lines_per_thread = (convert->fout_height[plane] + n_threads - 1) / n_threads;
+      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_tasks);
+  n_tasks = get_n_stripes (convert, convert->fout_height[plane], 1,
+      &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_PLANE_STRIDE (dest, plane);
     tasks[i].sstride = FRAME_GET_PLANE_STRIDE (src, splane);
 
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = convert->fout_width[plane];
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, convert->fout_height[plane]);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_h_double_task,
-      (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_plane_h_double_task, (gpointer *) tasks_p,
+      n_tasks);
 }
 
 static void
@@ -6355,8 +7075,8 @@ convert_plane_h_halve (GstVideoConverter * convert,
   gint splane = convert->fsplane[plane];
   FSimpleScaleTask *tasks;
   FSimpleScaleTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
@@ -6364,30 +7084,32 @@ convert_plane_h_halve (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[plane] =
-      g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
+      g_renew (FSimpleScaleTask, convert->tasks[plane], n_tasks);
   tasks_p = convert->tasks_p[plane] =
-      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_threads);
-  lines_per_thread = (convert->fout_height[plane] + n_threads - 1) / n_threads;
+      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_tasks);
+  n_tasks = get_n_stripes (convert, convert->fout_height[plane], 1,
+      &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
+  for (i = 0; i < n_tasks; i++) {
     tasks[i].dstride = FRAME_GET_PLANE_STRIDE (dest, plane);
     tasks[i].sstride = FRAME_GET_PLANE_STRIDE (src, splane);
 
-    tasks[i].d = d + i * lines_per_thread * tasks[i].dstride;
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].d = d + i * lines_per_task * tasks[i].dstride;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride;
 
     tasks[i].width = convert->fout_width[plane];
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, convert->fout_height[plane]);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_h_halve_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_plane_h_halve_task, (gpointer *) tasks_p,
+      n_tasks);
 }
 
 static void
@@ -6405,8 +7127,8 @@ convert_plane_v_double (GstVideoConverter * convert,
   gint ds, splane = convert->fsplane[plane];
   FSimpleScaleTask *tasks;
   FSimpleScaleTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
@@ -6417,33 +7139,32 @@ convert_plane_v_double (GstVideoConverter * convert,
   d2 += convert->fout_x[plane];
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[plane] =
-      g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
+      g_renew (FSimpleScaleTask, convert->tasks[plane], n_tasks);
   tasks_p = convert->tasks_p[plane] =
-      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_threads);
-  lines_per_thread =
-      GST_ROUND_UP_2 ((convert->fout_height[plane] + n_threads -
-          1) / n_threads);
-
-  for (i = 0; i < n_threads; i++) {
-    tasks[i].d = d1 + i * lines_per_thread * ds;
-    tasks[i].d2 = d2 + i * lines_per_thread * ds;
+      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_tasks);
+  n_tasks = get_n_stripes (convert, convert->fout_height[plane], 2,
+      &lines_per_task);
+
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].d = d1 + i * lines_per_task * ds;
+    tasks[i].d2 = d2 + i * lines_per_task * ds;
     tasks[i].dstride = ds;
     tasks[i].sstride = FRAME_GET_PLANE_STRIDE (src, splane);
-    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride / 2;
+    tasks[i].s = s + i * lines_per_task * tasks[i].sstride / 2;
 
     tasks[i].width = convert->fout_width[plane];
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, convert->fout_height[plane]);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_v_double_task,
-      (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_plane_v_double_task, (gpointer *) tasks_p,
+      n_tasks);
 }
 
 static void
@@ -6462,8 +7183,8 @@ convert_plane_v_halve (GstVideoConverter * convert,
   gint ss, ds, splane = convert->fsplane[plane];
   FSimpleScaleTask *tasks;
   FSimpleScaleTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s1 = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
@@ -6476,30 +7197,32 @@ convert_plane_v_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[plane] =
-      g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
+      g_renew (FSimpleScaleTask, convert->tasks[plane], n_tasks);
   tasks_p = convert->tasks_p[plane] =
-      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_threads);
-  lines_per_thread = (convert->fout_height[plane] + n_threads - 1) / n_threads;
+      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_tasks);
+  n_tasks = get_n_stripes (convert, convert->fout_height[plane], 1,
+      &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
-    tasks[i].d = d + i * lines_per_thread * ds;
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].d = d + i * lines_per_task * ds;
     tasks[i].dstride = ds;
-    tasks[i].s = s1 + i * lines_per_thread * ss * 2;
-    tasks[i].s2 = s2 + i * lines_per_thread * ss * 2;
+    tasks[i].s = s1 + i * lines_per_task * ss * 2;
+    tasks[i].s2 = s2 + i * lines_per_task * ss * 2;
     tasks[i].sstride = ss;
 
     tasks[i].width = convert->fout_width[plane];
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, convert->fout_height[plane]);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_v_halve_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_plane_v_halve_task, (gpointer *) tasks_p,
+      n_tasks);
 }
 
 static void
@@ -6518,8 +7241,8 @@ convert_plane_hv_double (GstVideoConverter * convert,
   gint ss, ds, splane = convert->fsplane[plane];
   FSimpleScaleTask *tasks;
   FSimpleScaleTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
@@ -6531,33 +7254,32 @@ convert_plane_hv_double (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[plane] =
-      g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
+      g_renew (FSimpleScaleTask, convert->tasks[plane], n_tasks);
   tasks_p = convert->tasks_p[plane] =
-      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_threads);
-  lines_per_thread =
-      GST_ROUND_UP_2 ((convert->fout_height[plane] + n_threads -
-          1) / n_threads);
-
-  for (i = 0; i < n_threads; i++) {
-    tasks[i].d = d1 + i * lines_per_thread * ds;
-    tasks[i].d2 = d2 + i * lines_per_thread * ds;
+      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_tasks);
+  n_tasks = get_n_stripes (convert, convert->fout_height[plane], 2,
+      &lines_per_task);
+
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].d = d1 + i * lines_per_task * ds;
+    tasks[i].d2 = d2 + i * lines_per_task * ds;
     tasks[i].dstride = ds;
     tasks[i].sstride = ss;
-    tasks[i].s = s + i * lines_per_thread * ss / 2;
+    tasks[i].s = s + i * lines_per_task * ss / 2;
 
     tasks[i].width = convert->fout_width[plane];
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, convert->fout_height[plane]);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_hv_double_task,
-      (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_plane_hv_double_task, (gpointer *) tasks_p,
+      n_tasks);
 }
 
 static void
@@ -6576,8 +7298,8 @@ convert_plane_hv_halve (GstVideoConverter * convert,
   gint ss, ds, splane = convert->fsplane[plane];
   FSimpleScaleTask *tasks;
   FSimpleScaleTask **tasks_p;
-  gint n_threads;
-  gint lines_per_thread;
+  gint n_tasks;
+  gint lines_per_task;
   gint i;
 
   s1 = FRAME_GET_PLANE_LINE (src, splane, convert->fin_y[splane]);
@@ -6589,36 +7311,38 @@ convert_plane_hv_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[plane] =
-      g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
+      g_renew (FSimpleScaleTask, convert->tasks[plane], n_tasks);
   tasks_p = convert->tasks_p[plane] =
-      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_threads);
-  lines_per_thread = (convert->fout_height[plane] + n_threads - 1) / n_threads;
+      g_renew (FSimpleScaleTask *, convert->tasks_p[plane], n_tasks);
+  n_tasks = get_n_stripes (convert, convert->fout_height[plane], 1,
+      &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
-    tasks[i].d = d + i * lines_per_thread * ds;
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].d = d + i * lines_per_task * ds;
     tasks[i].dstride = ds;
-    tasks[i].s = s1 + i * lines_per_thread * ss * 2;
-    tasks[i].s2 = s2 + i * lines_per_thread * ss * 2;
+    tasks[i].s = s1 + i * lines_per_task * ss * 2;
+    tasks[i].s2 = s2 + i * lines_per_task * ss * 2;
     tasks[i].sstride = ss;
 
     tasks[i].width = convert->fout_width[plane];
-    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = (i + 1) * lines_per_task;
     tasks[i].height = MIN (tasks[i].height, convert->fout_height[plane]);
-    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height -= i * lines_per_task;
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_hv_halve_task,
-      (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_plane_hv_halve_task, (gpointer *) tasks_p,
+      n_tasks);
 }
 
 typedef struct
 {
-  GstVideoScaler *h_scaler, *v_scaler;
+  /* per worker scalers */
+  GstVideoScaler **h_scaler, **v_scaler;
   GstVideoFormat format;
   const guint8 *s;
   guint8 *d;
@@ -6627,9 +7351,10 @@ typedef struct
 } FScaleTask;
 
 static void
-convert_plane_hv_task (FScaleTask * task)
+convert_plane_hv_task (FScaleTask * task, guint worker)
 {
-  gst_video_scaler_2d (task->h_scaler, task->v_scaler, task->format,
+  gst_video_scaler_2d (task->h_scaler ? task->h_scaler[worker] : NULL,
+      task->v_scaler ? task->v_scaler[worker] : NULL, task->format,
       (guint8 *) task->s, task->sstride,
       task->d, task->dstride, task->x, task->y, task->w, task->h);
 }
@@ -6645,7 +7370,7 @@ convert_plane_hv (GstVideoConverter * convert,
   gint sstride, dstride;
   FScaleTask *tasks;
   FScaleTask **tasks_p;
-  gint i, n_threads, lines_per_thread;
+  gint i, n_tasks, lines_per_task;
 
   in_x = convert->fin_x[splane];
   in_y = convert->fin_y[splane];
@@ -6663,21 +7388,17 @@ convert_plane_hv (GstVideoConverter * convert,
   sstride = FRAME_GET_PLANE_STRIDE (src, splane);
   dstride = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_tasks = convert->n_tasks;
   tasks = convert->tasks[plane] =
-      g_renew (FScaleTask, convert->tasks[plane], n_threads);
+      g_renew (FScaleTask, convert->tasks[plane], n_tasks);
   tasks_p = convert->tasks_p[plane] =
-      g_renew (FScaleTask *, convert->tasks_p[plane], n_threads);
+      g_renew (FScaleTask *, convert->tasks_p[plane], n_tasks);
 
-  lines_per_thread = (out_height + n_threads - 1) / n_threads;
+  n_tasks = get_n_stripes (convert, out_height, 1, &lines_per_task);
 
-  for (i = 0; i < n_threads; i++) {
-    tasks[i].h_scaler =
-        convert->fh_scaler[plane].scaler ? convert->
-        fh_scaler[plane].scaler[i] : NULL;
-    tasks[i].v_scaler =
-        convert->fv_scaler[plane].scaler ? convert->
-        fv_scaler[plane].scaler[i] : NULL;
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].h_scaler = convert->fh_scaler[plane].scaler;
+    tasks[i].v_scaler = convert->fv_scaler[plane].scaler;
     tasks[i].format = format;
     tasks[i].s = s;
     tasks[i].d = d;
@@ -6687,15 +7408,15 @@ convert_plane_hv (GstVideoConverter * convert,
     tasks[i].x = 0;
     tasks[i].w = out_width;
 
-    tasks[i].y = i * lines_per_thread;
-    tasks[i].h = tasks[i].y + lines_per_thread;
+    tasks[i].y = i * lines_per_task;
+    tasks[i].h = tasks[i].y + lines_per_task;
     tasks[i].h = MIN (out_height, tasks[i].h);
 
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_hv_task, (gpointer) tasks_p);
+  gst_video_task_runner_run (convert->conversion_runner,
+      (GstVideoTaskFunc) convert_plane_hv_task, (gpointer *) tasks_p, n_tasks);
 }
 
 static void
@@ -6864,7 +7585,7 @@ setup_scale (GstVideoConverter * convert)
   const GstVideoFormatInfo *in_finfo, *out_finfo;
   GstVideoFormat in_format, out_format;
   gboolean interlaced;
-  guint n_threads = convert->conversion_runner->n_threads;
+  guint n_threads = convert->n_threads;
 
   in_info = &convert->in_info;
   out_info = &convert->out_info;
@@ -7149,6 +7870,401 @@ setup_scale (GstVideoConverter * convert)
   return TRUE;
 }
 
+/* Fused fastpaths
+ *
+ * These convert, scale and pack in one pass over the output lines. The
+ * horizontally scaled input lines are kept in a small ring per worker while
+ * the vertical scaler needs them, so no intermediate AYUV lines are made and
+ * the working set stays in the cache.
+ */
+typedef struct
+{
+  GstVideoConverter *convert;
+  const GstVideoFrame *src;
+  GstVideoFrame *dest;
+  /* output lines to produce */
+  gint y0, y1;
+} FFusedTask;
+
+static void
+fused_ring_init (FusedLineRing * ring, GstVideoScaler * v_scaler,
+    gsize line_size)
+{
+  ring->n_lines = v_scaler ? gst_video_scaler_get_max_taps (v_scaler) : 0;
+  ring->stride = GST_ROUND_UP_32 (line_size);
+  ring->data = g_malloc (ring->n_lines * ring->stride);
+  ring->in_line = g_new (gint, ring->n_lines);
+}
+
+static void
+fused_ring_reset (FusedLineRing * ring)
+{
+  guint i;
+
+  for (i = 0; i < ring->n_lines; i++)
+    ring->in_line[i] = -1;
+}
+
+/* scale output line @out_line of the plane at @src into @dest, @width is in
+ * pixels of @format and @line_size in bytes */
+static void
+fused_scale_line (FusedLineRing * ring, GstVideoScaler * h_scaler,
+    GstVideoScaler * v_scaler, GstVideoFormat format, const guint8 * src,
+    gint sstride, guint out_line, guint width, gsize line_size, guint8 * dest)
+{
+  gpointer *lines;
+  guint in_line, n_taps, i;
+
+  if (v_scaler == NULL) {
+    const guint8 *s = src + out_line * sstride;
+
+    if (h_scaler)
+      gst_video_scaler_horizontal (h_scaler, format, (gpointer) s, dest, 0,
+          width);
+    else
+      memcpy (dest, s, line_size);
+    return;
+  }
+
+  gst_video_scaler_get_coeff (v_scaler, out_line, &in_line, &n_taps);
+  lines = g_newa (gpointer, n_taps);
+
+  for (i = 0; i < n_taps; i++) {
+    guint l = in_line + i;
+    guint slot;
+
+    if (h_scaler == NULL) {
+      lines[i] = (gpointer) (src + l * sstride);
+      continue;
+    }
+
+    /* consecutive output lines share most of their input lines */
+    slot = l % ring->n_lines;
+    if (ring->in_line[slot] != (gint) l) {
+      gst_video_scaler_horizontal (h_scaler, format,
+          (gpointer) (src + l * sstride), ring->data + slot * ring->stride, 0,
+          width);
+      ring->in_line[slot] = l;
+    }
+    lines[i] = ring->data + slot * ring->stride;
+  }
+
+  gst_video_scaler_vertical (v_scaler, format, lines, dest, out_line, width);
+}
+
+static void
+fused_new_scalers (GstVideoConverter * convert, gint plane, gint method,
+    gint in_width, gint in_height, gint out_width, gint out_height)
+{
+  guint taps = GET_OPT_RESAMPLER_TAPS (convert);
+  guint j;
+
+  if (in_width != out_width) {
+    convert->fh_scaler[plane].scaler =
+        g_new (GstVideoScaler *, convert->n_threads);
+    for (j = 0; j < convert->n_threads; j++)
+      convert->fh_scaler[plane].scaler[j] =
+          gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
+          in_width, out_width, convert->config);
+  }
+  if (in_height != out_height) {
+    convert->fv_scaler[plane].scaler =
+        g_new (GstVideoScaler *, convert->n_threads);
+    for (j = 0; j < convert->n_threads; j++)
+      convert->fv_scaler[plane].scaler[j] =
+          gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE, taps,
+          in_height, out_height, convert->config);
+  }
+}
+
+static void
+fused_init_rings (GstVideoConverter * convert, gint plane, gsize line_size)
+{
+  guint j;
+
+  convert->fring[plane] = g_new0 (FusedLineRing, convert->n_threads);
+  for (j = 0; j < convert->n_threads; j++)
+    fused_ring_init (&convert->fring[plane][j],
+        convert->fv_scaler[plane].scaler ?
+        convert->fv_scaler[plane].scaler[j] : NULL, line_size);
+}
+
+static void
+fused_init_out_lines (GstVideoConverter * convert, gsize line_size,
+    guint n_lines)
+{
+  guint j;
+
+  convert->fout_stride = GST_ROUND_UP_32 (line_size);
+  convert->fout_lines = g_new (guint8 *, convert->n_threads);
+  for (j = 0; j < convert->n_threads; j++)
+    convert->fout_lines[j] = g_malloc (convert->fout_stride * n_lines);
+}
+
+#define FUSED_SCALER(c,p,w) ((c)->fh_scaler[p].scaler ? \
+    (c)->fh_scaler[p].scaler[w] : NULL)
+#define FUSED_V_SCALER(c,p,w) ((c)->fv_scaler[p].scaler ? \
+    (c)->fv_scaler[p].scaler[w] : NULL)
+
+static void
+fused_run (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest, GstVideoTaskFunc func)
+{
+  FFusedTask *tasks;
+  FFusedTask **tasks_p;
+  gint i, n_tasks, lines_per_task;
+
+  n_tasks = convert->n_tasks;
+  tasks = convert->tasks[0] =
+      g_renew (FFusedTask, convert->tasks[0], n_tasks);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FFusedTask *, convert->tasks_p[0], n_tasks);
+
+  /* keep luma line pairs for the subsampled chroma together */
+  n_tasks = get_n_stripes (convert, convert->out_height, 2, &lines_per_task);
+
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].convert = convert;
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+    tasks[i].y0 = i * lines_per_task;
+    tasks[i].y1 = MIN (tasks[i].y0 + lines_per_task, convert->out_height);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_video_task_runner_run (convert->conversion_runner, func,
+      (gpointer *) tasks_p, n_tasks);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_NV12_I420_fused_task (FFusedTask * task, guint worker)
+{
+  GstVideoConverter *convert = task->convert;
+  const GstVideoFrame *src = task->src;
+  GstVideoFrame *dest = task->dest;
+  FusedLineRing *y_ring = &convert->fring[0][worker];
+  FusedLineRing *uv_ring = &convert->fring[1][worker];
+  guint8 *uv = convert->fout_lines[worker];
+  const guint8 *sy, *suv;
+  gint i, j, width, c_width;
+
+  width = convert->out_width;
+  c_width = convert->fout_width[1];
+
+  sy = FRAME_GET_PLANE_LINE (src, 0, convert->in_y);
+  sy += convert->in_x;
+  suv = FRAME_GET_PLANE_LINE (src, 1, convert->in_y >> 1);
+  suv += GST_ROUND_DOWN_2 (convert->in_x);
+
+  fused_ring_reset (y_ring);
+  fused_ring_reset (uv_ring);
+
+  for (i = task->y0; i < task->y1; i += 2) {
+    guint8 *du, *dv;
+    gint c = i >> 1;
+
+    for (j = i; j < MIN (i + 2, task->y1); j++) {
+      guint8 *dy = FRAME_GET_PLANE_LINE (dest, 0, convert->out_y + j);
+
+      fused_scale_line (y_ring, FUSED_SCALER (convert, 0, worker),
+          FUSED_V_SCALER (convert, 0, worker), GST_VIDEO_FORMAT_GRAY8, sy,
+          FRAME_GET_PLANE_STRIDE (src, 0), j, width, width,
+          dy + convert->out_x);
+    }
+
+    if (c >= convert->fout_height[1])
+      continue;
+
+    fused_scale_line (uv_ring, FUSED_SCALER (convert, 1, worker),
+        FUSED_V_SCALER (convert, 1, worker), GST_VIDEO_FORMAT_NV12, suv,
+        FRAME_GET_PLANE_STRIDE (src, 1), c, c_width, c_width * 2, uv);
+
+    du = FRAME_GET_PLANE_LINE (dest, 1, (convert->out_y >> 1) + c);
+    du += convert->out_x >> 1;
+    dv = FRAME_GET_PLANE_LINE (dest, 2, (convert->out_y >> 1) + c);
+    dv += convert->out_x >> 1;
+
+    for (j = 0; j < c_width; j++) {
+      du[j] = uv[2 * j];
+      dv[j] = uv[2 * j + 1];
+    }
+  }
+}
+
+static void
+convert_NV12_I420_fused (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  fused_run (convert, src, dest,
+      (GstVideoTaskFunc) convert_NV12_I420_fused_task);
+}
+
+static gboolean
+setup_NV12_I420_fused (GstVideoConverter * convert)
+{
+  gint method, cr_method;
+  gint c_in_width, c_in_height, c_out_width, c_out_height;
+
+  method = GET_OPT_RESAMPLER_METHOD (convert);
+  if (method == GST_VIDEO_RESAMPLER_METHOD_NEAREST)
+    cr_method = method;
+  else
+    cr_method = GET_OPT_CHROMA_RESAMPLER_METHOD (convert);
+
+  c_in_width = (convert->in_width + 1) >> 1;
+  c_in_height = (convert->in_height + 1) >> 1;
+  c_out_width = (convert->out_width + 1) >> 1;
+  c_out_height = (convert->out_height + 1) >> 1;
+
+  fused_new_scalers (convert, 0, method, convert->in_width,
+      convert->in_height, convert->out_width, convert->out_height);
+  fused_new_scalers (convert, 1, cr_method, c_in_width, c_in_height,
+      c_out_width, c_out_height);
+
+  fused_init_rings (convert, 0, convert->out_width);
+  fused_init_rings (convert, 1, c_out_width * 2);
+  fused_init_out_lines (convert, c_out_width * 2, 1);
+
+  convert->fout_width[1] = c_out_width;
+  convert->fout_height[1] = c_out_height;
+
+  return TRUE;
+}
+
+static void
+convert_UYVY_NV12_fused_task (FFusedTask * task, guint worker)
+{
+  GstVideoConverter *convert = task->convert;
+  const GstVideoFrame *src = task->src;
+  GstVideoFrame *dest = task->dest;
+  FusedLineRing *ring = &convert->fring[0][worker];
+  GstVideoScaler *h_scaler, *v_scaler;
+  const guint8 *s;
+  gint i, j, width, sstride;
+  gsize line_size;
+
+  width = convert->out_width;
+  line_size = GST_ROUND_UP_2 (width) * 2;
+  h_scaler = FUSED_SCALER (convert, 0, worker);
+  v_scaler = FUSED_V_SCALER (convert, 0, worker);
+
+  s = FRAME_GET_LINE (src, convert->in_y);
+  s += GST_ROUND_UP_2 (convert->in_x) * 2;
+  sstride = FRAME_GET_STRIDE (src);
+
+  fused_ring_reset (ring);
+
+  for (i = task->y0; i < task->y1; i += 2) {
+    guint8 *l1 = convert->fout_lines[worker];
+    guint8 *l2 = l1 + convert->fout_stride;
+    guint8 *dy1, *dy2, *duv;
+
+    fused_scale_line (ring, h_scaler, v_scaler, GST_VIDEO_FORMAT_UYVY, s,
+        sstride, i, width, line_size, l1);
+
+    dy1 = FRAME_GET_PLANE_LINE (dest, 0, convert->out_y + i);
+    dy1 += convert->out_x;
+    duv = FRAME_GET_PLANE_LINE (dest, 1, (convert->out_y + i) >> 1);
+    duv += GST_ROUND_DOWN_2 (convert->out_x);
+
+    if (i + 1 < task->y1) {
+      fused_scale_line (ring, h_scaler, v_scaler, GST_VIDEO_FORMAT_UYVY, s,
+          sstride, i + 1, width, line_size, l2);
+      dy2 = FRAME_GET_PLANE_LINE (dest, 0, convert->out_y + i + 1);
+      dy2 += convert->out_x;
+    } else {
+      /* last line of an odd height, its chroma is used as is */
+      l2 = l1;
+      dy2 = NULL;
+    }
+
+    for (j = 0; j < width; j += 2) {
+      dy1[j] = l1[2 * j + 1];
+      if (dy2)
+        dy2[j] = l2[2 * j + 1];
+      if (j + 1 < width) {
+        dy1[j + 1] = l1[2 * j + 3];
+        if (dy2)
+          dy2[j + 1] = l2[2 * j + 3];
+      }
+      duv[j] = (l1[2 * j] + l2[2 * j] + 1) >> 1;
+      duv[j + 1] = (l1[2 * j + 2] + l2[2 * j + 2] + 1) >> 1;
+    }
+  }
+}
+
+static void
+convert_UYVY_NV12_fused (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  fused_run (convert, src, dest,
+      (GstVideoTaskFunc) convert_UYVY_NV12_fused_task);
+}
+
+static gboolean
+setup_UYVY_NV12_fused (GstVideoConverter * convert)
+{
+  const GstVideoFormatInfo *finfo = convert->in_info.finfo;
+  gint method;
+  guint taps, j;
+
+  method = GET_OPT_RESAMPLER_METHOD (convert);
+  taps = GET_OPT_RESAMPLER_TAPS (convert);
+
+  /* scale the packed UYVY lines, the luma and chroma scalers are combined
+   * like for UYVY to UYVY */
+  if (convert->in_width != convert->out_width) {
+    convert->fh_scaler[0].scaler = g_new (GstVideoScaler *, convert->n_threads);
+    for (j = 0; j < convert->n_threads; j++) {
+      GstVideoScaler *y_scaler, *uv_scaler;
+
+      y_scaler = gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE,
+          taps, convert->in_width, convert->out_width, convert->config);
+      uv_scaler = gst_video_scaler_new (method, GST_VIDEO_SCALER_FLAG_NONE,
+          gst_video_scaler_get_max_taps (y_scaler),
+          GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, GST_VIDEO_COMP_U,
+              convert->in_width),
+          GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, GST_VIDEO_COMP_U,
+              convert->out_width), convert->config);
+
+      convert->fh_scaler[0].scaler[j] =
+          gst_video_scaler_combine_packed_YUV (y_scaler, uv_scaler,
+          GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_UYVY);
+
+      gst_video_scaler_free (y_scaler);
+      gst_video_scaler_free (uv_scaler);
+    }
+  }
+  fused_new_scalers (convert, 0, method, convert->out_width,
+      convert->in_height, convert->out_width, convert->out_height);
+
+  fused_init_rings (convert, 0, GST_ROUND_UP_2 (convert->out_width) * 2);
+  fused_init_out_lines (convert, GST_ROUND_UP_2 (convert->out_width) * 2, 2);
+
+  return TRUE;
+}
+
+typedef struct
+{
+  GstVideoFormat in_format;
+  GstVideoFormat out_format;
+  const gchar *name;
+  gboolean (*setup) (GstVideoConverter * convert);
+  void (*convert) (GstVideoConverter * convert, const GstVideoFrame * src,
+      GstVideoFrame * dest);
+} VideoFusedTransform;
+
+/* only used when scaling, without color matrix or interlacing */
+static const VideoFusedTransform fused_transforms[] = {
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, "NV12-I420-fused-scale",
+      setup_NV12_I420_fused, convert_NV12_I420_fused},
+  {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_NV12, "UYVY-NV12-fused-scale",
+      setup_UYVY_NV12_fused, convert_UYVY_NV12_fused},
+};
+
 /* Fast paths */
 
 typedef struct
@@ -7262,6 +8378,12 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_v210, GST_VIDEO_FORMAT_Y42B, TRUE, FALSE, TRUE, FALSE,
       FALSE, FALSE, FALSE, FALSE, 0, 0, convert_v210_Y42B},
 
+  /* 10 bit -> 10 bit, without going through AYUV64 */
+  {GST_VIDEO_FORMAT_v210, GST_VIDEO_FORMAT_P010_10LE, TRUE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_v210_P010_10LE},
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_I420_10LE, TRUE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_P010_10LE_I420_10LE},
+
   /* planar -> planar */
   {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_I420, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
@@ -7648,7 +8770,11 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
 
   same_size = (width == convert->out_width && height == convert->out_height);
 
-  /* fastpaths don't do gamma */
+  /* fastpaths don't do gamma. Tone mapping was already disabled by
+   * setup_tone_map() when the transfer functions don't need it, so it only
+   * rules out the fastpaths when the values have to be remapped anyway */
+  if (CHECK_TONE_MAP (convert))
+    return FALSE;
   if (CHECK_GAMMA_REMAP (convert) && (!same_size
           || !gst_video_transfer_function_is_equivalent (in_transf, in_bpp,
               out_transf, out_bpp)))
@@ -7692,6 +8818,24 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
       || convert->out_width < convert->out_maxwidth
       || convert->out_height < convert->out_maxheight;
 
+  if (!same_size && !interlaced && same_matrix && same_primaries
+      && !need_copy && !need_set && !need_mult) {
+    for (i = 0; i < G_N_ELEMENTS (fused_transforms); i++) {
+      if (fused_transforms[i].in_format != in_format ||
+          fused_transforms[i].out_format != out_format)
+        continue;
+
+      GST_DEBUG ("using fused fastpath %s", fused_transforms[i].name);
+      if (!fused_transforms[i].setup (convert))
+        return FALSE;
+      convert->convert = fused_transforms[i].convert;
+      convert->fastpath_name = g_strdup (fused_transforms[i].name);
+      if (border)
+        setup_borderline (convert);
+      return TRUE;
+    }
+  }
+
   for (i = 0; i < G_N_ELEMENTS (transforms); i++) {
     if (transforms[i].in_format == in_format &&
         transforms[i].out_format == out_format &&
@@ -7712,9 +8856,22 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
         video_converter_compute_matrix (convert);
       convert->convert = transforms[i].convert;
 
-      convert->tmpline =
-          g_new (guint16 *, convert->conversion_runner->n_threads);
-      for (j = 0; j < convert->conversion_runner->n_threads; j++)
+      if (convert->blend_overlays && convert->convert == convert_I420_BGRA) {
+        /* blend the overlays while the converted lines are in the cache */
+        convert->convert = convert_I420_BGRA_fused_blend;
+        convert->fused_blend = TRUE;
+        convert->fastpath_name = g_strdup_printf ("%s-%s-fused-blend",
+            gst_video_format_to_string (in_format),
+            gst_video_format_to_string (out_format));
+      } else {
+        convert->fastpath_name = g_strdup_printf ("%s-%s%s",
+            gst_video_format_to_string (in_format),
+            gst_video_format_to_string (out_format),
+            transforms[i].keeps_size ? "" : "-scale");
+      }
+
+      convert->tmpline = g_new (guint16 *, convert->n_threads);
+      for (j = 0; j < convert->n_threads; j++)
         convert->tmpline[j] = g_malloc0 (sizeof (guint16) * (width + 8) * 4);
 
       if (!transforms[i].keeps_size)
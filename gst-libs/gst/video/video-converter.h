@@ -285,8 +285,100 @@ typedef enum {
  */
 #define GST_VIDEO_CONVERTER_OPT_ASYNC_TASKS   "GstVideoConverter.async-tasks"
 
+/**
+ * GST_VIDEO_CONVERTER_OPT_BLEND_OVERLAYS:
+ *
+ * #G_TYPE_BOOLEAN, whether the #GstVideoOverlayCompositionMeta of the source
+ * buffer is blended onto the converted frame. The overlay rectangles are
+ * scaled along with the video. Default %FALSE
+ *
+ * Since: 1.20
+ */
+#define GST_VIDEO_CONVERTER_OPT_BLEND_OVERLAYS   "GstVideoConverter.blend-overlays"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_SCALE_TILE_WIDTH:
+ *
+ * #G_TYPE_UINT, the width in pixels of the column tiles used for vertical
+ * scaling. When set, a block of output lines is scaled one column tile at a
+ * time so that the input lines of a tile stay in the CPU cache, which is
+ * faster for large frames and many-tap filters. 0 scales full lines.
+ * Default 0
+ *
+ * Since: 1.20
+ */
+#define GST_VIDEO_CONVERTER_OPT_SCALE_TILE_WIDTH   "GstVideoConverter.scale-tile-width"
+
+/**
+ * GstVideoToneMapMethod:
+ * @GST_VIDEO_TONE_MAP_METHOD_NONE: disable tone mapping
+ * @GST_VIDEO_TONE_MAP_METHOD_BT2390: the EETF of ITU-R BT.2390, which keeps
+ *   the luminance below the knee point and compresses the highlights
+ * @GST_VIDEO_TONE_MAP_METHOD_HABLE: the filmic curve of John Hable, which
+ *   also compresses the midtones
+ *
+ * Methods to map HDR luminance to the range of an SDR display
+ *
+ * Since: 1.20
+ */
+typedef enum {
+  GST_VIDEO_TONE_MAP_METHOD_NONE,
+  GST_VIDEO_TONE_MAP_METHOD_BT2390,
+  GST_VIDEO_TONE_MAP_METHOD_HABLE
+} GstVideoToneMapMethod;
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_TONE_MAP_METHOD:
+ *
+ * #GstVideoToneMapMethod, the method used to tone map the input when it uses
+ * the #GST_VIDEO_TRANSFER_SMPTE2084 (PQ) or #GST_VIDEO_TRANSFER_ARIB_STD_B67
+ * (HLG) transfer function and the output does not. Tone mapping is done
+ * while gamma decoding, which implies #GST_VIDEO_GAMMA_MODE_REMAP.
+ * As none of the fast paths do gamma conversion, a conversion that needs
+ * tone mapping always uses the slower generic path. The method has no effect,
+ * and the fast paths stay available, when the transfer functions do not
+ * need tone mapping. Default is #GST_VIDEO_TONE_MAP_METHOD_NONE.
+ *
+ * Since: 1.20
+ */
+#define GST_VIDEO_CONVERTER_OPT_TONE_MAP_METHOD   "GstVideoConverter.tone-map-method"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_TONE_MAP_SOURCE_PEAK:
+ *
+ * #G_TYPE_DOUBLE, the peak luminance of the input in cd/m^2. This is usually
+ * the maximum content light level or the maximum mastering display luminance
+ * of the HDR metadata. 0 uses 1000 cd/m^2. Default 0
+ *
+ * Since: 1.20
+ */
+#define GST_VIDEO_CONVERTER_OPT_TONE_MAP_SOURCE_PEAK   "GstVideoConverter.tone-map-source-peak"
+
+/**
+ * GST_VIDEO_CONVERTER_OPT_TONE_MAP_TARGET_PEAK:
+ *
+ * #G_TYPE_DOUBLE, the peak luminance of the output display in cd/m^2.
+ * Default 100
+ *
+ * Since: 1.20
+ */
+#define GST_VIDEO_CONVERTER_OPT_TONE_MAP_TARGET_PEAK   "GstVideoConverter.tone-map-target-peak"
+
 typedef struct _GstVideoConverter GstVideoConverter;
 
+/**
+ * GstVideoConverterDoneFunc:
+ * @convert: the #GstVideoConverter
+ * @user_data: the user data passed to gst_video_converter_frame_async()
+ *
+ * Function called when a conversion started with
+ * gst_video_converter_frame_async() completed.
+ *
+ * Since: 1.20
+ */
+typedef void (*GstVideoConverterDoneFunc) (GstVideoConverter * convert,
+                                           gpointer user_data);
+
 GST_VIDEO_API
 GstVideoConverter *  gst_video_converter_new            (const GstVideoInfo *in_info,
                                                          const GstVideoInfo *out_info,
@@ -310,9 +402,23 @@ const GstStructure * gst_video_converter_get_config     (GstVideoConverter * con
 GST_VIDEO_API
 void                 gst_video_converter_frame          (GstVideoConverter * convert,
                                                          const GstVideoFrame *src, GstVideoFrame *dest);
+
+GST_VIDEO_API
+void                 gst_video_converter_frame_async    (GstVideoConverter * convert,
+                                                         const GstVideoFrame *src,
+                                                         GstVideoFrame *dest,
+                                                         GstVideoConverterDoneFunc done,
+                                                         gpointer user_data);
+
 GST_VIDEO_API
 void                 gst_video_converter_frame_finish   (GstVideoConverter * convert);
 
+GST_VIDEO_API
+const gchar *        gst_video_converter_get_fastpath_name (GstVideoConverter * convert);
+
+GST_VIDEO_API
+GstStructure *       gst_video_converter_get_stats      (GstVideoConverter * convert);
+
 G_END_DECLS
 
 #endif /* __GST_VIDEO_CONVERTER_H__ */
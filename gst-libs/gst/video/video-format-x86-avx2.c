@@ -0,0 +1,248 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-format-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <immintrin.h>
+
+/* byte shuffle that picks 16 bit words from the same 128 bit lane, -1
+ * gives a 0 word */
+static inline __m256i
+word_shuffle (gint w0, gint w1, gint w2, gint w3, gint w4, gint w5, gint w6,
+    gint w7)
+{
+  const gint w[8] = { w0, w1, w2, w3, w4, w5, w6, w7 };
+  gint8 b[16];
+  gint i;
+
+  for (i = 0; i < 8; i++) {
+    b[2 * i + 0] = w[i] < 0 ? -1 : 2 * w[i] + 0;
+    b[2 * i + 1] = w[i] < 0 ? -1 : 2 * w[i] + 1;
+  }
+  return _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) b));
+}
+
+static inline __m256i
+load_2x128 (const guint16 * lo, const guint16 * hi)
+{
+  return _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_loadu_si128 ((
+                  const __m128i *) lo)), _mm_loadu_si128 ((const __m128i *) hi),
+      1);
+}
+
+static inline void
+store_2x128 (guint16 * lo, guint16 * hi, __m256i v)
+{
+  _mm_storeu_si128 ((__m128i *) lo, _mm256_castsi256_si128 (v));
+  _mm_storeu_si128 ((__m128i *) hi, _mm256_extracti128_si256 (v, 1));
+}
+
+gboolean
+video_format_x86_have_avx2 (void)
+{
+#if defined (__GNUC__)
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("avx2") != 0;
+#else
+  return FALSE;
+#endif
+}
+
+/* each 128 bit lane holds one group of 6 pixels in 4 words:
+ *   u0 y0 v0 | y1 u2 y2 | v2 y3 u4 | y4 v4 y5 */
+gint
+video_format_unpack_v210_avx2 (guint16 * d, const guint8 * s,
+    gboolean truncate, gint width)
+{
+  const __m256i mask = _mm256_set1_epi32 (0x3ff);
+  const __m256i alpha = _mm256_setr_epi16 (-1, 0, 0, 0, -1, 0, 0, 0,
+      -1, 0, 0, 0, -1, 0, 0, 0);
+  /* a = u0 y1 v2 y4 y0 u2 y3 v4, b = v0 y2 u4 y5 */
+  const __m256i p01a = word_shuffle (-1, 4, 0, -1, -1, 1, 0, -1);
+  const __m256i p01b = word_shuffle (-1, -1, -1, 0, -1, -1, -1, 0);
+  const __m256i p23a = word_shuffle (-1, -1, 5, 2, -1, 6, 5, 2);
+  const __m256i p23b = word_shuffle (-1, 1, -1, -1, -1, -1, -1, -1);
+  const __m256i p45a = word_shuffle (-1, 3, -1, 7, -1, -1, -1, 7);
+  const __m256i p45b = word_shuffle (-1, -1, 2, -1, -1, 3, 2, -1);
+  gint i;
+
+  for (i = 0; i + 12 <= width; i += 12) {
+    __m256i w, a, b, o;
+
+    w = _mm256_loadu_si256 ((const __m256i *) (s + (i / 6) * 16));
+    a = _mm256_packs_epi32 (_mm256_and_si256 (w, mask),
+        _mm256_and_si256 (_mm256_srli_epi32 (w, 10), mask));
+    b = _mm256_and_si256 (_mm256_srli_epi32 (w, 20), mask);
+    b = _mm256_packs_epi32 (b, b);
+
+    a = _mm256_slli_epi16 (a, 6);
+    b = _mm256_slli_epi16 (b, 6);
+    if (!truncate) {
+      a = _mm256_or_si256 (a, _mm256_srli_epi16 (a, 10));
+      b = _mm256_or_si256 (b, _mm256_srli_epi16 (b, 10));
+    }
+
+    o = _mm256_or_si256 (_mm256_shuffle_epi8 (a, p01a),
+        _mm256_shuffle_epi8 (b, p01b));
+    store_2x128 (d + 4 * (i + 0), d + 4 * (i + 6), _mm256_or_si256 (o, alpha));
+    o = _mm256_or_si256 (_mm256_shuffle_epi8 (a, p23a),
+        _mm256_shuffle_epi8 (b, p23b));
+    store_2x128 (d + 4 * (i + 2), d + 4 * (i + 8), _mm256_or_si256 (o, alpha));
+    o = _mm256_or_si256 (_mm256_shuffle_epi8 (a, p45a),
+        _mm256_shuffle_epi8 (b, p45b));
+    store_2x128 (d + 4 * (i + 4), d + 4 * (i + 10), _mm256_or_si256 (o, alpha));
+  }
+  return i;
+}
+
+gint
+video_format_pack_v210_avx2 (guint8 * d, const guint16 * s, gint width)
+{
+  /* gather the 10 bit fields of the 4 words into 32 bit lanes */
+  const __m256i f0_01 = word_shuffle (2, -1, 5, -1, -1, -1, -1, -1);
+  const __m256i f0_23 = word_shuffle (-1, -1, -1, -1, 3, -1, -1, -1);
+  const __m256i f0_45 = word_shuffle (-1, -1, -1, -1, -1, -1, 1, -1);
+  const __m256i f1_01 = word_shuffle (1, -1, -1, -1, -1, -1, -1, -1);
+  const __m256i f1_23 = word_shuffle (-1, -1, 2, -1, 5, -1, -1, -1);
+  const __m256i f1_45 = word_shuffle (-1, -1, -1, -1, -1, -1, 3, -1);
+  const __m256i f2_01 = word_shuffle (3, -1, -1, -1, -1, -1, -1, -1);
+  const __m256i f2_23 = word_shuffle (-1, -1, 1, -1, -1, -1, -1, -1);
+  const __m256i f2_45 = word_shuffle (-1, -1, -1, -1, 2, -1, 5, -1);
+  gint i;
+
+  for (i = 0; i + 12 <= width; i += 12) {
+    __m256i p01, p23, p45, f0, f1, f2;
+
+    p01 = _mm256_srli_epi16 (load_2x128 (s + 4 * (i + 0), s + 4 * (i + 6)), 6);
+    p23 = _mm256_srli_epi16 (load_2x128 (s + 4 * (i + 2), s + 4 * (i + 8)), 6);
+    p45 = _mm256_srli_epi16 (load_2x128 (s + 4 * (i + 4), s + 4 * (i + 10)),
+        6);
+
+    f0 = _mm256_or_si256 (_mm256_shuffle_epi8 (p01, f0_01),
+        _mm256_or_si256 (_mm256_shuffle_epi8 (p23, f0_23),
+            _mm256_shuffle_epi8 (p45, f0_45)));
+    f1 = _mm256_or_si256 (_mm256_shuffle_epi8 (p01, f1_01),
+        _mm256_or_si256 (_mm256_shuffle_epi8 (p23, f1_23),
+            _mm256_shuffle_epi8 (p45, f1_45)));
+    f2 = _mm256_or_si256 (_mm256_shuffle_epi8 (p01, f2_01),
+        _mm256_or_si256 (_mm256_shuffle_epi8 (p23, f2_23),
+            _mm256_shuffle_epi8 (p45, f2_45)));
+
+    f0 = _mm256_or_si256 (f0, _mm256_or_si256 (_mm256_slli_epi32 (f1, 10),
+            _mm256_slli_epi32 (f2, 20)));
+    _mm256_storeu_si256 ((__m256i *) (d + (i / 6) * 16), f0);
+  }
+  return i;
+}
+
+gint
+video_format_unpack_P010_10LE_avx2 (guint16 * d, const guint16 * sy,
+    const guint16 * suv, gboolean truncate, gint width)
+{
+  const __m256i alpha = _mm256_set1_epi16 (-1);
+  gint i;
+
+  for (i = 0; i + 16 <= width; i += 16) {
+    __m256i y, uv, ay_lo, ay_hi, uv_lo, uv_hi, p0, p1, p2, p3;
+
+    y = _mm256_loadu_si256 ((const __m256i *) (sy + i));
+    uv = _mm256_loadu_si256 ((const __m256i *) (suv + i));
+    if (!truncate) {
+      y = _mm256_or_si256 (y, _mm256_srli_epi16 (y, 10));
+      uv = _mm256_or_si256 (uv, _mm256_srli_epi16 (uv, 10));
+    }
+
+    /* per lane, pixels 0-3 and 4-7 of each half */
+    ay_lo = _mm256_unpacklo_epi16 (alpha, y);
+    ay_hi = _mm256_unpackhi_epi16 (alpha, y);
+    uv_lo = _mm256_unpacklo_epi32 (uv, uv);
+    uv_hi = _mm256_unpackhi_epi32 (uv, uv);
+
+    p0 = _mm256_unpacklo_epi32 (ay_lo, uv_lo);
+    p1 = _mm256_unpackhi_epi32 (ay_lo, uv_lo);
+    p2 = _mm256_unpacklo_epi32 (ay_hi, uv_hi);
+    p3 = _mm256_unpackhi_epi32 (ay_hi, uv_hi);
+
+    _mm256_storeu_si256 ((__m256i *) (d + 4 * (i + 0)),
+        _mm256_permute2x128_si256 (p0, p1, 0x20));
+    _mm256_storeu_si256 ((__m256i *) (d + 4 * (i + 4)),
+        _mm256_permute2x128_si256 (p2, p3, 0x20));
+    _mm256_storeu_si256 ((__m256i *) (d + 4 * (i + 8)),
+        _mm256_permute2x128_si256 (p0, p1, 0x31));
+    _mm256_storeu_si256 ((__m256i *) (d + 4 * (i + 12)),
+        _mm256_permute2x128_si256 (p2, p3, 0x31));
+  }
+  return i;
+}
+
+/* sorts 4 pixels of AYUV64 into AY0 AY1 AY2 AY3 UV0 UV1 UV2 UV3 */
+static inline __m256i
+load_ay_uv (const guint16 * s)
+{
+  __m256i v = _mm256_loadu_si256 ((const __m256i *) s);
+
+  v = _mm256_shuffle_epi32 (v, _MM_SHUFFLE (3, 1, 2, 0));
+  return _mm256_permute4x64_epi64 (v, _MM_SHUFFLE (3, 1, 2, 0));
+}
+
+gint
+video_format_pack_P010_10LE_avx2 (guint16 * dy, guint16 * duv,
+    const guint16 * s, gint width)
+{
+  const __m256i mask = _mm256_set1_epi16 (0xffc0);
+  gint i;
+
+  for (i = 0; i + 16 <= width; i += 16) {
+    __m256i t0, t1, t2, t3, ay0, ay1, uv0, uv1, y, uv;
+
+    t0 = load_ay_uv (s + 4 * (i + 0));
+    t1 = load_ay_uv (s + 4 * (i + 4));
+    t2 = load_ay_uv (s + 4 * (i + 8));
+    t3 = load_ay_uv (s + 4 * (i + 12));
+
+    ay0 = _mm256_permute2x128_si256 (t0, t1, 0x20);
+    ay1 = _mm256_permute2x128_si256 (t2, t3, 0x20);
+    /* sign extending keeps the 16 bit value through the saturating pack */
+    y = _mm256_packs_epi32 (_mm256_srai_epi32 (ay0, 16),
+        _mm256_srai_epi32 (ay1, 16));
+    y = _mm256_permute4x64_epi64 (y, _MM_SHUFFLE (3, 1, 2, 0));
+    _mm256_storeu_si256 ((__m256i *) (dy + i), _mm256_and_si256 (y, mask));
+
+    if (duv == NULL)
+      continue;
+
+    /* chroma of the even pixels */
+    uv0 = _mm256_permute2x128_si256 (t0, t1, 0x31);
+    uv1 = _mm256_permute2x128_si256 (t2, t3, 0x31);
+    uv0 = _mm256_shuffle_epi32 (uv0, _MM_SHUFFLE (3, 1, 2, 0));
+    uv0 = _mm256_permute4x64_epi64 (uv0, _MM_SHUFFLE (3, 1, 2, 0));
+    uv1 = _mm256_shuffle_epi32 (uv1, _MM_SHUFFLE (3, 1, 2, 0));
+    uv1 = _mm256_permute4x64_epi64 (uv1, _MM_SHUFFLE (3, 1, 2, 0));
+    uv = _mm256_permute2x128_si256 (uv0, uv1, 0x20);
+    _mm256_storeu_si256 ((__m256i *) (duv + i), _mm256_and_si256 (uv, mask));
+  }
+  return i;
+}
+
+#endif
@@ -0,0 +1,51 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_FORMAT_X86_AVX2_H__
+#define __GST_VIDEO_FORMAT_X86_AVX2_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* These produce exactly the same as the C unpack and pack functions in
+ * video-format.c. They only handle whole blocks of 12 (v210) or 16 (P010)
+ * pixels and return how many pixels they did, the caller converts the
+ * remaining ones. */
+
+G_GNUC_INTERNAL
+gboolean video_format_x86_have_avx2 (void);
+
+G_GNUC_INTERNAL
+gint video_format_unpack_v210_avx2 (guint16 * d, const guint8 * s,
+    gboolean truncate, gint width);
+
+G_GNUC_INTERNAL
+gint video_format_pack_v210_avx2 (guint8 * d, const guint16 * s, gint width);
+
+G_GNUC_INTERNAL
+gint video_format_unpack_P010_10LE_avx2 (guint16 * d, const guint16 * sy,
+    const guint16 * suv, gboolean truncate, gint width);
+
+G_GNUC_INTERNAL
+gint video_format_pack_P010_10LE_avx2 (guint16 * dy, guint16 * duv,
+    const guint16 * s, gint width);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_FORMAT_X86_AVX2_H__ */
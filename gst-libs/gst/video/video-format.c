@@ -29,6 +29,12 @@
 #include "video-format.h"
 #include "video-orc.h"
 
+#if defined (HAVE_AVX2) && defined (HAVE_IMMINTRIN_H) && \
+    (defined (__i386__) || defined (__x86_64__))
+#define USE_AVX2
+#include "video-format-x86-avx2.h"
+#endif
+
 #ifndef restrict
 #if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
 /* restrict should be available */
@@ -86,6 +92,27 @@
 
 #define IS_ALIGNED(x,n) ((((guintptr)(x)&((n)-1))) == 0)
 
+#ifdef USE_AVX2
+/* some formats have x86 unpack and pack functions for the bulk of the
+ * line. Setting GST_VIDEO_FORMAT_NO_SIMD in the environment forces the C
+ * versions, for comparing. */
+static gboolean
+video_format_use_avx2 (void)
+{
+  static gsize use_avx2 = 0;
+
+  if (g_once_init_enter (&use_avx2)) {
+    gsize res = 1;
+
+    if (g_getenv ("GST_VIDEO_FORMAT_NO_SIMD") == NULL
+        && video_format_x86_have_avx2 ())
+      res = 2;
+    g_once_init_leave (&use_avx2, res);
+  }
+  return use_avx2 == 2;
+}
+#endif
+
 #define PACK_420 GST_VIDEO_FORMAT_AYUV, unpack_planar_420, 1, pack_planar_420
 static void
 unpack_planar_420 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
@@ -571,7 +598,14 @@ unpack_v210 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   /* FIXME */
   s += x * 2;
 
-  for (i = 0; i < width; i += 6) {
+  i = 0;
+#ifdef USE_AVX2
+  if (video_format_use_avx2 ())
+    i = video_format_unpack_v210_avx2 (d, s,
+        (flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) != 0, width);
+#endif
+
+  for (; i < width; i += 6) {
     a0 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 0);
     a1 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 4);
     a2 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 8);
@@ -661,7 +695,13 @@ pack_v210 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 u0, u1, u2;
   guint16 v0, v1, v2;
 
-  for (i = 0; i < width - 5; i += 6) {
+  i = 0;
+#ifdef USE_AVX2
+  if (video_format_use_avx2 ())
+    i = video_format_pack_v210_avx2 (d, s, width);
+#endif
+
+  for (; i < width - 5; i += 6) {
     y0 = s[4 * (i + 0) + 1] >> 6;
     y1 = s[4 * (i + 1) + 1] >> 6;
     y2 = s[4 * (i + 2) + 1] >> 6;
@@ -4720,6 +4760,18 @@ unpack_P010_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     suv += 2;
   }
 
+#ifdef USE_AVX2
+  if (video_format_use_avx2 ()) {
+    gint n = video_format_unpack_P010_10LE_avx2 (d, sy, suv,
+        (flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) != 0, width);
+
+    d += 4 * n;
+    sy += n;
+    suv += n;
+    width -= n;
+  }
+#endif
+
   for (i = 0; i < width / 2; i++) {
     Y0 = GST_READ_UINT16_LE (sy + 2 * i);
     Y1 = GST_READ_UINT16_LE (sy + 2 * i + 1);
@@ -4775,9 +4827,14 @@ pack_P010_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 *restrict duv = GET_PLANE_LINE (1, uv);
   guint16 Y0, Y1, U, V;
   const guint16 *restrict s = src;
+  gint n = 0;
 
   if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width / 2; i++) {
+#ifdef USE_AVX2
+    if (video_format_use_avx2 ())
+      n = video_format_pack_P010_10LE_avx2 (dy, duv, s, width);
+#endif
+    for (i = n / 2; i < width / 2; i++) {
       Y0 = s[i * 8 + 1] & 0xffc0;
       Y1 = s[i * 8 + 5] & 0xffc0;
       U = s[i * 8 + 2] & 0xffc0;
@@ -4800,7 +4857,11 @@ pack_P010_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
       GST_WRITE_UINT16_LE (duv + i + 1, V);
     }
   } else {
-    for (i = 0; i < width; i++) {
+#ifdef USE_AVX2
+    if (video_format_use_avx2 ())
+      n = video_format_pack_P010_10LE_avx2 (dy, NULL, s, width);
+#endif
+    for (i = n; i < width; i++) {
       Y0 = s[i * 4 + 1] & 0xffc0;
       GST_WRITE_UINT16_LE (dy + i, Y0);
     }
@@ -57,6 +57,10 @@ ensure_debug_category (void)
  * #GstVideoResampler is a structure which holds the information
  * required to perform various kinds of resampling filtering.
  *
+ * The tables of a #GstVideoResampler are shared between all resamplers that
+ * were initialized with the same parameters, so making the same resampler
+ * again, for example after a renegotiation or in many identical pipelines,
+ * does not recompute them. The tables must therefore be treated as read-only.
  */
 
 
@@ -123,6 +127,173 @@ get_opt_int (GstStructure * options, const gchar * name, gint def)
 #define GET_OPT_MAX_TAPS(options) get_opt_int(options, \
     GST_VIDEO_RESAMPLER_OPT_MAX_TAPS, DEFAULT_OPT_MAX_TAPS)
 
+/* Cache of the calculated tables, keyed by everything that goes into the
+ * calculation. Entries are refcounted by the resamplers that use them and a
+ * few unused ones are kept around for when the same resampler is made again
+ * shortly after, like on renegotiation. */
+#define MAX_UNUSED_TABLES 16
+
+typedef struct
+{
+  GstVideoResamplerMethod method;
+  GstVideoResamplerFlags flags;
+  guint n_phases;
+  guint n_taps;
+  gdouble shift;
+  guint in_size;
+  guint out_size;
+  /* options */
+  gdouble b, c;
+  gdouble envelope;
+  gdouble sharpness;
+  gdouble sharpen;
+  gint max_taps;
+} ResamplerKey;
+
+typedef struct
+{
+  ResamplerKey key;
+  gint refcount;
+
+  guint max_taps;
+  guint32 *offset;
+  guint32 *phase;
+  guint32 *n_taps;
+  gdouble *taps;
+} ResamplerTables;
+
+static GMutex tables_lock;
+static GHashTable *tables;
+static GQueue unused_tables = G_QUEUE_INIT;
+
+static guint
+resampler_key_hash (gconstpointer data)
+{
+  const ResamplerKey *key = data;
+  guint hash;
+
+  hash = key->method;
+  hash = hash * 31 + key->flags;
+  hash = hash * 31 + key->n_taps;
+  hash = hash * 31 + key->in_size;
+  hash = hash * 31 + key->out_size;
+  hash = hash * 31 + key->max_taps;
+  hash = hash * 31 + g_double_hash (&key->shift);
+  hash = hash * 31 + g_double_hash (&key->sharpness);
+  hash = hash * 31 + g_double_hash (&key->sharpen);
+
+  return hash;
+}
+
+static gboolean
+resampler_key_equal (gconstpointer a, gconstpointer b)
+{
+  const ResamplerKey *ka = a, *kb = b;
+
+  return ka->method == kb->method && ka->flags == kb->flags &&
+      ka->n_phases == kb->n_phases && ka->n_taps == kb->n_taps &&
+      ka->shift == kb->shift && ka->in_size == kb->in_size &&
+      ka->out_size == kb->out_size && ka->b == kb->b && ka->c == kb->c &&
+      ka->envelope == kb->envelope && ka->sharpness == kb->sharpness &&
+      ka->sharpen == kb->sharpen && ka->max_taps == kb->max_taps;
+}
+
+static void
+resampler_tables_free (ResamplerTables * tables)
+{
+  g_free (tables->phase);
+  g_free (tables->offset);
+  g_free (tables->n_taps);
+  g_free (tables->taps);
+  g_slice_free (ResamplerTables, tables);
+}
+
+static void
+resampler_tables_apply (ResamplerTables * tables,
+    GstVideoResampler * resampler)
+{
+  resampler->max_taps = tables->max_taps;
+  resampler->offset = tables->offset;
+  resampler->phase = tables->phase;
+  resampler->n_taps = tables->n_taps;
+  resampler->taps = tables->taps;
+  resampler->_gst_reserved[0] = tables;
+}
+
+/* must be called with tables_lock */
+static ResamplerTables *
+resampler_tables_lookup (const ResamplerKey * key)
+{
+  ResamplerTables *res;
+
+  if (tables == NULL)
+    return NULL;
+
+  res = g_hash_table_lookup (tables, key);
+  if (res == NULL)
+    return NULL;
+
+  if (res->refcount++ == 0)
+    g_queue_remove (&unused_tables, res);
+
+  return res;
+}
+
+/* takes ownership of the tables in @resampler */
+static void
+resampler_tables_add (const ResamplerKey * key, GstVideoResampler * resampler)
+{
+  ResamplerTables *res, *old;
+
+  res = g_slice_new (ResamplerTables);
+  res->key = *key;
+  res->refcount = 1;
+  res->max_taps = resampler->max_taps;
+  res->offset = resampler->offset;
+  res->phase = resampler->phase;
+  res->n_taps = resampler->n_taps;
+  res->taps = resampler->taps;
+  resampler->_gst_reserved[0] = res;
+
+  g_mutex_lock (&tables_lock);
+  if (tables == NULL)
+    tables = g_hash_table_new (resampler_key_hash, resampler_key_equal);
+
+  /* someone else might have calculated the same tables meanwhile, use
+   * those and drop ours */
+  old = resampler_tables_lookup (key);
+  if (old) {
+    g_mutex_unlock (&tables_lock);
+    resampler_tables_free (res);
+    resampler_tables_apply (old, resampler);
+    return;
+  }
+  g_hash_table_insert (tables, &res->key, res);
+  g_mutex_unlock (&tables_lock);
+}
+
+static void
+resampler_tables_unref (ResamplerTables * res)
+{
+  ResamplerTables *evict = NULL;
+
+  g_mutex_lock (&tables_lock);
+  if (--res->refcount == 0) {
+    g_queue_push_tail (&unused_tables, res);
+    if (unused_tables.length > MAX_UNUSED_TABLES) {
+      evict = g_queue_pop_head (&unused_tables);
+      g_hash_table_remove (tables, &evict->key);
+    }
+  }
+  g_mutex_unlock (&tables_lock);
+
+  if (evict) {
+    GST_DEBUG ("evicting tables %u->%u", evict->key.in_size,
+        evict->key.out_size);
+    resampler_tables_free (evict);
+  }
+}
+
 static double
 sinc (double x)
 {
@@ -336,6 +507,11 @@ resampler_dump (GstVideoResampler * resampler)
  * element. If n_taps is 0, this function chooses a good value automatically based
  * on the @method and @in_size/@out_size.
  *
+ * Since 1.20 the @offset, @phase, @n_taps and @taps arrays of @resampler may
+ * be shared with other resamplers that were initialized with the same
+ * parameters. They must be treated as read-only and are only valid until
+ * gst_video_resampler_clear() is called on @resampler.
+ *
  * Returns: %TRUE on success
  *
  * Since: 1.6
@@ -347,6 +523,8 @@ gst_video_resampler_init (GstVideoResampler * resampler,
     GstStructure * options)
 {
   ResamplerParams params;
+  ResamplerKey key;
+  ResamplerTables *cached;
   gint max_taps;
   gdouble scale_factor;
 
@@ -358,6 +536,33 @@ gst_video_resampler_init (GstVideoResampler * resampler,
   resampler->out_size = out_size;
   resampler->n_phases = n_phases;
 
+  /* the padding in the key would otherwise break the hash */
+  memset (&key, 0, sizeof (key));
+  key.method = method;
+  key.flags = flags;
+  key.n_phases = n_phases;
+  key.n_taps = n_taps;
+  key.shift = shift;
+  key.in_size = in_size;
+  key.out_size = out_size;
+  key.b = GET_OPT_CUBIC_B (options);
+  key.c = GET_OPT_CUBIC_C (options);
+  key.envelope = GET_OPT_ENVELOPE (options);
+  key.sharpness = GET_OPT_SHARPNESS (options);
+  key.sharpen = GET_OPT_SHARPEN (options);
+  key.max_taps = GET_OPT_MAX_TAPS (options);
+
+  g_mutex_lock (&tables_lock);
+  cached = resampler_tables_lookup (&key);
+  g_mutex_unlock (&tables_lock);
+
+  if (cached) {
+    GST_DEBUG ("%d %u  %u->%u, using cached tables", method, n_taps, in_size,
+        out_size);
+    resampler_tables_apply (cached, resampler);
+    return TRUE;
+  }
+
   params.method = method;
   params.flags = flags;
   params.shift = shift;
@@ -425,6 +630,8 @@ gst_video_resampler_init (GstVideoResampler * resampler,
 
   resampler_dump (resampler);
 
+  resampler_tables_add (&key, resampler);
+
   return TRUE;
 }
 
@@ -441,8 +648,13 @@ gst_video_resampler_clear (GstVideoResampler * resampler)
 {
   g_return_if_fail (resampler != NULL);
 
-  g_free (resampler->phase);
-  g_free (resampler->offset);
-  g_free (resampler->n_taps);
-  g_free (resampler->taps);
+  if (resampler->_gst_reserved[0]) {
+    resampler_tables_unref (resampler->_gst_reserved[0]);
+    resampler->_gst_reserved[0] = NULL;
+  } else {
+    g_free (resampler->phase);
+    g_free (resampler->offset);
+    g_free (resampler->n_taps);
+    g_free (resampler->taps);
+  }
 }
@@ -143,6 +143,9 @@ typedef enum {
  *
  * A structure holding resampler information.
  *
+ * The arrays are owned by the resampler and may be shared with other
+ * resamplers with the same parameters since 1.20, they must not be modified.
+ *
  * Since: 1.6
  */
 struct _GstVideoResampler
@@ -0,0 +1,228 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-scaler-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <immintrin.h>
+
+/* the 8 bit kernels use 16 bit wrapping arithmetic like the _lq ORC
+ * programs, the 16 bit kernels 32 bit arithmetic */
+#define SCALE_U8_LQ 6
+#define SCALE_U16 12
+
+static inline guint8
+scale_u8_lq (gint16 acc)
+{
+  acc = (gint16) (acc + (1 << (SCALE_U8_LQ - 1))) >> SCALE_U8_LQ;
+  return CLAMP (acc, 0, 255);
+}
+
+static inline guint16
+scale_u16 (gint32 acc, gint32 round)
+{
+  acc = (gint32) ((guint32) acc + round) >> SCALE_U16;
+  return CLAMP (acc, 0, 65535);
+}
+
+static inline void
+store_u8_lq (guint8 * d, __m256i acc)
+{
+  acc = _mm256_add_epi16 (acc, _mm256_set1_epi16 (1 << (SCALE_U8_LQ - 1)));
+  acc = _mm256_srai_epi16 (acc, SCALE_U8_LQ);
+  _mm_storeu_si128 ((__m128i *) d,
+      _mm_packus_epi16 (_mm256_castsi256_si128 (acc),
+          _mm256_extracti128_si256 (acc, 1)));
+}
+
+static inline void
+store_u16 (guint16 * d, __m256i acc, __m256i round)
+{
+  acc = _mm256_srai_epi32 (_mm256_add_epi32 (acc, round), SCALE_U16);
+  _mm_storeu_si128 ((__m128i *) d,
+      _mm_packus_epi32 (_mm256_castsi256_si128 (acc),
+          _mm256_extracti128_si256 (acc, 1)));
+}
+
+static inline __m256i
+load_u8 (const guint8 * s)
+{
+  return _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) s));
+}
+
+static inline __m256i
+load_u16 (const guint16 * s)
+{
+  return _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) s));
+}
+
+gboolean
+video_scaler_x86_have_avx2 (void)
+{
+#if defined (__GNUC__)
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("avx2") != 0;
+#else
+  return FALSE;
+#endif
+}
+
+void
+video_scale_v_4tap_u8_lq_avx2 (guint8 * d, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, gint16 p1,
+    gint16 p2, gint16 p3, gint16 p4, gint count)
+{
+  __m256i t1 = _mm256_set1_epi16 (p1);
+  __m256i t2 = _mm256_set1_epi16 (p2);
+  __m256i t3 = _mm256_set1_epi16 (p3);
+  __m256i t4 = _mm256_set1_epi16 (p4);
+  gint i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    __m256i acc;
+
+    acc = _mm256_mullo_epi16 (load_u8 (s1 + i), t1);
+    acc = _mm256_add_epi16 (acc, _mm256_mullo_epi16 (load_u8 (s2 + i), t2));
+    acc = _mm256_add_epi16 (acc, _mm256_mullo_epi16 (load_u8 (s3 + i), t3));
+    acc = _mm256_add_epi16 (acc, _mm256_mullo_epi16 (load_u8 (s4 + i), t4));
+    store_u8_lq (d + i, acc);
+  }
+  for (; i < count; i++) {
+    gint16 acc;
+
+    acc = (gint16) (s1[i] * p1 + s2[i] * p2 + s3[i] * p3 + s4[i] * p4);
+    d[i] = scale_u8_lq (acc);
+  }
+}
+
+void
+video_scale_v_ntap_u8_lq_avx2 (guint8 * d, gpointer srcs[], gint src_inc,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i = 0, j;
+
+  /* all taps in one pass, the ORC version needs a pass per tap */
+  for (; i + 16 <= count; i += 16) {
+    __m256i acc = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint8 *s = (const guint8 *) srcs[j * src_inc] + i;
+
+      acc = _mm256_add_epi16 (acc,
+          _mm256_mullo_epi16 (load_u8 (s), _mm256_set1_epi16 (taps[j])));
+    }
+    store_u8_lq (d + i, acc);
+  }
+  for (; i < count; i++) {
+    gint16 acc = 0;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (gint16) (((const guint8 *) srcs[j * src_inc])[i] * taps[j]);
+    d[i] = scale_u8_lq (acc);
+  }
+}
+
+void
+video_scale_v_ntap_u16_avx2 (guint16 * d, gpointer srcs[], gint src_inc,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  __m256i round = _mm256_set1_epi32 ((1 << SCALE_U16) - 1);
+  gint i = 0, j;
+
+  for (; i + 8 <= count; i += 8) {
+    __m256i acc = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      const guint16 *s = (const guint16 *) srcs[j * src_inc] + i;
+
+      acc = _mm256_add_epi32 (acc,
+          _mm256_mullo_epi32 (load_u16 (s), _mm256_set1_epi32 (taps[j])));
+    }
+    store_u16 (d + i, acc, round);
+  }
+  for (; i < count; i++) {
+    guint32 acc = 0;
+
+    for (j = 0; j < n_taps; j++)
+      acc += ((const guint16 *) srcs[j * src_inc])[i] * (gint32) taps[j];
+    d[i] = scale_u16 (acc, (1 << SCALE_U16) - 1);
+  }
+}
+
+void
+video_scale_h_ntap_u8_lq_avx2 (guint8 * d, const guint8 * pixels,
+    const gint16 * taps, gint n_taps, gint count)
+{
+  gint i = 0, j;
+
+  for (; i + 16 <= count; i += 16) {
+    __m256i acc = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      __m256i t;
+
+      t = _mm256_loadu_si256 ((const __m256i *) (taps + j * count + i));
+      acc = _mm256_add_epi16 (acc,
+          _mm256_mullo_epi16 (load_u8 (pixels + j * count + i), t));
+    }
+    store_u8_lq (d + i, acc);
+  }
+  for (; i < count; i++) {
+    gint16 acc = 0;
+
+    for (j = 0; j < n_taps; j++)
+      acc += (gint16) (pixels[j * count + i] * taps[j * count + i]);
+    d[i] = scale_u8_lq (acc);
+  }
+}
+
+void
+video_scale_h_ntap_u16_avx2 (guint16 * d, const guint16 * pixels,
+    const gint16 * taps, gint n_taps, gint count, gint round)
+{
+  __m256i vround = _mm256_set1_epi32 (round);
+  gint i = 0, j;
+
+  for (; i + 8 <= count; i += 8) {
+    __m256i acc = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      __m256i t;
+
+      t = _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *)
+              (taps + j * count + i)));
+      acc = _mm256_add_epi32 (acc,
+          _mm256_mullo_epi32 (load_u16 (pixels + j * count + i), t));
+    }
+    store_u16 (d + i, acc, vround);
+  }
+  for (; i < count; i++) {
+    guint32 acc = 0;
+
+    for (j = 0; j < n_taps; j++)
+      acc += pixels[j * count + i] * (gint32) taps[j * count + i];
+    d[i] = scale_u16 (acc, round);
+  }
+}
+
+#endif
@@ -0,0 +1,56 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_SCALER_X86_AVX2_H__
+#define __GST_VIDEO_SCALER_X86_AVX2_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* These compute exactly the same as the ORC programs they replace, see
+ * video-orc.orc. Pixels and taps of the horizontal kernels are laid out with
+ * all pixels of one tap after each other, as prepared in video-scaler.c. */
+
+G_GNUC_INTERNAL
+gboolean video_scaler_x86_have_avx2 (void);
+
+G_GNUC_INTERNAL
+void video_scale_v_4tap_u8_lq_avx2 (guint8 * d, const guint8 * s1,
+    const guint8 * s2, const guint8 * s3, const guint8 * s4, gint16 p1,
+    gint16 p2, gint16 p3, gint16 p4, gint count);
+
+G_GNUC_INTERNAL
+void video_scale_v_ntap_u8_lq_avx2 (guint8 * d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gint count);
+
+G_GNUC_INTERNAL
+void video_scale_v_ntap_u16_avx2 (guint16 * d, gpointer srcs[],
+    gint src_inc, const gint16 * taps, gint n_taps, gint count);
+
+G_GNUC_INTERNAL
+void video_scale_h_ntap_u8_lq_avx2 (guint8 * d, const guint8 * pixels,
+    const gint16 * taps, gint n_taps, gint count);
+
+G_GNUC_INTERNAL
+void video_scale_h_ntap_u16_avx2 (guint16 * d, const guint16 * pixels,
+    const gint16 * taps, gint n_taps, gint count, gint round);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_SCALER_X86_AVX2_H__ */
@@ -44,6 +44,12 @@
 #include "video-orc.h"
 #include "video-scaler.h"
 
+#if defined (HAVE_AVX2) && defined (HAVE_IMMINTRIN_H) && \
+    (defined (__i386__) || defined (__x86_64__))
+#define USE_AVX2
+#include "video-scaler-x86-avx2.h"
+#endif
+
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
 static GstDebugCategory *
@@ -76,6 +82,29 @@ ensure_debug_category (void)
 
 #define LQ
 
+#ifdef USE_AVX2
+static gboolean use_avx2 = FALSE;
+#endif
+
+/* select the kernels for this CPU, the ORC programs are used when no
+ * better implementation is available. Setting GST_VIDEO_SCALER_NO_SIMD in
+ * the environment disables the AVX2 kernels and forces the ORC programs,
+ * for comparing. It is read once, when the first scaler is made. */
+static void
+video_scaler_init_simd (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+#ifdef USE_AVX2
+    if (g_getenv ("GST_VIDEO_SCALER_NO_SIMD") == NULL)
+      use_avx2 = video_scaler_x86_have_avx2 ();
+    GST_DEBUG ("AVX2 kernels %s", use_avx2 ? "enabled" : "disabled");
+#endif
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
+
 typedef void (*GstVideoScalerHFunc) (GstVideoScaler * scale,
     gpointer src, gpointer dest, guint dest_offset, guint width, guint n_elems);
 typedef void (*GstVideoScalerVFunc) (GstVideoScaler * scale,
@@ -219,6 +248,8 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
   g_return_val_if_fail (in_size != 0, NULL);
   g_return_val_if_fail (out_size != 0, NULL);
 
+  video_scaler_init_simd ();
+
   scale = g_slice_new0 (GstVideoScaler);
 
   GST_DEBUG ("%d %u  %u->%u", method, n_taps, in_size, out_size);
@@ -697,6 +728,13 @@ video_scale_h_ntap_u8 (GstVideoScaler * scale,
   taps = scale->taps_s16_4;
   count = width * n_elems;
 
+#if defined (USE_AVX2) && defined (LQ)
+  if (use_avx2) {
+    video_scale_h_ntap_u8_lq_avx2 (d, pixels, taps, max_taps, count);
+    return;
+  }
+#endif
+
 #ifdef LQ
   if (max_taps == 2) {
     video_orc_resample_h_2tap_u8_lq (d, pixels, pixels + count, taps,
@@ -811,6 +849,15 @@ video_scale_h_ntap_u16 (GstVideoScaler * scale,
   taps = scale->taps_s16_4;
   count = width * n_elems;
 
+#ifdef USE_AVX2
+  if (use_avx2) {
+    /* the 2 tap ORC program rounds differently */
+    video_scale_h_ntap_u16_avx2 (d, pixels, taps, max_taps, count,
+        max_taps == 2 ? 4096 : 4095);
+    return;
+  }
+#endif
+
   if (max_taps == 2) {
     video_orc_resample_h_2tap_u16 (d, pixels, pixels + count, taps,
         taps + count, count);
@@ -975,6 +1022,13 @@ video_scale_v_4tap_u8 (GstVideoScaler * scale,
   p4 = taps[3];
 
 #ifdef LQ
+#ifdef USE_AVX2
+  if (use_avx2) {
+    video_scale_v_4tap_u8_lq_avx2 (d, s1, s2, s3, s4, p1, p2, p3, p4,
+        width * n_elems);
+    return;
+  }
+#endif
   video_orc_resample_v_4tap_u8_lq (d, s1, s2, s3, s4, p1, p2, p3, p4,
       width * n_elems);
 #else
@@ -1013,6 +1067,13 @@ video_scale_v_ntap_u8 (GstVideoScaler * scale,
   temp = (gint16 *) scale->tmpline2;
   count = width * n_elems;
 
+#if defined (USE_AVX2) && defined (LQ)
+  if (use_avx2) {
+    video_scale_v_ntap_u8_lq_avx2 (d, srcs, src_inc, taps, max_taps, count);
+    return;
+  }
+#endif
+
 #ifdef LQ
   if (max_taps >= 4) {
     video_orc_resample_v_multaps4_u8_lq (temp, srcs[0], srcs[1 * src_inc],
@@ -1097,6 +1158,13 @@ video_scale_v_ntap_u16 (GstVideoScaler * scale,
   temp = (gint32 *) scale->tmpline2;
   count = width * n_elems;
 
+#ifdef USE_AVX2
+  if (use_avx2) {
+    video_scale_v_ntap_u16_avx2 (d, srcs, src_inc, taps, max_taps, count);
+    return;
+  }
+#endif
+
   video_orc_resample_v_multaps_u16 (temp, srcs[0], taps[0], count);
   for (i = 1; i < max_taps; i++) {
     video_orc_resample_v_muladdtaps_u16 (temp, srcs[i * src_inc], taps[i],
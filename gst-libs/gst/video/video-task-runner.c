@@ -0,0 +1,581 @@
+/* GStreamer
+ * Copyright (C) 2010 David Schleef <ds@schleef.org>
+ * Copyright (C) 2010 Sebastian Dröge <sebastian.droege@collabora.co.uk>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/base/base.h>
+
+#include "video-task-runner.h"
+#include "gst/shared-task-pool-private.h"
+
+/**
+ * SECTION:videotaskrunner
+ * @title: GstVideoTaskRunner
+ * @short_description: Parallel execution of per-line video tasks
+ *
+ * #GstVideoTaskRunner splits work such as converting or blending a video
+ * frame over a number of workers. The work is described by an array of
+ * tasks, usually horizontal stripes of the frame. All workers of a run pull
+ * the next unstarted task from a shared counter, so a worker that is done
+ * with its stripes takes over the ones a slower worker did not get to yet.
+ * Using more stripes than workers lets the load balance out.
+ *
+ * By default all runners share one process-wide #GstTaskPool with one thread
+ * per CPU core, see gst_video_task_runner_get_shared_pool(), so that many
+ * converters in one process do not oversubscribe the machine.
+ *
+ * Async runners can notify the completion of all scheduled work with a
+ * #GstVideoTaskDoneFunc, see gst_video_task_runner_set_done_func(). Work
+ * done outside of the tasks, for example on the calling thread, can be
+ * included with gst_video_task_runner_hold() and
+ * gst_video_task_runner_release().
+ *
+ * Each runner accounts the time its workers spend running tasks, which can
+ * be retrieved with gst_video_task_runner_get_stats().
+ *
+ * Since: 1.20
+ */
+
+#ifndef GST_DISABLE_GST_DEBUG
+#define GST_CAT_DEFAULT ensure_debug_category()
+static GstDebugCategory *
+ensure_debug_category (void)
+{
+  static gsize cat_gonce = 0;
+
+  if (g_once_init_enter (&cat_gonce)) {
+    gsize cat_done;
+
+    cat_done = (gsize) _gst_debug_category_new ("video-task-runner", 0,
+        "video-task-runner object");
+
+    g_once_init_leave (&cat_gonce, cat_done);
+  }
+
+  return (GstDebugCategory *) cat_gonce;
+}
+#else
+#define ensure_debug_category() /* NOOP */
+#endif /* GST_DISABLE_GST_DEBUG */
+
+/* number of stripes each worker gets when splitting up a frame */
+#define STRIPES_PER_WORKER 4
+
+typedef struct _GstVideoTaskJob GstVideoTaskJob;
+
+struct _GstVideoTaskJob
+{
+  GstVideoTaskRunner *runner;
+  GstVideoTaskFunc func;
+  gpointer *task_data;
+  guint n_tasks;
+
+  /* atomic */
+  gint next_task;
+  gint next_worker;
+};
+
+struct _GstVideoTaskRunner
+{
+  GstTaskPool *pool;
+  guint n_workers;
+  gboolean async_tasks;
+
+  GMutex lock;
+  /* handles of the pushed helpers and jobs, protected by lock */
+  GstQueueArray *tasks;
+  GstQueueArray *jobs;
+
+  /* helpers and holds that did not complete yet, atomic */
+  gint pending;
+  /* protected by lock */
+  GstVideoTaskDoneFunc done_func;
+  gpointer done_data;
+
+  /* stats, protected by lock */
+  guint64 n_runs;
+  guint64 n_tasks;
+  guint64 n_helper_tasks;
+  GstClockTime cpu_time;
+};
+
+/**
+ * gst_video_task_runner_get_shared_pool:
+ *
+ * Get the process-wide #GstTaskPool used by runners that were created
+ * without a pool. It is a #GstSharedTaskPool with one thread per CPU core,
+ * also used by the other libraries of gst-plugins-base, for example by the
+ * #GstAudioResampler.
+ *
+ * Returns: (transfer none): the shared #GstTaskPool
+ *
+ * Since: 1.20
+ */
+GstTaskPool *
+gst_video_task_runner_get_shared_pool (void)
+{
+  return _gst_plugins_base_get_shared_task_pool ();
+}
+
+static guint
+gst_video_task_job_process (GstVideoTaskJob * job, guint worker)
+{
+  guint n_done = 0;
+
+  while (TRUE) {
+    guint idx = g_atomic_int_add (&job->next_task, 1);
+
+    if (idx >= job->n_tasks)
+      break;
+
+    job->func (job->task_data[idx], worker);
+    n_done++;
+  }
+  return n_done;
+}
+
+static void
+gst_video_task_runner_account (GstVideoTaskRunner * self, guint n_done,
+    gboolean helper, gint64 start)
+{
+  GstClockTime elapsed;
+
+  if (n_done == 0)
+    return;
+
+  elapsed = (g_get_monotonic_time () - start) * GST_USECOND;
+
+  g_mutex_lock (&self->lock);
+  self->n_tasks += n_done;
+  if (helper)
+    self->n_helper_tasks += n_done;
+  self->cpu_time += elapsed;
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+gst_video_task_thread_func (gpointer data)
+{
+  GstVideoTaskJob *job = data;
+  gint64 start;
+  guint worker, n_done;
+
+  start = g_get_monotonic_time ();
+  /* every participant of a job gets its own worker index */
+  worker = g_atomic_int_add (&job->next_worker, 1);
+  g_assert (worker < job->runner->n_workers);
+
+  n_done = gst_video_task_job_process (job, worker);
+  gst_video_task_runner_account (job->runner, n_done, TRUE, start);
+
+  if (job->runner->async_tasks)
+    gst_video_task_runner_release (job->runner);
+}
+
+static void
+gst_video_task_runner_join (GstVideoTaskRunner * self)
+{
+  gboolean joined = FALSE;
+
+  while (!joined) {
+    g_mutex_lock (&self->lock);
+    if (!(joined = gst_queue_array_is_empty (self->tasks))) {
+      gpointer task = gst_queue_array_pop_head (self->tasks);
+      g_mutex_unlock (&self->lock);
+      gst_task_pool_join (self->pool, task);
+    } else {
+      g_mutex_unlock (&self->lock);
+    }
+  }
+
+  /* all helpers are done, the async jobs can go now */
+  g_mutex_lock (&self->lock);
+  while (!gst_queue_array_is_empty (self->jobs))
+    g_free (gst_queue_array_pop_head (self->jobs));
+  g_mutex_unlock (&self->lock);
+}
+
+/**
+ * gst_video_task_runner_new:
+ * @n_workers: the maximum number of workers, 0 for the number of CPU cores
+ * @pool: (allow-none): a #GstTaskPool to run the workers on, or %NULL to use
+ *   the shared pool
+ * @async_tasks: whether gst_video_task_runner_run() returns before the tasks
+ *   are done
+ *
+ * Create a new runner that runs tasks on at most @n_workers workers.
+ *
+ * When @async_tasks is %TRUE, gst_video_task_runner_run() only schedules the
+ * tasks and gst_video_task_runner_finish() must be called to wait for them.
+ * Otherwise the calling thread is one of the workers and
+ * gst_video_task_runner_run() returns when all tasks are done.
+ *
+ * Returns: a new #GstVideoTaskRunner. Free with gst_video_task_runner_free().
+ *
+ * Since: 1.20
+ */
+GstVideoTaskRunner *
+gst_video_task_runner_new (guint n_workers, GstTaskPool * pool,
+    gboolean async_tasks)
+{
+  GstVideoTaskRunner *self;
+
+  g_return_val_if_fail (pool == NULL || GST_IS_TASK_POOL (pool), NULL);
+
+  if (n_workers == 0)
+    n_workers = g_get_num_processors ();
+
+  if (pool == NULL)
+    pool = gst_video_task_runner_get_shared_pool ();
+
+  /* No reason to split up the work between more threads than the
+   * pool can spawn */
+  if (GST_IS_SHARED_TASK_POOL (pool))
+    n_workers =
+        MIN (n_workers,
+        gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
+  if (n_workers < 1)
+    n_workers = 1;
+
+  self = g_new0 (GstVideoTaskRunner, 1);
+  self->pool = gst_object_ref (pool);
+  self->n_workers = n_workers;
+  self->async_tasks = async_tasks;
+
+  self->tasks = gst_queue_array_new (n_workers);
+  self->jobs = gst_queue_array_new (4);
+  g_mutex_init (&self->lock);
+
+  GST_DEBUG ("new runner %p with %u workers, async %d", self, n_workers,
+      async_tasks);
+
+  return self;
+}
+
+/**
+ * gst_video_task_runner_free:
+ * @runner: a #GstVideoTaskRunner
+ *
+ * Wait for all pending tasks of @runner and free it.
+ *
+ * Since: 1.20
+ */
+void
+gst_video_task_runner_free (GstVideoTaskRunner * runner)
+{
+  g_return_if_fail (runner != NULL);
+
+  gst_video_task_runner_join (runner);
+
+  gst_queue_array_free (runner->tasks);
+  gst_queue_array_free (runner->jobs);
+  gst_object_unref (runner->pool);
+  g_mutex_clear (&runner->lock);
+  g_free (runner);
+}
+
+/**
+ * gst_video_task_runner_get_n_workers:
+ * @runner: a #GstVideoTaskRunner
+ *
+ * Get the maximum number of workers that run tasks of @runner in parallel.
+ * Per-worker state passed to the #GstVideoTaskFunc needs this many entries.
+ *
+ * Returns: the number of workers
+ *
+ * Since: 1.20
+ */
+guint
+gst_video_task_runner_get_n_workers (GstVideoTaskRunner * runner)
+{
+  g_return_val_if_fail (runner != NULL, 0);
+
+  return runner->n_workers;
+}
+
+/**
+ * gst_video_task_runner_is_async:
+ * @runner: a #GstVideoTaskRunner
+ *
+ * Returns: %TRUE if @runner was created with async tasks.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_video_task_runner_is_async (GstVideoTaskRunner * runner)
+{
+  g_return_val_if_fail (runner != NULL, FALSE);
+
+  return runner->async_tasks;
+}
+
+/**
+ * gst_video_task_runner_get_n_stripes:
+ * @runner: a #GstVideoTaskRunner
+ * @n_lines: the number of lines to process
+ * @min_lines: the minimum number of lines in one stripe
+ *
+ * Get the number of stripes to split @n_lines into. This is a few stripes
+ * per worker so that idle workers can take over work from busy ones, but
+ * never stripes smaller than @min_lines.
+ *
+ * Returns: the number of stripes, at least 1
+ *
+ * Since: 1.20
+ */
+guint
+gst_video_task_runner_get_n_stripes (GstVideoTaskRunner * runner,
+    guint n_lines, guint min_lines)
+{
+  guint n_stripes;
+
+  g_return_val_if_fail (runner != NULL, 1);
+
+  if (runner->n_workers == 1)
+    return 1;
+
+  n_stripes = runner->n_workers * STRIPES_PER_WORKER;
+  if (min_lines > 0)
+    n_stripes = MIN (n_stripes, n_lines / min_lines);
+
+  return MAX (n_stripes, 1);
+}
+
+/**
+ * gst_video_task_runner_run:
+ * @runner: a #GstVideoTaskRunner
+ * @func: (scope call): the function to run for each task
+ * @task_data: (array length=n_tasks): the data of the tasks
+ * @n_tasks: the number of tasks
+ *
+ * Run @func for each of the @n_tasks entries in @task_data. The tasks can
+ * run in any order and in parallel on up to
+ * gst_video_task_runner_get_n_workers() workers.
+ *
+ * For async runners, @task_data must stay valid until
+ * gst_video_task_runner_finish() returned.
+ *
+ * Since: 1.20
+ */
+void
+gst_video_task_runner_run (GstVideoTaskRunner * runner,
+    GstVideoTaskFunc func, gpointer * task_data, guint n_tasks)
+{
+  GstVideoTaskJob *job, sync_job;
+  guint i, n_helpers;
+
+  g_return_if_fail (runner != NULL);
+  g_return_if_fail (func != NULL);
+
+  if (n_tasks == 0)
+    return;
+
+  if (runner->async_tasks)
+    job = g_new0 (GstVideoTaskJob, 1);
+  else
+    job = &sync_job;
+
+  job->runner = runner;
+  job->func = func;
+  job->task_data = task_data;
+  job->n_tasks = n_tasks;
+  job->next_task = 0;
+  job->next_worker = 0;
+
+  if (runner->async_tasks) {
+    /* not more helpers than tasks */
+    n_helpers = MIN (runner->n_workers, n_tasks);
+  } else {
+    /* the current thread is one of the workers */
+    n_helpers = MIN (runner->n_workers, n_tasks) - 1;
+    /* and it uses the first worker index */
+    job->next_worker = 1;
+  }
+
+  g_mutex_lock (&runner->lock);
+  runner->n_runs++;
+  if (runner->async_tasks) {
+    gst_queue_array_push_tail (runner->jobs, job);
+    /* every helper releases the runner when it is done */
+    g_atomic_int_add (&runner->pending, n_helpers);
+  }
+
+  for (i = 0; i < n_helpers; i++) {
+    gpointer task =
+        gst_task_pool_push (runner->pool, gst_video_task_thread_func, job,
+        NULL);
+
+    /* The return value of push() is nullable but NULL is only returned
+     * with the shared task pool when gst_task_pool_prepare() has not been
+     * called and would thus be a programming error that we should hard-fail
+     * on.
+     */
+    g_assert (task != NULL);
+    gst_queue_array_push_tail (runner->tasks, task);
+  }
+  g_mutex_unlock (&runner->lock);
+
+  if (!runner->async_tasks) {
+    gint64 start = g_get_monotonic_time ();
+    guint n_done;
+
+    n_done = gst_video_task_job_process (job, 0);
+    gst_video_task_runner_account (runner, n_done, FALSE, start);
+
+    gst_video_task_runner_join (runner);
+  }
+}
+
+/**
+ * gst_video_task_runner_set_done_func:
+ * @runner: a #GstVideoTaskRunner
+ * @func: (allow-none): the function to call on completion, or %NULL
+ * @user_data: user data passed to @func
+ *
+ * Set the function that is called when all tasks scheduled on an async
+ * @runner completed and no hold taken with gst_video_task_runner_hold() is
+ * outstanding anymore.
+ *
+ * @func is called from the thread that completed the last piece of work,
+ * which is usually one of the pool threads. It must not call
+ * gst_video_task_runner_finish() or gst_video_task_runner_free(), but those
+ * will not block for long once @func was called.
+ *
+ * Since: 1.20
+ */
+void
+gst_video_task_runner_set_done_func (GstVideoTaskRunner * runner,
+    GstVideoTaskDoneFunc func, gpointer user_data)
+{
+  g_return_if_fail (runner != NULL);
+
+  g_mutex_lock (&runner->lock);
+  runner->done_func = func;
+  runner->done_data = user_data;
+  g_mutex_unlock (&runner->lock);
+}
+
+/**
+ * gst_video_task_runner_hold:
+ * @runner: a #GstVideoTaskRunner
+ *
+ * Delay the completion notification of @runner until a matching
+ * gst_video_task_runner_release(). This is used to cover work that is done
+ * around gst_video_task_runner_run(), such as several runs that make up one
+ * frame.
+ *
+ * Since: 1.20
+ */
+void
+gst_video_task_runner_hold (GstVideoTaskRunner * runner)
+{
+  g_return_if_fail (runner != NULL);
+
+  g_atomic_int_inc (&runner->pending);
+}
+
+/**
+ * gst_video_task_runner_release:
+ * @runner: a #GstVideoTaskRunner
+ *
+ * Release a hold taken with gst_video_task_runner_hold(). When this was the
+ * last outstanding piece of work, the function set with
+ * gst_video_task_runner_set_done_func() is called from the calling thread.
+ *
+ * Since: 1.20
+ */
+void
+gst_video_task_runner_release (GstVideoTaskRunner * runner)
+{
+  GstVideoTaskDoneFunc func;
+  gpointer user_data;
+
+  g_return_if_fail (runner != NULL);
+
+  if (!g_atomic_int_dec_and_test (&runner->pending))
+    return;
+
+  g_mutex_lock (&runner->lock);
+  func = runner->done_func;
+  user_data = runner->done_data;
+  g_mutex_unlock (&runner->lock);
+
+  GST_LOG ("runner %p done", runner);
+
+  if (func)
+    func (runner, user_data);
+}
+
+/**
+ * gst_video_task_runner_finish:
+ * @runner: a #GstVideoTaskRunner
+ *
+ * Wait for all tasks scheduled with gst_video_task_runner_run() to complete.
+ *
+ * Since: 1.20
+ */
+void
+gst_video_task_runner_finish (GstVideoTaskRunner * runner)
+{
+  g_return_if_fail (runner != NULL);
+
+  gst_video_task_runner_join (runner);
+}
+
+/**
+ * gst_video_task_runner_get_stats:
+ * @runner: a #GstVideoTaskRunner
+ *
+ * Get statistics about the work done by @runner. The returned structure
+ * contains the following fields:
+ *
+ *  * "n-workers" (#G_TYPE_UINT): the maximum number of workers
+ *  * "runs" (#G_TYPE_UINT64): the number of calls to
+ *    gst_video_task_runner_run()
+ *  * "tasks" (#G_TYPE_UINT64): the number of tasks that were run
+ *  * "helper-tasks" (#G_TYPE_UINT64): the number of tasks that were run on
+ *    pool threads instead of the calling thread
+ *  * "cpu-time" (#G_TYPE_UINT64): the total time in nanoseconds all workers
+ *    spent running tasks
+ *
+ * Returns: (transfer full): a #GstStructure with the statistics
+ *
+ * Since: 1.20
+ */
+GstStructure *
+gst_video_task_runner_get_stats (GstVideoTaskRunner * runner)
+{
+  GstStructure *s;
+
+  g_return_val_if_fail (runner != NULL, NULL);
+
+  g_mutex_lock (&runner->lock);
+  s = gst_structure_new ("GstVideoTaskRunnerStats",
+      "n-workers", G_TYPE_UINT, runner->n_workers,
+      "runs", G_TYPE_UINT64, runner->n_runs,
+      "tasks", G_TYPE_UINT64, runner->n_tasks,
+      "helper-tasks", G_TYPE_UINT64, runner->n_helper_tasks,
+      "cpu-time", G_TYPE_UINT64, runner->cpu_time, NULL);
+  g_mutex_unlock (&runner->lock);
+
+  return s;
+}
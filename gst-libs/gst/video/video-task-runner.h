@@ -0,0 +1,105 @@
+/* GStreamer
+ * Copyright (C) 2010 David Schleef <ds@schleef.org>
+ * Copyright (C) 2010 Sebastian Dröge <sebastian.droege@collabora.co.uk>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_TASK_RUNNER_H__
+#define __GST_VIDEO_TASK_RUNNER_H__
+
+#include <gst/gst.h>
+#include <gst/video/video-prelude.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GstVideoTaskFunc:
+ * @task_data: the data of the task to run
+ * @worker: the index of the worker running the task, smaller than
+ *   gst_video_task_runner_get_n_workers()
+ *
+ * Function called by a #GstVideoTaskRunner for each task. Only one task at a
+ * time is run with a given @worker index, which can be used to select
+ * per-worker scratch state.
+ *
+ * Since: 1.20
+ */
+typedef void (*GstVideoTaskFunc) (gpointer task_data, guint worker);
+
+typedef struct _GstVideoTaskRunner GstVideoTaskRunner;
+
+/**
+ * GstVideoTaskDoneFunc:
+ * @runner: the #GstVideoTaskRunner
+ * @user_data: the user data passed to gst_video_task_runner_set_done_func()
+ *
+ * Function called when all work scheduled on an async #GstVideoTaskRunner
+ * completed.
+ *
+ * Since: 1.20
+ */
+typedef void (*GstVideoTaskDoneFunc) (GstVideoTaskRunner * runner,
+                                      gpointer user_data);
+
+GST_VIDEO_API
+GstTaskPool *         gst_video_task_runner_get_shared_pool (void);
+
+GST_VIDEO_API
+GstVideoTaskRunner *  gst_video_task_runner_new         (guint n_workers,
+                                                         GstTaskPool * pool,
+                                                         gboolean async_tasks);
+
+GST_VIDEO_API
+void                  gst_video_task_runner_free        (GstVideoTaskRunner * runner);
+
+GST_VIDEO_API
+guint                 gst_video_task_runner_get_n_workers (GstVideoTaskRunner * runner);
+
+GST_VIDEO_API
+gboolean              gst_video_task_runner_is_async    (GstVideoTaskRunner * runner);
+
+GST_VIDEO_API
+guint                 gst_video_task_runner_get_n_stripes (GstVideoTaskRunner * runner,
+                                                         guint n_lines,
+                                                         guint min_lines);
+
+GST_VIDEO_API
+void                  gst_video_task_runner_run         (GstVideoTaskRunner * runner,
+                                                         GstVideoTaskFunc func,
+                                                         gpointer * task_data,
+                                                         guint n_tasks);
+
+GST_VIDEO_API
+void                  gst_video_task_runner_set_done_func (GstVideoTaskRunner * runner,
+                                                         GstVideoTaskDoneFunc func,
+                                                         gpointer user_data);
+
+GST_VIDEO_API
+void                  gst_video_task_runner_hold        (GstVideoTaskRunner * runner);
+
+GST_VIDEO_API
+void                  gst_video_task_runner_release     (GstVideoTaskRunner * runner);
+
+GST_VIDEO_API
+void                  gst_video_task_runner_finish      (GstVideoTaskRunner * runner);
+
+GST_VIDEO_API
+GstStructure *        gst_video_task_runner_get_stats   (GstVideoTaskRunner * runner);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_TASK_RUNNER_H__ */
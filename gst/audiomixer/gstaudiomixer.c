@@ -80,6 +80,29 @@
 #define VOLUME_UNITY_INT32           134217728  /* internal int for unity 2^(32-5) */
 #define VOLUME_UNITY_INT32_BIT_SHIFT 27
 
+/* number of samples that are accumulated at a time when mixing several
+ * inputs in one pass */
+#define MIX_BLOCK_SAMPLES 256
+
+/* an input buffer waiting to be mixed into the output buffer */
+typedef struct
+{
+  GstBuffer *buffer;
+  guint in_offset;
+  guint out_offset;
+  guint num_frames;
+
+  gboolean unity;
+  gdouble volume;
+  gint volume_i8;
+  gint volume_i16;
+  gint volume_i32;
+
+  /* only valid while mixing */
+  GstMapInfo map;
+  const guint8 *data;
+} GstAudioMixerInput;
+
 enum
 {
   PROP_PAD_0,
@@ -212,14 +235,33 @@ static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
     GstBuffer * outbuf, guint out_offset, guint num_samples);
+static GstFlowReturn gst_audiomixer_aggregate (GstAggregator * agg,
+    gboolean timeout);
+static GstFlowReturn gst_audiomixer_finish_buffer (GstAggregator * agg,
+    GstBuffer * buffer);
+static void gst_audiomixer_mix_pending (GstAudioMixer * audiomixer);
+
+static void
+gst_audiomixer_finalize (GObject * object)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (object);
+
+  g_array_unref (audiomixer->pending);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
 
 
 static void
 gst_audiomixer_class_init (GstAudioMixerClass * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
   GstElementClass *gstelement_class = (GstElementClass *) klass;
+  GstAggregatorClass *agg_class = (GstAggregatorClass *) klass;
   GstAudioAggregatorClass *aagg_class = (GstAudioAggregatorClass *) klass;
 
+  gobject_class->finalize = gst_audiomixer_finalize;
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_src_template, GST_TYPE_AUDIO_AGGREGATOR_CONVERT_PAD);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
@@ -233,6 +275,9 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
   gstelement_class->release_pad =
       GST_DEBUG_FUNCPTR (gst_audiomixer_release_pad);
 
+  agg_class->aggregate = GST_DEBUG_FUNCPTR (gst_audiomixer_aggregate);
+  agg_class->finish_buffer = GST_DEBUG_FUNCPTR (gst_audiomixer_finish_buffer);
+
   aagg_class->aggregate_one_buffer = gst_audiomixer_aggregate_one_buffer;
 
   gst_type_mark_as_plugin_api (GST_TYPE_AUDIO_MIXER_PAD, 0);
@@ -241,6 +286,7 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
 static void
 gst_audiomixer_init (GstAudioMixer * audiomixer)
 {
+  audiomixer->pending = g_array_new (FALSE, FALSE, sizeof (GstAudioMixerInput));
 }
 
 static GstPad *
@@ -284,134 +330,348 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 }
 
 
-static gboolean
-gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
-    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
-    GstBuffer * outbuf, guint out_offset, guint num_frames)
+/* adds one input to the output, like the mixing of a single pad always
+ * worked */
+static void
+gst_audiomixer_mix_one (GstAudioFormat format, GstAudioMixerInput * input,
+    guint8 * out, guint num_samples)
 {
-  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
-  GstMapInfo inmap;
-  GstMapInfo outmap;
-  gint bpf;
-  GstAggregator *agg = GST_AGGREGATOR (aagg);
-  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  gpointer in = (gpointer) input->data;
 
-  GST_OBJECT_LOCK (aagg);
-  GST_OBJECT_LOCK (aaggpad);
-
-  if (pad->mute || pad->volume < G_MINDOUBLE) {
-    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
-    GST_OBJECT_UNLOCK (aaggpad);
-    GST_OBJECT_UNLOCK (aagg);
-    return FALSE;
-  }
-
-  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
-
-  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
-  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
-  GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
-      num_frames * bpf, out_offset * bpf, in_offset * bpf);
-
-  /* further buffers, need to add them */
-  if (pad->volume == 1.0) {
-    switch (srcpad->info.finfo->format) {
+  if (input->unity) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_u8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u8 ((gpointer) out, in, num_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_s8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s8 ((gpointer) out, in, num_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_u16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u16 ((gpointer) out, in, num_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_s16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s16 ((gpointer) out, in, num_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_u32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u32 ((gpointer) out, in, num_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_s32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s32 ((gpointer) out, in, num_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_f32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f32 ((gpointer) out, in, num_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_f64 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f64 ((gpointer) out, in, num_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   } else {
-    switch (srcpad->info.finfo->format) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_volume_u8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u8 ((gpointer) out, in, input->volume_i8,
+            num_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_volume_s8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s8 ((gpointer) out, in, input->volume_i8,
+            num_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_volume_u16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u16 ((gpointer) out, in, input->volume_i16,
+            num_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_volume_s16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s16 ((gpointer) out, in, input->volume_i16,
+            num_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_volume_u32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u32 ((gpointer) out, in, input->volume_i32,
+            num_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_volume_s32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s32 ((gpointer) out, in, input->volume_i32,
+            num_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_volume_f32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f32 ((gpointer) out, in, input->volume,
+            num_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_volume_f64 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f64 ((gpointer) out, in, input->volume,
+            num_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   }
-  gst_buffer_unmap (inbuf, &inmap);
-  gst_buffer_unmap (outbuf, &outmap);
+}
+
+/* Accumulates all inputs in a wider type, one block of samples at a time,
+ * and clamps once at the end. The block stays in the cache while the inputs
+ * are added so the output is only read and written once. The volume is
+ * applied like the ORC functions do it. Unsigned samples are converted to
+ * signed for the volume multiplication. */
+#define DEFINE_MIX_INT_FUNC(name, type, stype, acctype, bias, volume_field, \
+    shift, tmin, tmax, smin, smax) \
+static void \
+gst_audiomixer_mix_##name (GstAudioMixerInput * inputs, guint n_inputs, \
+    guint8 * out_data, guint num_samples) \
+{ \
+  acctype acc[MIX_BLOCK_SAMPLES]; \
+  type *out = (type *) out_data; \
+  guint offset, i, k, n; \
+  \
+  for (offset = 0; offset < num_samples; offset += MIX_BLOCK_SAMPLES) { \
+    n = MIN (MIX_BLOCK_SAMPLES, num_samples - offset); \
+    \
+    for (i = 0; i < n; i++) \
+      acc[i] = out[offset + i]; \
+    \
+    for (k = 0; k < n_inputs; k++) { \
+      const type *in = (const type *) inputs[k].data + offset; \
+      \
+      if (inputs[k].unity) { \
+        for (i = 0; i < n; i++) \
+          acc[i] += in[i]; \
+      } else { \
+        acctype volume = inputs[k].volume_field; \
+        \
+        for (i = 0; i < n; i++) { \
+          acctype v = ((acctype) (stype) (in[i] ^ bias) * volume) >> shift; \
+          \
+          v = CLAMP (v, smin, smax); \
+          acc[i] += (type) ((stype) v ^ bias); \
+        } \
+      } \
+    } \
+    \
+    for (i = 0; i < n; i++) \
+      out[offset + i] = CLAMP (acc[i], tmin, tmax); \
+  } \
+}
+
+#define DEFINE_MIX_FLOAT_FUNC(name, type, voltype) \
+static void \
+gst_audiomixer_mix_##name (GstAudioMixerInput * inputs, guint n_inputs, \
+    guint8 * out_data, guint num_samples) \
+{ \
+  type *out = (type *) out_data; \
+  guint offset, i, k, n; \
+  \
+  for (offset = 0; offset < num_samples; offset += MIX_BLOCK_SAMPLES) { \
+    type *o = out + offset; \
+    \
+    n = MIN (MIX_BLOCK_SAMPLES, num_samples - offset); \
+    \
+    for (k = 0; k < n_inputs; k++) { \
+      const type *in = (const type *) inputs[k].data + offset; \
+      \
+      if (inputs[k].unity) { \
+        for (i = 0; i < n; i++) \
+          o[i] += in[i]; \
+      } else { \
+        voltype volume = inputs[k].volume; \
+        \
+        for (i = 0; i < n; i++) \
+          o[i] += in[i] * volume; \
+      } \
+    } \
+  } \
+}
+
+DEFINE_MIX_INT_FUNC (s8, gint8, gint8, gint32, 0, volume_i8,
+    VOLUME_UNITY_INT8_BIT_SHIFT, G_MININT8, G_MAXINT8, G_MININT8, G_MAXINT8);
+DEFINE_MIX_INT_FUNC (u8, guint8, gint8, gint32, 0x80, volume_i8,
+    VOLUME_UNITY_INT8_BIT_SHIFT, 0, G_MAXUINT8, G_MININT8, G_MAXINT8);
+DEFINE_MIX_INT_FUNC (s16, gint16, gint16, gint32, 0, volume_i16,
+    VOLUME_UNITY_INT16_BIT_SHIFT, G_MININT16, G_MAXINT16, G_MININT16,
+    G_MAXINT16);
+DEFINE_MIX_INT_FUNC (u16, guint16, gint16, gint32, 0x8000, volume_i16,
+    VOLUME_UNITY_INT16_BIT_SHIFT, 0, G_MAXUINT16, G_MININT16, G_MAXINT16);
+DEFINE_MIX_INT_FUNC (s32, gint32, gint32, gint64, 0, volume_i32,
+    VOLUME_UNITY_INT32_BIT_SHIFT, G_MININT32, G_MAXINT32, G_MININT32,
+    G_MAXINT32);
+DEFINE_MIX_INT_FUNC (u32, guint32, gint32, gint64, 0x80000000, volume_i32,
+    VOLUME_UNITY_INT32_BIT_SHIFT, 0, G_MAXUINT32, G_MININT32, G_MAXINT32);
+DEFINE_MIX_FLOAT_FUNC (f32, gfloat, gfloat);
+DEFINE_MIX_FLOAT_FUNC (f64, gdouble, gdouble);
+
+static void
+gst_audiomixer_mix_many (GstAudioFormat format, GstAudioMixerInput * inputs,
+    guint n_inputs, guint8 * out, guint num_samples)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_U8:
+      gst_audiomixer_mix_u8 (inputs, n_inputs, out, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S8:
+      gst_audiomixer_mix_s8 (inputs, n_inputs, out, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      gst_audiomixer_mix_u16 (inputs, n_inputs, out, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      gst_audiomixer_mix_s16 (inputs, n_inputs, out, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      gst_audiomixer_mix_u32 (inputs, n_inputs, out, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      gst_audiomixer_mix_s32 (inputs, n_inputs, out, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      gst_audiomixer_mix_f32 (inputs, n_inputs, out, num_samples);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      gst_audiomixer_mix_f64 (inputs, n_inputs, out, num_samples);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+/* Mix all pending inputs into the pending output buffer. Inputs that cover
+ * the same part of the output, which is the normal case, are added in one
+ * pass. Must be called before the output buffer is pushed or dropped. */
+static void
+gst_audiomixer_mix_pending (GstAudioMixer * audiomixer)
+{
+  GstAggregator *agg = GST_AGGREGATOR (audiomixer);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GstAudioMixerInput *inputs;
+  GstAudioFormat format;
+  GstMapInfo outmap;
+  guint i, j, n_inputs, bpf, channels;
+
+  n_inputs = audiomixer->pending->len;
+  if (n_inputs == 0)
+    return;
+
+  inputs = (GstAudioMixerInput *) audiomixer->pending->data;
+
+  GST_OBJECT_LOCK (audiomixer);
+  format = GST_AUDIO_INFO_FORMAT (&srcpad->info);
+  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
+  channels = GST_AUDIO_INFO_CHANNELS (&srcpad->info);
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  gst_buffer_map (audiomixer->pending_outbuf, &outmap, GST_MAP_READWRITE);
+  for (i = 0; i < n_inputs; i++) {
+    gst_buffer_map (inputs[i].buffer, &inputs[i].map, GST_MAP_READ);
+    inputs[i].data = inputs[i].map.data + inputs[i].in_offset * bpf;
+  }
+
+  /* group the inputs by the part of the output they cover */
+  for (i = 0; i < n_inputs;) {
+    guint out_offset = inputs[i].out_offset;
+    guint num_frames = inputs[i].num_frames;
+    guint n_group = 1;
+
+    for (j = i + 1; j < n_inputs; j++) {
+      if (inputs[j].out_offset == out_offset &&
+          inputs[j].num_frames == num_frames) {
+        if (j != i + n_group) {
+          GstAudioMixerInput tmp = inputs[i + n_group];
+
+          inputs[i + n_group] = inputs[j];
+          inputs[j] = tmp;
+        }
+        n_group++;
+      }
+    }
+
+    GST_LOG_OBJECT (audiomixer, "mixing %u inputs, %u frames at offset %u",
+        n_group, num_frames, out_offset);
+
+    if (n_group == 1)
+      gst_audiomixer_mix_one (format, &inputs[i],
+          outmap.data + out_offset * bpf, num_frames * channels);
+    else
+      gst_audiomixer_mix_many (format, &inputs[i], n_group,
+          outmap.data + out_offset * bpf, num_frames * channels);
+
+    i += n_group;
+  }
+
+  for (i = 0; i < n_inputs; i++) {
+    gst_buffer_unmap (inputs[i].buffer, &inputs[i].map);
+    gst_buffer_unref (inputs[i].buffer);
+  }
+  gst_buffer_unmap (audiomixer->pending_outbuf, &outmap);
+
+  g_array_set_size (audiomixer->pending, 0);
+  audiomixer->pending_outbuf = NULL;
+}
+
+static GstFlowReturn
+gst_audiomixer_aggregate (GstAggregator * agg, gboolean timeout)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+  GstFlowReturn ret;
+
+  ret = GST_AGGREGATOR_CLASS (parent_class)->aggregate (agg, timeout);
+
+  /* the output buffer was not finished yet, it stays around until more
+   * data arrives so mix what we have into it now */
+  gst_audiomixer_mix_pending (audiomixer);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_audiomixer_finish_buffer (GstAggregator * agg, GstBuffer * buffer)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+
+  if (audiomixer->pending_outbuf == buffer)
+    gst_audiomixer_mix_pending (audiomixer);
+
+  return GST_AGGREGATOR_CLASS (parent_class)->finish_buffer (agg, buffer);
+}
+
+/* The input is only queued here, all inputs for the output buffer are mixed
+ * together when it is complete */
+static gboolean
+gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
+    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
+    GstBuffer * outbuf, guint out_offset, guint num_frames)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (aagg);
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
+  GstAudioMixerInput input = { NULL, };
+
+  if (audiomixer->pending_outbuf != outbuf)
+    gst_audiomixer_mix_pending (audiomixer);
+
+  GST_OBJECT_LOCK (aaggpad);
+
+  if (pad->mute || pad->volume < G_MINDOUBLE) {
+    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
+    GST_OBJECT_UNLOCK (aaggpad);
+    return FALSE;
+  }
+
+  input.buffer = gst_buffer_ref (inbuf);
+  input.in_offset = in_offset;
+  input.out_offset = out_offset;
+  input.num_frames = num_frames;
+  input.unity = pad->volume == 1.0;
+  input.volume = pad->volume;
+  input.volume_i8 = pad->volume_i8;
+  input.volume_i16 = pad->volume_i16;
+  input.volume_i32 = pad->volume_i32;
 
   GST_OBJECT_UNLOCK (aaggpad);
-  GST_OBJECT_UNLOCK (aagg);
+
+  GST_LOG_OBJECT (pad, "queueing %u frames at offset %u from offset %u",
+      num_frames, out_offset, in_offset);
+
+  g_array_append_val (audiomixer->pending, input);
+  audiomixer->pending_outbuf = outbuf;
 
   return TRUE;
 }
@@ -703,6 +703,9 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
 #define DEFAULT_ZERO_SIZE_IS_UNSCALED TRUE
 #define DEFAULT_MAX_THREADS 0
 
+/* never split the output in stripes of less lines than this */
+#define MIN_LINES_PER_TASK 32
+
 enum
 {
   PROP_0,
@@ -1015,148 +1018,6 @@ _fixate_caps (GstAggregator * agg, GstCaps * caps)
   return ret;
 }
 
-static void
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskRunner *runner = data;
-  gint idx;
-
-  g_mutex_lock (&runner->lock);
-  idx = runner->n_todo--;
-  g_assert (runner->n_todo >= -1);
-  g_mutex_unlock (&runner->lock);
-
-  g_assert (runner->func != NULL);
-
-  runner->func (runner->task_data[idx]);
-}
-
-static void
-gst_parallelized_task_runner_join (GstParallelizedTaskRunner * self)
-{
-  gboolean joined = FALSE;
-
-  while (!joined) {
-    g_mutex_lock (&self->lock);
-    if (!(joined = gst_queue_array_is_empty (self->tasks))) {
-      gpointer task = gst_queue_array_pop_head (self->tasks);
-      g_mutex_unlock (&self->lock);
-      gst_task_pool_join (self->pool, task);
-    } else {
-      g_mutex_unlock (&self->lock);
-    }
-  }
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-
-  gst_queue_array_free (self->tasks);
-  if (self->own_pool)
-    gst_task_pool_cleanup (self->pool);
-  gst_object_unref (self->pool);
-  g_mutex_clear (&self->lock);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
-    gboolean async_tasks)
-{
-  GstParallelizedTaskRunner *self;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-
-  if (pool) {
-    self->pool = g_object_ref (pool);
-    self->own_pool = FALSE;
-
-    /* No reason to split up the work between more threads than the
-     * pool can spawn */
-    if (GST_IS_SHARED_TASK_POOL (pool))
-      n_threads =
-          MIN (n_threads,
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
-  } else {
-    self->pool = gst_shared_task_pool_new ();
-    self->own_pool = TRUE;
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
-        n_threads);
-    gst_task_pool_prepare (self->pool, NULL);
-  }
-
-  self->tasks = gst_queue_array_new (n_threads);
-
-  self->n_threads = n_threads;
-
-  self->n_todo = -1;
-  g_mutex_init (&self->lock);
-
-  /* Set when scheduling a job */
-  self->func = NULL;
-  self->task_data = NULL;
-  self->async_tasks = async_tasks;
-
-  return self;
-}
-
-static void
-gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
-{
-  g_return_if_fail (self->func != NULL);
-
-  gst_parallelized_task_runner_join (self);
-
-  self->func = NULL;
-  self->task_data = NULL;
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  self->func = func;
-  self->task_data = task_data;
-
-  if (n_threads > 1 || self->async_tasks) {
-    guint i = 0;
-    g_mutex_lock (&self->lock);
-    self->n_todo = self->n_threads - 1;
-    if (!self->async_tasks) {
-      /* if not async, perform one of the functions in the current thread */
-      self->n_todo--;
-      i = 1;
-    }
-    for (; i < n_threads; i++) {
-      gpointer task =
-          gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
-          self, NULL);
-
-      /* The return value of push() is nullable but NULL is only returned
-       * with the shared task pool when gst_task_pool_prepare() has not been
-       * called and would thus be a programming error that we should hard-fail
-       * on.
-       */
-      g_assert (task != NULL);
-      gst_queue_array_push_tail (self->tasks, task);
-    }
-    g_mutex_unlock (&self->lock);
-  }
-
-  if (!self->async_tasks) {
-    self->func (self->task_data[self->n_threads - 1]);
-
-    gst_parallelized_task_runner_finish (self);
-  }
-}
-
 static gboolean
 _negotiated_caps (GstAggregator * agg, GstCaps * caps)
 {
@@ -1188,14 +1049,15 @@ _negotiated_caps (GstAggregator * agg, GstCaps * caps)
 
   /* XXX: implement better thread count change */
   if (compositor->blend_runner
-      && compositor->blend_runner->n_threads != n_threads) {
-    gst_parallelized_task_runner_free (compositor->blend_runner);
+      && gst_video_task_runner_get_n_workers (compositor->blend_runner) !=
+      n_threads) {
+    gst_video_task_runner_free (compositor->blend_runner);
     compositor->blend_runner = NULL;
   }
   if (!compositor->blend_runner) {
     GstTaskPool *pool = gst_video_aggregator_get_execution_task_pool (vagg);
-    compositor->blend_runner =
-        gst_parallelized_task_runner_new (n_threads, pool, FALSE);
+    compositor->blend_runner = gst_video_task_runner_new (n_threads, pool,
+        FALSE);
     gst_clear_object (&pool);
   }
 
@@ -1310,7 +1172,7 @@ _draw_background (GstCompositor * comp, GstVideoFrame * outframe,
 }
 
 static void
-blend_pads (struct CompositeTask *comp)
+blend_pads (struct CompositeTask *comp, guint worker)
 {
   BlendFunction composite;
   guint i;
@@ -1409,37 +1271,37 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   }
 
   {
-    guint n_threads, lines_per_thread;
+    guint n_tasks, lines_per_task;
     guint out_height;
     struct CompositeTask *tasks;
     struct CompositeTask **tasks_p;
 
-    n_threads = compositor->blend_runner->n_threads;
+    out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
+    n_tasks = gst_video_task_runner_get_n_stripes (compositor->blend_runner,
+        out_height, MIN_LINES_PER_TASK);
 
-    tasks = g_newa (struct CompositeTask, n_threads);
-    tasks_p = g_newa (struct CompositeTask *, n_threads);
+    tasks = g_newa (struct CompositeTask, n_tasks);
+    tasks_p = g_newa (struct CompositeTask *, n_tasks);
 
-    out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
-    lines_per_thread = (out_height + n_threads - 1) / n_threads;
+    lines_per_task = GST_ROUND_UP_2 ((out_height + n_tasks - 1) / n_tasks);
 
-    for (i = 0; i < n_threads; i++) {
+    for (i = 0; i < n_tasks; i++) {
       tasks[i].compositor = compositor;
       tasks[i].n_pads = n_pads;
       tasks[i].pads_info = pads_info;
       tasks[i].out_frame = outframe;
       tasks[i].draw_background = draw_background;
-      /* This is a dumb split of the work by number of output lines.
-       * If there is a section of the output that reads from a lot of source
-       * pads, then that thread will consume more time. Maybe tracking and
-       * splitting on the source fill rate would produce better results. */
-      tasks[i].dst_line_start = i * lines_per_thread;
-      tasks[i].dst_line_end = MIN ((i + 1) * lines_per_thread, out_height);
+      /* Split the work in more stripes than threads. If there is a section
+       * of the output that reads from a lot of source pads, the threads
+       * that are done with their stripes pick up the remaining ones. */
+      tasks[i].dst_line_start = MIN (i * lines_per_task, out_height);
+      tasks[i].dst_line_end = MIN ((i + 1) * lines_per_task, out_height);
 
       tasks_p[i] = &tasks[i];
     }
 
-    gst_parallelized_task_runner_run (compositor->blend_runner,
-        (GstParallelizedTaskFunc) blend_pads, (gpointer *) tasks_p);
+    gst_video_task_runner_run (compositor->blend_runner,
+        (GstVideoTaskFunc) blend_pads, (gpointer *) tasks_p, n_tasks);
   }
 
   GST_OBJECT_UNLOCK (vagg);
@@ -1537,7 +1399,7 @@ gst_compositor_finalize (GObject * object)
   GstCompositor *compositor = GST_COMPOSITOR (object);
 
   if (compositor->blend_runner)
-    gst_parallelized_task_runner_free (compositor->blend_runner);
+    gst_video_task_runner_free (compositor->blend_runner);
   compositor->blend_runner = NULL;
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
@@ -267,6 +267,15 @@ struct _GstDecodebin3
 
   /* Properties */
   GstCaps *caps;
+  guint decoder_pool_size;
+
+  /* Decoders kept in READY for reuse (List of PooledDecoder), most recently
+   * released first. Protected by the object lock, like the statistics */
+  GList *decoder_pool;
+  guint64 decoder_pool_hits;
+  guint64 decoder_pool_misses;
+  GstClockTime last_decoder_setup_time;
+  GstClockTime last_first_buffer_time;
 };
 
 struct _GstDecodebin3Class
@@ -360,6 +369,14 @@ struct _DecodebinOutputStream
   gulong drop_probe_id;
 };
 
+/* Decoder kept in the pool, with the media type it last handled */
+typedef struct _PooledDecoder
+{
+  GstElement *decoder;
+  /* 0 if unknown */
+  GQuark media_type;
+} PooledDecoder;
+
 /* Pending pads from parsebin */
 typedef struct _PendingPad
 {
@@ -376,9 +393,13 @@ typedef struct _PendingPad
 enum
 {
   PROP_0,
-  PROP_CAPS
+  PROP_CAPS,
+  PROP_DECODER_POOL_SIZE,
+  PROP_STATS
 };
 
+#define DEFAULT_DECODER_POOL_SIZE 0
+
 /* signals */
 enum
 {
@@ -507,6 +528,9 @@ static gboolean set_input_group_id (DecodebinInput * input, guint32 * group_id);
 
 static void reconfigure_output_stream (DecodebinOutputStream * output,
     MultiQueueSlot * slot);
+static void pooled_decoder_free (PooledDecoder * pooled);
+static GList *trim_decoder_pool_unlocked (GstDecodebin3 * dbin);
+static void clear_decoder_pool (GstDecodebin3 * dbin);
 static void free_output_stream (GstDecodebin3 * dbin,
     DecodebinOutputStream * output);
 static DecodebinOutputStream *create_output_stream (GstDecodebin3 * dbin,
@@ -560,6 +584,47 @@ gst_decodebin3_class_init (GstDecodebin3Class * klass)
           "The caps on which to stop decoding. (NULL = default)",
           GST_TYPE_CAPS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDecodebin3:decoder-pool-size:
+   *
+   * Maximum number of decoders kept in READY state once they are no longer
+   * used, so that they can be reused instead of instantiating new ones when
+   * switching to a stream with the same media type. 0 disables the pool.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_klass, PROP_DECODER_POOL_SIZE,
+      g_param_spec_uint ("decoder-pool-size", "Decoder pool size",
+          "Maximum number of unused decoders kept for reuse (0 = disabled)",
+          0, G_MAXUINT, DEFAULT_DECODER_POOL_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDecodebin3:stats:
+   *
+   * Various decodebin3 statistics. This property returns a #GstStructure
+   * with name "application/x-decodebin3-stats" containing the following
+   * fields:
+   *
+   * - "decoder-pool-hits" G_TYPE_UINT64: number of decoders taken from the
+   *   decoder pool
+   * - "decoder-pool-misses" G_TYPE_UINT64: number of decoders that had to
+   *   be instantiated
+   * - "decoder-pool-level" G_TYPE_UINT: number of decoders currently in the
+   *   pool
+   * - "decoder-setup-time" G_TYPE_UINT64: time spent setting up the last
+   *   decoder, or GST_CLOCK_TIME_NONE
+   * - "time-to-first-buffer" G_TYPE_UINT64: time between the start of the
+   *   last decoder setup and the first buffer it produced, or
+   *   GST_CLOCK_TIME_NONE
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_klass, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Various statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /* FIXME : ADD SIGNALS ! */
   /**
    * GstDecodebin3::select-stream
@@ -643,6 +708,9 @@ gst_decodebin3_init (GstDecodebin3 * dbin)
   g_mutex_init (&dbin->input_lock);
 
   dbin->caps = gst_static_caps_get (&default_raw_caps);
+  dbin->decoder_pool_size = DEFAULT_DECODER_POOL_SIZE;
+  dbin->last_decoder_setup_time = GST_CLOCK_TIME_NONE;
+  dbin->last_first_buffer_time = GST_CLOCK_TIME_NONE;
 
   GST_OBJECT_FLAG_SET (dbin, GST_BIN_FLAG_STREAMS_AWARE);
 }
@@ -664,6 +732,7 @@ gst_decodebin3_dispose (GObject * object)
   g_list_free (dbin->to_activate);
   g_list_free (dbin->pending_select_streams);
   g_clear_object (&dbin->collection);
+  clear_decoder_pool (dbin);
 
   free_input (dbin, dbin->main_input);
 
@@ -694,6 +763,17 @@ gst_decodebin3_set_property (GObject * object, guint prop_id,
       dbin->caps = g_value_dup_boxed (value);
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_DECODER_POOL_SIZE:
+    {
+      GList *evicted;
+
+      GST_OBJECT_LOCK (dbin);
+      dbin->decoder_pool_size = g_value_get_uint (value);
+      evicted = trim_decoder_pool_unlocked (dbin);
+      GST_OBJECT_UNLOCK (dbin);
+      g_list_free_full (evicted, (GDestroyNotify) pooled_decoder_free);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -713,6 +793,24 @@ gst_decodebin3_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_boxed (value, dbin->caps);
       GST_OBJECT_UNLOCK (dbin);
       break;
+    case PROP_DECODER_POOL_SIZE:
+      GST_OBJECT_LOCK (dbin);
+      g_value_set_uint (value, dbin->decoder_pool_size);
+      GST_OBJECT_UNLOCK (dbin);
+      break;
+    case PROP_STATS:
+      GST_OBJECT_LOCK (dbin);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-decodebin3-stats",
+              "decoder-pool-hits", G_TYPE_UINT64, dbin->decoder_pool_hits,
+              "decoder-pool-misses", G_TYPE_UINT64, dbin->decoder_pool_misses,
+              "decoder-pool-level", G_TYPE_UINT,
+              g_list_length (dbin->decoder_pool), "decoder-setup-time",
+              G_TYPE_UINT64, dbin->last_decoder_setup_time,
+              "time-to-first-buffer", G_TYPE_UINT64,
+              dbin->last_first_buffer_time, NULL));
+      GST_OBJECT_UNLOCK (dbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2192,12 +2290,187 @@ keyframe_waiter_probe (GstPad * pad, GstPadProbeInfo * info,
   return GST_PAD_PROBE_DROP;
 }
 
+/* Decoder pool
+ *
+ * Decoders that are no longer used by an output are kept in READY state (and
+ * out of the bin) instead of being destroyed, so that a later stream switch
+ * to the same media type can reuse them and skip element creation and the
+ * NULL to READY transition */
+
+static void
+pooled_decoder_free (PooledDecoder * pooled)
+{
+  gst_element_set_state (pooled->decoder, GST_STATE_NULL);
+  gst_object_unref (pooled->decoder);
+  g_free (pooled);
+}
+
+/* Call with the object lock. Detaches and returns the entries beyond the
+ * configured pool size, to be freed without the lock */
+static GList *
+trim_decoder_pool_unlocked (GstDecodebin3 * dbin)
+{
+  GList *evicted;
+
+  evicted = g_list_nth (dbin->decoder_pool, dbin->decoder_pool_size);
+  if (evicted == NULL)
+    return NULL;
+
+  if (evicted->prev) {
+    evicted->prev->next = NULL;
+    evicted->prev = NULL;
+  } else {
+    dbin->decoder_pool = NULL;
+  }
+
+  return evicted;
+}
+
+static void
+clear_decoder_pool (GstDecodebin3 * dbin)
+{
+  GList *pool;
+
+  GST_OBJECT_LOCK (dbin);
+  pool = dbin->decoder_pool;
+  dbin->decoder_pool = NULL;
+  GST_OBJECT_UNLOCK (dbin);
+
+  g_list_free_full (pool, (GDestroyNotify) pooled_decoder_free);
+}
+
+/* Removes @decoder (already unlinked) from the bin, and keeps it in the
+ * decoder pool if enabled. @caps is used as a fallback to know which media
+ * type the decoder handled if its sink pad has no caps anymore */
+static void
+release_decoder (GstDecodebin3 * dbin, GstElement * decoder, GstCaps * caps)
+{
+  PooledDecoder *pooled;
+  GstCaps *current_caps = NULL;
+  GstPad *sinkpad;
+  GList *evicted;
+  GQuark media_type = 0;
+  guint pool_size;
+
+  GST_OBJECT_LOCK (dbin);
+  pool_size = dbin->decoder_pool_size;
+  GST_OBJECT_UNLOCK (dbin);
+
+  gst_element_set_locked_state (decoder, TRUE);
+
+  if (pool_size == 0)
+    goto destroy;
+
+  sinkpad = gst_element_get_static_pad (decoder, "sink");
+  if (sinkpad) {
+    current_caps = gst_pad_get_current_caps (sinkpad);
+    gst_object_unref (sinkpad);
+  }
+  if (current_caps)
+    caps = current_caps;
+  if (caps && !gst_caps_is_empty (caps) && !gst_caps_is_any (caps))
+    media_type = gst_structure_get_name_id (gst_caps_get_structure (caps, 0));
+  if (current_caps)
+    gst_caps_unref (current_caps);
+
+  if (gst_element_set_state (decoder,
+          GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+    GST_DEBUG_OBJECT (dbin, "Decoder '%s' failed to go to READY, not pooling",
+        GST_ELEMENT_NAME (decoder));
+    goto destroy;
+  }
+
+  GST_DEBUG_OBJECT (dbin, "Keeping decoder '%s' in pool for %s",
+      GST_ELEMENT_NAME (decoder),
+      GST_STR_NULL (g_quark_to_string (media_type)));
+
+  gst_object_ref (decoder);
+  gst_bin_remove ((GstBin *) dbin, decoder);
+
+  pooled = g_new0 (PooledDecoder, 1);
+  pooled->decoder = decoder;
+  pooled->media_type = media_type;
+
+  GST_OBJECT_LOCK (dbin);
+  dbin->decoder_pool = g_list_prepend (dbin->decoder_pool, pooled);
+  evicted = trim_decoder_pool_unlocked (dbin);
+  GST_OBJECT_UNLOCK (dbin);
+
+  g_list_free_full (evicted, (GDestroyNotify) pooled_decoder_free);
+  return;
+
+destroy:
+  gst_element_set_state (decoder, GST_STATE_NULL);
+  gst_bin_remove ((GstBin *) dbin, decoder);
+}
+
+/* Takes out of the pool the most recently used decoder created by one of
+ * @factories and which last handled the media type of @caps. Whether it
+ * accepts @caps is checked by the caller like for new decoders */
+static GstElement *
+acquire_pooled_decoder (GstDecodebin3 * dbin, GstCaps * caps,
+    GList * factories)
+{
+  GstElement *decoder = NULL;
+  GQuark media_type;
+  GList *tmp;
+
+  if (gst_caps_is_empty (caps) || gst_caps_is_any (caps))
+    return NULL;
+  media_type = gst_structure_get_name_id (gst_caps_get_structure (caps, 0));
+
+  GST_OBJECT_LOCK (dbin);
+  for (tmp = dbin->decoder_pool; tmp; tmp = tmp->next) {
+    PooledDecoder *pooled = tmp->data;
+
+    if (pooled->media_type != 0 && pooled->media_type != media_type)
+      continue;
+    if (!g_list_find (factories, gst_element_get_factory (pooled->decoder)))
+      continue;
+
+    decoder = pooled->decoder;
+    g_free (pooled);
+    dbin->decoder_pool = g_list_delete_link (dbin->decoder_pool, tmp);
+    break;
+  }
+  if (decoder)
+    dbin->decoder_pool_hits++;
+  else
+    dbin->decoder_pool_misses++;
+  GST_OBJECT_UNLOCK (dbin);
+
+  return decoder;
+}
+
+typedef struct
+{
+  GstDecodebin3 *dbin;
+  GstClockTime start;
+} FirstBufferData;
+
+static GstPadProbeReturn
+first_buffer_probe (GstPad * pad, GstPadProbeInfo * info,
+    FirstBufferData * data)
+{
+  GstClockTime elapsed = gst_util_get_timestamp () - data->start;
+
+  GST_DEBUG_OBJECT (pad, "First buffer %" GST_TIME_FORMAT
+      " after decoder setup started", GST_TIME_ARGS (elapsed));
+
+  GST_OBJECT_LOCK (data->dbin);
+  data->dbin->last_first_buffer_time = elapsed;
+  GST_OBJECT_UNLOCK (data->dbin);
+
+  return GST_PAD_PROBE_REMOVE;
+}
+
 static void
 reconfigure_output_stream (DecodebinOutputStream * output,
     MultiQueueSlot * slot)
 {
   GstDecodebin3 *dbin = output->dbin;
   GstCaps *new_caps = (GstCaps *) gst_stream_get_caps (slot->active_stream);
+  GstClockTime start = gst_util_get_timestamp ();
   gboolean needs_decoder;
 
   needs_decoder = gst_caps_can_intersect (new_caps, dbin->caps) != TRUE;
@@ -2259,10 +2532,7 @@ reconfigure_output_stream (DecodebinOutputStream * output,
       goto cleanup;
     }
 
-    gst_element_set_locked_state (output->decoder, TRUE);
-    gst_element_set_state (output->decoder, GST_STATE_NULL);
-
-    gst_bin_remove ((GstBin *) dbin, output->decoder);
+    release_decoder (dbin, output->decoder, NULL);
     output->decoder = NULL;
     output->decoder_latency = GST_CLOCK_TIME_NONE;
   } else if (output->linked) {
@@ -2282,13 +2552,24 @@ reconfigure_output_stream (DecodebinOutputStream * output,
   /* If a decoder is required, create one */
   if (needs_decoder) {
     GList *factories, *next_factory;
+    GstElement *pooled;
 
     factories = next_factory = create_decoder_factory_list (dbin, new_caps);
+    pooled = acquire_pooled_decoder (dbin, new_caps, factories);
     while (!output->decoder) {
       gboolean decoder_failed = FALSE;
-
-      /* If we don't have a decoder yet, instantiate one */
-      if (next_factory) {
+      gboolean from_pool = FALSE;
+
+      /* If we don't have a decoder yet, reuse the pooled one or
+       * instantiate one */
+      if (pooled) {
+        output->decoder = pooled;
+        pooled = NULL;
+        from_pool = TRUE;
+        gst_element_set_locked_state (output->decoder, FALSE);
+        GST_DEBUG ("Reusing pooled decoder '%s'",
+            GST_ELEMENT_NAME (output->decoder));
+      } else if (next_factory) {
         output->decoder = gst_element_factory_create ((GstElementFactory *)
             next_factory->data, NULL);
         GST_DEBUG ("Created decoder '%s'", GST_ELEMENT_NAME (output->decoder));
@@ -2311,8 +2592,16 @@ reconfigure_output_stream (DecodebinOutputStream * output,
       }
       if (!gst_bin_add ((GstBin *) dbin, output->decoder)) {
         GST_ERROR_OBJECT (dbin, "could not add decoder to pipeline");
+        if (from_pool) {
+          gst_element_set_state (output->decoder, GST_STATE_NULL);
+          gst_object_unref (output->decoder);
+          output->decoder = NULL;
+        }
         goto cleanup;
       }
+      /* The bin holds the reference the pool had */
+      if (from_pool)
+        gst_object_unref (output->decoder);
       output->decoder_sink =
           gst_element_get_static_pad (output->decoder, "sink");
       output->decoder_src = gst_element_get_static_pad (output->decoder, "src");
@@ -2354,7 +2643,9 @@ reconfigure_output_stream (DecodebinOutputStream * output,
         gst_bin_remove ((GstBin *) dbin, output->decoder);
         output->decoder = NULL;
       }
-      next_factory = next_factory->next;
+      /* The factory list is only walked once the pooled decoder was tried */
+      if (!from_pool)
+        next_factory = next_factory->next;
     }
     gst_plugin_feature_list_free (factories);
   } else {
@@ -2388,9 +2679,22 @@ reconfigure_output_stream (DecodebinOutputStream * output,
     gst_element_add_pad (GST_ELEMENT_CAST (dbin), output->src_pad);
   }
 
-  if (output->decoder)
+  if (output->decoder) {
+    FirstBufferData *data;
+
     gst_element_sync_state_with_parent (output->decoder);
 
+    GST_OBJECT_LOCK (dbin);
+    dbin->last_decoder_setup_time = gst_util_get_timestamp () - start;
+    GST_OBJECT_UNLOCK (dbin);
+
+    data = g_new (FirstBufferData, 1);
+    data->dbin = dbin;
+    data->start = start;
+    gst_pad_add_probe (output->src_pad, GST_PAD_PROBE_TYPE_BUFFER,
+        (GstPadProbeCallback) first_buffer_probe, data, g_free);
+  }
+
   output->slot = slot;
   return;
 
@@ -2978,7 +3282,11 @@ create_output_stream (GstDecodebin3 * dbin, GstStreamType type)
 static void
 free_output_stream (GstDecodebin3 * dbin, DecodebinOutputStream * output)
 {
+  GstCaps *caps = NULL;
+
   if (output->slot) {
+    if (output->slot->active_stream)
+      caps = gst_stream_get_caps (output->slot->active_stream);
     if (output->decoder_sink && output->decoder)
       gst_pad_unlink (output->slot->src_pad, output->decoder_sink);
 
@@ -2991,11 +3299,10 @@ free_output_stream (GstDecodebin3 * dbin, DecodebinOutputStream * output)
   if (output->src_exposed) {
     gst_element_remove_pad ((GstElement *) dbin, output->src_pad);
   }
-  if (output->decoder) {
-    gst_element_set_locked_state (output->decoder, TRUE);
-    gst_element_set_state (output->decoder, GST_STATE_NULL);
-    gst_bin_remove ((GstBin *) dbin, output->decoder);
-  }
+  if (output->decoder)
+    release_decoder (dbin, output->decoder, caps);
+  if (caps)
+    gst_caps_unref (caps);
   g_free (output);
 }
 
@@ -3043,6 +3350,9 @@ gst_decodebin3_change_state (GstElement * element, GstStateChange transition)
       dbin->current_mq_min_interleave = dbin->default_mq_min_interleave;
     }
       break;
+    case GST_STATE_CHANGE_READY_TO_NULL:
+      clear_decoder_pool (dbin);
+      break;
     default:
       break;
   }
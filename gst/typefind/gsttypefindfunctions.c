@@ -44,6 +44,7 @@
 #include <gst/base/gstbytereader.h>
 
 #include "gsttypefindfunctionsplugin.h"
+#include "gsttypefindfunctionsdata.h"
 
 /* DataScanCtx: helper for typefind functions that scan through data
  * step-by-step, to avoid doing a peek at each and every offset */
@@ -168,6 +169,9 @@ utf8_type_find (GstTypeFind * tf, gpointer unused)
   GstTypeFindProbability start_prob, mid_prob;
   guint64 length;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   /* leave xml to the xml typefinders */
   if (xml_check_first_element (tf, "", 0, TRUE))
     return;
@@ -1182,6 +1186,9 @@ aac_type_find (GstTypeFind * tf, gpointer unused)
   GstCaps *best_caps = NULL;
   gint best_count = 0;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   while (c.offset < AAC_AMOUNT) {
     guint snc, len, offset, i;
 
@@ -1645,6 +1652,9 @@ mp3_type_find (GstTypeFind * tf, gpointer unused)
   guint layer, mid_layer;
   guint64 length;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   mp3_type_find_at_offset (tf, 0, &layer, &prob);
   length = gst_type_find_get_length (tf);
 
@@ -1796,6 +1806,9 @@ ac3_type_find (GstTypeFind * tf, gpointer unused)
 {
   DataScanCtx c = { 0, NULL, 0 };
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   /* Search for an ac3 frame; not necessarily right at the start, but give it
    * a lower probability if not found right at the start. Check that the
    * frame is followed by a second frame at the expected offset.
@@ -1963,6 +1976,9 @@ dts_type_find (GstTypeFind * tf, gpointer unused)
 {
   DataScanCtx c = { 0, NULL, 0 };
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   /* Search for an dts frame; not necessarily right at the start, but give it
    * a lower probability if not found right at the start. Check that the
    * frame is followed by a second frame at the expected offset. */
@@ -2362,6 +2378,9 @@ mpeg_sys_type_find (GstTypeFind * tf, gpointer unused)
   guint32 sync_word = 0xffffffff;
   guint potential_headers = 0;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   G_STMT_START {
     gint len;
 
@@ -2544,6 +2563,9 @@ mpeg_ts_type_find (GstTypeFind * tf, gpointer unused)
   guint size = 0;
   guint64 skipped = 0;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   while (skipped < GST_MPEGTS_TYPEFIND_SCAN_LENGTH) {
     if (size < MPEGTS_HDR_SIZE) {
       data = gst_type_find_peek (tf, skipped, GST_MPEGTS_TYPEFIND_SYNC_SIZE);
@@ -2633,6 +2655,9 @@ mpeg4_video_type_find (GstTypeFind * tf, gpointer unused)
   guint num_vop_headers = 0;
   guint8 sc;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   while (c.offset < GST_MPEGVID_TYPEFIND_TRY_SYNC) {
     if (num_vop_headers >= GST_MPEGVID_TYPEFIND_TRY_PICTURES)
       break;
@@ -2754,6 +2779,9 @@ h263_video_type_find (GstTypeFind * tf, gpointer unused)
   guint bad = 0;
   guint pc_type, pb_mode;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   while (c.offset < H263_MAX_PROBE_LENGTH) {
     if (G_UNLIKELY (!data_scan_ctx_ensure_data (tf, &c, 4)))
       break;
@@ -2819,6 +2847,9 @@ h264_video_type_find (GstTypeFind * tf, gpointer unused)
   int good = 0;
   int bad = 0;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   while (c.offset < H264_MAX_PROBE_LENGTH) {
     if (G_UNLIKELY (!data_scan_ctx_ensure_data (tf, &c, 4)))
       break;
@@ -2916,6 +2947,9 @@ h265_video_type_find (GstTypeFind * tf, gpointer unused)
   int good = 0;
   int bad = 0;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   while (c.offset < H265_MAX_PROBE_LENGTH) {
     if (G_UNLIKELY (!data_scan_ctx_ensure_data (tf, &c, 5)))
       break;
@@ -3010,6 +3044,9 @@ mpeg_video_stream_type_find (GstTypeFind * tf, gpointer unused)
   gint num_pic_headers = 0;
   gint found = 0;
 
+  if (sw_data_index_has_match (tf))
+    return;
+
   while (c.offset < GST_MPEGVID_TYPEFIND_TRY_SYNC) {
     if (found >= GST_MPEGVID_TYPEFIND_TRY_PICTURES)
       break;
@@ -28,11 +28,125 @@
 #endif
 
 #include <gst/gst.h>
+#include <string.h>
+
+#include "gsttypefindfunctionsplugin.h"
 #include "gsttypefindfunctionsdata.h"
 
+/* Signatures of the start-with and RIFF typefinders that suggest the
+ * maximum probability, by first byte. Scanning typefinders check this first
+ * to avoid going through data that is already known to be something else. */
+typedef struct
+{
+  GstTypeFindData *sw_data;
+  gboolean riff;
+} IndexEntry;
+
+#define RIFF_SIGNATURE_SIZE 12
+
+G_LOCK_DEFINE_STATIC (index_lock);
+static GSList *sw_data_index[256];
+static guint sw_data_index_max_size;
+
+static void
+sw_data_index_insert (guint8 first, GstTypeFindData * sw_data, gboolean riff)
+{
+  IndexEntry *entry = g_slice_new (IndexEntry);
+
+  entry->sw_data = sw_data;
+  entry->riff = riff;
+  sw_data_index[first] = g_slist_prepend (sw_data_index[first], entry);
+}
+
+void
+sw_data_index_add (GstTypeFindData * sw_data, gboolean riff)
+{
+  if (sw_data->probability < GST_TYPE_FIND_MAXIMUM)
+    return;
+
+  G_LOCK (index_lock);
+  if (riff) {
+    sw_data_index_insert ('R', sw_data, TRUE);
+    sw_data_index_insert ('A', sw_data, TRUE);
+    sw_data_index_max_size =
+        MAX (sw_data_index_max_size, RIFF_SIGNATURE_SIZE);
+  } else if (sw_data->size > 0) {
+    sw_data_index_insert (sw_data->data[0], sw_data, FALSE);
+    sw_data_index_max_size = MAX (sw_data_index_max_size, sw_data->size);
+  }
+  G_UNLOCK (index_lock);
+}
+
+static void
+sw_data_index_remove (GstTypeFindData * sw_data)
+{
+  guint i;
+
+  G_LOCK (index_lock);
+  for (i = 0; i < G_N_ELEMENTS (sw_data_index); i++) {
+    GSList *l = sw_data_index[i];
+
+    while (l) {
+      IndexEntry *entry = l->data;
+      GSList *next = l->next;
+
+      if (entry->sw_data == sw_data) {
+        sw_data_index[i] = g_slist_delete_link (sw_data_index[i], l);
+        g_slice_free (IndexEntry, entry);
+      }
+      l = next;
+    }
+  }
+  G_UNLOCK (index_lock);
+}
+
+static gboolean
+sw_data_index_entry_matches (IndexEntry * entry, const guint8 * data,
+    guint size)
+{
+  if (entry->riff) {
+    return size >= RIFF_SIGNATURE_SIZE && (memcmp (data, "RIFF", 4) == 0
+        || memcmp (data, "AVF0", 4) == 0)
+        && memcmp (data + 8, entry->sw_data->data, 4) == 0;
+  }
+
+  return size >= entry->sw_data->size
+      && memcmp (data, entry->sw_data->data, entry->sw_data->size) == 0;
+}
+
+/* Returns TRUE if the stream starts with the data of a start-with or RIFF
+ * typefinder that suggests the maximum probability. */
+gboolean
+sw_data_index_has_match (GstTypeFind * tf)
+{
+  const guint8 *data = NULL;
+  gboolean res = FALSE;
+  guint size;
+  GSList *l;
+
+  /* peek as much as the longest signature, or less for short streams */
+  size = g_atomic_int_get (&sw_data_index_max_size);
+  while (size > 0 && !(data = gst_type_find_peek (tf, 0, size)))
+    size /= 2;
+  if (!data)
+    return FALSE;
+
+  G_LOCK (index_lock);
+  for (l = sw_data_index[data[0]]; l && !res; l = l->next)
+    res = sw_data_index_entry_matches (l->data, data, size);
+  G_UNLOCK (index_lock);
+
+  if (res)
+    GST_LOG ("stream starts with a known signature");
+
+  return res;
+}
+
 void
 sw_data_destroy (GstTypeFindData * sw_data)
 {
+  sw_data_index_remove (sw_data);
+
   if (G_LIKELY (sw_data->caps != NULL))
     gst_caps_unref (sw_data->caps);
   g_slice_free (GstTypeFindData, sw_data);
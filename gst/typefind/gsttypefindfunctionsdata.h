@@ -41,4 +41,9 @@ GstTypeFindData;
 
 void sw_data_destroy (GstTypeFindData * sw_data);
 
+/*** index of the data at the start of streams ***/
+void sw_data_index_add (GstTypeFindData * sw_data, gboolean riff);
+
+gboolean sw_data_index_has_match (GstTypeFind * tf);
+
 #endif //__GST_TYPE_FIND_FUNCTIONS_DATA_H__
@@ -64,6 +64,7 @@ G_PASTE(_private_type_find_start_with_, typefind_name) (GstPlugin * plugin) \
     sw_data_destroy (sw_data);                                          \
     return FALSE; \
   } \
+  sw_data_index_add (sw_data, FALSE); \
   return TRUE; \
 }\
 GST_TYPE_FIND_REGISTER_DEFINE_CUSTOM (typefind_name, G_PASTE(_private_type_find_start_with_, typefind_name)); \
@@ -34,6 +34,16 @@
  * window. If the video sink selected does not support YUY2 videoconvert will
  * automatically convert the video to a format understood by the video sink.
  *
+ * When #GstVideoConvert:max-inflight-frames is bigger than 1, the conversion
+ * of a frame is started before the previous frames are complete, so that the
+ * threads that are done with their part of one frame can start on the next
+ * one. This adds up to #GstVideoConvert:max-inflight-frames - 1 frames of
+ * latency.
+ *
+ * When converting, upstream can attach a #GstVideoCropMeta to the buffers
+ * instead of cropping them. Only the cropped region of the input frames is
+ * read then.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -69,6 +79,8 @@ GST_ELEMENT_REGISTER_DEFINE (videoconvert, "videoconvert",
 #define DEFAULT_PROP_GAMMA_MODE GST_VIDEO_GAMMA_MODE_NONE
 #define DEFAULT_PROP_PRIMARIES_MODE GST_VIDEO_PRIMARIES_MODE_NONE
 #define DEFAULT_PROP_N_THREADS 1
+#define DEFAULT_PROP_MAX_INFLIGHT_FRAMES 1
+#define DEFAULT_PROP_TONE_MAP_METHOD GST_VIDEO_TONE_MAP_METHOD_NONE
 
 enum
 {
@@ -82,9 +94,21 @@ enum
   PROP_MATRIX_MODE,
   PROP_GAMMA_MODE,
   PROP_PRIMARIES_MODE,
-  PROP_N_THREADS
+  PROP_N_THREADS,
+  PROP_MAX_INFLIGHT_FRAMES,
+  PROP_TONE_MAP_METHOD
 };
 
+/* a frame whose conversion was started but not waited for yet */
+typedef struct
+{
+  GstVideoConverter *convert;
+  GstBuffer *inbuf;
+  GstBuffer *outbuf;
+  GstVideoFrame in_frame;
+  GstVideoFrame out_frame;
+} GstVideoConvertFrame;
+
 #define CSP_VIDEO_CAPS GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL) ";" \
     GST_VIDEO_CAPS_MAKE_WITH_FEATURES ("ANY", GST_VIDEO_FORMATS_ALL)
 
@@ -112,6 +136,22 @@ static gboolean gst_video_convert_set_info (GstVideoFilter * filter,
     GstVideoInfo * out_info);
 static GstFlowReturn gst_video_convert_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame);
+static void gst_video_convert_flush_inflight (GstVideoConvert * space);
+static GstFlowReturn gst_video_convert_drain_inflight (GstVideoConvert * space);
+static GstFlowReturn gst_video_convert_generate_output (GstBaseTransform *
+    trans, GstBuffer ** outbuf);
+static gboolean gst_video_convert_sink_event (GstBaseTransform * trans,
+    GstEvent * event);
+static gboolean gst_video_convert_src_event (GstBaseTransform * trans,
+    GstEvent * event);
+static gboolean gst_video_convert_start (GstBaseTransform * trans);
+static gboolean gst_video_convert_stop (GstBaseTransform * trans);
+static gboolean gst_video_convert_query (GstBaseTransform * trans,
+    GstPadDirection direction, GstQuery * query);
+static gboolean gst_video_convert_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query);
+static gboolean gst_video_convert_decide_allocation (GstBaseTransform * trans,
+    GstQuery * query);
 
 static GstCapsFeatures *features_format_interlaced,
     *features_format_interlaced_sysmem;
@@ -528,6 +568,9 @@ gst_video_convert_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
     /* don't copy colorspace specific metadata, FIXME, we need a MetaTransform
      * for the colorspace metadata. */
     ret = FALSE;
+  } else if (info->api == GST_VIDEO_CROP_META_API_TYPE) {
+    /* the crop was applied while converting */
+    ret = FALSE;
   } else {
     /* copy other metadata */
     ret = TRUE;
@@ -535,6 +578,126 @@ gst_video_convert_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
   return ret;
 }
 
+static void
+gst_video_convert_free_converters (GstVideoConvert * space)
+{
+  guint i;
+
+  gst_video_convert_flush_inflight (space);
+
+  if (space->convert) {
+    gst_video_converter_free (space->convert);
+    space->convert = NULL;
+  }
+
+  for (i = 0; i < space->n_converters; i++) {
+    if (space->converters[i])
+      gst_video_converter_free (space->converters[i]);
+  }
+  g_free (space->converters);
+  space->converters = NULL;
+  space->n_converters = 0;
+  space->next_converter = 0;
+}
+
+/* creates the converters with the current config, reading @crop of the input
+ * frames if not %NULL */
+static gboolean
+gst_video_convert_create_converters (GstVideoConvert * space,
+    const GstVideoInfo * in_info, const GstVideoInfo * out_info,
+    const GstVideoRectangle * crop)
+{
+  GstStructure *config;
+  guint i;
+
+  config = gst_structure_copy (space->config);
+  if (crop) {
+    gst_structure_set (config,
+        GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, crop->x,
+        GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, crop->y,
+        GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT, crop->w,
+        GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, crop->h, NULL);
+    space->crop = *crop;
+  } else {
+    memset (&space->crop, 0, sizeof (space->crop));
+  }
+  space->crop_full_width = GST_VIDEO_INFO_WIDTH (in_info);
+  space->crop_full_height = GST_VIDEO_INFO_HEIGHT (in_info);
+
+  if (space->max_inflight_frames <= 1) {
+    space->convert = gst_video_converter_new (in_info, out_info, config);
+    return space->convert != NULL;
+  }
+
+  space->n_converters = space->max_inflight_frames;
+  space->converters = g_new0 (GstVideoConverter *, space->n_converters);
+  for (i = 0; i < space->n_converters; i++) {
+    space->converters[i] = gst_video_converter_new (in_info, out_info,
+        gst_structure_copy (config));
+    if (space->converters[i] == NULL)
+      break;
+  }
+  gst_structure_free (config);
+
+  return i == space->n_converters;
+}
+
+/* Makes the converters read the region of @frame given by the crop meta of
+ * its buffer. Upstream only adds the meta when we proposed it, the caps then
+ * describe the cropped region and the video meta the full frame. The
+ * converters are only recreated when the region changes. */
+static GstFlowReturn
+gst_video_convert_update_crop (GstVideoConvert * space,
+    const GstVideoFrame * frame)
+{
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (space);
+  GstVideoCropMeta *meta;
+  GstVideoRectangle crop = { 0, };
+  GstFlowReturn ret;
+
+  meta = gst_buffer_get_video_crop_meta (frame->buffer);
+  if (meta == NULL) {
+    if (space->crop.w == 0)
+      return GST_FLOW_OK;
+  } else {
+    crop.x = meta->x;
+    crop.y = meta->y;
+    crop.w = meta->width;
+    crop.h = meta->height;
+
+    if (crop.x == space->crop.x && crop.y == space->crop.y
+        && crop.w == space->crop.w && crop.h == space->crop.h
+        && space->crop_full_width == GST_VIDEO_FRAME_WIDTH (frame)
+        && space->crop_full_height == GST_VIDEO_FRAME_HEIGHT (frame))
+      return GST_FLOW_OK;
+  }
+
+  GST_DEBUG_OBJECT (space, "input crop region changed to %d,%d %dx%d",
+      meta ? crop.x : 0, meta ? crop.y : 0,
+      meta ? crop.w : GST_VIDEO_INFO_WIDTH (&filter->in_info),
+      meta ? crop.h : GST_VIDEO_INFO_HEIGHT (&filter->in_info));
+
+  /* frames in flight were started with the old region */
+  ret = gst_video_convert_drain_inflight (space);
+  gst_video_convert_free_converters (space);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  if (!gst_video_convert_create_converters (space,
+          meta ? &frame->info : &filter->in_info, &filter->out_info,
+          meta ? &crop : NULL)) {
+    gst_video_convert_free_converters (space);
+    /* try again with the next frame */
+    space->crop_full_width = 0;
+    GST_ELEMENT_ERROR (space, CORE, NEGOTIATION, (NULL),
+        ("could not create converter for crop region %d,%d %dx%d", crop.x,
+            crop.y, crop.w, crop.h));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  return GST_FLOW_OK;
+}
+
 static gboolean
 gst_video_convert_set_info (GstVideoFilter * filter,
     GstCaps * incaps, GstVideoInfo * in_info, GstCaps * outcaps,
@@ -544,13 +707,13 @@ gst_video_convert_set_info (GstVideoFilter * filter,
   GstBaseTransformClass *gstbasetransform_class =
       GST_BASE_TRANSFORM_GET_CLASS (filter);
   GstVideoInfo tmp_info;
+  GstStructure *config;
 
   space = GST_VIDEO_CONVERT_CAST (filter);
 
-  if (space->convert) {
-    gst_video_converter_free (space->convert);
-    space->convert = NULL;
-  }
+  /* frames converted with the previous caps go first */
+  gst_video_convert_drain_inflight (space);
+  gst_video_convert_free_converters (space);
 
   /* these must match */
   if (in_info->width != out_info->width || in_info->height != out_info->height
@@ -581,34 +744,65 @@ gst_video_convert_set_info (GstVideoFilter * filter,
   gstbasetransform_class->passthrough_on_same_caps = TRUE;
   gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (filter), FALSE);
 
-  space->convert = gst_video_converter_new (in_info, out_info,
-      gst_structure_new ("GstVideoConvertConfig",
-          GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
-          space->dither,
-          GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, G_TYPE_UINT,
-          space->dither_quantization,
-          GST_VIDEO_CONVERTER_OPT_CHROMA_RESAMPLER_METHOD,
-          GST_TYPE_VIDEO_RESAMPLER_METHOD, space->chroma_resampler,
-          GST_VIDEO_CONVERTER_OPT_ALPHA_MODE,
-          GST_TYPE_VIDEO_ALPHA_MODE, space->alpha_mode,
-          GST_VIDEO_CONVERTER_OPT_ALPHA_VALUE,
-          G_TYPE_DOUBLE, space->alpha_value,
-          GST_VIDEO_CONVERTER_OPT_CHROMA_MODE,
-          GST_TYPE_VIDEO_CHROMA_MODE, space->chroma_mode,
-          GST_VIDEO_CONVERTER_OPT_MATRIX_MODE,
-          GST_TYPE_VIDEO_MATRIX_MODE, space->matrix_mode,
-          GST_VIDEO_CONVERTER_OPT_GAMMA_MODE,
-          GST_TYPE_VIDEO_GAMMA_MODE, space->gamma_mode,
-          GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE,
-          GST_TYPE_VIDEO_PRIMARIES_MODE, space->primaries_mode,
-          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT,
-          space->n_threads, NULL));
-  if (space->convert == NULL)
+  config = gst_structure_new ("GstVideoConvertConfig",
+      GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+      space->dither,
+      GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, G_TYPE_UINT,
+      space->dither_quantization,
+      GST_VIDEO_CONVERTER_OPT_CHROMA_RESAMPLER_METHOD,
+      GST_TYPE_VIDEO_RESAMPLER_METHOD, space->chroma_resampler,
+      GST_VIDEO_CONVERTER_OPT_ALPHA_MODE,
+      GST_TYPE_VIDEO_ALPHA_MODE, space->alpha_mode,
+      GST_VIDEO_CONVERTER_OPT_ALPHA_VALUE,
+      G_TYPE_DOUBLE, space->alpha_value,
+      GST_VIDEO_CONVERTER_OPT_CHROMA_MODE,
+      GST_TYPE_VIDEO_CHROMA_MODE, space->chroma_mode,
+      GST_VIDEO_CONVERTER_OPT_MATRIX_MODE,
+      GST_TYPE_VIDEO_MATRIX_MODE, space->matrix_mode,
+      GST_VIDEO_CONVERTER_OPT_GAMMA_MODE,
+      GST_TYPE_VIDEO_GAMMA_MODE, space->gamma_mode,
+      GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE,
+      GST_TYPE_VIDEO_PRIMARIES_MODE, space->primaries_mode,
+      GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT,
+      space->n_threads, NULL);
+
+  if (space->tone_map_method != GST_VIDEO_TONE_MAP_METHOD_NONE) {
+    GstVideoContentLightLevel cll;
+    GstVideoMasteringDisplayInfo minfo;
+    gdouble peak = 0.0;
+
+    /* the brightest pixel, or else what the mastering display could show */
+    if (gst_video_content_light_level_from_caps (&cll, incaps)
+        && cll.max_content_light_level > 0)
+      peak = cll.max_content_light_level;
+    else if (gst_video_mastering_display_info_from_caps (&minfo, incaps)
+        && minfo.max_display_mastering_luminance > 0)
+      peak = minfo.max_display_mastering_luminance / 10000.0;
+
+    gst_structure_set (config,
+        GST_VIDEO_CONVERTER_OPT_TONE_MAP_METHOD,
+        GST_TYPE_VIDEO_TONE_MAP_METHOD, space->tone_map_method,
+        GST_VIDEO_CONVERTER_OPT_TONE_MAP_SOURCE_PEAK, G_TYPE_DOUBLE, peak,
+        NULL);
+  }
+
+  /* one async converter per frame in flight, they all share the same
+   * task pool */
+  if (space->max_inflight_frames > 1)
+    gst_structure_set (config, GST_VIDEO_CONVERTER_OPT_ASYNC_TASKS,
+        G_TYPE_BOOLEAN, TRUE, NULL);
+
+  if (space->config)
+    gst_structure_free (space->config);
+  space->config = config;
+
+  if (!gst_video_convert_create_converters (space, in_info, out_info, NULL))
     goto no_convert;
 
-  GST_DEBUG_OBJECT (filter, "converting format %s -> %s",
+  GST_DEBUG_OBJECT (filter, "converting format %s -> %s, %u frames in flight",
       gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (in_info)),
-      gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (out_info)));
+      gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (out_info)),
+      MAX (space->n_converters, 1));
 
   return TRUE;
 
@@ -621,6 +815,7 @@ format_mismatch:
 no_convert:
   {
     GST_ERROR_OBJECT (space, "could not create converter");
+    gst_video_convert_free_converters (space);
     return FALSE;
   }
 }
@@ -630,9 +825,9 @@ gst_video_convert_finalize (GObject * obj)
 {
   GstVideoConvert *space = GST_VIDEO_CONVERT (obj);
 
-  if (space->convert) {
-    gst_video_converter_free (space->convert);
-  }
+  gst_video_convert_free_converters (space);
+  if (space->config)
+    gst_structure_free (space->config);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -668,6 +863,19 @@ gst_video_convert_class_init (GstVideoConvertClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_convert_filter_meta);
   gstbasetransform_class->transform_meta =
       GST_DEBUG_FUNCPTR (gst_video_convert_transform_meta);
+  gstbasetransform_class->generate_output =
+      GST_DEBUG_FUNCPTR (gst_video_convert_generate_output);
+  gstbasetransform_class->sink_event =
+      GST_DEBUG_FUNCPTR (gst_video_convert_sink_event);
+  gstbasetransform_class->src_event =
+      GST_DEBUG_FUNCPTR (gst_video_convert_src_event);
+  gstbasetransform_class->start = GST_DEBUG_FUNCPTR (gst_video_convert_start);
+  gstbasetransform_class->stop = GST_DEBUG_FUNCPTR (gst_video_convert_stop);
+  gstbasetransform_class->query = GST_DEBUG_FUNCPTR (gst_video_convert_query);
+  gstbasetransform_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_convert_propose_allocation);
+  gstbasetransform_class->decide_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_convert_decide_allocation);
 
   gstbasetransform_class->passthrough_on_same_caps = TRUE;
 
@@ -719,6 +927,40 @@ gst_video_convert_class_init (GstVideoConvertClass * klass)
       g_param_spec_uint ("n-threads", "Threads",
           "Maximum number of threads to use", 0, G_MAXUINT,
           DEFAULT_PROP_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstVideoConvert:max-inflight-frames:
+   *
+   * Maximum number of frames that are converted at the same time. With more
+   * than one frame in flight, the conversion of a frame starts while the
+   * previous ones are still converted, which keeps more threads busy but adds
+   * up to this many frames minus one of latency. The change is applied on
+   * the next caps change.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_INFLIGHT_FRAMES,
+      g_param_spec_uint ("max-inflight-frames", "Max In-flight Frames",
+          "Maximum number of frames converted at the same time", 1, 16,
+          DEFAULT_PROP_MAX_INFLIGHT_FRAMES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstVideoConvert:tone-map-method:
+   *
+   * Method used to tone map PQ or HLG input to an SDR transfer function.
+   * The peak luminance of the input is taken from the content light level
+   * or the mastering display info of the input caps.
+   *
+   * Conversions that tone map can't use any of the optimized fast paths
+   * and are done with the generic, slower, conversion path. Other
+   * conversions are not affected by this property.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_TONE_MAP_METHOD,
+      g_param_spec_enum ("tone-map-method", "Tone Map Method",
+          "Method for tone mapping HDR input to SDR output",
+          gst_video_tone_map_method_get_type (), DEFAULT_PROP_TONE_MAP_METHOD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -734,6 +976,11 @@ gst_video_convert_init (GstVideoConvert * space)
   space->gamma_mode = DEFAULT_PROP_GAMMA_MODE;
   space->primaries_mode = DEFAULT_PROP_PRIMARIES_MODE;
   space->n_threads = DEFAULT_PROP_N_THREADS;
+  space->max_inflight_frames = DEFAULT_PROP_MAX_INFLIGHT_FRAMES;
+  space->tone_map_method = DEFAULT_PROP_TONE_MAP_METHOD;
+  g_queue_init (&space->inflight);
+  space->drain_ret = GST_FLOW_OK;
+  space->earliest_time = GST_CLOCK_TIME_NONE;
 }
 
 void
@@ -775,6 +1022,12 @@ gst_video_convert_set_property (GObject * object, guint property_id,
     case PROP_N_THREADS:
       csp->n_threads = g_value_get_uint (value);
       break;
+    case PROP_MAX_INFLIGHT_FRAMES:
+      csp->max_inflight_frames = g_value_get_uint (value);
+      break;
+    case PROP_TONE_MAP_METHOD:
+      csp->tone_map_method = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -820,6 +1073,12 @@ gst_video_convert_get_property (GObject * object, guint property_id,
     case PROP_N_THREADS:
       g_value_set_uint (value, csp->n_threads);
       break;
+    case PROP_MAX_INFLIGHT_FRAMES:
+      g_value_set_uint (value, csp->max_inflight_frames);
+      break;
+    case PROP_TONE_MAP_METHOD:
+      g_value_set_enum (value, csp->tone_map_method);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -831,9 +1090,14 @@ gst_video_convert_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
 {
   GstVideoConvert *space;
+  GstFlowReturn ret;
 
   space = GST_VIDEO_CONVERT_CAST (filter);
 
+  ret = gst_video_convert_update_crop (space, in_frame);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
   GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter,
       "doing colorspace conversion from %s -> to %s",
       GST_VIDEO_INFO_NAME (&filter->in_info),
@@ -844,6 +1108,402 @@ gst_video_convert_transform_frame (GstVideoFilter * filter,
   return GST_FLOW_OK;
 }
 
+/* waits for the conversion of @frame to complete, frees @frame and returns
+ * its output buffer */
+static GstBuffer *
+gst_video_convert_frame_complete (GstVideoConvertFrame * frame)
+{
+  GstBuffer *outbuf = frame->outbuf;
+
+  gst_video_converter_frame_finish (frame->convert);
+
+  gst_video_frame_unmap (&frame->out_frame);
+  gst_video_frame_unmap (&frame->in_frame);
+  gst_buffer_unref (frame->inbuf);
+  g_slice_free (GstVideoConvertFrame, frame);
+
+  return outbuf;
+}
+
+static void
+gst_video_convert_flush_inflight (GstVideoConvert * space)
+{
+  GstVideoConvertFrame *frame;
+
+  while ((frame = g_queue_pop_head (&space->inflight)))
+    gst_buffer_unref (gst_video_convert_frame_complete (frame));
+}
+
+/* GstBaseTransform only drops late buffers before they are converted. A
+ * frame in flight is output a few frames later, so check again against the
+ * QoS info received meanwhile. Returns @outbuf, or %NULL if it was dropped */
+static GstBuffer *
+gst_video_convert_qos_check (GstVideoConvert * space, GstBuffer * outbuf)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (space);
+  GstClockTime running_time, stream_time, timestamp, earliest_time;
+  gdouble proportion;
+  GstMessage *qos_msg;
+
+  timestamp = GST_BUFFER_PTS (outbuf);
+  if (!gst_base_transform_is_qos_enabled (trans)
+      || trans->segment.format != GST_FORMAT_TIME
+      || !GST_CLOCK_TIME_IS_VALID (timestamp))
+    goto output;
+
+  running_time = gst_segment_to_running_time (&trans->segment,
+      GST_FORMAT_TIME, timestamp);
+
+  GST_OBJECT_LOCK (space);
+  earliest_time = space->earliest_time;
+  proportion = space->proportion;
+  GST_OBJECT_UNLOCK (space);
+
+  if (!GST_CLOCK_TIME_IS_VALID (running_time)
+      || !GST_CLOCK_TIME_IS_VALID (earliest_time)
+      || running_time > earliest_time)
+    goto output;
+
+  GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, space, "skipping late frame %"
+      GST_TIME_FORMAT " <= %" GST_TIME_FORMAT, GST_TIME_ARGS (running_time),
+      GST_TIME_ARGS (earliest_time));
+
+  stream_time = gst_segment_to_stream_time (&trans->segment, GST_FORMAT_TIME,
+      timestamp);
+  qos_msg = gst_message_new_qos (GST_OBJECT_CAST (space), FALSE,
+      running_time, stream_time, timestamp, GST_BUFFER_DURATION (outbuf));
+  gst_message_set_qos_values (qos_msg, earliest_time - running_time,
+      proportion, 1000000);
+  gst_element_post_message (GST_ELEMENT_CAST (space), qos_msg);
+
+  /* the next frame that makes it is a discont */
+  space->discont = TRUE;
+  gst_buffer_unref (outbuf);
+
+  return NULL;
+
+output:
+  if (space->discont) {
+    GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
+    space->discont = FALSE;
+  }
+
+  return outbuf;
+}
+
+/* pushes all frames in flight downstream. A failed push is also remembered
+ * to be returned upstream with the next buffer, for the callers that can't
+ * return it themselves */
+static GstFlowReturn
+gst_video_convert_drain_inflight (GstVideoConvert * space)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstVideoConvertFrame *frame;
+
+  if (!g_queue_is_empty (&space->inflight))
+    GST_DEBUG_OBJECT (space, "draining %u frames",
+        g_queue_get_length (&space->inflight));
+
+  while ((frame = g_queue_pop_head (&space->inflight))) {
+    GstBuffer *outbuf = gst_video_convert_frame_complete (frame);
+
+    if (ret == GST_FLOW_OK) {
+      outbuf = gst_video_convert_qos_check (space, outbuf);
+      if (outbuf)
+        ret = gst_pad_push (GST_BASE_TRANSFORM_SRC_PAD (space), outbuf);
+    } else {
+      gst_buffer_unref (outbuf);
+    }
+  }
+
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (space, "draining failed: %s", gst_flow_get_name (ret));
+    space->drain_ret = ret;
+  }
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_video_convert_generate_output (GstBaseTransform * trans,
+    GstBuffer ** outbuf)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (trans);
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (trans);
+  GstVideoConvertFrame *frame;
+  GstBuffer *inbuf, *buf = NULL;
+  GstFlowReturn ret;
+
+  /* With a single frame in flight (no converters array) the default
+   * implementation converts synchronously through transform_frame */
+  if (space->n_converters == 0 || gst_base_transform_is_passthrough (trans))
+    return GST_BASE_TRANSFORM_CLASS (parent_class)->generate_output (trans,
+        outbuf);
+
+  /* As in the default implementation, the QoS dropping of late input and
+   * before_transform were done by submit_input_buffer, and
+   * prepare_output_buffer copies the metadata and flags, GAP included. */
+  *outbuf = NULL;
+  inbuf = trans->queued_buf;
+  trans->queued_buf = NULL;
+
+  /* nothing queued, the output of the frames in flight is pushed once their
+   * converter is needed again or when draining */
+  if (inbuf == NULL)
+    return GST_FLOW_OK;
+
+  /* a push of frames in flight failed outside of the streaming thread's
+   * chain function, return it now */
+  if (space->drain_ret != GST_FLOW_OK) {
+    ret = space->drain_ret;
+    space->drain_ret = GST_FLOW_OK;
+    gst_buffer_unref (inbuf);
+    return ret;
+  }
+
+  if (G_UNLIKELY (!filter->negotiated)) {
+    GST_ELEMENT_ERROR (space, CORE, NOT_IMPLEMENTED, (NULL),
+        ("unknown format"));
+    gst_buffer_unref (inbuf);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  ret = GST_BASE_TRANSFORM_GET_CLASS (trans)->prepare_output_buffer (trans,
+      inbuf, &buf);
+  if (ret != GST_FLOW_OK || buf == NULL) {
+    gst_buffer_unref (inbuf);
+    return ret;
+  }
+
+  frame = g_slice_new0 (GstVideoConvertFrame);
+  if (!gst_video_frame_map (&frame->in_frame, &filter->in_info, inbuf,
+          GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_NO_REF))
+    goto invalid_buffer;
+
+  if (!gst_video_frame_map (&frame->out_frame, &filter->out_info, buf,
+          GST_MAP_WRITE | GST_VIDEO_FRAME_MAP_FLAG_NO_REF)) {
+    gst_video_frame_unmap (&frame->in_frame);
+    goto invalid_buffer;
+  }
+
+  ret = gst_video_convert_update_crop (space, &frame->in_frame);
+  if (ret != GST_FLOW_OK) {
+    /* returned right away */
+    space->drain_ret = GST_FLOW_OK;
+    gst_video_frame_unmap (&frame->out_frame);
+    gst_video_frame_unmap (&frame->in_frame);
+    g_slice_free (GstVideoConvertFrame, frame);
+    gst_buffer_unref (inbuf);
+    gst_buffer_unref (buf);
+    return ret;
+  }
+
+  frame->inbuf = inbuf;
+  frame->outbuf = buf;
+  frame->convert = space->converters[space->next_converter];
+  space->next_converter = (space->next_converter + 1) % space->n_converters;
+
+  GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter,
+      "starting colorspace conversion from %s -> to %s, %u frames in flight",
+      GST_VIDEO_INFO_NAME (&filter->in_info),
+      GST_VIDEO_INFO_NAME (&filter->out_info),
+      g_queue_get_length (&space->inflight));
+
+  gst_video_converter_frame (frame->convert, &frame->in_frame,
+      &frame->out_frame);
+  g_queue_push_tail (&space->inflight, frame);
+
+  /* the converter of the oldest frame is needed for the next one */
+  if (g_queue_get_length (&space->inflight) >= space->n_converters)
+    *outbuf = gst_video_convert_qos_check (space,
+        gst_video_convert_frame_complete (g_queue_pop_head
+            (&space->inflight)));
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+invalid_buffer:
+  {
+    GST_ELEMENT_WARNING (space, CORE, NOT_IMPLEMENTED, (NULL),
+        ("invalid video buffer received"));
+    g_slice_free (GstVideoConvertFrame, frame);
+    gst_buffer_unref (inbuf);
+    gst_buffer_unref (buf);
+    return GST_FLOW_OK;
+  }
+}
+
+static void
+gst_video_convert_reset_qos (GstVideoConvert * space)
+{
+  GST_OBJECT_LOCK (space);
+  space->earliest_time = GST_CLOCK_TIME_NONE;
+  space->proportion = 1.0;
+  GST_OBJECT_UNLOCK (space);
+  space->discont = FALSE;
+}
+
+static gboolean
+gst_video_convert_sink_event (GstBaseTransform * trans, GstEvent * event)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (trans);
+  GstFlowReturn ret;
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP) {
+    gst_video_convert_flush_inflight (space);
+    gst_video_convert_reset_qos (space);
+    space->drain_ret = GST_FLOW_OK;
+  } else if (GST_EVENT_IS_SERIALIZED (event)) {
+    /* keep the order between buffers and serialized events */
+    ret = gst_video_convert_drain_inflight (space);
+
+    /* nothing upstream will see the flow return after EOS */
+    if (GST_EVENT_TYPE (event) == GST_EVENT_EOS
+        && (ret == GST_FLOW_NOT_LINKED || ret < GST_FLOW_EOS))
+      GST_ELEMENT_FLOW_ERROR (space, ret);
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (trans, event);
+}
+
+static gboolean
+gst_video_convert_src_event (GstBaseTransform * trans, GstEvent * event)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (trans);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_QOS) {
+    GstClockTimeDiff diff;
+    GstClockTime timestamp;
+    gdouble proportion;
+
+    gst_event_parse_qos (event, NULL, &proportion, &diff, &timestamp);
+
+    GST_OBJECT_LOCK (space);
+    space->proportion = proportion;
+    if (diff < 0 && timestamp < -diff)
+      space->earliest_time = 0;
+    else
+      space->earliest_time = timestamp + diff;
+    GST_OBJECT_UNLOCK (space);
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->src_event (trans, event);
+}
+
+static gboolean
+gst_video_convert_start (GstBaseTransform * trans)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (trans);
+
+  gst_video_convert_reset_qos (space);
+  space->drain_ret = GST_FLOW_OK;
+
+  return TRUE;
+}
+
+static gboolean
+gst_video_convert_stop (GstBaseTransform * trans)
+{
+  gst_video_convert_flush_inflight (GST_VIDEO_CONVERT_CAST (trans));
+
+  return TRUE;
+}
+
+static gboolean
+gst_video_convert_query (GstBaseTransform * trans, GstPadDirection direction,
+    GstQuery * query)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (trans);
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (trans);
+  gboolean ret;
+
+  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->query (trans, direction,
+      query);
+
+  if (ret && direction == GST_PAD_SRC
+      && GST_QUERY_TYPE (query) == GST_QUERY_LATENCY
+      && space->n_converters > 1 && filter->in_info.fps_n > 0) {
+    GstClockTime min, max, latency;
+    gboolean live;
+
+    /* the output of a frame is held back until n_converters - 1 more frames
+     * were started */
+    latency = gst_util_uint64_scale_int ((space->n_converters - 1) * GST_SECOND,
+        filter->in_info.fps_d, filter->in_info.fps_n);
+
+    gst_query_parse_latency (query, &live, &min, &max);
+    min += latency;
+    if (GST_CLOCK_TIME_IS_VALID (max))
+      max += latency;
+    gst_query_set_latency (query, live, min, max);
+
+    GST_DEBUG_OBJECT (space, "added %" GST_TIME_FORMAT " of latency",
+        GST_TIME_ARGS (latency));
+  }
+
+  return ret;
+}
+
+static gboolean
+gst_video_convert_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (trans);
+  GstBufferPool *pool;
+  guint size, min, max;
+
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  /* When converting we can read the cropped region of the input frames
+   * directly. In passthrough the query was answered by downstream. */
+  if (decide_query != NULL) {
+    if (!gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL))
+      gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+    if (!gst_query_find_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE,
+            NULL))
+      gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE,
+          NULL);
+  }
+
+  /* the input buffers of the frames in flight are kept */
+  if (space->n_converters > 1 && gst_query_get_n_allocation_pools (query) > 0) {
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+    min += space->n_converters - 1;
+    if (max != 0 && max < min)
+      max = min;
+    gst_query_set_nth_allocation_pool (query, 0, pool, size, min, max);
+    if (pool)
+      gst_object_unref (pool);
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_video_convert_decide_allocation (GstBaseTransform * trans,
+    GstQuery * query)
+{
+  GstVideoConvert *space = GST_VIDEO_CONVERT_CAST (trans);
+  GstBufferPool *pool;
+  guint size, min, max;
+
+  /* and so are the output buffers */
+  if (space->n_converters > 1 && gst_query_get_n_allocation_pools (query) > 0) {
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+    min += space->n_converters - 1;
+    if (max != 0 && max < min)
+      max = min;
+    gst_query_set_nth_allocation_pool (query, 0, pool, size, min, max);
+    if (pool)
+      gst_object_unref (pool);
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->decide_allocation (trans,
+      query);
+}
+
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
@@ -52,6 +52,30 @@ struct _GstVideoConvert {
   GstVideoPrimariesMode primaries_mode;
   gdouble alpha_value;
   gint n_threads;
+  guint max_inflight_frames;
+  GstVideoToneMapMethod tone_map_method;
+
+  /* converters used in turn when more than one frame can be in flight */
+  GstVideoConverter **converters;
+  guint n_converters;
+  guint next_converter;
+  /* GstVideoConvertFrame, oldest first */
+  GQueue inflight;
+  /* flow return of the last failed push of frames in flight, returned
+   * upstream with the next buffer */
+  GstFlowReturn drain_ret;
+  /* QoS of downstream, to drop frames that got late while in flight */
+  GstClockTime earliest_time;
+  gdouble proportion;
+  gboolean discont;
+
+  /* options of the converters, to recreate them for another crop region */
+  GstStructure *config;
+  /* region of the input frames the converters read and the full size of
+   * those frames, width 0 if all */
+  GstVideoRectangle crop;
+  gint crop_full_width;
+  gint crop_full_height;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (videoconvert);
@@ -32,6 +32,11 @@
  * RGB formats and is therefore generally able to operate anywhere in a
  * pipeline.
  *
+ * When scaling, upstream can attach a #GstVideoCropMeta to the buffers
+ * instead of cropping them. Only the cropped region of the input frames is
+ * read and scaled to the output size then. When no scaling is needed, the
+ * buffers and their crop meta are passed through if downstream supports it.
+ *
  * ## Example pipelines
  * |[
  * gst-launch-1.0 -v filesrc location=videotestsrc.ogg ! oggdemux ! theoradec ! videoconvert ! videoscale ! autovideosink
@@ -196,6 +201,8 @@ static GstCaps *gst_video_scale_fixate_caps (GstBaseTransform * base,
     GstPadDirection direction, GstCaps * caps, GstCaps * othercaps);
 static gboolean gst_video_scale_transform_meta (GstBaseTransform * trans,
     GstBuffer * outbuf, GstMeta * meta, GstBuffer * inbuf);
+static gboolean gst_video_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query);
 
 static gboolean gst_video_scale_set_info (GstVideoFilter * filter,
     GstCaps * in, GstVideoInfo * in_info, GstCaps * out,
@@ -295,6 +302,8 @@ gst_video_scale_class_init (GstVideoScaleClass * klass)
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_scale_src_event);
   trans_class->transform_meta =
       GST_DEBUG_FUNCPTR (gst_video_scale_transform_meta);
+  trans_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_scale_propose_allocation);
 
   filter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_scale_set_info);
   filter_class->transform_frame =
@@ -325,6 +334,8 @@ gst_video_scale_finalize (GstVideoScale * videoscale)
 {
   if (videoscale->convert)
     gst_video_converter_free (videoscale->convert);
+  if (videoscale->config)
+    gst_structure_free (videoscale->config);
 
   G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (videoscale));
 }
@@ -522,6 +533,10 @@ gst_video_scale_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
     GST_META_TAG_VIDEO_SIZE_STR
   };
 
+  /* the crop was applied while scaling */
+  if (info->api == GST_VIDEO_CROP_META_API_TYPE)
+    return FALSE;
+
   tags = gst_meta_api_type_get_tags (info->api);
 
   /* No specific tags, we are good to copy */
@@ -560,6 +575,28 @@ gst_video_scale_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
   return TRUE;
 }
 
+static gboolean
+gst_video_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  /* When scaling we can read the cropped region of the input frames
+   * directly. In passthrough the query was answered by downstream. */
+  if (decide_query != NULL) {
+    if (!gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL))
+      gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+    if (!gst_query_find_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE,
+            NULL))
+      gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE,
+          NULL);
+  }
+
+  return TRUE;
+}
+
 static gboolean
 gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
     GstVideoInfo * in_info, GstCaps * out, GstVideoInfo * out_info)
@@ -709,6 +746,13 @@ gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
           GST_VIDEO_GAMMA_MODE_REMAP, NULL);
     }
 
+    if (videoscale->config)
+      gst_structure_free (videoscale->config);
+    videoscale->config = gst_structure_copy (options);
+    memset (&videoscale->crop, 0, sizeof (videoscale->crop));
+    videoscale->crop_full_width = in_info->width;
+    videoscale->crop_full_height = in_info->height;
+
     if (videoscale->convert)
       gst_video_converter_free (videoscale->convert);
     videoscale->convert = gst_video_converter_new (in_info, out_info, options);
@@ -1173,6 +1217,66 @@ done:
     (gpointer)(((guint8*)(GST_VIDEO_FRAME_PLANE_DATA (frame, 0))) + \
      GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0) * (line))
 
+/* Makes the converter read the region of @frame given by the crop meta of
+ * its buffer. Upstream only adds the meta when we proposed it, the caps then
+ * describe the cropped region and the video meta the full frame. */
+static gboolean
+gst_video_scale_update_crop (GstVideoScale * videoscale,
+    const GstVideoFrame * frame)
+{
+  GstVideoFilter *filter = GST_VIDEO_FILTER_CAST (videoscale);
+  const GstVideoInfo *in_info = &filter->in_info;
+  GstVideoCropMeta *meta;
+  GstStructure *config;
+
+  meta = gst_buffer_get_video_crop_meta (frame->buffer);
+  if (meta == NULL) {
+    if (videoscale->crop.w == 0)
+      return TRUE;
+    memset (&videoscale->crop, 0, sizeof (videoscale->crop));
+  } else {
+    if (meta->x == videoscale->crop.x && meta->y == videoscale->crop.y
+        && meta->width == videoscale->crop.w
+        && meta->height == videoscale->crop.h
+        && videoscale->crop_full_width == GST_VIDEO_FRAME_WIDTH (frame)
+        && videoscale->crop_full_height == GST_VIDEO_FRAME_HEIGHT (frame))
+      return TRUE;
+    videoscale->crop.x = meta->x;
+    videoscale->crop.y = meta->y;
+    videoscale->crop.w = meta->width;
+    videoscale->crop.h = meta->height;
+    in_info = &frame->info;
+  }
+  videoscale->crop_full_width = GST_VIDEO_INFO_WIDTH (in_info);
+  videoscale->crop_full_height = GST_VIDEO_INFO_HEIGHT (in_info);
+
+  GST_DEBUG_OBJECT (videoscale, "input crop region changed to %d,%d %dx%d",
+      videoscale->crop.x, videoscale->crop.y, videoscale->crop.w,
+      videoscale->crop.h);
+
+  config = gst_structure_copy (videoscale->config);
+  if (meta) {
+    gst_structure_set (config,
+        GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, videoscale->crop.x,
+        GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, videoscale->crop.y,
+        GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT, videoscale->crop.w,
+        GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, videoscale->crop.h,
+        NULL);
+  }
+
+  if (videoscale->convert)
+    gst_video_converter_free (videoscale->convert);
+  videoscale->convert = gst_video_converter_new (in_info, &filter->out_info,
+      config);
+  if (videoscale->convert == NULL) {
+    /* try again with the next frame */
+    videoscale->crop_full_width = 0;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_video_scale_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
@@ -1180,11 +1284,24 @@ gst_video_scale_transform_frame (GstVideoFilter * filter,
   GstVideoScale *videoscale = GST_VIDEO_SCALE_CAST (filter);
   GstFlowReturn ret = GST_FLOW_OK;
 
+  if (!gst_video_scale_update_crop (videoscale, in_frame))
+    goto no_convert;
+
   GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter, "doing video scaling");
 
   gst_video_converter_frame (videoscale->convert, in_frame, out_frame);
 
   return ret;
+
+  /* ERRORS */
+no_convert:
+  {
+    GST_ELEMENT_ERROR (videoscale, CORE, NEGOTIATION, (NULL),
+        ("could not create converter for crop region %d,%d %dx%d",
+            videoscale->crop.x, videoscale->crop.y, videoscale->crop.w,
+            videoscale->crop.h));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
 }
 
 static gboolean
@@ -81,6 +81,13 @@ struct _GstVideoScale {
   gint n_threads;
 
   GstVideoConverter *convert;
+  /* options of the converter, to recreate it for another crop region */
+  GstStructure *config;
+  /* region of the input frames the converter reads and the full size of
+   * those frames, width 0 if all */
+  GstVideoRectangle crop;
+  gint crop_full_width;
+  gint crop_full_height;
 
   gint borders_h;
   gint borders_w;
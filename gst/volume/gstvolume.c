@@ -91,12 +91,14 @@ enum
 
 #define DEFAULT_PROP_MUTE       FALSE
 #define DEFAULT_PROP_VOLUME     1.0
+#define DEFAULT_PROP_LOUDNESS_INTERVAL 0
 
 enum
 {
   PROP_0,
   PROP_MUTE,
-  PROP_VOLUME
+  PROP_VOLUME,
+  PROP_LOUDNESS_INTERVAL
 };
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
@@ -324,6 +326,24 @@ gst_volume_class_init (GstVolumeClass * klass)
           0.0, VOLUME_MAX_DOUBLE, DEFAULT_PROP_VOLUME,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVolume:loudness-interval:
+   *
+   * Measure the EBU R128 loudness and true-peak of the output and post a
+   * "loudness" element message every loudness-interval nanoseconds. The
+   * message contains the fields of gst_audio_loudness_get_structure() and
+   * the "timestamp", "stream-time" and "running-time" of the end of the last
+   * measured buffer. Only S16, S32 and F32 samples are measured. 0 disables
+   * the measurement.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_LOUDNESS_INTERVAL,
+      g_param_spec_uint64 ("loudness-interval", "Loudness Interval",
+          "Interval of the loudness messages in nanoseconds (0 = disabled)",
+          0, G_MAXUINT64, DEFAULT_PROP_LOUDNESS_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class, "Volume",
       "Filter/Effect/Audio",
       "Set volume on audio/raw streams", "Andy Wingo <wingo@pobox.com>");
@@ -345,6 +365,7 @@ gst_volume_init (GstVolume * self)
 {
   self->mute = DEFAULT_PROP_MUTE;
   self->volume = DEFAULT_PROP_VOLUME;
+  self->loudness_interval = DEFAULT_PROP_LOUDNESS_INTERVAL;
 
   self->tracklist = NULL;
   self->negotiated = FALSE;
@@ -656,6 +677,9 @@ volume_setup (GstAudioFilter * filter, const GstAudioInfo * info)
   mute = self->mute;
   GST_OBJECT_UNLOCK (self);
 
+  /* the loudness meter is recreated for the new format */
+  g_clear_pointer (&self->loudness, gst_audio_loudness_free);
+
   res = volume_update_volume (self, info, volume, mute);
   if (!res) {
     GST_ELEMENT_ERROR (self, CORE, NEGOTIATION,
@@ -679,10 +703,84 @@ volume_stop (GstBaseTransform * base)
   self->mutes = NULL;
   self->mutes_count = 0;
 
+  g_clear_pointer (&self->loudness, gst_audio_loudness_free);
+
   return GST_CALL_PARENT_WITH_DEFAULT (GST_BASE_TRANSFORM_CLASS, stop, (base),
       TRUE);
 }
 
+/* measures the samples in data, that are the final samples of buffer, and
+ * posts a message when the loudness-interval has passed */
+static void
+volume_measure_loudness (GstVolume * self, GstBuffer * buffer,
+    gconstpointer data, gsize size)
+{
+  GstBaseTransform *base = GST_BASE_TRANSFORM_CAST (self);
+  GstAudioInfo *info = &GST_AUDIO_FILTER_CAST (self)->info;
+  GstClockTime interval, timestamp, running_time, stream_time;
+  GstStructure *s;
+  guint64 interval_frames;
+  gsize frames;
+
+  GST_OBJECT_LOCK (self);
+  interval = self->loudness_interval;
+  GST_OBJECT_UNLOCK (self);
+
+  if (interval == 0)
+    return;
+
+  if (!self->loudness) {
+    self->loudness = gst_audio_loudness_new (info);
+    self->loudness_frames = 0;
+    if (!self->loudness) {
+      GST_LOG_OBJECT (self, "can't measure loudness of %s",
+          GST_AUDIO_INFO_NAME (info));
+      return;
+    }
+  }
+
+  frames = size / GST_AUDIO_INFO_BPF (info);
+  gst_audio_loudness_process (self->loudness, data, frames);
+  self->loudness_frames += frames;
+
+  interval_frames =
+      gst_util_uint64_scale (interval, GST_AUDIO_INFO_RATE (info), GST_SECOND);
+  if (self->loudness_frames < MAX (interval_frames, 1))
+    return;
+  self->loudness_frames = 0;
+
+  timestamp = GST_BUFFER_TIMESTAMP (buffer);
+  if (GST_CLOCK_TIME_IS_VALID (timestamp)
+      && GST_BUFFER_DURATION_IS_VALID (buffer))
+    timestamp += GST_BUFFER_DURATION (buffer);
+  running_time = gst_segment_to_running_time (&base->segment, GST_FORMAT_TIME,
+      timestamp);
+  stream_time = gst_segment_to_stream_time (&base->segment, GST_FORMAT_TIME,
+      timestamp);
+
+  s = gst_audio_loudness_get_structure (self->loudness);
+  gst_structure_set (s, "timestamp", G_TYPE_UINT64, timestamp,
+      "stream-time", G_TYPE_UINT64, stream_time,
+      "running-time", G_TYPE_UINT64, running_time, NULL);
+
+  gst_element_post_message (GST_ELEMENT_CAST (self),
+      gst_message_new_element (GST_OBJECT_CAST (self), s));
+}
+
+static void
+volume_measure_loudness_buffer (GstVolume * self, GstBuffer * buffer)
+{
+  GstMapInfo map;
+
+  if (self->loudness_interval == 0)
+    return;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+    return;
+  volume_measure_loudness (self, buffer, map.data, map.size);
+  gst_buffer_unmap (buffer, &map);
+}
+
 static void
 volume_before_transform (GstBaseTransform * base, GstBuffer * buffer)
 {
@@ -712,6 +810,11 @@ volume_before_transform (GstBaseTransform * base, GstBuffer * buffer)
      * we continue processing. */
     volume_update_volume (self, GST_AUDIO_FILTER_INFO (self), volume, mute);
   }
+
+  /* transform_ip is not called in passthrough mode, the output is the input
+   * then */
+  if (gst_base_transform_is_passthrough (base))
+    volume_measure_loudness_buffer (self, buffer);
 }
 
 /* call the plugged-in process function for this instance
@@ -730,8 +833,10 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
     goto not_negotiated;
 
   /* don't process data with GAP */
-  if (GST_BUFFER_FLAG_IS_SET (outbuf, GST_BUFFER_FLAG_GAP))
+  if (GST_BUFFER_FLAG_IS_SET (outbuf, GST_BUFFER_FLAG_GAP)) {
+    volume_measure_loudness_buffer (self, outbuf);
     return GST_FLOW_OK;
+  }
 
   gst_buffer_map (outbuf, &map, GST_MAP_READWRITE);
   ts = GST_BUFFER_TIMESTAMP (outbuf);
@@ -802,6 +907,7 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
   }
 
 done:
+  volume_measure_loudness (self, outbuf, map.data, map.size);
   gst_buffer_unmap (outbuf, &map);
 
   return GST_FLOW_OK;
@@ -832,6 +938,11 @@ volume_set_property (GObject * object, guint prop_id, const GValue * value,
       self->volume = g_value_get_double (value);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_LOUDNESS_INTERVAL:
+      GST_OBJECT_LOCK (self);
+      self->loudness_interval = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -855,6 +966,11 @@ volume_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_double (value, self->volume);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_LOUDNESS_INTERVAL:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint64 (value, self->loudness_interval);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
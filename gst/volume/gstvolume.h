@@ -64,6 +64,10 @@ struct _GstVolume {
   guint mutes_count;
   gdouble *volumes;
   guint volumes_count;
+
+  GstClockTime loudness_interval;
+  GstAudioLoudness *loudness;
+  guint64 loudness_frames;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (volume);
@@ -1962,6 +1962,108 @@ GST_START_TEST (test_change_output_caps)
 
 GST_END_TEST;
 
+/* Two sink pads with the same input format are converted to the output
+ * format and mixed, which makes them use the same converter */
+GST_START_TEST (test_convert_same_format_pads)
+{
+  GstSegment segment;
+  GstElement *bin, *audiomixer, *capsfilter, *sink;
+  GstBus *bus;
+  GstPad *sinkpad1, *sinkpad2;
+  gboolean res;
+  GstStateChangeReturn state_res;
+  GstFlowReturn ret;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  GstQuery *drain = gst_query_new_drain ();
+  GstMapInfo outmap;
+  gsize i;
+
+  bin = gst_pipeline_new ("pipeline");
+  bus = gst_element_get_bus (bin);
+  gst_bus_add_signal_watch_full (bus, G_PRIORITY_HIGH);
+
+  g_signal_connect (bus, "message::error", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::warning", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::eos", (GCallback) message_received, bin);
+
+  audiomixer = gst_element_factory_make ("audiomixer", "audiomixer");
+  g_object_set (audiomixer, "output-buffer-duration", GST_SECOND, NULL);
+  capsfilter = gst_element_factory_make ("capsfilter", NULL);
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_cb, NULL);
+  gst_bin_add_many (GST_BIN (bin), audiomixer, capsfilter, sink, NULL);
+
+  res = gst_element_link_many (audiomixer, capsfilter, sink, NULL);
+  fail_unless (res == TRUE, NULL);
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, GST_AUDIO_NE (S32),
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 10, "channels", G_TYPE_INT, 1, NULL);
+  g_object_set (capsfilter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  state_res = gst_element_set_state (bin, GST_STATE_PLAYING);
+  ck_assert_int_ne (state_res, GST_STATE_CHANGE_FAILURE);
+
+  sinkpad1 = gst_element_request_pad_simple (audiomixer, "sink_%u");
+  fail_if (sinkpad1 == NULL, NULL);
+  sinkpad2 = gst_element_request_pad_simple (audiomixer, "sink_%u");
+  fail_if (sinkpad2 == NULL, NULL);
+
+  gst_pad_send_event (sinkpad1, gst_event_new_stream_start ("test1"));
+  gst_pad_send_event (sinkpad2, gst_event_new_stream_start ("test2"));
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, "S8",
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 10, "channels", G_TYPE_INT, 1, NULL);
+  gst_pad_set_caps (sinkpad1, caps);
+  gst_pad_set_caps (sinkpad2, caps);
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  segment.start = 0;
+  segment.stop = GST_SECOND;
+  segment.time = 0;
+  gst_pad_send_event (sinkpad1, gst_event_new_segment (&segment));
+  gst_pad_send_event (sinkpad2, gst_event_new_segment (&segment));
+
+  gst_buffer_replace (&handoff_buffer, NULL);
+
+  buffer = new_buffer (10, 1, 0, GST_SECOND, 0);
+  ret = gst_pad_chain (sinkpad1, buffer);
+  ck_assert_int_eq (ret, GST_FLOW_OK);
+  buffer = new_buffer (10, 2, 0, GST_SECOND, 0);
+  ret = gst_pad_chain (sinkpad2, buffer);
+  ck_assert_int_eq (ret, GST_FLOW_OK);
+  gst_pad_query (sinkpad1, drain);
+  gst_pad_query (sinkpad2, drain);
+
+  fail_unless (handoff_buffer != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (handoff_buffer), 40);
+
+  gst_buffer_map (handoff_buffer, &outmap, GST_MAP_READ);
+  for (i = 0; i < 10; i++)
+    fail_unless_equals_int (((gint32 *) outmap.data)[i], 3 << 24);
+  gst_buffer_unmap (handoff_buffer, &outmap);
+  gst_clear_buffer (&handoff_buffer);
+
+  gst_element_release_request_pad (audiomixer, sinkpad1);
+  gst_object_unref (sinkpad1);
+  gst_element_release_request_pad (audiomixer, sinkpad2);
+  gst_object_unref (sinkpad2);
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_bus_remove_signal_watch (bus);
+  gst_object_unref (bus);
+  gst_object_unref (bin);
+  gst_query_unref (drain);
+}
+
+GST_END_TEST;
+
 /* In this test, we create two input buffers with a duration of 1 second,
  * and require the audiomixer to output 1.5 second long buffers.
  *
@@ -2252,6 +2354,7 @@ audiomixer_suite (void)
   tcase_add_checked_fixture (tc_chain, test_setup, test_teardown);
   tcase_add_test (tc_chain, test_change_output_caps);
   tcase_add_test (tc_chain, test_change_output_caps_mid_output_buffer);
+  tcase_add_test (tc_chain, test_convert_same_format_pads);
 
   /* Use a longer timeout */
 #ifdef HAVE_VALGRIND
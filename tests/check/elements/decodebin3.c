@@ -0,0 +1,310 @@
+/* GStreamer unit tests for decodebin3
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gst/check/gstcheck.h>
+
+/* Fake decoder for the decoder pool test */
+static GType gst_fake_video_decoder_get_type (void);
+
+typedef struct _GstFakeVideoDecoder GstFakeVideoDecoder;
+typedef GstElementClass GstFakeVideoDecoderClass;
+
+struct _GstFakeVideoDecoder
+{
+  GstElement parent;
+};
+
+G_DEFINE_TYPE (GstFakeVideoDecoder, gst_fake_video_decoder, GST_TYPE_ELEMENT);
+
+static void
+gst_fake_video_decoder_class_init (GstFakeVideoDecoderClass * klass)
+{
+  static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
+      GST_PAD_SINK, GST_PAD_ALWAYS,
+      GST_STATIC_CAPS ("video/x-fake"));
+  static GstStaticPadTemplate src_templ = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC, GST_PAD_ALWAYS,
+      GST_STATIC_CAPS ("video/x-raw"));
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  gst_element_class_add_static_pad_template (element_class, &sink_templ);
+  gst_element_class_add_static_pad_template (element_class, &src_templ);
+  gst_element_class_set_metadata (element_class,
+      "FakeVideoDecoder", "Codec/Decoder/Video", "yep", "me");
+}
+
+static gboolean
+gst_fake_video_decoder_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstElement *self = GST_ELEMENT (parent);
+  GstPad *otherpad = gst_element_get_static_pad (self, "src");
+  GstCaps *caps;
+  gboolean ret = TRUE;
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+      caps = gst_caps_new_empty_simple ("video/x-raw");
+      gst_pad_set_caps (otherpad, caps);
+      gst_caps_unref (caps);
+      gst_event_unref (event);
+      event = NULL;
+      break;
+    default:
+      break;
+  }
+
+  if (event)
+    ret = gst_pad_push_event (otherpad, event);
+  gst_object_unref (otherpad);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_fake_video_decoder_sink_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buf)
+{
+  GstElement *self = GST_ELEMENT (parent);
+  GstPad *otherpad = gst_element_get_static_pad (self, "src");
+  GstFlowReturn ret;
+
+  ret = gst_pad_push (otherpad, buf);
+
+  gst_object_unref (otherpad);
+
+  return ret;
+}
+
+static void
+gst_fake_video_decoder_init (GstFakeVideoDecoder * self)
+{
+  GstPad *pad;
+
+  pad =
+      gst_pad_new_from_template (gst_element_class_get_pad_template
+      (GST_ELEMENT_GET_CLASS (self), "sink"), "sink");
+  gst_pad_set_event_function (pad, gst_fake_video_decoder_sink_event);
+  gst_pad_set_chain_function (pad, gst_fake_video_decoder_sink_chain);
+  gst_element_add_pad (GST_ELEMENT (self), pad);
+
+  pad =
+      gst_pad_new_from_template (gst_element_class_get_pad_template
+      (GST_ELEMENT_GET_CLASS (self), "src"), "src");
+  gst_element_add_pad (GST_ELEMENT (self), pad);
+}
+
+static gint
+select_all_cb (GstElement * dbin, GstStreamCollection * collection,
+    GstStream * stream, gpointer user_data)
+{
+  return 1;
+}
+
+static void
+pad_added_cb (GstElement * dbin, GstPad * pad, GstBin * pipe)
+{
+  GstElement *sink;
+  GstPad *sinkpad;
+
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+  gst_bin_add (pipe, sink);
+  gst_element_sync_state_with_parent (sink);
+  sinkpad = gst_element_get_static_pad (sink, "sink");
+  fail_unless_equals_int (gst_pad_link (pad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+}
+
+static void
+add_input (GstElement * pipe, GstElement * dbin)
+{
+  GstElement *src, *filter;
+  GstCaps *caps;
+  GstPad *srcpad, *sinkpad;
+
+  src = gst_element_factory_make ("fakesrc", NULL);
+  fail_unless (src != NULL);
+  g_object_set (src, "sizetype", 2, "filltype", 2, "can-activate-pull", FALSE,
+      NULL);
+
+  filter = gst_element_factory_make ("capsfilter", NULL);
+  fail_unless (filter != NULL);
+  caps = gst_caps_new_empty_simple ("video/x-fake");
+  g_object_set (filter, "caps", caps, NULL);
+  gst_caps_unref (caps);
+
+  gst_bin_add_many (GST_BIN (pipe), src, filter, NULL);
+  fail_unless (gst_element_link (src, filter));
+
+  srcpad = gst_element_get_static_pad (filter, "src");
+  sinkpad = gst_element_request_pad_simple (dbin, "sink_%u");
+  fail_unless (sinkpad != NULL);
+  fail_unless_equals_int (gst_pad_link (srcpad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+}
+
+static void
+get_pool_stats (GstElement * dbin, guint64 * hits, guint64 * misses,
+    guint * level)
+{
+  GstStructure *stats = NULL;
+
+  g_object_get (dbin, "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get (stats,
+          "decoder-pool-hits", G_TYPE_UINT64, hits,
+          "decoder-pool-misses", G_TYPE_UINT64, misses,
+          "decoder-pool-level", G_TYPE_UINT, level, NULL));
+  gst_structure_free (stats);
+}
+
+/* stream switches happen in the streaming threads, wait for them */
+static void
+wait_for_pool_stats (GstElement * dbin, guint64 expected_hits,
+    guint64 expected_misses, guint expected_level)
+{
+  gint64 end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  guint64 hits, misses;
+  guint level;
+
+  get_pool_stats (dbin, &hits, &misses, &level);
+  while ((hits != expected_hits || misses != expected_misses
+          || level != expected_level) && g_get_monotonic_time () < end_time) {
+    g_usleep (G_USEC_PER_SEC / 100);
+    get_pool_stats (dbin, &hits, &misses, &level);
+  }
+
+  fail_unless_equals_uint64 (hits, expected_hits);
+  fail_unless_equals_uint64 (misses, expected_misses);
+  fail_unless_equals_int (level, expected_level);
+}
+
+static void
+select_streams (GstElement * dbin, GstStreamCollection * collection,
+    guint n_streams)
+{
+  GList *streams = NULL;
+  guint i;
+
+  for (i = 0; i < n_streams; i++)
+    streams = g_list_append (streams, (gchar *)
+        gst_stream_get_stream_id (gst_stream_collection_get_stream
+            (collection, i)));
+
+  fail_unless (gst_element_send_event (dbin,
+          gst_event_new_select_streams (streams)));
+  g_list_free (streams);
+}
+
+GST_START_TEST (test_decoder_pool)
+{
+  GstElement *pipe, *dbin;
+  GstStreamCollection *collection = NULL;
+  GstMessage *msg;
+  guint64 hits, misses;
+  guint level;
+
+  fail_unless (gst_element_register (NULL, "fakevideodec",
+          GST_RANK_PRIMARY + 100, gst_fake_video_decoder_get_type ()));
+
+  pipe = gst_pipeline_new (NULL);
+  dbin = gst_element_factory_make ("decodebin3", NULL);
+  fail_unless (dbin != NULL);
+  g_object_set (dbin, "decoder-pool-size", 2, NULL);
+  gst_bin_add (GST_BIN (pipe), dbin);
+
+  /* two streams with the same caps, both selected */
+  add_input (pipe, dbin);
+  add_input (pipe, dbin);
+  g_signal_connect (dbin, "select-stream", G_CALLBACK (select_all_cb), NULL);
+  g_signal_connect (dbin, "pad-added", G_CALLBACK (pad_added_cb), pipe);
+
+  fail_if (gst_element_set_state (pipe,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+
+  while (!collection || gst_stream_collection_get_size (collection) < 2) {
+    msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe),
+        5 * GST_SECOND, GST_MESSAGE_STREAM_COLLECTION | GST_MESSAGE_ERROR);
+    fail_unless (msg != NULL);
+    fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_STREAM_COLLECTION);
+    if (GST_MESSAGE_SRC (msg) == GST_OBJECT (dbin)) {
+      gst_clear_object (&collection);
+      gst_message_parse_stream_collection (msg, &collection);
+    }
+    gst_message_unref (msg);
+  }
+
+  /* the pool starts empty, both decoders are created */
+  wait_for_pool_stats (dbin, 0, 2, 0);
+
+  /* deselecting the second stream keeps its decoder */
+  select_streams (dbin, collection, 1);
+  wait_for_pool_stats (dbin, 0, 2, 1);
+
+  /* and selecting it again reuses it */
+  select_streams (dbin, collection, 2);
+  wait_for_pool_stats (dbin, 1, 2, 0);
+
+  /* shrinking the pool evicts the decoders that don't fit anymore */
+  select_streams (dbin, collection, 1);
+  wait_for_pool_stats (dbin, 1, 2, 1);
+  g_object_set (dbin, "decoder-pool-size", 0, NULL);
+  get_pool_stats (dbin, &hits, &misses, &level);
+  fail_unless_equals_int (level, 0);
+
+  /* going to READY releases all decoders, only as many as the pool size are
+   * kept */
+  select_streams (dbin, collection, 2);
+  wait_for_pool_stats (dbin, 1, 3, 0);
+  g_object_set (dbin, "decoder-pool-size", 1, NULL);
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_READY),
+      GST_STATE_CHANGE_SUCCESS);
+  get_pool_stats (dbin, &hits, &misses, &level);
+  fail_unless_equals_int (level, 1);
+
+  /* and they are all destroyed when going to NULL */
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  get_pool_stats (dbin, &hits, &misses, &level);
+  fail_unless_equals_int (level, 0);
+
+  gst_object_unref (collection);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+decodebin3_suite (void)
+{
+  Suite *s = suite_create ("decodebin3");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_decoder_pool);
+
+  return s;
+}
+
+GST_CHECK_MAIN (decodebin3);
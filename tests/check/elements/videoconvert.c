@@ -159,6 +159,158 @@ GST_START_TEST (test_negotiate_alternate)
 
 GST_END_TEST;
 
+GST_START_TEST (test_max_inflight_frames)
+{
+  GstHarness *h;
+  GstBuffer *buffer;
+  guint i;
+
+  h = gst_harness_new ("videoconvert");
+  g_object_set (h->element, "max-inflight-frames", 3, "n-threads", 2, NULL);
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,width=320,height=240,format=I420,framerate=30/1");
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw,width=320,height=240,format=BGRx,framerate=30/1");
+
+  for (i = 0; i < 5; i++) {
+    buffer = gst_buffer_new_and_alloc (320 * 240 * 3 / 2);
+    gst_buffer_memset (buffer, 0, 0x80, -1);
+    GST_BUFFER_PTS (buffer) = i * GST_SECOND / 30;
+    fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+  }
+
+  /* two frames are still in flight */
+  fail_unless_equals_int (gst_harness_buffers_received (h), 3);
+
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+  fail_unless_equals_int (gst_harness_buffers_received (h), 5);
+
+  for (i = 0; i < 5; i++) {
+    buffer = gst_harness_pull (h);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer), i * GST_SECOND / 30);
+    gst_buffer_unref (buffer);
+  }
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_max_inflight_frames_qos)
+{
+  GstHarness *h;
+  GstBuffer *buffer;
+  guint i;
+
+  h = gst_harness_new ("videoconvert");
+  g_object_set (h->element, "max-inflight-frames", 3, "n-threads", 2, NULL);
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,width=320,height=240,format=I420,framerate=30/1");
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw,width=320,height=240,format=BGRx,framerate=30/1");
+
+  for (i = 0; i < 8; i++) {
+    /* frames 3 and 4 are in flight when downstream reports being late */
+    if (i == 5)
+      fail_unless (gst_harness_push_upstream_event (h,
+              gst_event_new_qos (GST_QOS_TYPE_UNDERFLOW, 1.5, 0,
+                  GST_SECOND / 2)));
+
+    buffer = gst_buffer_new_and_alloc (320 * 240 * 3 / 2);
+    gst_buffer_memset (buffer, 0, 0x80, -1);
+    GST_BUFFER_PTS (buffer) = i * GST_SECOND / 30;
+    if (i >= 5)
+      GST_BUFFER_PTS (buffer) += GST_SECOND;
+    GST_BUFFER_DURATION (buffer) = GST_SECOND / 30;
+    fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+  }
+
+  /* frames 3 and 4 got late while in flight and were dropped */
+  fail_unless_equals_int (gst_harness_buffers_received (h), 4);
+
+  for (i = 0; i < 3; i++) {
+    buffer = gst_harness_pull (h);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer), i * GST_SECOND / 30);
+    gst_buffer_unref (buffer);
+  }
+  buffer = gst_harness_pull (h);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+      GST_SECOND + 5 * GST_SECOND / 30);
+  fail_unless (GST_BUFFER_IS_DISCONT (buffer));
+  gst_buffer_unref (buffer);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_crop_meta)
+{
+  GstHarness *h;
+  GstBuffer *full, *cropped, *outbuf, *refbuf;
+  GstVideoCropMeta *crop;
+  GstMapInfo map;
+  GstQuery *query;
+  GstCaps *caps;
+  guint i;
+
+  h = gst_harness_new ("videoconvert");
+
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw,width=8,height=8,format=BGRA,framerate=30/1");
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw,width=8,height=8,format=RGBA,framerate=30/1");
+
+  /* a 16x16 frame of which the 8x8 region at 4,2 is shown */
+  full = gst_buffer_new_and_alloc (16 * 16 * 4);
+  cropped = gst_buffer_new_and_alloc (8 * 8 * 4);
+  gst_buffer_map (full, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = i * 7;
+  for (i = 0; i < 8; i++)
+    gst_buffer_fill (cropped, i * 8 * 4, map.data + ((i + 2) * 16 + 4) * 4,
+        8 * 4);
+  gst_buffer_unmap (full, &map);
+
+  gst_buffer_add_video_meta (full, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_BGRA, 16, 16);
+  crop = gst_buffer_add_video_crop_meta (full);
+  crop->x = 4;
+  crop->y = 2;
+  crop->width = 8;
+  crop->height = 8;
+
+  fail_unless_equals_int (gst_harness_push (h, cropped), GST_FLOW_OK);
+  refbuf = gst_harness_pull (h);
+  fail_unless_equals_int (gst_harness_push (h, full), GST_FLOW_OK);
+  outbuf = gst_harness_pull (h);
+
+  /* only the cropped region was converted and the meta was consumed */
+  fail_unless (gst_buffer_get_video_crop_meta (outbuf) == NULL);
+  gst_buffer_map (refbuf, &map, GST_MAP_READ);
+  fail_unless_equals_int (gst_buffer_get_size (outbuf), map.size);
+  fail_unless (gst_buffer_memcmp (outbuf, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (refbuf, &map);
+  gst_buffer_unref (refbuf);
+  gst_buffer_unref (outbuf);
+
+  /* the crop meta is proposed upstream when converting */
+  caps = gst_caps_from_string
+      ("video/x-raw,width=8,height=8,format=BGRA,framerate=30/1");
+  query = gst_query_new_allocation (caps, TRUE);
+  fail_unless (gst_pad_peer_query (h->srcpad, query));
+  fail_unless (gst_query_find_allocation_meta (query,
+          GST_VIDEO_CROP_META_API_TYPE, NULL));
+  gst_query_unref (query);
+  gst_caps_unref (caps);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 videoconvert_suite (void)
 {
@@ -169,6 +321,9 @@ videoconvert_suite (void)
 
   tcase_add_test (tc_chain, test_template_formats);
   tcase_add_test (tc_chain, test_negotiate_alternate);
+  tcase_add_test (tc_chain, test_max_inflight_frames);
+  tcase_add_test (tc_chain, test_max_inflight_frames_qos);
+  tcase_add_test (tc_chain, test_crop_meta);
 
   return s;
 }
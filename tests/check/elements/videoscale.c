@@ -963,6 +963,58 @@ GST_START_TEST (test_basetransform_negotiation)
 
 GST_END_TEST;
 
+GST_START_TEST (test_crop_meta)
+{
+  GstHarness *h;
+  GstBuffer *full, *cropped, *outbuf, *refbuf;
+  GstVideoCropMeta *crop;
+  GstMapInfo map;
+  guint i;
+
+  h = gst_harness_new ("videoscale");
+
+  gst_harness_set_src_caps_str (h, "video/x-raw,width=8,height=8,"
+      "format=GRAY8,pixel-aspect-ratio=1/1,framerate=30/1");
+  gst_harness_set_sink_caps_str (h, "video/x-raw,width=16,height=16,"
+      "format=GRAY8,pixel-aspect-ratio=1/1,framerate=30/1");
+
+  /* a 16x16 frame of which the 8x8 region at 4,2 is shown */
+  full = gst_buffer_new_and_alloc (16 * 16);
+  cropped = gst_buffer_new_and_alloc (8 * 8);
+  gst_buffer_map (full, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = i * 7;
+  for (i = 0; i < 8; i++)
+    gst_buffer_fill (cropped, i * 8, map.data + (i + 2) * 16 + 4, 8);
+  gst_buffer_unmap (full, &map);
+
+  gst_buffer_add_video_meta (full, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_GRAY8, 16, 16);
+  crop = gst_buffer_add_video_crop_meta (full);
+  crop->x = 4;
+  crop->y = 2;
+  crop->width = 8;
+  crop->height = 8;
+
+  fail_unless_equals_int (gst_harness_push (h, cropped), GST_FLOW_OK);
+  refbuf = gst_harness_pull (h);
+  fail_unless_equals_int (gst_harness_push (h, full), GST_FLOW_OK);
+  outbuf = gst_harness_pull (h);
+
+  /* only the cropped region was scaled and the meta was consumed */
+  fail_unless (gst_buffer_get_video_crop_meta (outbuf) == NULL);
+  gst_buffer_map (refbuf, &map, GST_MAP_READ);
+  fail_unless_equals_int (gst_buffer_get_size (outbuf), map.size);
+  fail_unless (gst_buffer_memcmp (outbuf, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (refbuf, &map);
+  gst_buffer_unref (refbuf);
+  gst_buffer_unref (outbuf);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 #endif /* !defined(VSCALE_TEST_GROUP) */
 
 static Suite *
@@ -985,6 +1037,7 @@ videoscale_suite (void)
   tcase_add_test (tc_chain, test_reverse_negotiation);
 #endif
   tcase_add_test (tc_chain, test_basetransform_negotiation);
+  tcase_add_test (tc_chain, test_crop_meta);
 #else
 #if VSCALE_TEST_GROUP == 1
   tcase_add_test (tc_chain, test_downscale_640x480_320x240_method_0);
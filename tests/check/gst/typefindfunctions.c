@@ -477,6 +477,36 @@ GST_START_TEST (test_manifest_typefinding)
 
 GST_END_TEST;
 
+/* data starting with a signature is not taken for a stream that the
+ * scanning typefinders find further in */
+GST_START_TEST (test_signature_before_mpegts)
+{
+  GstTypeFindProbability prob;
+  GstCaps *caps;
+  guint8 *data;
+  gsize size = 9 + 20 * 188;
+  gint i;
+
+  data = g_malloc0 (size);
+  memcpy (data, "FLV\001\005\000\000\000\011", 9);
+  for (i = 0; i < 20; i++) {
+    data[9 + i * 188] = 0x47;
+    data[9 + i * 188 + 1] = 0x40;
+    data[9 + i * 188 + 3] = 0x10;
+  }
+
+  caps = typefind_data (data, size, &prob);
+  fail_unless (caps != NULL);
+  fail_unless (gst_structure_has_name (gst_caps_get_structure (caps, 0),
+          "video/x-flv"));
+  fail_unless_equals_int (prob, GST_TYPE_FIND_MAXIMUM);
+
+  gst_caps_unref (caps);
+  g_free (data);
+}
+
+GST_END_TEST;
+
 static Suite *
 typefindfunctions_suite (void)
 {
@@ -494,6 +524,7 @@ typefindfunctions_suite (void)
   tcase_add_test (tc_chain, test_random_data);
   tcase_add_test (tc_chain, test_hls_m3u8);
   tcase_add_test (tc_chain, test_manifest_typefinding);
+  tcase_add_test (tc_chain, test_signature_before_mpegts);
 
   return s;
 }
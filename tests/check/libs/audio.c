@@ -29,6 +29,7 @@
 
 #include <gst/audio/audio.h>
 #include <string.h>
+#include <math.h>
 
 static GstBuffer *
 make_buffer (guint8 ** _data)
@@ -1578,6 +1579,473 @@ GST_START_TEST (test_audio_make_raw_caps)
 
 GST_END_TEST;
 
+static gint16 *
+run_resampler (GstAudioResamplerFilterMode mode, GstAudioResamplerFlags flags,
+    guint max_threads, const gint16 * in, gint channels, gsize in_frames,
+    gsize * out_frames)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+  gpointer in_p[16], out_p[16];
+  gint16 *out;
+  gsize out_len;
+  gint i;
+
+  options = gst_structure_new ("options",
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      mode, GST_AUDIO_RESAMPLER_OPT_MAX_THREADS, G_TYPE_UINT, max_threads,
+      NULL);
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      flags, GST_AUDIO_FORMAT_S16, channels, 44100, 48000, options);
+  gst_structure_free (options);
+
+  out_len = gst_audio_resampler_get_out_frames (resampler, in_frames);
+  out = g_new0 (gint16, out_len * channels);
+
+  if (flags & GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_IN) {
+    for (i = 0; i < channels; i++) {
+      in_p[i] = (gpointer) (in + i * in_frames);
+      out_p[i] = out + i * out_len;
+    }
+  } else {
+    in_p[0] = (gpointer) in;
+    out_p[0] = out;
+  }
+  gst_audio_resampler_resample (resampler, in_p, in_frames, out_p, out_len);
+  gst_audio_resampler_free (resampler);
+
+  *out_frames = out_len;
+  return out;
+}
+
+GST_START_TEST (test_resampler_threads)
+{
+  static const GstAudioResamplerFilterMode modes[] = {
+    GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+    GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED
+  };
+  static const GstAudioResamplerFlags flags[] = {
+    GST_AUDIO_RESAMPLER_FLAG_NONE,
+    GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_IN |
+        GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT
+  };
+  const gint channels = 16;
+  const gsize in_frames = 4096;
+  gint16 *in, *expected, *out;
+  gsize expected_frames, out_frames;
+  guint m, f, i;
+
+  in = g_new (gint16, in_frames * channels);
+  for (i = 0; i < in_frames * channels; i++)
+    in[i] = g_random_int_range (-16384, 16384);
+
+  /* the output has to be the same no matter how many threads are used */
+  for (m = 0; m < G_N_ELEMENTS (modes); m++) {
+    for (f = 0; f < G_N_ELEMENTS (flags); f++) {
+      expected = run_resampler (modes[m], flags[f], 1, in, channels,
+          in_frames, &expected_frames);
+
+      for (i = 2; i <= 5; i++) {
+        out = run_resampler (modes[m], flags[f], i, in, channels, in_frames,
+            &out_frames);
+        fail_unless_equals_int (out_frames, expected_frames);
+        fail_unless (memcmp (out, expected,
+                out_frames * channels * sizeof (gint16)) == 0);
+        g_free (out);
+      }
+      g_free (expected);
+    }
+  }
+  g_free (in);
+}
+
+GST_END_TEST;
+
+static guint8 *
+run_converter (const GstAudioInfo * in_info, const GstAudioInfo * out_info,
+    guint block_frames, const guint8 * in, gsize in_frames, gsize * out_size)
+{
+  GstAudioConverter *convert;
+  GstAudioInfo in_copy = *in_info, out_copy = *out_info;
+  gpointer in_p[8], out_p[8];
+  guint8 *out;
+  gsize out_frames;
+  gint i;
+
+  convert = gst_audio_converter_new (GST_AUDIO_CONVERTER_FLAG_NONE, &in_copy,
+      &out_copy, gst_structure_new ("options",
+          GST_AUDIO_CONVERTER_OPT_BLOCK_FRAMES, G_TYPE_UINT, block_frames,
+          NULL));
+  fail_unless (convert != NULL);
+
+  out_frames = gst_audio_converter_get_out_frames (convert, in_frames);
+  *out_size = out_frames * out_info->bpf;
+  out = g_malloc0 (*out_size);
+
+  if (in_info->layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    for (i = 0; i < in_info->channels; i++)
+      in_p[i] = (gpointer) (in + i * in_frames * in_info->bpf /
+          in_info->channels);
+  } else {
+    in_p[0] = (gpointer) in;
+  }
+  if (out_info->layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    for (i = 0; i < out_info->channels; i++)
+      out_p[i] = out + i * out_frames * out_info->bpf / out_info->channels;
+  } else {
+    out_p[0] = out;
+  }
+
+  fail_unless (gst_audio_converter_samples (convert,
+          GST_AUDIO_CONVERTER_FLAG_NONE, in_p, in_frames, out_p, out_frames));
+  gst_audio_converter_free (convert);
+
+  return out;
+}
+
+GST_START_TEST (test_converter_blocks)
+{
+  static const struct
+  {
+    GstAudioFormat in_format;
+    gint in_rate, in_channels;
+    GstAudioLayout in_layout;
+    GstAudioFormat out_format;
+    gint out_rate, out_channels;
+    GstAudioLayout out_layout;
+  } tests[] = {
+    {GST_AUDIO_FORMAT_S16, 48000, 2, GST_AUDIO_LAYOUT_INTERLEAVED,
+        GST_AUDIO_FORMAT_F32, 48000, 6, GST_AUDIO_LAYOUT_INTERLEAVED},
+    {GST_AUDIO_FORMAT_S24_32, 48000, 2, GST_AUDIO_LAYOUT_INTERLEAVED,
+        GST_AUDIO_FORMAT_S16, 48000, 2, GST_AUDIO_LAYOUT_INTERLEAVED},
+    {GST_AUDIO_FORMAT_F32, 44100, 2, GST_AUDIO_LAYOUT_NON_INTERLEAVED,
+        GST_AUDIO_FORMAT_S16, 48000, 1, GST_AUDIO_LAYOUT_INTERLEAVED},
+    {GST_AUDIO_FORMAT_S16, 48000, 6, GST_AUDIO_LAYOUT_INTERLEAVED,
+        GST_AUDIO_FORMAT_F32, 44100, 2, GST_AUDIO_LAYOUT_NON_INTERLEAVED},
+  };
+  const gsize in_frames = 4000;
+  guint i, j, k;
+
+  /* converting in blocks has to give the same result as converting all
+   * samples at once */
+  for (i = 0; i < G_N_ELEMENTS (tests); i++) {
+    GstAudioInfo in_info, out_info;
+    guint8 *in, *expected, *out;
+    gsize in_size, expected_size, out_size;
+    static const guint block_frames[] = { 64, 100, G_MAXUINT };
+
+    gst_audio_info_set_format (&in_info, tests[i].in_format, tests[i].in_rate,
+        tests[i].in_channels, NULL);
+    in_info.layout = tests[i].in_layout;
+    gst_audio_info_set_format (&out_info, tests[i].out_format,
+        tests[i].out_rate, tests[i].out_channels, NULL);
+    out_info.layout = tests[i].out_layout;
+
+    in_size = in_frames * in_info.bpf;
+    in = g_malloc (in_size);
+    if (GST_AUDIO_INFO_IS_FLOAT (&in_info)) {
+      for (j = 0; j < in_frames * in_info.channels; j++)
+        ((gfloat *) in)[j] = g_random_double_range (-1.0, 1.0);
+    } else {
+      for (j = 0; j < in_size; j++)
+        in[j] = g_random_int_range (0, 256);
+      /* keep the padding of S24_32 in range */
+      if (tests[i].in_format == GST_AUDIO_FORMAT_S24_32) {
+        for (j = 0; j < in_frames * in_info.channels; j++)
+          ((gint32 *) in)[j] = ((gint32 *) in)[j] >> 8;
+      }
+    }
+
+    expected = run_converter (&in_info, &out_info, 0, in, in_frames,
+        &expected_size);
+    for (k = 0; k < G_N_ELEMENTS (block_frames); k++) {
+      out = run_converter (&in_info, &out_info, block_frames[k], in,
+          in_frames, &out_size);
+      fail_unless_equals_int (out_size, expected_size);
+      fail_unless (memcmp (out, expected, out_size) == 0);
+      g_free (out);
+    }
+    g_free (expected);
+    g_free (in);
+  }
+}
+
+GST_END_TEST;
+
+static GstAudioChannelMixer *
+make_channel_mixer (GstAudioChannelMixerFlags flags, GstAudioFormat format,
+    gint in_channels, gint out_channels, const gfloat * coeffs)
+{
+  gfloat **matrix;
+  gint i, j;
+
+  matrix = g_new (gfloat *, in_channels);
+  for (i = 0; i < in_channels; i++) {
+    matrix[i] = g_new (gfloat, out_channels);
+    for (j = 0; j < out_channels; j++)
+      matrix[i][j] = coeffs[j * in_channels + i];
+  }
+  return gst_audio_channel_mixer_new_with_matrix (flags, format, in_channels,
+      out_channels, matrix);
+}
+
+GST_START_TEST (test_channel_mixer_permutation)
+{
+  /* swap the first two channels and silence the third */
+  static const gfloat coeffs[] = {
+    0.0, 1.0, 0.0,
+    1.0, 0.0, 0.0,
+    0.0, 0.0, 0.0,
+  };
+  GstAudioChannelMixer *mix;
+  gint16 in[3 * 4], out[3 * 4];
+  gpointer in_p[3], out_p[3];
+  gint i, n, planar;
+
+  for (i = 0; i < G_N_ELEMENTS (in); i++)
+    in[i] = i + 1;
+
+  for (planar = 0; planar < 2; planar++) {
+    GstAudioChannelMixerFlags flags = GST_AUDIO_CHANNEL_MIXER_FLAGS_NONE;
+
+    if (planar) {
+      flags = GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN |
+          GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT;
+      for (i = 0; i < 3; i++) {
+        in_p[i] = in + i * 4;
+        out_p[i] = out + i * 4;
+      }
+    } else {
+      in_p[0] = in;
+      out_p[0] = out;
+    }
+
+    mix = make_channel_mixer (flags, GST_AUDIO_FORMAT_S16, 3, 3, coeffs);
+    fail_unless (mix != NULL);
+    fail_if (gst_audio_channel_mixer_is_passthrough (mix));
+
+    memset (out, 0xff, sizeof (out));
+    gst_audio_channel_mixer_samples (mix, in_p, out_p, 4);
+
+    for (n = 0; n < 4; n++) {
+      if (planar) {
+        fail_unless_equals_int (out[n], in[4 + n]);
+        fail_unless_equals_int (out[4 + n], in[n]);
+        fail_unless_equals_int (out[8 + n], 0);
+      } else {
+        fail_unless_equals_int (out[n * 3], in[n * 3 + 1]);
+        fail_unless_equals_int (out[n * 3 + 1], in[n * 3]);
+        fail_unless_equals_int (out[n * 3 + 2], 0);
+      }
+    }
+    gst_audio_channel_mixer_free (mix);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_channel_mixer_sparse)
+{
+  static const gfloat coeffs[] = {
+    0.5, 0.0, 0.25, 0.0,
+    0.0, 0.5, 0.25, 0.0,
+  };
+  GstAudioChannelMixer *mix;
+  gfloat in[4 * 32], out[2 * 32];
+  gint16 in16[4 * 32], out16[2 * 32];
+  gpointer in_p[4], out_p[2];
+  gint i, n, c, planar;
+
+  for (i = 0; i < G_N_ELEMENTS (in); i++) {
+    in16[i] = g_random_int_range (-16384, 16384);
+    in[i] = in16[i] / 32768.0;
+  }
+
+  for (planar = 0; planar < 2; planar++) {
+    GstAudioChannelMixerFlags flags = GST_AUDIO_CHANNEL_MIXER_FLAGS_NONE;
+
+    if (planar)
+      flags = GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN |
+          GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT;
+
+    /* float */
+    for (i = 0; i < 4; i++)
+      in_p[i] = planar ? in + i * 32 : in;
+    for (i = 0; i < 2; i++)
+      out_p[i] = planar ? out + i * 32 : out;
+
+    mix = make_channel_mixer (flags, GST_AUDIO_FORMAT_F32, 4, 2, coeffs);
+    gst_audio_channel_mixer_samples (mix, in_p, out_p, 32);
+    gst_audio_channel_mixer_free (mix);
+
+    /* integer */
+    for (i = 0; i < 4; i++)
+      in_p[i] = planar ? in16 + i * 32 : in16;
+    for (i = 0; i < 2; i++)
+      out_p[i] = planar ? out16 + i * 32 : out16;
+
+    mix = make_channel_mixer (flags, GST_AUDIO_FORMAT_S16, 4, 2, coeffs);
+    gst_audio_channel_mixer_samples (mix, in_p, out_p, 32);
+    gst_audio_channel_mixer_free (mix);
+
+    for (n = 0; n < 32; n++) {
+      for (c = 0; c < 2; c++) {
+        gint o = planar ? c * 32 + n : n * 2 + c;
+        gint a = planar ? c * 32 + n : n * 4 + c;
+        gint b = planar ? 2 * 32 + n : n * 4 + 2;
+        gint expected16;
+
+        /* all coefficients are exact in float and in 10 bit fixed point */
+        fail_unless_equals_float (out[o], in[a] * 0.5f + in[b] * 0.25f);
+        expected16 = (in16[a] * 512 + in16[b] * 256 + 512) >> 10;
+        fail_unless_equals_int (out16[o], expected16);
+      }
+    }
+  }
+}
+
+GST_END_TEST;
+
+/* a 1 kHz sine at -23 dBFS on both channels is -23 LUFS, see EBU Tech 3341 */
+static void
+check_loudness_sine (GstAudioFormat format)
+{
+  GstAudioLoudness *loudness;
+  GstAudioInfo info;
+  GstStructure *s;
+  const GValue *peaks;
+  gdouble amplitude = pow (10.0, -23.0 / 20.0);
+  gint rate = 48000, frames = 10 * rate, i, c;
+  gpointer data;
+  gdouble v;
+
+  gst_audio_info_set_format (&info, format, rate, 2, NULL);
+  loudness = gst_audio_loudness_new (&info);
+  fail_unless (loudness != NULL);
+
+  data = g_malloc (frames * GST_AUDIO_INFO_BPF (&info));
+  for (i = 0; i < frames; i++) {
+    v = amplitude * sin (2.0 * G_PI * 1000.0 * i / rate);
+    for (c = 0; c < 2; c++) {
+      switch (format) {
+        case GST_AUDIO_FORMAT_S16:
+          ((gint16 *) data)[2 * i + c] = lrint (v * 32767.0);
+          break;
+        case GST_AUDIO_FORMAT_S32:
+          ((gint32 *) data)[2 * i + c] = lrint (v * 2147483647.0);
+          break;
+        case GST_AUDIO_FORMAT_F32:
+          ((gfloat *) data)[2 * i + c] = v;
+          break;
+        default:
+          g_assert_not_reached ();
+      }
+    }
+  }
+
+  /* odd sized chunks, crossing the internal blocks */
+  for (i = 0; i < frames; i += 1001) {
+    guint8 *p = (guint8 *) data + i * GST_AUDIO_INFO_BPF (&info);
+
+    gst_audio_loudness_process (loudness, p, MIN (1001, frames - i));
+  }
+
+  fail_unless (fabs (gst_audio_loudness_get_momentary (loudness) + 23.0) <
+      0.1);
+  fail_unless (fabs (gst_audio_loudness_get_short_term (loudness) + 23.0) <
+      0.1);
+  fail_unless (fabs (gst_audio_loudness_get_integrated (loudness) + 23.0) <
+      0.1);
+  fail_unless (fabs (gst_audio_loudness_get_true_peak (loudness, -1) + 23.0) <
+      0.1);
+
+  s = gst_audio_loudness_get_structure (loudness);
+  fail_unless (gst_structure_has_name (s, "loudness"));
+  fail_unless (gst_structure_has_field_typed (s, "integrated",
+          G_TYPE_DOUBLE));
+  peaks = gst_structure_get_value (s, "true-peak");
+  fail_unless (peaks != NULL);
+  fail_unless_equals_int (gst_value_array_get_size (peaks), 2);
+  gst_structure_free (s);
+
+  gst_audio_loudness_reset (loudness);
+  fail_unless (isinf (gst_audio_loudness_get_integrated (loudness)));
+  fail_unless (isinf (gst_audio_loudness_get_true_peak (loudness, 0)));
+
+  g_free (data);
+  gst_audio_loudness_free (loudness);
+}
+
+GST_START_TEST (test_loudness)
+{
+  GstAudioInfo info;
+
+  check_loudness_sine (GST_AUDIO_FORMAT_S16);
+  check_loudness_sine (GST_AUDIO_FORMAT_S32);
+  check_loudness_sine (GST_AUDIO_FORMAT_F32);
+
+  /* unsupported formats */
+  gst_audio_info_set_format (&info, GST_AUDIO_FORMAT_U8, 48000, 2, NULL);
+  fail_unless (gst_audio_loudness_new (&info) == NULL);
+  gst_audio_info_set_format (&info, GST_AUDIO_FORMAT_F32, 48000, 2, NULL);
+  info.layout = GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+  fail_unless (gst_audio_loudness_new (&info) == NULL);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_quantize)
+{
+  GstAudioDitherMethod dither;
+  GstAudioNoiseShapingMethod ns;
+  const guint quantizer = 1 << 16;
+  gint32 in[2 * 1000], out[2 * 1000], first[2 * 1000];
+  gpointer in_p[1] = { in }, out_p[1] = { out };
+  gint i;
+
+  for (i = 0; i < G_N_ELEMENTS (in); i++)
+    in[i] = (gint32) g_random_int_range (-(1 << 23), 1 << 23) << 8;
+
+  for (dither = GST_AUDIO_DITHER_NONE; dither <= GST_AUDIO_DITHER_TPDF_HF;
+      dither++) {
+    for (ns = GST_AUDIO_NOISE_SHAPING_NONE; ns <= GST_AUDIO_NOISE_SHAPING_HIGH;
+        ns++) {
+      GstAudioQuantize *quant;
+
+      quant = gst_audio_quantize_new (dither, ns, GST_AUDIO_QUANTIZE_FLAG_NONE,
+          GST_AUDIO_FORMAT_S32, 2, quantizer);
+      fail_unless (quant != NULL);
+
+      gst_audio_quantize_samples (quant, in_p, out_p, 1000);
+      for (i = 0; i < G_N_ELEMENTS (out); i++) {
+        fail_unless (out[i] % (gint32) quantizer == 0);
+        /* without noise shaping the error is bounded by the dither */
+        if (ns == GST_AUDIO_NOISE_SHAPING_NONE)
+          fail_unless (ABS ((gint64) out[i] - in[i]) <= 2 * quantizer);
+      }
+      memcpy (first, out, sizeof (out));
+
+      /* the same output after a reset */
+      gst_audio_quantize_reset (quant);
+      gst_audio_quantize_samples (quant, in_p, out_p, 1000);
+      fail_unless (memcmp (first, out, sizeof (out)) == 0);
+
+      gst_audio_quantize_free (quant);
+
+      /* another instance dithers differently */
+      if (dither != GST_AUDIO_DITHER_NONE) {
+        quant = gst_audio_quantize_new (dither, ns,
+            GST_AUDIO_QUANTIZE_FLAG_NONE, GST_AUDIO_FORMAT_S32, 2, quantizer);
+        gst_audio_quantize_samples (quant, in_p, out_p, 1000);
+        fail_if (memcmp (first, out, sizeof (out)) == 0);
+        gst_audio_quantize_free (quant);
+      }
+    }
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1616,6 +2084,12 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_buffer_and_audio_meta);
   tcase_add_test (tc_chain, test_audio_info_from_caps);
   tcase_add_test (tc_chain, test_audio_make_raw_caps);
+  tcase_add_test (tc_chain, test_resampler_threads);
+  tcase_add_test (tc_chain, test_converter_blocks);
+  tcase_add_test (tc_chain, test_channel_mixer_permutation);
+  tcase_add_test (tc_chain, test_channel_mixer_sparse);
+  tcase_add_test (tc_chain, test_loudness);
+  tcase_add_test (tc_chain, test_quantize);
 
   return s;
 }
@@ -26,6 +26,8 @@
 
 #include <gst/check/gstcheck.h>
 #include <gst/audio/gstaudiosink.h>
+#include <gst/audio/gstaudiosrc.h>
+#include <gst/app/gstappsrc.h>
 
 #define GST_TYPE_AUDIO_FOO_SINK           (gst_audio_foo_sink_get_type())
 #define GST_AUDIO_FOO_SINK(obj)           (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_AUDIO_FOO_SINK,GstAudioFooSink))
@@ -33,6 +35,11 @@
 typedef struct _GstAudioFooSink GstAudioFooSink;
 typedef struct _GstAudioFooSinkClass GstAudioFooSinkClass;
 
+#define FOO_CAPS "audio/x-raw, format=(string) " GST_AUDIO_NE (S16) ", " \
+    "rate=(int) 48000, channels=(int) 1, layout=(string) interleaved"
+#define FOO_SAMPLE(i) ((gint16) ((i) % G_MAXINT16 + 1))
+#define FOO_MAX_WRITTEN (1 << 20)
+
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -43,6 +50,15 @@ struct _GstAudioFooSink
   GstAudioSink parent;
 
   guint num_clear_all_call;
+
+  GMutex lock;
+  GCond cond;
+  /* what the device played, up to FOO_MAX_WRITTEN bytes */
+  GByteArray *written;
+  guint min_write;
+  /* frames the device reports as queued */
+  gint delay;
+  gint byte_rate;
 };
 
 struct _GstAudioFooSinkClass
@@ -61,25 +77,245 @@ gst_audio_foo_sink_clear_all (GstAudioSink * sink)
   self->num_clear_all_call++;
 }
 
+static gboolean
+gst_audio_foo_sink_prepare (GstAudioSink * sink, GstAudioRingBufferSpec * spec)
+{
+  GstAudioFooSink *self = GST_AUDIO_FOO_SINK (sink);
+
+  self->byte_rate = GST_AUDIO_INFO_RATE (&spec->info) *
+      GST_AUDIO_INFO_BPF (&spec->info);
+
+  return TRUE;
+}
+
+static gboolean
+gst_audio_foo_sink_unprepare (GstAudioSink * sink)
+{
+  return TRUE;
+}
+
+static gint
+gst_audio_foo_sink_write (GstAudioSink * sink, gpointer data, guint length)
+{
+  GstAudioFooSink *self = GST_AUDIO_FOO_SINK (sink);
+
+  g_mutex_lock (&self->lock);
+  if (self->written->len < FOO_MAX_WRITTEN)
+    g_byte_array_append (self->written, data, length);
+  self->min_write = MIN (self->min_write, length);
+  g_cond_broadcast (&self->cond);
+  g_mutex_unlock (&self->lock);
+
+  /* play the samples in real time */
+  g_usleep (gst_util_uint64_scale_int (length, G_USEC_PER_SEC,
+          self->byte_rate));
+
+  return length;
+}
+
+static guint
+gst_audio_foo_sink_delay (GstAudioSink * sink)
+{
+  GstAudioFooSink *self = GST_AUDIO_FOO_SINK (sink);
+
+  return g_atomic_int_get (&self->delay);
+}
+
+/* wait until the device played at least @len bytes */
+static gboolean
+gst_audio_foo_sink_wait_written (GstAudioFooSink * self, guint len)
+{
+  gint64 end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  gboolean res = TRUE;
+
+  g_mutex_lock (&self->lock);
+  while (self->written->len < len && res)
+    res = g_cond_wait_until (&self->cond, &self->lock, end_time);
+  res = self->written->len >= len;
+  g_mutex_unlock (&self->lock);
+
+  return res;
+}
+
+static void
+gst_audio_foo_sink_finalize (GObject * object)
+{
+  GstAudioFooSink *self = GST_AUDIO_FOO_SINK (object);
+
+  g_byte_array_unref (self->written);
+  g_mutex_clear (&self->lock);
+  g_cond_clear (&self->cond);
+
+  G_OBJECT_CLASS (gst_audio_foo_sink_parent_class)->finalize (object);
+}
+
 static void
-gst_audio_foo_sink_init (GstAudioFooSink * src)
+gst_audio_foo_sink_init (GstAudioFooSink * self)
 {
+  g_mutex_init (&self->lock);
+  g_cond_init (&self->cond);
+  self->written = g_byte_array_new ();
+  self->min_write = G_MAXUINT;
 }
 
 static void
 gst_audio_foo_sink_class_init (GstAudioFooSinkClass * klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
   GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
   GstAudioSinkClass *audiosink_class = GST_AUDIO_SINK_CLASS (klass);
 
+  gobject_class->finalize = gst_audio_foo_sink_finalize;
+
   gst_element_class_add_static_pad_template (element_class, &sink_template);
   gst_element_class_set_metadata (element_class,
       "AudioFooSink", "Sink/Audio",
       "Audio Sink Unit Test element", "Foo Bar <foo@bar.com>");
 
+  audiosink_class->prepare = gst_audio_foo_sink_prepare;
+  audiosink_class->unprepare = gst_audio_foo_sink_unprepare;
+  audiosink_class->write = gst_audio_foo_sink_write;
+  audiosink_class->delay = gst_audio_foo_sink_delay;
   audiosink_class->extension->clear_all = gst_audio_foo_sink_clear_all;
 }
 
+#define GST_TYPE_AUDIO_FOO_SRC            (gst_audio_foo_src_get_type())
+#define GST_AUDIO_FOO_SRC(obj)            (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_AUDIO_FOO_SRC,GstAudioFooSrc))
+typedef struct _GstAudioFooSrc GstAudioFooSrc;
+typedef struct _GstAudioFooSrcClass GstAudioFooSrcClass;
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (FOO_CAPS));
+
+struct _GstAudioFooSrc
+{
+  GstAudioSrc parent;
+
+  /* frames captured so far */
+  guint64 frames;
+  gint rate;
+};
+
+struct _GstAudioFooSrcClass
+{
+  GstAudioSrcClass parent_class;
+};
+
+GType gst_audio_foo_src_get_type (void);
+G_DEFINE_TYPE (GstAudioFooSrc, gst_audio_foo_src, GST_TYPE_AUDIO_SRC);
+
+static gboolean
+gst_audio_foo_src_prepare (GstAudioSrc * src, GstAudioRingBufferSpec * spec)
+{
+  GstAudioFooSrc *self = GST_AUDIO_FOO_SRC (src);
+
+  self->rate = GST_AUDIO_INFO_RATE (&spec->info);
+  self->frames = 0;
+
+  return TRUE;
+}
+
+static gboolean
+gst_audio_foo_src_unprepare (GstAudioSrc * src)
+{
+  return TRUE;
+}
+
+/* capture a ramp of FOO_SAMPLE() values in real time */
+static guint
+gst_audio_foo_src_read (GstAudioSrc * src, gpointer data, guint length,
+    GstClockTime * timestamp)
+{
+  GstAudioFooSrc *self = GST_AUDIO_FOO_SRC (src);
+  gint16 *samples = data;
+  guint i, n_frames = length / sizeof (gint16);
+
+  g_usleep (gst_util_uint64_scale_int (n_frames, G_USEC_PER_SEC, self->rate));
+
+  for (i = 0; i < n_frames; i++)
+    samples[i] = FOO_SAMPLE (self->frames + i);
+  self->frames += n_frames;
+
+  *timestamp = GST_CLOCK_TIME_NONE;
+
+  return length;
+}
+
+static void
+gst_audio_foo_src_init (GstAudioFooSrc * self)
+{
+}
+
+static void
+gst_audio_foo_src_class_init (GstAudioFooSrcClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstAudioSrcClass *audiosrc_class = GST_AUDIO_SRC_CLASS (klass);
+
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+  gst_element_class_set_metadata (element_class,
+      "AudioFooSrc", "Source/Audio",
+      "Audio Source Unit Test element", "Foo Bar <foo@bar.com>");
+
+  audiosrc_class->prepare = gst_audio_foo_src_prepare;
+  audiosrc_class->unprepare = gst_audio_foo_src_unprepare;
+  audiosrc_class->read = gst_audio_foo_src_read;
+}
+
+/* four segments of 10ms */
+static void
+acquire_ringbuffer (GstAudioRingBuffer * ringbuffer)
+{
+  GstAudioRingBufferSpec *spec = &ringbuffer->spec;
+  GstCaps *caps;
+
+  caps = gst_caps_from_string (FOO_CAPS);
+  spec->latency_time = 10000;
+  spec->buffer_time = 40000;
+  fail_unless (gst_audio_ring_buffer_parse_caps (spec, caps));
+  gst_caps_unref (caps);
+
+  fail_unless (gst_audio_ring_buffer_acquire (ringbuffer, spec));
+  fail_unless (gst_audio_ring_buffer_activate (ringbuffer, TRUE));
+  gst_audio_ring_buffer_may_start (ringbuffer, TRUE);
+}
+
+/* push a quarter of a 10ms segment of the ramp */
+static void
+push_quarter_segment (GstAppSrc * appsrc, guint64 * offset)
+{
+  GstBuffer *buf;
+  GstMapInfo map;
+  gint16 *data;
+  guint i, n_frames = 48000 / 100 / 4;
+
+  buf = gst_buffer_new_allocate (NULL, n_frames * sizeof (gint16), NULL);
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  data = (gint16 *) map.data;
+  for (i = 0; i < n_frames; i++)
+    data[i] = FOO_SAMPLE (*offset + i);
+  gst_buffer_unmap (buf, &map);
+
+  GST_BUFFER_PTS (buf) = gst_util_uint64_scale_int (*offset, GST_SECOND,
+      48000);
+  GST_BUFFER_DURATION (buf) = gst_util_uint64_scale_int (n_frames,
+      GST_SECOND, 48000);
+  *offset += n_frames;
+
+  fail_unless_equals_int (gst_app_src_push_buffer (appsrc, buf),
+      GST_FLOW_OK);
+}
+
+static void
+release_ringbuffer (GstAudioRingBuffer * ringbuffer)
+{
+  gst_audio_ring_buffer_set_flushing (ringbuffer, TRUE);
+  fail_unless (gst_audio_ring_buffer_activate (ringbuffer, FALSE));
+  fail_unless (gst_audio_ring_buffer_release (ringbuffer));
+}
+
 GST_START_TEST (test_class_extension)
 {
   GstAudioFooSink *foosink = NULL;
@@ -107,6 +343,254 @@ GST_START_TEST (test_class_extension)
 
 GST_END_TEST;
 
+GST_START_TEST (test_lock_free)
+{
+  GstAudioFooSink *foosink = NULL;
+  GstAudioRingBuffer *ringbuffer;
+  GstStructure *stats = NULL;
+  const GValue *wakeups;
+  guint64 periods;
+
+  foosink = g_object_new (GST_TYPE_AUDIO_FOO_SINK, "lock-free", TRUE, NULL);
+  fail_unless (foosink != NULL);
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (foosink),
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+
+  ringbuffer = GST_AUDIO_BASE_SINK (foosink)->ringbuffer;
+  fail_unless (ringbuffer != NULL);
+  fail_unless (gst_audio_ring_buffer_get_lock_free (ringbuffer));
+
+  g_object_set (foosink, "lock-free", FALSE, NULL);
+  fail_if (gst_audio_ring_buffer_get_lock_free (ringbuffer));
+
+  g_object_get (foosink, "ringbuffer-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "periods", &periods));
+  fail_unless_equals_uint64 (periods, 0);
+  wakeups = gst_structure_get_value (stats, "wakeups");
+  fail_unless (wakeups != NULL);
+  fail_unless_equals_int (gst_value_array_get_size (wakeups), 0);
+  gst_structure_free (stats);
+
+  gst_element_set_state (GST_ELEMENT (foosink), GST_STATE_NULL);
+  gst_clear_object (&foosink);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_lock_free_commit)
+{
+  GstAudioFooSink *foosink = NULL;
+  GstAudioRingBuffer *ringbuffer;
+  GstStructure *stats = NULL;
+  guint64 sample = 0, periods;
+  gint16 *data;
+  gint i, n_samples, accum = 0;
+
+  foosink = g_object_new (GST_TYPE_AUDIO_FOO_SINK, "lock-free", TRUE, NULL);
+  fail_unless (foosink != NULL);
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (foosink),
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+
+  ringbuffer = GST_AUDIO_BASE_SINK (foosink)->ringbuffer;
+  fail_unless (gst_audio_ring_buffer_get_lock_free (ringbuffer));
+  acquire_ringbuffer (ringbuffer);
+
+  /* five times the size of the ringbuffer, committing has to wait for the
+   * device thread to free segments */
+  n_samples = ringbuffer->samples_per_seg * ringbuffer->spec.segtotal * 5;
+  data = g_new (gint16, n_samples);
+  for (i = 0; i < n_samples; i++)
+    data[i] = FOO_SAMPLE (i);
+
+  fail_unless_equals_int (gst_audio_ring_buffer_commit (ringbuffer, &sample,
+          (guint8 *) data, n_samples, n_samples, &accum), n_samples);
+
+  /* everything is played in order, followed by silence */
+  fail_unless (gst_audio_foo_sink_wait_written (foosink,
+          n_samples * sizeof (gint16)));
+  g_mutex_lock (&foosink->lock);
+  fail_unless (memcmp (foosink->written->data, data,
+          n_samples * sizeof (gint16)) == 0);
+  g_mutex_unlock (&foosink->lock);
+
+  g_object_get (foosink, "ringbuffer-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "periods", &periods));
+  fail_unless (periods > 0);
+  gst_structure_free (stats);
+
+  release_ringbuffer (ringbuffer);
+  g_free (data);
+
+  gst_element_set_state (GST_ELEMENT (foosink), GST_STATE_NULL);
+  gst_clear_object (&foosink);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_lock_free_read)
+{
+  GstAudioFooSrc *foosrc = NULL;
+  GstAudioRingBuffer *ringbuffer;
+  GstClockTime timestamp;
+  gint16 *data;
+  gint i, n_samples, n_captured = 0;
+
+  foosrc = g_object_new (GST_TYPE_AUDIO_FOO_SRC, "lock-free", TRUE, NULL);
+  fail_unless (foosrc != NULL);
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (foosrc),
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+
+  ringbuffer = GST_AUDIO_BASE_SRC (foosrc)->ringbuffer;
+  fail_unless (gst_audio_ring_buffer_get_lock_free (ringbuffer));
+  acquire_ringbuffer (ringbuffer);
+
+  /* reading waits for the device thread to capture every segment */
+  n_samples = ringbuffer->samples_per_seg * ringbuffer->spec.segtotal * 3;
+  data = g_new (gint16, n_samples);
+  fail_unless_equals_int (gst_audio_ring_buffer_read (ringbuffer, 0,
+          (guint8 *) data, n_samples, &timestamp), n_samples);
+
+  /* we get the captured ramp, or silence for segments that were overwritten
+   * before we got to them */
+  for (i = 0; i < n_samples; i++) {
+    if (data[i] != 0) {
+      fail_unless_equals_int (data[i], FOO_SAMPLE (i));
+      n_captured++;
+    }
+  }
+  fail_unless (n_captured > 0);
+
+  release_ringbuffer (ringbuffer);
+  g_free (data);
+
+  gst_element_set_state (GST_ELEMENT (foosrc), GST_STATE_NULL);
+  gst_clear_object (&foosrc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_low_latency)
+{
+  GstAudioFooSink *foosink = NULL;
+  GstStructure *stats = NULL;
+  gboolean low_latency;
+  guint64 device_delay;
+  guint underruns;
+
+  foosink = g_object_new (GST_TYPE_AUDIO_FOO_SINK, "low-latency", TRUE, NULL);
+  fail_unless (foosink != NULL);
+
+  g_object_get (foosink, "low-latency", &low_latency, NULL);
+  fail_unless (low_latency);
+
+  fail_unless (gst_element_set_state (GST_ELEMENT (foosink),
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+
+  /* nothing was written yet so nothing was measured */
+  g_object_get (foosink, "ringbuffer-stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint (stats, "underruns", &underruns));
+  fail_unless_equals_int (underruns, 0);
+  fail_unless (gst_structure_get_uint64 (stats, "device-delay",
+          &device_delay));
+  fail_unless (device_delay == GST_CLOCK_TIME_NONE);
+  gst_structure_free (stats);
+
+  gst_element_set_state (GST_ELEMENT (foosink), GST_STATE_NULL);
+  gst_clear_object (&foosink);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_low_latency_data_flow)
+{
+  GstElement *pipeline, *appsrc;
+  GstAudioFooSink *foosink;
+  GstStructure *stats = NULL;
+  GstCaps *caps;
+  GstQuery *query;
+  GstClockTime min_latency = 0, max_latency, subsegment, expected;
+  gboolean live = FALSE;
+  guint64 offset = 0;
+  guint underruns = 0, n_samples, i, j;
+  gint16 *played;
+  gint64 end_time;
+
+  pipeline = gst_pipeline_new (NULL);
+  appsrc = g_object_new (GST_TYPE_APP_SRC, NULL);
+  caps = gst_caps_from_string (FOO_CAPS);
+  g_object_set (appsrc, "is-live", TRUE, "format", GST_FORMAT_TIME,
+      "caps", caps, "min-latency", (gint64) 0, NULL);
+  gst_caps_unref (caps);
+
+  /* four segments of 10ms and a device that always has 5ms queued */
+  foosink = g_object_new (GST_TYPE_AUDIO_FOO_SINK, "low-latency", TRUE,
+      "buffer-time", (gint64) 40000, "latency-time", (gint64) 10000,
+      "processing-deadline", (guint64) 0, NULL);
+  foosink->delay = 240;
+
+  gst_bin_add_many (GST_BIN (pipeline), appsrc, GST_ELEMENT (foosink), NULL);
+  fail_unless (gst_element_link (appsrc, GST_ELEMENT (foosink)));
+  fail_if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+
+  /* fill the ringbuffer and one quarter of the next segment, the device
+   * writes that quarter as soon as it gets to it and then runs dry */
+  for (i = 0; i < 17; i++)
+    push_quarter_segment (GST_APP_SRC (appsrc), &offset);
+
+  end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  while (underruns == 0 && g_get_monotonic_time () < end_time) {
+    g_usleep (10000);
+    g_object_get (foosink, "ringbuffer-stats", &stats, NULL);
+    fail_unless (gst_structure_get_uint (stats, "underruns", &underruns));
+    gst_structure_free (stats);
+  }
+  fail_unless (underruns > 0);
+
+  /* the complete ramp was played although its last segment was never
+   * filled, in writes of less than a segment */
+  n_samples = offset;
+  g_mutex_lock (&foosink->lock);
+  fail_unless (foosink->min_write < 480 * sizeof (gint16));
+  played = (gint16 *) foosink->written->data;
+  for (i = 0; i < foosink->written->len / sizeof (gint16); i++) {
+    if (played[i] != 0)
+      break;
+  }
+  fail_unless (foosink->written->len >= (i + n_samples) * sizeof (gint16));
+  for (j = 0; j < n_samples; j++)
+    fail_unless_equals_int (played[i + j], FOO_SAMPLE (j));
+  g_mutex_unlock (&foosink->lock);
+
+  /* the next render picks up the measured delay and the underruns, we now
+   * report the 5ms device delay plus two quarter segments of headroom */
+  push_quarter_segment (GST_APP_SRC (appsrc), &offset);
+
+  subsegment = gst_util_uint64_scale_int (120, GST_SECOND, 48000);
+  expected = gst_util_uint64_scale_int (240, GST_SECOND, 48000) +
+      2 * subsegment;
+  end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  query = gst_query_new_latency ();
+  while (min_latency != expected && g_get_monotonic_time () < end_time) {
+    g_usleep (10000);
+    if (gst_element_query (GST_ELEMENT (foosink), query))
+      gst_query_parse_latency (query, &live, &min_latency, &max_latency);
+  }
+  gst_query_unref (query);
+  fail_unless (live);
+  fail_unless_equals_uint64 (min_latency, expected);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
 
 static Suite *
 audiosink_suite (void)
@@ -116,6 +600,11 @@ audiosink_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_class_extension);
+  tcase_add_test (tc_chain, test_lock_free);
+  tcase_add_test (tc_chain, test_lock_free_commit);
+  tcase_add_test (tc_chain, test_lock_free_read);
+  tcase_add_test (tc_chain, test_low_latency);
+  tcase_add_test (tc_chain, test_low_latency_data_flow);
 
   return s;
 }
@@ -26,6 +26,7 @@
 #include <gst/pbutils/pbutils.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <glib/gstdio.h>
 #include <glib/gprintf.h>
 
@@ -373,6 +374,307 @@ GST_START_TEST (test_disco_async_custom_context)
 
 GST_END_TEST;
 
+typedef struct _BatchTestData
+{
+  GMainLoop *loop;
+  guint n_discovered;
+  gboolean finished;
+} BatchTestData;
+
+static void
+batch_discovered_cb (GstDiscoverer * discoverer,
+    GstDiscovererInfo * info, GError * err, BatchTestData * data)
+{
+  fail_unless (g_str_has_suffix (gst_discoverer_info_get_uri (info),
+          "theora-vorbis.ogg"));
+  fail_unless (GST_CLOCK_TIME_IS_VALID (gst_discoverer_info_get_discovery_time
+          (info)));
+  fail_if (data->finished);
+
+  data->n_discovered++;
+}
+
+static void
+batch_finished_cb (GstDiscoverer * discoverer, BatchTestData * data)
+{
+  data->finished = TRUE;
+  g_main_loop_quit (data->loop);
+}
+
+GST_START_TEST (test_disco_async_batch)
+{
+  GstDiscoverer *dc;
+  GError *err = NULL;
+  BatchTestData data = { 0, };
+  gchar *uris[6] = { NULL, };
+  gchar *path =
+      g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  guint i, max_concurrent;
+
+  for (i = 0; i < G_N_ELEMENTS (uris) - 1; i++) {
+    uris[i] = gst_filename_to_uri (path, &err);
+    fail_unless (err == NULL);
+  }
+  g_free (path);
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+
+  /* high timeout, in case we're running under valgrind */
+  dc = gst_discoverer_new (30 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+
+  g_object_set (dc, "max-concurrent", 2, NULL);
+  g_object_get (dc, "max-concurrent", &max_concurrent, NULL);
+  fail_unless_equals_int (max_concurrent, 2);
+
+  g_signal_connect (dc, "discovered", G_CALLBACK (batch_discovered_cb), &data);
+  g_signal_connect (dc, "finished", G_CALLBACK (batch_finished_cb), &data);
+
+  gst_discoverer_start (dc);
+  fail_unless (gst_discoverer_discover_uris_async (dc,
+          (const gchar * const *) uris));
+
+  g_main_loop_run (data.loop);
+
+  fail_unless (data.finished);
+  fail_unless_equals_int (data.n_discovered, G_N_ELEMENTS (uris) - 1);
+
+  /* The workers are reused for a second batch */
+  data.finished = FALSE;
+  data.n_discovered = 0;
+  fail_unless (gst_discoverer_discover_uris_async (dc,
+          (const gchar * const *) uris));
+
+  g_main_loop_run (data.loop);
+
+  fail_unless (data.finished);
+  fail_unless_equals_int (data.n_discovered, G_N_ELEMENTS (uris) - 1);
+
+  /* Stopping interrupts the busy workers, new ones take over after a
+   * restart */
+  fail_unless (gst_discoverer_discover_uris_async (dc,
+          (const gchar * const *) uris));
+  gst_discoverer_stop (dc);
+
+  data.finished = FALSE;
+  data.n_discovered = 0;
+  gst_discoverer_start (dc);
+  fail_unless (gst_discoverer_discover_uris_async (dc,
+          (const gchar * const *) uris));
+
+  g_main_loop_run (data.loop);
+
+  fail_unless (data.finished);
+  fail_unless_equals_int (data.n_discovered, G_N_ELEMENTS (uris) - 1);
+
+  gst_discoverer_stop (dc);
+  g_object_unref (dc);
+  for (i = 0; i < G_N_ELEMENTS (uris); i++)
+    g_free (uris[i]);
+
+  g_main_loop_unref (data.loop);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_disco_cache)
+{
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  GstDiscovererInfo *info;
+  guint64 hits, misses;
+  gchar *uri;
+  gchar *path =
+      g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  gint i;
+
+  /* only successful results are cached */
+  if (!have_theora || !have_ogg) {
+    g_free (path);
+    return;
+  }
+
+  uri = gst_filename_to_uri (path, &err);
+  fail_unless (err == NULL);
+  g_free (path);
+
+  dc = gst_discoverer_new (30 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "use-cache", TRUE, NULL);
+
+  for (i = 0; i < 2; i++) {
+    info = gst_discoverer_discover_uri (dc, uri, &err);
+    fail_unless (info != NULL);
+    fail_unless (err == NULL);
+    fail_unless_equals_int (gst_discoverer_info_get_result (info),
+        GST_DISCOVERER_OK);
+    fail_unless_equals_string (gst_discoverer_info_get_uri (info), uri);
+    gst_discoverer_info_unref (info);
+  }
+
+  /* the first run might hit an entry from a previous run already */
+  g_object_get (dc, "cache-hits", &hits, "cache-misses", &misses, NULL);
+  fail_unless (hits >= 1);
+  fail_unless_equals_int (hits + misses, 2);
+
+  g_free (uri);
+  g_object_unref (dc);
+}
+
+GST_END_TEST;
+
+/* an entry with the right key and outer layout but garbage inside must be
+ * dropped and replaced by a new discovery */
+GST_START_TEST (test_disco_cache_corrupt)
+{
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  GstDiscovererInfo *info;
+  GVariant *entry, *info_variant, *stream_variant;
+  GChecksum *cs;
+  GStatBuf file_status;
+  guint64 hits, misses;
+  const gchar *checksum;
+  gchar *uri, *location, *cache_dir, *cachefile, hash_dirname[3] = "00";
+  gchar *path =
+      g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+
+  /* only successful results are cached */
+  if (!have_theora || !have_ogg) {
+    g_free (path);
+    return;
+  }
+
+  uri = gst_filename_to_uri (path, &err);
+  fail_unless (err == NULL);
+
+  /* write the entry where the discoverer looks for it */
+  location = gst_uri_get_location (uri);
+  fail_unless (g_stat (location, &file_status) == 0);
+  cs = g_checksum_new (G_CHECKSUM_SHA1);
+  g_checksum_update (cs, (const guchar *) location, strlen (location));
+  checksum = g_checksum_get_string (cs);
+  hash_dirname[0] = checksum[0];
+  hash_dirname[1] = checksum[1];
+  cache_dir = g_build_filename (g_get_user_cache_dir (),
+      "gstreamer-" GST_API_VERSION, "discoverer", hash_dirname, NULL);
+  fail_unless (g_mkdir_with_parents (cache_dir, 0777) == 0);
+  cachefile = g_build_filename (cache_dir, &checksum[2], NULL);
+  g_checksum_free (cs);
+
+  /* valid info, but an audio stream with garbage in place of the common and
+   * specific stream info */
+  info_variant = g_variant_new ("(mstbmsb)", uri, (guint64) 0, FALSE, NULL,
+      FALSE);
+  stream_variant = g_variant_new ("(yvv)", 'a',
+      g_variant_new_string ("garbage"), g_variant_new_uint32 (42));
+  entry = g_variant_new ("(txtv)", (guint64) file_status.st_size,
+      (gint64) file_status.st_mtime, (guint64) file_status.st_ino,
+      g_variant_new ("(vv)", info_variant, stream_variant));
+  g_variant_ref_sink (entry);
+  fail_unless (g_file_set_contents (cachefile, g_variant_get_data (entry),
+          g_variant_get_size (entry), NULL));
+  g_variant_unref (entry);
+
+  dc = gst_discoverer_new (30 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "use-cache", TRUE, NULL);
+
+  info = gst_discoverer_discover_uri (dc, uri, &err);
+  fail_unless (info != NULL);
+  fail_unless (err == NULL);
+  fail_unless_equals_int (gst_discoverer_info_get_result (info),
+      GST_DISCOVERER_OK);
+  fail_unless (gst_discoverer_info_get_video_streams (info) != NULL);
+  gst_discoverer_stream_info_list_free (gst_discoverer_info_get_video_streams
+      (info));
+  gst_discoverer_info_unref (info);
+
+  g_object_get (dc, "cache-hits", &hits, "cache-misses", &misses, NULL);
+  fail_unless_equals_int (hits, 0);
+  fail_unless_equals_int (misses, 1);
+
+  /* the entry was replaced by a valid one */
+  info = gst_discoverer_discover_uri (dc, uri, &err);
+  fail_unless (info != NULL);
+  fail_unless (err == NULL);
+  gst_discoverer_info_unref (info);
+
+  g_object_get (dc, "cache-hits", &hits, NULL);
+  fail_unless_equals_int (hits, 1);
+
+  g_object_unref (dc);
+  g_free (cachefile);
+  g_free (cache_dir);
+  g_free (location);
+  g_free (uri);
+  g_free (path);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_disco_header_only)
+{
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  GstDiscovererInfo *info;
+  GstDiscovererVideoInfo *vinfo;
+  const GstStructure *sources;
+  GList *streams;
+  gchar *uri;
+  gchar *path =
+      g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+
+  /* the decoder is needed for decodebin to select it, but it is exposed
+   * instead of being plugged */
+  if (!have_theora || !have_ogg) {
+    g_free (path);
+    return;
+  }
+
+  uri = gst_filename_to_uri (path, &err);
+  fail_unless (err == NULL);
+  g_free (path);
+
+  dc = gst_discoverer_new (30 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "header-only", TRUE, NULL);
+
+  info = gst_discoverer_discover_uri (dc, uri, &err);
+  fail_unless (info != NULL);
+  fail_unless (err == NULL);
+  fail_unless_equals_int (gst_discoverer_info_get_result (info),
+      GST_DISCOVERER_OK);
+
+  streams = gst_discoverer_info_get_video_streams (info);
+  fail_unless_equals_int (g_list_length (streams), 1);
+  vinfo = streams->data;
+
+  fail_unless (gst_discoverer_video_info_get_width (vinfo) > 0);
+  fail_unless (gst_discoverer_video_info_get_height (vinfo) > 0);
+
+  /* the stream was not decoded, so its depth is unknown */
+  sources =
+      gst_discoverer_stream_info_get_field_sources (GST_DISCOVERER_STREAM_INFO
+      (vinfo));
+  fail_unless (sources != NULL);
+  fail_unless_equals_string (gst_structure_get_string (sources, "width"),
+      "caps");
+  fail_unless_equals_string (gst_structure_get_string (sources, "depth"),
+      "unknown");
+
+  gst_discoverer_stream_info_list_free (streams);
+  gst_discoverer_info_unref (info);
+  g_free (uri);
+  g_object_unref (dc);
+}
+
+GST_END_TEST;
+
 static Suite *
 discoverer_suite (void)
 {
@@ -392,8 +694,12 @@ discoverer_suite (void)
   tcase_add_test (tc_chain, test_disco_sync_reuse_timeout);
   tcase_add_test (tc_chain, test_disco_missing_plugins);
   tcase_add_test (tc_chain, test_disco_serializing);
+  tcase_add_test (tc_chain, test_disco_cache);
+  tcase_add_test (tc_chain, test_disco_cache_corrupt);
+  tcase_add_test (tc_chain, test_disco_header_only);
   tcase_add_test (tc_chain, test_disco_async);
   tcase_add_test (tc_chain, test_disco_async_custom_context);
+  tcase_add_test (tc_chain, test_disco_async_batch);
   return s;
 }
 
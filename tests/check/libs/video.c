@@ -2488,6 +2488,46 @@ GST_START_TEST (test_video_scaler)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_scaler_shared_taps)
+{
+  GstVideoScaler *scale1, *scale2, *scale3;
+  const gdouble *taps1, *taps2;
+  GstStructure *options;
+
+  scale1 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, 1920, 1280, NULL);
+  scale2 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, 1920, 1280, NULL);
+
+  /* identical scalers share their tables */
+  taps1 = gst_video_scaler_get_coeff (scale1, 0, NULL, NULL);
+  taps2 = gst_video_scaler_get_coeff (scale2, 0, NULL, NULL);
+  fail_unless (taps1 == taps2);
+
+  /* but not with different options */
+  options = gst_structure_new ("options",
+      GST_VIDEO_RESAMPLER_OPT_SHARPEN, G_TYPE_DOUBLE, 0.5, NULL);
+  scale3 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, 1920, 1280, options);
+  fail_unless (gst_video_scaler_get_coeff (scale3, 0, NULL, NULL) != taps1);
+  gst_structure_free (options);
+
+  gst_video_scaler_free (scale1);
+  gst_video_scaler_free (scale3);
+
+  /* the tables stay valid while they are used */
+  fail_unless (gst_video_scaler_get_coeff (scale2, 0, NULL, NULL) == taps2);
+  gst_video_scaler_free (scale2);
+
+  /* and can be reused after all users went away */
+  scale1 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, 1920, 1280, NULL);
+  fail_unless (gst_video_scaler_get_coeff (scale1, 0, NULL, NULL) != NULL);
+  gst_video_scaler_free (scale1);
+}
+
+GST_END_TEST;
+
 typedef enum
 {
   RGB,
@@ -2872,6 +2912,637 @@ GST_START_TEST (test_video_convert_multithreading)
 
 GST_END_TEST;
 
+/* downscaling to subsampled formats fills chroma planes that are a lot
+ * smaller than the height the frame was split in stripes for */
+GST_START_TEST (test_video_convert_small_planes)
+{
+  GstVideoFormat formats[] = { GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_YUV9 };
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe, refframe;
+  GstBuffer *inbuffer, *outbuffer, *refbuffer;
+  GstVideoConverter *convert;
+  GstTaskPool *pool;
+  GstMapInfo info;
+  gint i;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_GRAY8,
+          64, 2160));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_memset (inbuffer, 0, 0x40, -1);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool), 8);
+  gst_task_pool_prepare (pool, NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    fail_unless (gst_video_info_set_format (&outinfo, formats[i], 64, 100));
+    outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+    refbuffer = gst_buffer_new_and_alloc (outinfo.size);
+
+    gst_video_frame_map (&refframe, &outinfo, refbuffer, GST_MAP_WRITE);
+    convert = gst_video_converter_new (&ininfo, &outinfo,
+        gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 1, NULL));
+    gst_video_converter_frame (convert, &inframe, &refframe);
+    gst_video_converter_free (convert);
+    gst_video_frame_unmap (&refframe);
+
+    gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+    convert = gst_video_converter_new_with_pool (&ininfo, &outinfo,
+        gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 8, NULL), pool);
+    gst_video_converter_frame (convert, &inframe, &outframe);
+    gst_video_converter_free (convert);
+    gst_video_frame_unmap (&outframe);
+
+    gst_buffer_map (outbuffer, &info, GST_MAP_READ);
+    fail_unless (gst_buffer_memcmp (refbuffer, 0, info.data, info.size) == 0);
+    gst_buffer_unmap (outbuffer, &info);
+
+    gst_buffer_unref (refbuffer);
+    gst_buffer_unref (outbuffer);
+  }
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+static void
+fill_frame_lines (GstVideoFrame * frame, guint seed)
+{
+  gint i, j, k;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (frame); i++) {
+    guint8 *data = GST_VIDEO_FRAME_PLANE_DATA (frame, i);
+    gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, i);
+    gint height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, i);
+
+    for (j = 0; j < height; j++)
+      for (k = 0; k < stride; k++)
+        data[j * stride + k] = (j * 7 + k + seed) & 0xff;
+  }
+}
+
+/* workers pick up stripes in any order, the lines they cached for the
+ * previous frame must not end up in the next one */
+GST_START_TEST (test_video_convert_frame_sequence)
+{
+  GstVideoFormat formats[] = { GST_VIDEO_FORMAT_AYUV, GST_VIDEO_FORMAT_I420 };
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe, refframe;
+  GstBuffer *inbuffer, *outbuffer, *refbuffer;
+  GstVideoConverter *convert, *refconvert;
+  GstTaskPool *pool;
+  GstMapInfo info;
+  gint i, j;
+
+  pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool), 4);
+  gst_task_pool_prepare (pool, NULL);
+
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_BGRA,
+          64, 360));
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    fail_unless (gst_video_info_set_format (&ininfo, formats[i], 64, 480));
+
+    refconvert = gst_video_converter_new (&ininfo, &outinfo,
+        gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 1, NULL));
+    convert = gst_video_converter_new_with_pool (&ininfo, &outinfo,
+        gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 4, NULL), pool);
+
+    for (j = 0; j < 4; j++) {
+      /* a new input buffer for every frame, like in a pipeline */
+      inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+      gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+      fill_frame_lines (&inframe, j * 37);
+      gst_video_frame_unmap (&inframe);
+
+      outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+      refbuffer = gst_buffer_new_and_alloc (outinfo.size);
+
+      gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+      gst_video_frame_map (&refframe, &outinfo, refbuffer, GST_MAP_WRITE);
+      gst_video_converter_frame (refconvert, &inframe, &refframe);
+      gst_video_frame_unmap (&refframe);
+
+      gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+      gst_video_converter_frame (convert, &inframe, &outframe);
+      gst_video_frame_unmap (&outframe);
+      gst_video_frame_unmap (&inframe);
+      gst_buffer_unref (inbuffer);
+
+      gst_buffer_map (outbuffer, &info, GST_MAP_READ);
+      fail_unless (gst_buffer_memcmp (refbuffer, 0, info.data,
+              info.size) == 0);
+      gst_buffer_unmap (outbuffer, &info);
+
+      gst_buffer_unref (refbuffer);
+      gst_buffer_unref (outbuffer);
+    }
+
+    gst_video_converter_free (convert);
+    gst_video_converter_free (refconvert);
+  }
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+static void
+convert_async_done (GstVideoConverter * convert, gint * done)
+{
+  g_atomic_int_inc (done);
+}
+
+GST_START_TEST (test_video_convert_async)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe, refframe;
+  GstBuffer *inbuffer, *outbuffer, *refbuffer;
+  GstVideoConverter *convert;
+  GstMapInfo info;
+  gint done = 0;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_I420, 1280,
+          720));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_memset (inbuffer, 0, 0x40, -1);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_BGRx, 640,
+          360));
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  refbuffer = gst_buffer_new_and_alloc (outinfo.size);
+
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+  gst_video_frame_map (&refframe, &outinfo, refbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new_empty ("options"));
+  gst_video_converter_frame (convert, &inframe, &refframe);
+  gst_video_converter_free (convert);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 4,
+          GST_VIDEO_CONVERTER_OPT_ASYNC_TASKS, G_TYPE_BOOLEAN, TRUE, NULL));
+  gst_video_converter_frame_async (convert, &inframe, &outframe,
+      (GstVideoConverterDoneFunc) convert_async_done, &done);
+  gst_video_converter_frame_finish (convert);
+  fail_unless_equals_int (g_atomic_int_get (&done), 1);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&refframe);
+
+  gst_buffer_map (outbuffer, &info, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (refbuffer, 0, info.data, info.size) == 0);
+  gst_buffer_unmap (outbuffer, &info);
+
+  gst_buffer_unref (refbuffer);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_convert_scale_tiles)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe, refframe;
+  GstBuffer *inbuffer, *outbuffer, *refbuffer;
+  GstVideoConverter *convert;
+  GstMapInfo info;
+  guint i;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_I420,
+          720, 480));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &info, GST_MAP_WRITE);
+  for (i = 0; i < info.size; i++)
+    info.data[i] = (i * 7 + (i / 4096) * 13) & 0xff;
+  gst_buffer_unmap (inbuffer, &info);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_AYUV64,
+          400, 270));
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  refbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+  gst_video_frame_map (&refframe, &outinfo, refbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+          NULL));
+  gst_video_converter_frame (convert, &inframe, &refframe);
+  gst_video_converter_free (convert);
+
+  /* tiles don't change the result */
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+          GST_VIDEO_CONVERTER_OPT_SCALE_TILE_WIDTH, G_TYPE_UINT, 96,
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 3, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&refframe);
+
+  gst_buffer_map (outbuffer, &info, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (refbuffer, 0, info.data, info.size) == 0);
+  gst_buffer_unmap (outbuffer, &info);
+
+  gst_buffer_unref (refbuffer);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+static void
+convert_pq_line (GstVideoFrame * inframe, GstVideoFrame * outframe,
+    GstVideoToneMapMethod method)
+{
+  GstVideoConverter *convert;
+
+  convert = gst_video_converter_new (&inframe->info, &outframe->info,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_GAMMA_MODE, GST_TYPE_VIDEO_GAMMA_MODE,
+          GST_VIDEO_GAMMA_MODE_REMAP,
+          GST_VIDEO_CONVERTER_OPT_TONE_MAP_METHOD,
+          GST_TYPE_VIDEO_TONE_MAP_METHOD, method,
+          GST_VIDEO_CONVERTER_OPT_TONE_MAP_SOURCE_PEAK, G_TYPE_DOUBLE, 1000.0,
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 2, NULL));
+  fail_unless (convert != NULL);
+  gst_video_converter_frame (convert, inframe, outframe);
+  gst_video_converter_free (convert);
+}
+
+GST_START_TEST (test_video_convert_tone_map)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoToneMapMethod method;
+  guint16 *in;
+  guint8 *out;
+  guint8 plain_100;
+  gint i;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_ARGB64,
+          258, 1));
+  ininfo.colorimetry.transfer = GST_VIDEO_TRANSFER_SMPTE2084;
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_ARGB,
+          258, 1));
+  outinfo.colorimetry.transfer = GST_VIDEO_TRANSFER_BT709;
+  outinfo.colorimetry.primaries = ininfo.colorimetry.primaries;
+
+  /* 100 cd/m^2, 1000 cd/m^2 and a ramp over all PQ code values */
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+  in = GST_VIDEO_FRAME_PLANE_DATA (&inframe, 0);
+  for (i = 0; i < 258; i++) {
+    guint16 val;
+
+    if (i == 0)
+      val = rint (gst_video_transfer_function_encode
+          (GST_VIDEO_TRANSFER_SMPTE2084, 0.01) * 65535.0);
+    else if (i == 1)
+      val = rint (gst_video_transfer_function_encode
+          (GST_VIDEO_TRANSFER_SMPTE2084, 0.1) * 65535.0);
+    else
+      val = (i - 2) * 257;
+
+    in[i * 4 + 0] = 0xffff;
+    in[i * 4 + 1] = in[i * 4 + 2] = in[i * 4 + 3] = val;
+  }
+
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+  out = GST_VIDEO_FRAME_PLANE_DATA (&outframe, 0);
+
+  /* without tone mapping 1.0 is 10000 cd/m^2 and 100 cd/m^2 is dark */
+  convert_pq_line (&inframe, &outframe, GST_VIDEO_TONE_MAP_METHOD_NONE);
+  plain_100 = out[0 * 4 + 1];
+  fail_unless (plain_100 < 32);
+
+  for (method = GST_VIDEO_TONE_MAP_METHOD_BT2390;
+      method <= GST_VIDEO_TONE_MAP_METHOD_HABLE; method++) {
+    convert_pq_line (&inframe, &outframe, method);
+
+    /* the source peak is mapped to white and 100 cd/m^2 below it */
+    fail_unless_equals_int (out[1 * 4 + 1], 255);
+    fail_unless (out[0 * 4 + 1] > plain_100);
+    fail_unless (out[0 * 4 + 1] > 128 && out[0 * 4 + 1] < 255);
+
+    /* the ramp stays gray and monotonic */
+    for (i = 2; i < 258; i++) {
+      fail_unless_equals_int (out[i * 4 + 1], out[i * 4 + 2]);
+      fail_unless_equals_int (out[i * 4 + 1], out[i * 4 + 3]);
+      if (i > 2)
+        fail_unless (out[i * 4 + 1] >= out[(i - 1) * 4 + 1]);
+    }
+    fail_unless_equals_int (out[2 * 4 + 1], 0);
+    fail_unless_equals_int (out[257 * 4 + 1], 255);
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+static const gchar *
+check_fastpath_name (GstVideoFormat in_format, gint in_width, gint in_height,
+    GstVideoFormat out_format, gint out_width, gint out_height,
+    GstStructure * options)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoConverter *convert;
+  static gchar name[64];
+  const gchar *fastpath;
+
+  fail_unless (gst_video_info_set_format (&ininfo, in_format, in_width,
+          in_height));
+  fail_unless (gst_video_info_set_format (&outinfo, out_format, out_width,
+          out_height));
+
+  convert = gst_video_converter_new (&ininfo, &outinfo, options);
+  fastpath = gst_video_converter_get_fastpath_name (convert);
+  g_strlcpy (name, fastpath ? fastpath : "", sizeof (name));
+  gst_video_converter_free (convert);
+
+  return name;
+}
+
+GST_START_TEST (test_video_convert_fused)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  GstMapInfo info;
+  gsize i;
+
+  fail_unless_equals_string (check_fastpath_name (GST_VIDEO_FORMAT_NV12,
+          1920, 1080, GST_VIDEO_FORMAT_I420, 1280, 720, NULL),
+      "NV12-I420-fused-scale");
+  fail_unless_equals_string (check_fastpath_name (GST_VIDEO_FORMAT_UYVY,
+          1920, 1080, GST_VIDEO_FORMAT_NV12, 960, 540, NULL),
+      "UYVY-NV12-fused-scale");
+  fail_unless_equals_string (check_fastpath_name (GST_VIDEO_FORMAT_I420,
+          320, 240, GST_VIDEO_FORMAT_BGRx, 320, 240, NULL), "I420-BGRx");
+  fail_unless_equals_string (check_fastpath_name (GST_VIDEO_FORMAT_I420,
+          320, 240, GST_VIDEO_FORMAT_BGRx, 320, 240,
+          gst_structure_new ("options",
+              GST_VIDEO_CONVERTER_OPT_BLEND_OVERLAYS, G_TYPE_BOOLEAN, TRUE,
+              NULL)), "I420-BGRx-fused-blend");
+  /* generic path */
+  fail_unless_equals_string (check_fastpath_name (GST_VIDEO_FORMAT_I420,
+          320, 240, GST_VIDEO_FORMAT_Y42B, 160, 120, NULL), "");
+
+  /* a flat picture stays flat when scaled */
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_NV12,
+          1920, 1080));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_memset (inbuffer, 0, 0x40, -1);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_I420,
+          1280, 720));
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_buffer_memset (outbuffer, 0, 0x00, -1);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 4, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+
+  gst_buffer_map (outbuffer, &info, GST_MAP_READ);
+  for (i = 0; i < info.size; i++)
+    fail_unless_equals_int (info.data[i], 0x40);
+  gst_buffer_unmap (outbuffer, &info);
+
+  gst_buffer_unref (outbuffer);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+#define FRAME_LINE(frame, plane, line) \
+  ((guint16 *) ((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (frame, plane) + \
+      (line) * GST_VIDEO_FRAME_PLANE_STRIDE (frame, plane)))
+
+GST_START_TEST (test_video_convert_10bit)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  const GstVideoFormatInfo *finfo;
+  guint16 *line;
+  gint i, j;
+
+  fail_unless_equals_string (check_fastpath_name (GST_VIDEO_FORMAT_P010_10LE,
+          38, 10, GST_VIDEO_FORMAT_I420_10LE, 38, 10, NULL),
+      "P010_10LE-I420_10LE");
+  fail_unless_equals_string (check_fastpath_name (GST_VIDEO_FORMAT_v210,
+          38, 10, GST_VIDEO_FORMAT_P010_10LE, 38, 10, NULL),
+      "v210-P010_10LE");
+
+  /* P010 -> I420_10LE only moves the samples to the low bits */
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_P010_10LE,
+          38, 10));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+  for (i = 0; i < 10; i++) {
+    line = FRAME_LINE (&inframe, 0, i);
+    for (j = 0; j < 38; j++)
+      GST_WRITE_UINT16_LE (line + j, ((i * 38 + j) & 0x3ff) << 6);
+    if (i % 2 == 0) {
+      line = FRAME_LINE (&inframe, 1, i / 2);
+      for (j = 0; j < 38; j++)
+        GST_WRITE_UINT16_LE (line + j, ((i * 19 + j * 5) & 0x3ff) << 6);
+    }
+  }
+
+  fail_unless (gst_video_info_set_format (&outinfo,
+          GST_VIDEO_FORMAT_I420_10LE, 38, 10));
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 3, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  for (i = 0; i < 10; i++) {
+    line = FRAME_LINE (&outframe, 0, i);
+    for (j = 0; j < 38; j++)
+      fail_unless_equals_int (GST_READ_UINT16_LE (line + j),
+          (i * 38 + j) & 0x3ff);
+  }
+  for (i = 0; i < 5; i++) {
+    guint16 *u = FRAME_LINE (&outframe, 1, i);
+    guint16 *v = FRAME_LINE (&outframe, 2, i);
+
+    for (j = 0; j < 19; j++) {
+      fail_unless_equals_int (GST_READ_UINT16_LE (u + j),
+          i * 2 * 19 + 2 * j * 5);
+      fail_unless_equals_int (GST_READ_UINT16_LE (v + j),
+          i * 2 * 19 + (2 * j + 1) * 5);
+    }
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+
+  /* v210 -> P010 keeps the 10 bits and merges the chroma of two lines */
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_v210,
+          38, 10));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_WRITE);
+  finfo = ininfo.finfo;
+  line = g_new0 (guint16, 4 * 48);
+  for (i = 0; i < 10; i++) {
+    for (j = 0; j < 38; j++) {
+      line[4 * j + 0] = 0xffff;
+      line[4 * j + 1] = ((i * 38 + j) & 0x3ff) << 6;
+      line[4 * j + 2] = ((i * 8 + (j & ~1)) & 0x3ff) << 6;
+      line[4 * j + 3] = ((i * 4 + 0x200) & 0x3ff) << 6;
+    }
+    finfo->pack_func (finfo, GST_VIDEO_PACK_FLAG_NONE, line, 0,
+        inframe.data, inframe.info.stride, GST_VIDEO_CHROMA_SITE_UNKNOWN, i,
+        38);
+  }
+  g_free (line);
+
+  fail_unless (gst_video_info_set_format (&outinfo,
+          GST_VIDEO_FORMAT_P010_10LE, 38, 10));
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 3, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  for (i = 0; i < 10; i++) {
+    line = FRAME_LINE (&outframe, 0, i);
+    for (j = 0; j < 38; j++)
+      fail_unless_equals_int (GST_READ_UINT16_LE (line + j),
+          ((i * 38 + j) & 0x3ff) << 6);
+  }
+  for (i = 0; i < 5; i++) {
+    line = FRAME_LINE (&outframe, 1, i);
+    for (j = 0; j < 19; j++) {
+      fail_unless_equals_int (GST_READ_UINT16_LE (line + 2 * j),
+          (((i * 16 + 2 * j) + (i * 16 + 8 + 2 * j)) / 2) << 6);
+      fail_unless_equals_int (GST_READ_UINT16_LE (line + 2 * j + 1),
+          (((i * 8 + 0x200) + (i * 8 + 4 + 0x200)) / 2) << 6);
+    }
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
+typedef struct
+{
+  gint count;
+  guint worker;
+} TaskRunnerData;
+
+static void
+task_runner_func (TaskRunnerData * data, guint worker)
+{
+  g_atomic_int_inc (&data->count);
+  data->worker = worker;
+}
+
+static void
+check_task_runner (gboolean async_tasks)
+{
+  GstVideoTaskRunner *runner;
+  TaskRunnerData data[64];
+  gpointer data_p[64];
+  GstStructure *stats;
+  guint64 runs, tasks;
+  guint i, n_workers;
+
+  runner = gst_video_task_runner_new (4, NULL, async_tasks);
+  n_workers = gst_video_task_runner_get_n_workers (runner);
+  fail_unless (n_workers >= 1 && n_workers <= 4);
+  fail_unless (gst_video_task_runner_get_n_stripes (runner, 1080, 200) <= 5);
+  fail_unless_equals_int (gst_video_task_runner_get_n_stripes (runner, 10,
+          200), 1);
+
+  for (i = 0; i < G_N_ELEMENTS (data); i++) {
+    data[i].count = 0;
+    data[i].worker = G_MAXUINT;
+    data_p[i] = &data[i];
+  }
+
+  gst_video_task_runner_run (runner, (GstVideoTaskFunc) task_runner_func,
+      data_p, G_N_ELEMENTS (data));
+  if (async_tasks)
+    gst_video_task_runner_finish (runner);
+
+  for (i = 0; i < G_N_ELEMENTS (data); i++) {
+    fail_unless_equals_int (data[i].count, 1);
+    fail_unless (data[i].worker < n_workers);
+  }
+
+  stats = gst_video_task_runner_get_stats (runner);
+  fail_unless (gst_structure_get_uint64 (stats, "runs", &runs));
+  fail_unless (gst_structure_get_uint64 (stats, "tasks", &tasks));
+  fail_unless_equals_uint64 (runs, 1);
+  fail_unless_equals_uint64 (tasks, G_N_ELEMENTS (data));
+  fail_unless (gst_structure_has_field (stats, "cpu-time"));
+  gst_structure_free (stats);
+
+  gst_video_task_runner_free (runner);
+}
+
+GST_START_TEST (test_video_task_runner)
+{
+  check_task_runner (FALSE);
+  check_task_runner (TRUE);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -4036,6 +4707,7 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_chroma);
   tcase_add_test (tc_chain, test_video_chroma_site);
   tcase_add_test (tc_chain, test_video_scaler);
+  tcase_add_test (tc_chain, test_video_scaler_shared_taps);
   tcase_add_test (tc_chain, test_video_color_convert_rgb_rgb);
   tcase_add_test (tc_chain, test_video_color_convert_rgb_yuv);
   tcase_add_test (tc_chain, test_video_color_convert_yuv_yuv);
@@ -4044,6 +4716,14 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
   tcase_add_test (tc_chain, test_video_convert_multithreading);
+  tcase_add_test (tc_chain, test_video_convert_small_planes);
+  tcase_add_test (tc_chain, test_video_convert_frame_sequence);
+  tcase_add_test (tc_chain, test_video_convert_async);
+  tcase_add_test (tc_chain, test_video_convert_fused);
+  tcase_add_test (tc_chain, test_video_convert_10bit);
+  tcase_add_test (tc_chain, test_video_convert_scale_tiles);
+  tcase_add_test (tc_chain, test_video_convert_tone_map);
+  tcase_add_test (tc_chain, test_video_task_runner);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
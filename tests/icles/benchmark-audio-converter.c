@@ -0,0 +1,172 @@
+/* GStreamer audio converter benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Runs some common conversions once with all frames going through each
+ * conversion step at once and once in cache sized blocks and prints the
+ * time per frame for both. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_DURATION 1.0
+#define DEFAULT_FRAMES 8192
+
+static const struct
+{
+  const gchar *name;
+  GstAudioFormat in_format;
+  gint in_rate, in_channels;
+  GstAudioFormat out_format;
+  gint out_rate, out_channels;
+  GstAudioDitherMethod dither;
+} conversions[] = {
+  {"S16 stereo -> F32 5.1", GST_AUDIO_FORMAT_S16, 48000, 2,
+      GST_AUDIO_FORMAT_F32, 48000, 6, GST_AUDIO_DITHER_NONE},
+  {"S24_32 -> S16 tpdf", GST_AUDIO_FORMAT_S24_32, 48000, 2,
+      GST_AUDIO_FORMAT_S16, 48000, 2, GST_AUDIO_DITHER_TPDF},
+  {"F32 5.1 -> S16 stereo", GST_AUDIO_FORMAT_F32, 48000, 6,
+      GST_AUDIO_FORMAT_S16, 48000, 2, GST_AUDIO_DITHER_TPDF},
+  {"S16 44.1k -> F32 48k", GST_AUDIO_FORMAT_S16, 44100, 2,
+      GST_AUDIO_FORMAT_F32, 48000, 2, GST_AUDIO_DITHER_NONE},
+  {"F32 7.1 -> S16 stereo 44.1k", GST_AUDIO_FORMAT_F32, 48000, 8,
+      GST_AUDIO_FORMAT_S16, 44100, 2, GST_AUDIO_DITHER_TPDF},
+};
+
+static gdouble
+do_benchmark (guint c, guint block_frames, gsize in_frames,
+    gdouble max_duration)
+{
+  GstAudioConverter *convert;
+  GstAudioInfo in_info, out_info;
+  guint8 *in, *out;
+  gpointer in_p[1], out_p[1];
+  gsize i, in_size, out_frames, total;
+  GTimer *timer;
+  gdouble elapsed;
+
+  gst_audio_info_set_format (&in_info, conversions[c].in_format,
+      conversions[c].in_rate, conversions[c].in_channels, NULL);
+  gst_audio_info_set_format (&out_info, conversions[c].out_format,
+      conversions[c].out_rate, conversions[c].out_channels, NULL);
+
+  convert = gst_audio_converter_new (GST_AUDIO_CONVERTER_FLAG_NONE, &in_info,
+      &out_info, gst_structure_new ("options",
+          GST_AUDIO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_AUDIO_DITHER_METHOD,
+          conversions[c].dither, GST_AUDIO_CONVERTER_OPT_BLOCK_FRAMES,
+          G_TYPE_UINT, block_frames, NULL));
+
+  in_size = in_frames * in_info.bpf;
+  in = g_malloc (in_size);
+  out = g_malloc (2 * in_frames * out_info.bpf);
+  in_p[0] = in;
+  out_p[0] = out;
+
+  /* low level noise */
+  for (i = 0; i < in_frames * in_info.channels; i++) {
+    switch (conversions[c].in_format) {
+      case GST_AUDIO_FORMAT_S16:
+        ((gint16 *) in)[i] = g_random_int_range (-8192, 8192);
+        break;
+      case GST_AUDIO_FORMAT_S24_32:
+        ((gint32 *) in)[i] = g_random_int_range (-(1 << 21), 1 << 21);
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        ((gfloat *) in)[i] = g_random_double_range (-0.25, 0.25);
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  }
+
+  timer = g_timer_new ();
+  total = 0;
+  while (TRUE) {
+    out_frames = gst_audio_converter_get_out_frames (convert, in_frames);
+    gst_audio_converter_samples (convert, GST_AUDIO_CONVERTER_FLAG_NONE,
+        in_p, in_frames, out_p, out_frames);
+    total += in_frames;
+
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+
+  g_timer_destroy (timer);
+  g_free (out);
+  g_free (in);
+  gst_audio_converter_free (convert);
+
+  return elapsed * 1e9 / total;
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gdouble max_dur = DEFAULT_DURATION;
+  gint frames = DEFAULT_FRAMES;
+  gint block_frames = -1;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each configuration (in seconds)", NULL},
+    {"frames", 'f', 0, G_OPTION_ARG_INT, &frames,
+        "Number of frames to convert per call", NULL},
+    {"block-frames", 'b', 0, G_OPTION_ARG_INT, &block_frames,
+        "Number of frames per block (default: automatic)", NULL},
+    {NULL}
+  };
+  guint c;
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (frames < 1) {
+    g_printerr ("Invalid number of frames %d\n", frames);
+    return 1;
+  }
+
+  gst_println ("%d frames per call", frames);
+  gst_println ("%-30s %12s %12s %8s", "conversion", "whole ns/f",
+      "blocks ns/f", "speedup");
+
+  for (c = 0; c < G_N_ELEMENTS (conversions); c++) {
+    gdouble whole, blocks;
+
+    whole = do_benchmark (c, 0, frames, max_dur);
+    blocks = do_benchmark (c, (guint) block_frames, frames, max_dur);
+
+    gst_println ("%-30s %12.2f %12.2f %7.2fx", conversions[c].name, whole,
+        blocks, whole / blocks);
+  }
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+/* GStreamer audiomixer scaling benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Mixes 2 to 128 inputs with audiomixer and prints the time per mixed input
+ * sample. Use --volume to measure the volume path instead of the unity gain
+ * path. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+
+#define DEFAULT_BUFFERS 1000
+#define DEFAULT_VOLUME 1.0
+#define SAMPLES_PER_BUFFER 1024
+#define CHANNELS 2
+
+static const gchar *formats[] = { "S16LE", "S32LE", "F32LE" };
+
+static void
+do_benchmark (const gchar * format, guint n_inputs, gint n_buffers,
+    gdouble volume)
+{
+  GstElement *pipeline, *mixer;
+  GstBus *bus;
+  GstMessage *msg;
+  GString *desc;
+  GTimer *timer;
+  gdouble elapsed;
+  GError *err = NULL;
+  guint i;
+
+  desc = g_string_new ("audiomixer name=mix ! fakesink sync=false");
+  for (i = 0; i < n_inputs; i++) {
+    g_string_append_printf (desc, " audiotestsrc wave=white-noise volume=0.1 "
+        "num-buffers=%d samplesperbuffer=%d ! "
+        "audio/x-raw,format=%s,channels=%d,rate=48000 ! mix.sink_%u",
+        n_buffers, SAMPLES_PER_BUFFER, format, CHANNELS, i);
+  }
+
+  pipeline = gst_parse_launch (desc->str, &err);
+  g_string_free (desc, TRUE);
+  if (!pipeline) {
+    g_printerr ("Failed to create pipeline: %s\n", err->message);
+    g_clear_error (&err);
+    return;
+  }
+
+  if (volume != 1.0) {
+    mixer = gst_bin_get_by_name (GST_BIN (pipeline), "mix");
+    for (i = 0; i < n_inputs; i++) {
+      gchar *name = g_strdup_printf ("sink_%u", i);
+      GstPad *pad = gst_element_get_static_pad (mixer, name);
+
+      g_object_set (pad, "volume", volume, NULL);
+      gst_object_unref (pad);
+      g_free (name);
+    }
+    gst_object_unref (mixer);
+  }
+
+  /* preroll first so that the setup is not measured */
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+  timer = g_timer_new ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  elapsed = g_timer_elapsed (timer, NULL);
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    gst_message_parse_error (msg, &err, NULL);
+    g_printerr ("Error: %s\n", err->message);
+    g_clear_error (&err);
+  } else {
+    gst_println ("%8.2f ns/sample %-5s %3u inputs %8.2f ms", elapsed * 1e9 /
+        ((gdouble) n_buffers * SAMPLES_PER_BUFFER * CHANNELS * n_inputs),
+        format, n_inputs, elapsed * 1000.0);
+  }
+
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+  g_timer_destroy (timer);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gint n_buffers = DEFAULT_BUFFERS;
+  gdouble volume = DEFAULT_VOLUME;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"buffers", 'b', 0, G_OPTION_ARG_INT, &n_buffers,
+        "Number of buffers to mix per input", NULL},
+    {"volume", 'v', 0, G_OPTION_ARG_DOUBLE, &volume,
+        "Volume of the input pads", NULL},
+    {NULL}
+  };
+  guint i, n_inputs;
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (n_buffers < 1) {
+    g_printerr ("Invalid number of buffers %d\n", n_buffers);
+    return 1;
+  }
+
+  gst_println ("%d buffers of %d samples, volume %.2f", n_buffers,
+      SAMPLES_PER_BUFFER, volume);
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++)
+    for (n_inputs = 2; n_inputs <= 128; n_inputs *= 2)
+      do_benchmark (formats[i], n_inputs, n_buffers, volume);
+
+  return 0;
+}
@@ -0,0 +1,142 @@
+/* GStreamer audio quantize benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Quantizes 24 bit samples in a 32 bit container to 16 bits with each
+ * dither and noise shaping method and prints the time per frame. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_DURATION 1.0
+#define DEFAULT_FRAMES 4096
+#define DEFAULT_CHANNELS 2
+
+static gdouble
+do_benchmark (GstAudioDitherMethod dither, GstAudioNoiseShapingMethod ns,
+    gint channels, gint frames, gdouble max_duration)
+{
+  GstAudioQuantize *quant;
+  gint32 *in, *out;
+  gpointer in_p[1], out_p[1];
+  gsize total;
+  GTimer *timer;
+  gdouble elapsed;
+  gint i;
+
+  quant = gst_audio_quantize_new (dither, ns, GST_AUDIO_QUANTIZE_FLAG_NONE,
+      GST_AUDIO_FORMAT_S32, channels, 1 << 16);
+
+  in = g_new (gint32, frames * channels);
+  out = g_new (gint32, frames * channels);
+  in_p[0] = in;
+  out_p[0] = out;
+
+  for (i = 0; i < frames * channels; i++)
+    in[i] = g_random_int_range (-(1 << 23), 1 << 23) * 256;
+
+  timer = g_timer_new ();
+  total = 0;
+  while (TRUE) {
+    gst_audio_quantize_samples (quant, in_p, out_p, frames);
+    total += frames;
+
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+
+  g_timer_destroy (timer);
+  g_free (out);
+  g_free (in);
+  gst_audio_quantize_free (quant);
+
+  return elapsed * 1e9 / total;
+}
+
+static const gchar *
+enum_nick (GType type, gint value)
+{
+  GEnumClass *klass = g_type_class_ref (type);
+  const gchar *nick = g_enum_get_value (klass, value)->value_nick;
+
+  g_type_class_unref (klass);
+
+  return nick;
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gdouble max_dur = DEFAULT_DURATION;
+  gint frames = DEFAULT_FRAMES;
+  gint channels = DEFAULT_CHANNELS;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each configuration (in seconds)", NULL},
+    {"frames", 'f', 0, G_OPTION_ARG_INT, &frames,
+        "Number of frames to quantize per call", NULL},
+    {"channels", 'c', 0, G_OPTION_ARG_INT, &channels,
+        "Number of channels", NULL},
+    {NULL}
+  };
+  GstAudioNoiseShapingMethod ns;
+  GstAudioDitherMethod dither;
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (frames < 1 || channels < 1) {
+    g_printerr ("Invalid number of frames %d or channels %d\n", frames,
+        channels);
+    return 1;
+  }
+
+  gst_println ("%d frames of %d channels per call, ns/frame", frames,
+      channels);
+  gst_print ("%-16s", "noise shaping");
+  for (dither = GST_AUDIO_DITHER_NONE; dither <= GST_AUDIO_DITHER_TPDF_HF;
+      dither++)
+    gst_print (" %10s", enum_nick (GST_TYPE_AUDIO_DITHER_METHOD, dither));
+  gst_println ("");
+
+  for (ns = GST_AUDIO_NOISE_SHAPING_NONE; ns <= GST_AUDIO_NOISE_SHAPING_HIGH;
+      ns++) {
+    gst_print ("%-16s", enum_nick (GST_TYPE_AUDIO_NOISE_SHAPING_METHOD, ns));
+    for (dither = GST_AUDIO_DITHER_NONE; dither <= GST_AUDIO_DITHER_TPDF_HF;
+        dither++)
+      gst_print (" %10.2f", do_benchmark (dither, ns, channels, frames,
+              max_dur));
+    gst_println ("");
+  }
+
+  return 0;
+}
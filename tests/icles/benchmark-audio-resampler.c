@@ -0,0 +1,184 @@
+/* GStreamer audio resampler kernel benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Resamples 48 channels from 44100 to 48000 Hz with the full and the
+ * interpolated filter tables and prints the time per output sample. Run with
+ * GST_AUDIO_RESAMPLER_NO_AVX=1 in the environment to measure the SSE kernels
+ * instead of the AVX2/AVX-512 ones for comparison. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+#include <x86intrin.h>
+#define HAVE_RDTSC
+#endif
+
+#define DEFAULT_DURATION 1.0
+#define DEFAULT_CHANNELS 48
+
+#define IN_RATE 44100
+#define OUT_RATE 48000
+#define IN_FRAMES 1024
+
+static const GstAudioFormat formats[] = {
+  GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32,
+  GST_AUDIO_FORMAT_F32, GST_AUDIO_FORMAT_F64
+};
+
+static const struct
+{
+  const gchar *name;
+  GstAudioResamplerFilterMode mode;
+} modes[] = {
+  {"full", GST_AUDIO_RESAMPLER_FILTER_MODE_FULL},
+  {"interpolated", GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED},
+};
+
+static void
+do_benchmark (GstAudioFormat format, guint m, gint channels,
+    gdouble max_duration)
+{
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  GstAudioResampler *resampler;
+  GstStructure *options;
+  guint8 *in, *out;
+  gpointer in_p[1], out_p[1];
+  gsize in_size, out_frames, out_samples;
+  GTimer *timer;
+  gdouble elapsed;
+#ifdef HAVE_RDTSC
+  guint64 start_tsc, tsc;
+#endif
+  gsize i;
+
+  options = gst_structure_new_empty ("options");
+  gst_structure_set (options, GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE, modes[m].mode, NULL);
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, channels, IN_RATE, OUT_RATE,
+      options);
+  gst_structure_free (options);
+
+  in_size = IN_FRAMES * channels * (finfo->width / 8);
+  in = g_malloc (in_size);
+  out = g_malloc (2 * in_size);
+  in_p[0] = in;
+  out_p[0] = out;
+
+  /* low level noise */
+  for (i = 0; i < IN_FRAMES * channels; i++) {
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        ((gint16 *) in)[i] = g_random_int_range (-8192, 8192);
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        ((gint32 *) in)[i] = g_random_int_range (-(1 << 29), 1 << 29);
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        ((gfloat *) in)[i] = g_random_double_range (-0.25, 0.25);
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        ((gdouble *) in)[i] = g_random_double_range (-0.25, 0.25);
+        break;
+      default:
+        break;
+    }
+  }
+
+  /* warmup, this also fills the history */
+  out_frames = gst_audio_resampler_get_out_frames (resampler, IN_FRAMES);
+  gst_audio_resampler_resample (resampler, in_p, IN_FRAMES, out_p, out_frames);
+
+  timer = g_timer_new ();
+#ifdef HAVE_RDTSC
+  start_tsc = __rdtsc ();
+#endif
+  out_samples = 0;
+  while (TRUE) {
+    out_frames = gst_audio_resampler_get_out_frames (resampler, IN_FRAMES);
+    gst_audio_resampler_resample (resampler, in_p, IN_FRAMES, out_p,
+        out_frames);
+    out_samples += out_frames * channels;
+
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+#ifdef HAVE_RDTSC
+  tsc = __rdtsc () - start_tsc;
+  gst_println ("%8.2f ns/sample %8.2f cycles/sample %-4s %-12s",
+      elapsed * 1e9 / out_samples, (gdouble) tsc / out_samples,
+      gst_audio_format_to_string (format), modes[m].name);
+#else
+  gst_println ("%8.2f ns/sample %-4s %-12s", elapsed * 1e9 / out_samples,
+      gst_audio_format_to_string (format), modes[m].name);
+#endif
+
+  g_timer_destroy (timer);
+  g_free (out);
+  g_free (in);
+  gst_audio_resampler_free (resampler);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gdouble max_dur = DEFAULT_DURATION;
+  gint channels = DEFAULT_CHANNELS;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each configuration (in seconds)", NULL},
+    {"channels", 'c', 0, G_OPTION_ARG_INT, &channels,
+        "Number of channels to resample", NULL},
+    {NULL}
+  };
+  guint i, m;
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (channels < 1) {
+    g_printerr ("Invalid number of channels %d\n", channels);
+    return 1;
+  }
+
+  gst_println ("kernels: %s, %d channels, %d -> %d Hz",
+      g_getenv ("GST_AUDIO_RESAMPLER_NO_AVX") ? "sse" : "default", channels,
+      IN_RATE, OUT_RATE);
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++)
+    for (m = 0; m < G_N_ELEMENTS (modes); m++)
+      do_benchmark (formats[i], m, channels, max_dur);
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+/* GStreamer typefind benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Typefinds the headers of some common formats, followed by random data,
+ * and prints the time per file and the detected caps. Files given on the
+ * command line are added to the corpus, only their first bytes are used. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/base/gsttypefindhelper.h>
+
+#define DEFAULT_DURATION 0.5
+#define DEFAULT_HEADER_SIZE 4096
+
+static const struct
+{
+  const gchar *name;
+  const gchar *header;
+  gsize header_size;
+} headers[] = {
+  {"png", "\211PNG\015\012\032\012\000\000\000\015IHDR", 16},
+  {"gif", "GIF89a", 6},
+  {"flv", "FLV\001\005\000\000\000\011", 9},
+  {"asf", "\060\046\262\165\216\146\317\021\246\331\000\252\000\142\316\154",
+      16},
+  {"wav", "RIFF\044\000\001\000WAVEfmt ", 16},
+  {"avi", "RIFF\044\000\001\000AVI LIST", 16},
+  {"ogg", "OggS\000\002", 6},
+  {"matroska", "\032\105\337\243\243\102\202\210matroska", 16},
+  {"mp4", "\000\000\000\030ftypmp42\000\000\000\000mp42isom", 24},
+  {"id3", "ID3\004\000\000\000\000\000\000", 10},
+  {"random", "", 0},
+};
+
+static gdouble
+do_benchmark (const guint8 * data, gsize size, gdouble max_duration,
+    GstCaps ** caps)
+{
+  GstTypeFindProbability prob;
+  GTimer *timer;
+  gdouble elapsed;
+  gsize total = 0;
+
+  timer = g_timer_new ();
+  while (TRUE) {
+    GstCaps *res = gst_type_find_helper_for_data (NULL, data, size, &prob);
+
+    gst_caps_replace (caps, res);
+    gst_clear_caps (&res);
+    total++;
+
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+  g_timer_destroy (timer);
+
+  return elapsed * 1e6 / total;
+}
+
+static void
+print_result (const gchar * name, gdouble us, GstCaps * caps)
+{
+  gchar *desc = caps ? gst_caps_to_string (caps) : g_strdup ("-");
+
+  gst_println ("%-24s %10.2f  %s", name, us, desc);
+  g_free (desc);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gdouble max_dur = DEFAULT_DURATION;
+  gint header_size = DEFAULT_HEADER_SIZE;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each file (in seconds)", NULL},
+    {"size", 's', 0, G_OPTION_ARG_INT, &header_size,
+        "Number of bytes to typefind per file", NULL},
+    {NULL}
+  };
+  gdouble sum = 0.0;
+  guint8 *data;
+  guint i, n = 0;
+  gint a;
+
+  ctx = g_option_context_new ("[FILE...]");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (header_size < 64) {
+    g_printerr ("Invalid size %d\n", header_size);
+    return 1;
+  }
+
+  data = g_malloc (header_size);
+
+  gst_println ("%-24s %10s  %s", "file", "us/file", "caps");
+
+  for (i = 0; i < G_N_ELEMENTS (headers); i++) {
+    GstCaps *caps = NULL;
+    gint j;
+    gdouble us;
+
+    for (j = 0; j < header_size; j++)
+      data[j] = g_random_int_range (0, 256);
+    memcpy (data, headers[i].header, headers[i].header_size);
+
+    us = do_benchmark (data, header_size, max_dur, &caps);
+    print_result (headers[i].name, us, caps);
+    gst_clear_caps (&caps);
+    sum += us;
+    n++;
+  }
+
+  for (a = 1; a < argc; a++) {
+    GstCaps *caps = NULL;
+    gchar *contents;
+    gsize len;
+    gdouble us;
+
+    if (!g_file_get_contents (argv[a], &contents, &len, &err)) {
+      g_printerr ("Could not read %s: %s\n", argv[a], err->message);
+      g_clear_error (&err);
+      continue;
+    }
+
+    us = do_benchmark ((const guint8 *) contents, MIN (len, header_size),
+        max_dur, &caps);
+    print_result (argv[a], us, caps);
+    gst_clear_caps (&caps);
+    g_free (contents);
+    sum += us;
+    n++;
+  }
+
+  gst_println ("%-24s %10.2f", "average", sum / n);
+
+  g_free (data);
+
+  return 0;
+}
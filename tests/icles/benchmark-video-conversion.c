@@ -22,6 +22,8 @@
 #include "config.h"
 #endif
 
+#include <stdio.h>
+
 #include <gst/gst.h>
 #include <gst/video/video.h>
 
@@ -30,6 +32,14 @@
 
 #define DEFAULT_DURATION 2.0
 
+typedef struct
+{
+  guint width, height;
+} Size;
+
+static gboolean json = FALSE;
+static gboolean json_first = TRUE;
+
 static gint
 get_num_formats (void)
 {
@@ -41,9 +51,102 @@ get_num_formats (void)
   return num_formats + 1;
 }
 
+/* parses a comma separated list of WIDTHxHEIGHT */
+static GArray *
+parse_sizes (const gchar * str)
+{
+  GArray *sizes = g_array_new (FALSE, FALSE, sizeof (Size));
+  gchar **items;
+  guint i;
+
+  items = g_strsplit (str, ",", -1);
+  for (i = 0; items[i] != NULL; i++) {
+    Size size;
+
+    if (sscanf (items[i], "%ux%u", &size.width, &size.height) != 2
+        || size.width == 0 || size.height == 0) {
+      g_printerr ("Invalid size '%s'\n", items[i]);
+      g_array_unref (sizes);
+      sizes = NULL;
+      break;
+    }
+    g_array_append_val (sizes, size);
+  }
+  g_strfreev (items);
+
+  return sizes;
+}
+
+/* parses a comma separated list of thread counts */
+static GArray *
+parse_threads (const gchar * str)
+{
+  GArray *threads = g_array_new (FALSE, FALSE, sizeof (guint));
+  gchar **items;
+  guint i;
+
+  items = g_strsplit (str, ",", -1);
+  for (i = 0; items[i] != NULL; i++) {
+    guint64 n;
+    guint n_threads;
+
+    if (!g_ascii_string_to_unsigned (items[i], 10, 1, 256, &n, NULL)) {
+      g_printerr ("Invalid thread count '%s'\n", items[i]);
+      g_array_unref (threads);
+      threads = NULL;
+      break;
+    }
+    n_threads = n;
+    g_array_append_val (threads, n_threads);
+  }
+  g_strfreev (items);
+
+  return threads;
+}
+
 static void
-do_benchmark_conversions (guint width, guint height, const gchar * in_format,
-    const gchar * out_format, gdouble max_duration)
+print_result (const gchar * infmt_str, const gchar * outfmt_str,
+    const GstVideoInfo * ininfo, const GstVideoInfo * outinfo, guint threads,
+    const gchar * fastpath, gint count, gdouble elapsed)
+{
+  gdouble convert_sec, mpixels_sec, bytes_pixel;
+  guint out_pixels;
+
+  out_pixels = GST_VIDEO_INFO_WIDTH (outinfo) * GST_VIDEO_INFO_HEIGHT (outinfo);
+  convert_sec = count / elapsed;
+  mpixels_sec = convert_sec * out_pixels / 1e6;
+  /* the minimum traffic: reading the input frame and writing the output
+   * frame once, per output pixel */
+  bytes_pixel = (gdouble) (ininfo->size + outinfo->size) / out_pixels;
+
+  if (!json) {
+    gst_println ("%8.1f conversions/sec %s -> %s @ %dx%d -> %dx%d, "
+        "%u threads, %.1f Mpixels/sec, %.2f bytes/pixel, %s, %d/%.5f",
+        convert_sec, infmt_str, outfmt_str, GST_VIDEO_INFO_WIDTH (ininfo),
+        GST_VIDEO_INFO_HEIGHT (ininfo), GST_VIDEO_INFO_WIDTH (outinfo),
+        GST_VIDEO_INFO_HEIGHT (outinfo), threads, mpixels_sec, bytes_pixel,
+        fastpath ? fastpath : "generic", count, elapsed);
+    return;
+  }
+
+  gst_print ("%s    {\"from\": \"%s\", \"to\": \"%s\", "
+      "\"in_width\": %d, \"in_height\": %d, "
+      "\"out_width\": %d, \"out_height\": %d, \"threads\": %u, "
+      "\"fastpath\": %s%s%s, \"count\": %d, \"elapsed\": %.5f, "
+      "\"conversions_per_sec\": %.3f, \"mpixels_per_sec\": %.3f, "
+      "\"bytes_per_pixel\": %.3f}", json_first ? "" : ",\n", infmt_str,
+      outfmt_str, GST_VIDEO_INFO_WIDTH (ininfo),
+      GST_VIDEO_INFO_HEIGHT (ininfo), GST_VIDEO_INFO_WIDTH (outinfo),
+      GST_VIDEO_INFO_HEIGHT (outinfo), threads, fastpath ? "\"" : "",
+      fastpath ? fastpath : "null", fastpath ? "\"" : "", count, elapsed,
+      convert_sec, mpixels_sec, bytes_pixel);
+  json_first = FALSE;
+}
+
+static void
+do_benchmark_conversions (guint width, guint height, gboolean scale,
+    GArray * threads, const gchar * in_format, const gchar * out_format,
+    gdouble max_duration)
 {
   const gchar *infmt_str, *outfmt_str;
   GstVideoFormat infmt, outfmt;
@@ -63,52 +166,71 @@ do_benchmark_conversions (guint width, guint height, const gchar * in_format,
     if (in_format != NULL && !g_str_equal (in_format, infmt_str))
       continue;
 
-    gst_video_info_set_format (&ininfo, infmt, width, height);
+    if (!gst_video_info_set_format (&ininfo, infmt, width, height))
+      continue;
     inbuffer = gst_buffer_new_and_alloc (ininfo.size);
     gst_buffer_memset (inbuffer, 0, 0, -1);
     gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
 
     for (outfmt = GST_VIDEO_FORMAT_I420; outfmt < num_formats; outfmt++) {
-      GstVideoInfo outinfo;
-      GstVideoFrame outframe;
-      GstBuffer *outbuffer;
-      GstVideoConverter *convert;
-      gdouble elapsed, convert_sec;
-      gint count;
+      guint s;
 
       outfmt_str = gst_video_format_to_string (outfmt);
       if (out_format != NULL && !g_str_equal (out_format, outfmt_str))
         continue;
 
-      /* Or maybe we should allocate more buffers to minimise cache effects? */
-      gst_video_info_set_format (&outinfo, outfmt, width, height);
-      outbuffer = gst_buffer_new_and_alloc (outinfo.size);
-      gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+      /* without scaling, and downscaling to 2/3 of the size */
+      for (s = 0; s < (scale ? 2 : 1); s++) {
+        GstVideoInfo outinfo;
+        GstVideoFrame outframe;
+        GstBuffer *outbuffer;
+        guint t;
 
-      convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
-      /* warmup */
-      gst_video_converter_frame (convert, &inframe, &outframe);
+        /* Or maybe we should allocate more buffers to minimise cache
+         * effects? */
+        if (!gst_video_info_set_format (&outinfo, outfmt,
+                s ? GST_ROUND_UP_2 (width * 2 / 3) : width,
+                s ? GST_ROUND_UP_2 (height * 2 / 3) : height))
+          continue;
+        outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+        gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
 
-      count = 0;
-      g_timer_start (timer);
-      while (TRUE) {
-        gst_video_converter_frame (convert, &inframe, &outframe);
+        for (t = 0; t < threads->len; t++) {
+          GstVideoConverter *convert;
+          gdouble elapsed;
+          gint count;
 
-        count++;
-        elapsed = g_timer_elapsed (timer, NULL);
-        if (elapsed >= max_duration)
-          break;
-      }
+          convert = gst_video_converter_new (&ininfo, &outinfo,
+              gst_structure_new ("options",
+                  GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT,
+                  g_array_index (threads, guint, t), NULL));
+          if (convert == NULL)
+            continue;
+
+          /* warmup */
+          gst_video_converter_frame (convert, &inframe, &outframe);
 
-      convert_sec = count / elapsed;
+          count = 0;
+          g_timer_start (timer);
+          while (TRUE) {
+            gst_video_converter_frame (convert, &inframe, &outframe);
 
-      gst_println ("%8.1f conversions/sec %s -> %s @ %ux%u, %d/%.5f",
-          convert_sec, infmt_str, outfmt_str, width, height, count, elapsed);
+            count++;
+            elapsed = g_timer_elapsed (timer, NULL);
+            if (elapsed >= max_duration)
+              break;
+          }
 
-      gst_video_converter_free (convert);
+          print_result (infmt_str, outfmt_str, &ininfo, &outinfo,
+              g_array_index (threads, guint, t),
+              gst_video_converter_get_fastpath_name (convert), count, elapsed);
 
-      gst_video_frame_unmap (&outframe);
-      gst_buffer_unref (outbuffer);
+          gst_video_converter_free (convert);
+        }
+
+        gst_video_frame_unmap (&outframe);
+        gst_buffer_unref (outbuffer);
+      }
     }
     gst_video_frame_unmap (&inframe);
     gst_buffer_unref (inbuffer);
@@ -126,17 +248,31 @@ main (int argc, char **argv)
   gdouble max_dur = DEFAULT_DURATION;
   gchar *from_fmt = NULL;
   gchar *to_fmt = NULL;
+  gchar *sizes_str = NULL;
+  gchar *threads_str = NULL;
+  gboolean scale = FALSE;
+  GArray *sizes, *threads;
   GOptionContext *ctx;
   GOptionEntry options[] = {
     {"width", 'w', 0, G_OPTION_ARG_INT, &width, "Width", NULL},
     {"height", 'h', 0, G_OPTION_ARG_INT, &height, "Height", NULL},
+    {"sizes", 's', 0, G_OPTION_ARG_STRING, &sizes_str,
+        "Comma separated list of sizes, overrides width and height",
+        "WxH,..."},
     {"from-format", 'f', 0, G_OPTION_ARG_STRING, &from_fmt, "From Format",
         NULL},
     {"to-format", 't', 0, G_OPTION_ARG_STRING, &to_fmt, "To Format", NULL},
+    {"scale", 0, 0, G_OPTION_ARG_NONE, &scale,
+        "Also run each conversion with scaling to 2/3 of the size", NULL},
+    {"threads", 'j', 0, G_OPTION_ARG_STRING, &threads_str,
+        "Comma separated list of thread counts", "N,..."},
+    {"json", 0, 0, G_OPTION_ARG_NONE, &json,
+        "Print the results as JSON", NULL},
     {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
         "Benchmark duration for each run (in seconds)", NULL},
     {NULL}
   };
+  guint i;
 
   ctx = g_option_context_new ("");
   g_option_context_add_main_entries (ctx, options, NULL);
@@ -149,6 +285,37 @@ main (int argc, char **argv)
   }
   g_option_context_free (ctx);
 
-  do_benchmark_conversions (width, height, from_fmt, to_fmt, max_dur);
+  if (sizes_str) {
+    sizes = parse_sizes (sizes_str);
+  } else {
+    Size size = { width, height };
+
+    sizes = g_array_new (FALSE, FALSE, sizeof (Size));
+    g_array_append_val (sizes, size);
+  }
+  threads = parse_threads (threads_str ? threads_str : "1");
+  if (sizes == NULL || threads == NULL)
+    return 1;
+
+  if (json)
+    gst_println ("{\n  \"results\": [");
+
+  for (i = 0; i < sizes->len; i++) {
+    Size *size = &g_array_index (sizes, Size, i);
+
+    do_benchmark_conversions (size->width, size->height, scale, threads,
+        from_fmt, to_fmt, max_dur);
+  }
+
+  if (json)
+    gst_println ("\n  ]\n}");
+
+  g_array_unref (threads);
+  g_array_unref (sizes);
+  g_free (threads_str);
+  g_free (sizes_str);
+  g_free (to_fmt);
+  g_free (from_fmt);
+
   return 0;
 }
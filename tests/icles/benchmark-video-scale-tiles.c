@@ -0,0 +1,155 @@
+/* GStreamer video scaling benchmark for column tiles
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define DEFAULT_DURATION 2.0
+
+static const struct
+{
+  const gchar *name;
+  guint in_width, in_height;
+  guint out_width, out_height;
+} sizes[] = {
+  {"4K", 3840, 2160, 2560, 1440},
+  {"8K", 7680, 4320, 3840, 2160},
+};
+
+static const guint tile_widths[] = { 0, 128, 256, 512 };
+
+static void
+do_benchmark_scale (const gchar * name, guint in_width, guint in_height,
+    guint out_width, guint out_height, const gchar * in_format,
+    const gchar * out_format, guint threads, gdouble max_duration)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GTimer *timer;
+  gdouble base = 0;
+  guint i;
+
+  timer = g_timer_new ();
+
+  gst_video_info_set_format (&ininfo, gst_video_format_from_string (in_format),
+      in_width, in_height);
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_memset (inbuffer, 0, 0x80, -1);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  gst_video_info_set_format (&outinfo,
+      gst_video_format_from_string (out_format), out_width, out_height);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  for (i = 0; i < G_N_ELEMENTS (tile_widths); i++) {
+    GstVideoConverter *convert;
+    gdouble elapsed, convert_sec;
+    gint count;
+
+    convert = gst_video_converter_new (&ininfo, &outinfo,
+        gst_structure_new ("options",
+            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+            GST_TYPE_VIDEO_RESAMPLER_METHOD,
+            GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+            GST_VIDEO_CONVERTER_OPT_SCALE_TILE_WIDTH, G_TYPE_UINT,
+            tile_widths[i], GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT,
+            threads, NULL));
+    /* warmup */
+    gst_video_converter_frame (convert, &inframe, &outframe);
+
+    count = 0;
+    g_timer_start (timer);
+    while (TRUE) {
+      gst_video_converter_frame (convert, &inframe, &outframe);
+
+      count++;
+      elapsed = g_timer_elapsed (timer, NULL);
+      if (elapsed >= max_duration)
+        break;
+    }
+
+    convert_sec = count / elapsed;
+    if (i == 0)
+      base = convert_sec;
+
+    gst_println ("%8.1f conversions/sec %s %s -> %s %ux%u -> %ux%u, "
+        "tile width %3u, %+.1f%%", convert_sec, name, in_format, out_format,
+        in_width, in_height, out_width, out_height, tile_widths[i],
+        (convert_sec / base - 1.0) * 100.0);
+
+    gst_video_converter_free (convert);
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+
+  g_timer_destroy (timer);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gdouble max_dur = DEFAULT_DURATION;
+  gchar *from_fmt = NULL;
+  gchar *to_fmt = NULL;
+  gint threads = 1;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"from-format", 'f', 0, G_OPTION_ARG_STRING, &from_fmt, "From Format",
+        NULL},
+    {"to-format", 't', 0, G_OPTION_ARG_STRING, &to_fmt, "To Format", NULL},
+    {"threads", 'j', 0, G_OPTION_ARG_INT, &threads, "Number of threads",
+        NULL},
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each run (in seconds)", NULL},
+    {NULL}
+  };
+  guint i;
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+    do_benchmark_scale (sizes[i].name, sizes[i].in_width, sizes[i].in_height,
+        sizes[i].out_width, sizes[i].out_height,
+        from_fmt ? from_fmt : "I420", to_fmt ? to_fmt : "AYUV64",
+        MAX (threads, 1), max_dur);
+  }
+
+  g_free (from_fmt);
+  g_free (to_fmt);
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+/* GStreamer video scaler kernel benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Runs the horizontal and vertical scaler kernels on 1080p lines. Run with
+ * GST_VIDEO_SCALER_NO_SIMD=1 in the environment to measure the ORC kernels
+ * instead of the x86 ones for comparison. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define DEFAULT_DURATION 1.0
+
+#define IN_WIDTH 1920
+#define IN_HEIGHT 1080
+#define OUT_WIDTH 1280
+#define OUT_HEIGHT 720
+
+static const struct
+{
+  const gchar *name;
+  gboolean vertical;
+  GstVideoFormat format;
+  guint pstride;
+  GstVideoResamplerMethod method;
+} kernels[] = {
+  {"h ntap u8", FALSE, GST_VIDEO_FORMAT_ARGB, 4,
+      GST_VIDEO_RESAMPLER_METHOD_LANCZOS},
+  {"h ntap u16", FALSE, GST_VIDEO_FORMAT_AYUV64, 8,
+      GST_VIDEO_RESAMPLER_METHOD_LANCZOS},
+  {"v 4tap u8", TRUE, GST_VIDEO_FORMAT_ARGB, 4,
+      GST_VIDEO_RESAMPLER_METHOD_CUBIC},
+  {"v ntap u8", TRUE, GST_VIDEO_FORMAT_ARGB, 4,
+      GST_VIDEO_RESAMPLER_METHOD_LANCZOS},
+  {"v ntap u16", TRUE, GST_VIDEO_FORMAT_AYUV64, 8,
+      GST_VIDEO_RESAMPLER_METHOD_LANCZOS},
+};
+
+static void
+scale_frame (GstVideoScaler * scale, gboolean vertical, GstVideoFormat format,
+    guint8 * src, guint src_stride, guint8 * dest, guint dest_stride,
+    gpointer * lines)
+{
+  guint i, j, in_offset, n_taps;
+
+  if (!vertical) {
+    for (i = 0; i < IN_HEIGHT; i++)
+      gst_video_scaler_horizontal (scale, format, src + i * src_stride,
+          dest + i * dest_stride, 0, OUT_WIDTH);
+    return;
+  }
+
+  for (i = 0; i < OUT_HEIGHT; i++) {
+    gst_video_scaler_get_coeff (scale, i, &in_offset, &n_taps);
+    for (j = 0; j < n_taps; j++)
+      lines[j] = src + MIN (in_offset + j, IN_HEIGHT - 1) * src_stride;
+    gst_video_scaler_vertical (scale, format, lines, dest + i * dest_stride,
+        i, IN_WIDTH);
+  }
+}
+
+static void
+do_benchmark_kernel (guint k, gdouble max_duration)
+{
+  GstVideoScaler *scale;
+  guint8 *src, *dest;
+  gpointer *lines;
+  guint src_stride, dest_stride, out_pixels;
+  GTimer *timer;
+  gdouble elapsed;
+  guint i;
+  gint count;
+
+  if (kernels[k].vertical) {
+    scale = gst_video_scaler_new (kernels[k].method, 0, 0, IN_HEIGHT,
+        OUT_HEIGHT, NULL);
+    src_stride = dest_stride = IN_WIDTH * kernels[k].pstride;
+    out_pixels = IN_WIDTH * OUT_HEIGHT;
+  } else {
+    scale = gst_video_scaler_new (kernels[k].method, 0, 0, IN_WIDTH,
+        OUT_WIDTH, NULL);
+    src_stride = IN_WIDTH * kernels[k].pstride;
+    dest_stride = OUT_WIDTH * kernels[k].pstride;
+    out_pixels = OUT_WIDTH * IN_HEIGHT;
+  }
+
+  src = g_malloc (src_stride * IN_HEIGHT);
+  for (i = 0; i < src_stride * IN_HEIGHT; i++)
+    src[i] = g_random_int ();
+  dest = g_malloc (dest_stride * IN_HEIGHT);
+  lines = g_new0 (gpointer, gst_video_scaler_get_max_taps (scale));
+
+  /* warmup */
+  scale_frame (scale, kernels[k].vertical, kernels[k].format, src,
+      src_stride, dest, dest_stride, lines);
+
+  timer = g_timer_new ();
+  count = 0;
+  while (TRUE) {
+    scale_frame (scale, kernels[k].vertical, kernels[k].format, src,
+        src_stride, dest, dest_stride, lines);
+
+    count++;
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+
+  gst_println ("%8.1f Mpixels/sec %-10s %-6s %u taps", (gdouble) count *
+      out_pixels / elapsed / 1e6, kernels[k].name,
+      gst_video_format_to_string (kernels[k].format),
+      gst_video_scaler_get_max_taps (scale));
+
+  g_timer_destroy (timer);
+  g_free (lines);
+  g_free (dest);
+  g_free (src);
+  gst_video_scaler_free (scale);
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gdouble max_dur = DEFAULT_DURATION;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
+        "Benchmark duration for each kernel (in seconds)", NULL},
+    {NULL}
+  };
+  guint i;
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  gst_println ("kernels: %s", g_getenv ("GST_VIDEO_SCALER_NO_SIMD") ?
+      "orc" : "default");
+
+  for (i = 0; i < G_N_ELEMENTS (kernels); i++)
+    do_benchmark_kernel (i, max_dur);
+
+  return 0;
+}
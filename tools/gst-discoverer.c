@@ -463,6 +463,9 @@ print_properties (GstDiscovererInfo * info, gint tab)
       (gst_discoverer_info_get_seekable (info) ? "yes" : "no"));
   g_print ("%*sLive: %s\n", tab + 1, " ",
       (gst_discoverer_info_get_live (info) ? "yes" : "no"));
+  if (verbose)
+    g_print ("%*sDiscovery time: %" GST_TIME_FORMAT "\n", tab + 1, " ",
+        GST_TIME_ARGS (gst_discoverer_info_get_discovery_time (info)));
   if (verbose && (tags = gst_discoverer_info_get_tags (info))) {
     g_print ("%*sTags: \n", tab + 1, " ");
     gst_tag_list_foreach (tags, print_tag_foreach, GUINT_TO_POINTER (tab + 2));
@@ -633,12 +636,21 @@ main (int argc, char **argv)
   GError *err = NULL;
   GstDiscoverer *dc;
   gint timeout = 10;
-  gboolean use_cache = FALSE, print_cache_dir = FALSE;
+  gint jobs = 1;
+  gint cache_max_size = 0;
+  gboolean use_cache = FALSE, print_cache_dir = FALSE, header_only = FALSE;
   GOptionEntry options[] = {
     {"async", 'a', 0, G_OPTION_ARG_NONE, &async,
         "Run asynchronously", NULL},
+    {"jobs", 'j', 0, G_OPTION_ARG_INT, &jobs,
+        "Number of URIs to discover in parallel (implies --async)", "N"},
     {"use-cache", 0, 0, G_OPTION_ARG_NONE, &use_cache,
         "Use GstDiscovererInfo from our cache.", NULL},
+    {"cache-max-size", 0, 0, G_OPTION_ARG_INT, &cache_max_size,
+        "Maximum size of the cache in MiB, 0 for no limit (implies "
+          "--use-cache)", "MIB"},
+    {"header-only", 0, 0, G_OPTION_ARG_NONE, &header_only,
+        "Only discover what the stream headers tell, without decoding", NULL},
     {"print-cache-dir", 0, 0, G_OPTION_ARG_NONE, &print_cache_dir,
         "Print the directory of the discoverer cache.", NULL},
     {"timeout", 't', 0, G_OPTION_ARG_INT, &timeout,
@@ -691,7 +703,18 @@ main (int argc, char **argv)
     exit (1);
   }
 
-  g_object_set (dc, "use-cache", use_cache, NULL);
+  if (cache_max_size > 0) {
+    g_object_set (dc, "cache-max-size", (guint64) cache_max_size * 1024 * 1024,
+        NULL);
+    use_cache = TRUE;
+  }
+
+  g_object_set (dc, "use-cache", use_cache, "header-only", header_only, NULL);
+
+  if (jobs > 1) {
+    g_object_set (dc, "max-concurrent", (guint) jobs, NULL);
+    async = TRUE;
+  }
 
   if (!async) {
     gint i;
@@ -720,6 +743,15 @@ main (int argc, char **argv)
     g_free (ps);
     g_main_loop_unref (ml);
   }
+
+  if (use_cache && verbose) {
+    guint64 hits, misses;
+
+    g_object_get (dc, "cache-hits", &hits, "cache-misses", &misses, NULL);
+    g_print ("\nCache: %" G_GUINT64_FORMAT " hits, %" G_GUINT64_FORMAT
+        " misses\n", hits, misses);
+  }
+
   g_object_unref (dc);
 
   return 0;